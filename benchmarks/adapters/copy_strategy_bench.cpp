@@ -0,0 +1,122 @@
+#include <benchmark/benchmark.h>
+
+#include "adapters/fs.hpp"
+
+#include <array>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include <fmt/core.h>
+
+// Каждая стратегия adapters::fs на файлах от 1 KB до 4 GB — на tmpfs и
+// на обычном диске, чтобы пороги select_strategy подбирались по цифрам.
+// async — путь io_uring на кольце потока (copy_file отдаёт его
+// copy_with_uring); без io_uring он откатывается на buffered.
+// Каталоги задают CCLONE_BENCH_TMPFS (по умолчанию /dev/shm) и
+// CCLONE_BENCH_DISK (по умолчанию текущий, то есть каталог сборки).
+// Источник создаётся один раз и читается из тёплого page cache; запись
+// идёт в новый файл на каждой итерации. Если места на двоих не хватает
+// или стратегия на этой ФС недоступна (O_DIRECT на tmpfs), запуск
+// помечается ошибкой с причиной, а не падает.
+
+namespace {
+
+namespace fs = std::filesystem;
+using cclone::adapters::fs::CopyStrategy;
+
+constexpr std::int64_t MIN_SIZE = std::int64_t{1} << 10;
+constexpr std::int64_t MAX_SIZE = std::int64_t{4} << 30;
+// Запас свободного места сверх источника и копии
+constexpr std::uintmax_t SPACE_MARGIN = 64 * 1024 * 1024;
+// Источники крупнее не держим между запусками: на tmpfs это память
+constexpr std::uintmax_t KEEP_SOURCE_LIMIT = 256 * 1024 * 1024;
+
+struct Location {
+    const char* name;
+    const char* env;
+    const char* fallback;   // пусто — текущий каталог
+};
+
+constexpr std::array LOCATIONS{
+    Location{"tmpfs", "CCLONE_BENCH_TMPFS", "/dev/shm"},
+    Location{"disk", "CCLONE_BENCH_DISK", ""},
+};
+
+constexpr std::array STRATEGIES{
+    std::pair{CopyStrategy::Buffered, "buffered"},
+    std::pair{CopyStrategy::MMap, "mmap"},
+    std::pair{CopyStrategy::DirectIO, "direct"},
+    std::pair{CopyStrategy::Async, "async"},
+};
+
+auto location_root(const Location& location) -> fs::path {
+    if (const char* value = std::getenv(location.env); value && *value) return value;
+    return *location.fallback ? fs::path(location.fallback) : fs::current_path();
+}
+
+// Случайные данные: сжатие и дедупликация ФС не искажают результат
+void write_source(const fs::path& path, std::uintmax_t size) {
+    std::mt19937_64 gen(size);
+    std::vector<std::uint64_t> block(1024 * 1024 / sizeof(std::uint64_t));
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    for (std::uintmax_t written = 0; written < size;) {
+        for (auto& word : block) word = gen();
+        const auto chunk = std::min<std::uintmax_t>(size - written, block.size() * sizeof(std::uint64_t));
+        out.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(chunk));
+        written += chunk;
+    }
+}
+
+void BM_CopyStrategy(benchmark::State& state, CopyStrategy strategy, const Location& location) {
+    const auto size = static_cast<std::uintmax_t>(state.range(0));
+    const auto dir = location_root(location) / "cclone_bench_copy";
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec) {
+        state.SkipWithError(fmt::format("cannot create {}: {}", dir.string(), ec.message()).c_str());
+        return;
+    }
+
+    const auto src = dir / fmt::format("src_{}.bin", size);
+    const auto dst = dir / fmt::format("dst_{}.bin", size);
+    const bool have_source = fs::exists(src, ec) && fs::file_size(src, ec) == size;
+    const auto space = fs::space(dir, ec);
+    const auto needed = (have_source ? 0 : size) + size + SPACE_MARGIN;
+    if (ec || space.available < needed) {
+        state.SkipWithError(fmt::format("not enough space in {} for {} bytes", dir.string(), needed).c_str());
+        return;
+    }
+    if (!have_source) write_source(src, size);
+
+    for (auto _ : state) {
+        auto copied = cclone::adapters::fs::copy_file(src, dst, strategy);
+        if (!copied) {
+            state.SkipWithError(copied.error().message.c_str());
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(size));
+
+    fs::remove(dst, ec);
+    if (size > KEEP_SOURCE_LIMIT) fs::remove(src, ec);
+}
+
+// BM_CopyStrategy/<стратегия>/<место>/<размер>
+[[maybe_unused]] const bool registered = [] {
+    for (const auto& location : LOCATIONS) {
+        for (const auto& [strategy, name] : STRATEGIES) {
+            benchmark::RegisterBenchmark(fmt::format("BM_CopyStrategy/{}/{}", name, location.name).c_str(),
+                                         BM_CopyStrategy, strategy, location)
+                ->RangeMultiplier(16)
+                ->Range(MIN_SIZE, MAX_SIZE)
+                ->Unit(benchmark::kMillisecond)
+                ->UseRealTime();
+        }
+    }
+    return true;
+}();
+
+} // namespace
@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+
+#include "core/copy_engine/copy_engine.hpp"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <fmt/core.h>
+
+// Фильтры --exclude/--include сканирования: проверка одного имени против
+// N шаблонов. Сканер зовёт их на каждый файл, так что items/s — верхняя
+// граница файлов в секунду, которую фильтр пропустит при таком числе шаблонов.
+
+namespace {
+
+constexpr std::size_t PATH_COUNT = 1024;
+
+auto make_paths() -> std::vector<std::filesystem::path> {
+    static const char* const EXTENSIONS[] = {"cpp", "hpp", "log", "tmp", "o", "json", "md", "bin"};
+    std::vector<std::filesystem::path> paths;
+    for (std::size_t i = 0; i < PATH_COUNT; ++i) {
+        paths.emplace_back(fmt::format("/data/project/dir{}/file_{}.{}", i % 32, i, EXTENSIONS[i % 8]));
+    }
+    return paths;
+}
+
+// Шаблоны не совпадают с именами, кроме последнего: проверяются все
+auto make_patterns(std::size_t count) -> std::vector<std::string> {
+    std::vector<std::string> patterns;
+    for (std::size_t i = 0; i + 1 < count; ++i) {
+        patterns.push_back(fmt::format(R"(.*\.ext{})", i));
+    }
+    if (count > 0) patterns.emplace_back(R"(.*\.tmp)");
+    return patterns;
+}
+
+void BM_FilterExclude(benchmark::State& state) {
+    cclone::infra::Config config;
+    config.exclude_patterns = make_patterns(static_cast<std::size_t>(state.range(0)));
+    cclone::infra::ProgressMonitor monitor(false, true);
+    const cclone::core::CopyEngine engine(config, monitor);
+    const auto paths = make_paths();
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine.should_exclude(paths[i++ % paths.size()]));
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+}
+
+void BM_FilterInclude(benchmark::State& state) {
+    cclone::infra::Config config;
+    config.include_patterns = make_patterns(static_cast<std::size_t>(state.range(0)));
+    cclone::infra::ProgressMonitor monitor(false, true);
+    const cclone::core::CopyEngine engine(config, monitor);
+    const auto paths = make_paths();
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine.should_include(paths[i++ % paths.size()]));
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+}
+
+} // namespace
+
+BENCHMARK(BM_FilterExclude)->Arg(0)->Arg(1)->Arg(4)->Arg(16);
+BENCHMARK(BM_FilterInclude)->Arg(1)->Arg(4)->Arg(16);
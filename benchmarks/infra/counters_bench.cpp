@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+
+#include "infra/concurrent/sharded_counters.hpp"
+
+#include <atomic>
+#include <cstdint>
+
+// Учёт завершённого файла из рабочих: три прибавления к общей статистике.
+// Shared — соседние атомики в одной кеш-линии (как было в CopyStats),
+// Sharded — ShardedCounters. Разница видна с ростом числа потоков.
+
+namespace {
+
+enum class Metric : std::size_t { Files, Bytes, Written, Count };
+
+struct SharedStats {
+    std::atomic<std::uint64_t> files{0};
+    std::atomic<std::uint64_t> bytes{0};
+    std::atomic<std::uint64_t> written{0};
+};
+
+SharedStats shared_stats;
+cclone::infra::ShardedCounters<Metric> sharded_stats;
+
+void BM_CountersShared(benchmark::State& state) {
+    for (auto _ : state) {
+        shared_stats.files.fetch_add(1, std::memory_order_relaxed);
+        shared_stats.bytes.fetch_add(4096, std::memory_order_relaxed);
+        shared_stats.written.fetch_add(4096, std::memory_order_relaxed);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+}
+
+void BM_CountersSharded(benchmark::State& state) {
+    for (auto _ : state) {
+        sharded_stats.add(Metric::Files);
+        sharded_stats.add(Metric::Bytes, 4096);
+        sharded_stats.add(Metric::Written, 4096);
+    }
+    if (state.thread_index() == 0) benchmark::DoNotOptimize(sharded_stats.load(Metric::Files));
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+}
+
+} // namespace
+
+BENCHMARK(BM_CountersShared)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_CountersSharded)->ThreadRange(1, 64)->UseRealTime();
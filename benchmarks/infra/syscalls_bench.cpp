@@ -0,0 +1,46 @@
+#include <benchmark/benchmark.h>
+
+#include "infra/syscall/syscalls.hpp"
+
+#include <filesystem>
+
+// Цена учёта рядом с самим вызовом: счётчик — fetch_add в линию шарда
+// потока, fstat — дешёвый системный вызов для сравнения
+
+namespace {
+
+namespace sys = cclone::infra::sys;
+
+void BM_SyscallNote(benchmark::State& state) {
+    for (auto _ : state) {
+        sys::note(sys::Syscall::Read);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+}
+
+void BM_FstatRaw(benchmark::State& state) {
+    const int fd = ::open(std::filesystem::temp_directory_path().c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat sb;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(::fstat(fd, &sb));
+    }
+    ::close(fd);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+}
+
+void BM_FstatCounted(benchmark::State& state) {
+    const int fd = ::open(std::filesystem::temp_directory_path().c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat sb;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sys::fstat(fd, &sb));
+    }
+    ::close(fd);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+}
+
+} // namespace
+
+BENCHMARK(BM_SyscallNote);
+BENCHMARK(BM_FstatRaw);
+BENCHMARK(BM_FstatCounted);
@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>
+
+#include "infra/thread_pool/thread_pool.hpp"
+#include "infra/thread_pool/work_stealing_pool.hpp"
+
+#include <atomic>
+
+// Пропускная способность планировщика: задачи/с на пустых задачах,
+// от 1 до 128 потоков. External — все задачи ставит один внешний поток
+// (как сканер движка), Nested — задачи порождают подзадачи из рабочих
+// (как хеширование сегментов). Время — реальное: главный поток ждёт.
+
+namespace {
+
+constexpr int TASKS = 20000;
+constexpr int FANOUT = 100;
+
+template <typename Pool>
+void BM_SchedulerExternal(benchmark::State& state) {
+    Pool pool{static_cast<std::size_t>(state.range(0))};
+    std::atomic<int> counter{0};
+    for (auto _ : state) {
+        for (int i = 0; i < TASKS; ++i) {
+            pool.enqueue([&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+        }
+        pool.wait();
+    }
+    benchmark::DoNotOptimize(counter.load());
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * TASKS);
+}
+
+template <typename Pool>
+void BM_SchedulerNested(benchmark::State& state) {
+    Pool pool{static_cast<std::size_t>(state.range(0))};
+    std::atomic<int> counter{0};
+    for (auto _ : state) {
+        for (int i = 0; i < TASKS / FANOUT; ++i) {
+            pool.enqueue([&pool, &counter] {
+                for (int j = 0; j < FANOUT; ++j) {
+                    pool.enqueue([&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+                }
+            });
+        }
+        pool.wait();
+    }
+    benchmark::DoNotOptimize(counter.load());
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * (TASKS + TASKS / FANOUT));
+}
+
+} // namespace
+
+using cclone::infra::ThreadPool;
+using cclone::infra::WorkStealingPool;
+
+BENCHMARK_TEMPLATE(BM_SchedulerExternal, ThreadPool)->RangeMultiplier(2)->Range(1, 128)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SchedulerExternal, WorkStealingPool)->RangeMultiplier(2)->Range(1, 128)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SchedulerNested, ThreadPool)->RangeMultiplier(2)->Range(1, 128)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SchedulerNested, WorkStealingPool)->RangeMultiplier(2)->Range(1, 128)->UseRealTime();
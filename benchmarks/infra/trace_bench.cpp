@@ -0,0 +1,37 @@
+#include <benchmark/benchmark.h>
+
+#include "infra/trace/trace.hpp"
+
+#include <filesystem>
+
+// Цена интервала на горячем пути: без --trace — одна relaxed-загрузка,
+// с --trace — два чтения часов и запись в кольцо потока
+
+namespace {
+
+namespace trace = cclone::infra::trace;
+
+void BM_TraceSpanDisabled(benchmark::State& state) {
+    for (auto _ : state) {
+        trace::Span span(trace::Phase::Read);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+}
+
+void BM_TraceSpanEnabled(benchmark::State& state) {
+    const auto output = std::filesystem::temp_directory_path() / "cclone_trace_bench.json";
+    trace::Session session({.output = output, .ring_events = 4096});
+    for (auto _ : state) {
+        trace::Span span(trace::Phase::Read);
+        benchmark::ClobberMemory();
+    }
+    (void)session.finish();
+    std::filesystem::remove(output);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+}
+
+} // namespace
+
+BENCHMARK(BM_TraceSpanDisabled);
+BENCHMARK(BM_TraceSpanEnabled);
@@ -0,0 +1,95 @@
+#include <benchmark/benchmark.h>
+
+#include "infra/compare/byte_comparator.hpp"
+#include "infra/hash/xxhash_verifier.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <vector>
+#include <fmt/core.h>
+
+// Сравнение стоимости проверки копии: XXH3 обоих файлов против
+// прямого побайтового сравнения. Throughput считается по логическому
+// размеру пары файлов (один раз size), как его видит пользователь.
+
+namespace {
+
+namespace fs = std::filesystem;
+
+struct FilePair {
+    fs::path src;
+    fs::path dst;
+};
+
+auto make_pair_files(std::size_t size) -> FilePair {
+    const auto dir = fs::temp_directory_path() / "cclone_bench_verify";
+    fs::create_directories(dir);
+
+    FilePair pair{dir / fmt::format("src_{}.bin", size), dir / fmt::format("dst_{}.bin", size)};
+    if (fs::exists(pair.src) && fs::file_size(pair.src) == size && fs::exists(pair.dst)) {
+        return pair;
+    }
+
+    std::mt19937_64 gen(size);
+    std::vector<std::uint64_t> block(1024 * 1024 / sizeof(std::uint64_t));
+    std::ofstream src(pair.src, std::ios::binary);
+    std::ofstream dst(pair.dst, std::ios::binary);
+    for (std::size_t written = 0; written < size;) {
+        for (auto& word : block) word = gen();
+        const auto chunk = std::min(size - written, block.size() * sizeof(std::uint64_t));
+        src.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(chunk));
+        dst.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(chunk));
+        written += chunk;
+    }
+    return pair;
+}
+
+void BM_XXHashVerifyFiles(benchmark::State& state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const auto pair = make_pair_files(size);
+    for (auto _ : state) {
+        auto result = cclone::infra::XXHashVerifier::verify_files(pair.src, pair.dst);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(size));
+}
+
+void BM_ByteCompareFiles(benchmark::State& state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const auto pair = make_pair_files(size);
+    for (auto _ : state) {
+        auto result = cclone::infra::ByteComparator::compare_files(pair.src, pair.dst);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(size));
+}
+
+// Хеш одного файла — то, что движок платит за --verify и манифест на файл
+void BM_XXHashFile(benchmark::State& state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const auto pair = make_pair_files(size);
+    for (auto _ : state) {
+        auto hash = cclone::infra::XXHashVerifier::hash_file(pair.src);
+        benchmark::DoNotOptimize(hash);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(size));
+}
+
+// Только ядро сравнения, без I/O
+void BM_FirstMismatchKernel(benchmark::State& state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    std::vector<unsigned char> a(size, 0x5a);
+    std::vector<unsigned char> b(size, 0x5a);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cclone::infra::ByteComparator::first_mismatch(a.data(), b.data(), size));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(size));
+}
+
+} // namespace
+
+BENCHMARK(BM_XXHashVerifyFiles)->RangeMultiplier(8)->Range(1 << 20, 256 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ByteCompareFiles)->RangeMultiplier(8)->Range(1 << 20, 256 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_XXHashFile)->RangeMultiplier(16)->Range(1 << 10, 256 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FirstMismatchKernel)->RangeMultiplier(16)->Range(4 << 10, 64 << 20);
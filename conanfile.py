@@ -16,6 +16,7 @@ class CcloneRecipe(ConanFile):
         "yaml-cpp/0.8.0",
         "spdlog/1.13.0",
         "gtest/1.14.0",
+        "benchmark/1.8.3",
         "xxhash/0.8.2",
         "liburing/2.7" if settings.os == "Linux" else None,
     )
@@ -0,0 +1,90 @@
+#include "file_stat.hpp"
+#include "infra/syscall/syscalls.hpp"
+#include <fmt/core.h>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#ifdef __linux__
+    #include <sys/sysmacros.h>
+#endif
+
+namespace cclone::adapters::fs {
+
+namespace {
+
+#ifndef _WIN32
+auto stat_error(const std::filesystem::path& path, int err) -> infra::Error {
+    const auto code = err == ENOENT ? infra::ErrorCode::FileNotFound
+                    : err == EACCES ? infra::ErrorCode::PermissionDenied
+                    : infra::ErrorCode::Unknown;
+    return infra::make_error(code, fmt::format("stat failed for {}: {}", path.string(), std::strerror(err)));
+}
+#endif
+
+} // namespace
+
+auto stat_file(const std::filesystem::path& path, bool follow_symlinks)
+    -> std::expected<FileStat, infra::Error>
+{
+    FileStat st;
+#if defined(__linux__) && defined(STATX_BASIC_STATS)
+    struct statx sx;
+    const int flags = AT_STATX_SYNC_AS_STAT | (follow_symlinks ? 0 : AT_SYMLINK_NOFOLLOW);
+    if (infra::sys::statx(AT_FDCWD, path.c_str(), flags, STATX_BASIC_STATS, &sx) != 0) {
+        return std::unexpected(stat_error(path, errno));
+    }
+    st.size = sx.stx_size;
+    st.mtime_ns = static_cast<std::int64_t>(sx.stx_mtime.tv_sec) * 1'000'000'000 + sx.stx_mtime.tv_nsec;
+    st.atime_ns = static_cast<std::int64_t>(sx.stx_atime.tv_sec) * 1'000'000'000 + sx.stx_atime.tv_nsec;
+    st.inode = sx.stx_ino;
+    // Кодировка st_dev, как у stat(): major()/minor() и sysfs её понимают
+    st.device = static_cast<std::uint64_t>(makedev(sx.stx_dev_major, sx.stx_dev_minor));
+    st.nlink = sx.stx_nlink;
+    st.mode = sx.stx_mode;
+    st.uid = sx.stx_uid;
+    st.gid = sx.stx_gid;
+#elif !defined(_WIN32)
+    struct stat sb;
+    const int rc = follow_symlinks ? infra::sys::stat(path.c_str(), &sb) : infra::sys::lstat(path.c_str(), &sb);
+    if (rc != 0) {
+        return std::unexpected(stat_error(path, errno));
+    }
+    st.size = static_cast<std::uint64_t>(sb.st_size);
+    #ifdef __APPLE__
+    st.mtime_ns = static_cast<std::int64_t>(sb.st_mtimespec.tv_sec) * 1'000'000'000 + sb.st_mtimespec.tv_nsec;
+    st.atime_ns = static_cast<std::int64_t>(sb.st_atimespec.tv_sec) * 1'000'000'000 + sb.st_atimespec.tv_nsec;
+    #else
+    st.mtime_ns = static_cast<std::int64_t>(sb.st_mtim.tv_sec) * 1'000'000'000 + sb.st_mtim.tv_nsec;
+    st.atime_ns = static_cast<std::int64_t>(sb.st_atim.tv_sec) * 1'000'000'000 + sb.st_atim.tv_nsec;
+    #endif
+    st.inode = static_cast<std::uint64_t>(sb.st_ino);
+    st.device = static_cast<std::uint64_t>(sb.st_dev);
+    st.nlink = static_cast<std::uint64_t>(sb.st_nlink);
+    st.mode = static_cast<std::uint32_t>(sb.st_mode);
+    st.uid = static_cast<std::uint32_t>(sb.st_uid);
+    st.gid = static_cast<std::uint32_t>(sb.st_gid);
+#else
+    (void)follow_symlinks;
+    std::error_code ec;
+    st.size = std::filesystem::file_size(path, ec);
+    if (!ec) {
+        const auto time = std::filesystem::last_write_time(path, ec);
+        const auto sys = std::chrono::file_clock::to_sys(time);
+        st.mtime_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(sys.time_since_epoch()).count();
+    }
+    if (ec) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::FileNotFound,
+                               fmt::format("stat failed for {}: {}", path.string(), ec.message())));
+    }
+#endif
+    return st;
+}
+
+} // namespace cclone::adapters::fs
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <filesystem>
+#include <expected>
+#include <cstdint>
+#include "infra/error_handler/error.hpp"
+
+namespace cclone::adapters::fs {
+
+// Метаданные файла, снятые одним системным вызовом при сканировании
+struct FileStat {
+    std::uint64_t size = 0;
+    std::int64_t mtime_ns = 0;   // наносекунды от Unix epoch
+    std::int64_t atime_ns = 0;
+    std::uint64_t inode = 0;     // 0, если платформа не сообщает
+    std::uint64_t device = 0;
+    std::uint64_t nlink = 1;
+    std::uint32_t mode = 0;      // тип и права (st_mode)
+    std::uint32_t uid = 0;
+    std::uint32_t gid = 0;
+};
+
+// statx (Linux) / stat (POSIX) / std::filesystem (Windows)
+[[nodiscard]] auto stat_file(const std::filesystem::path& path, bool follow_symlinks = true)
+    -> std::expected<FileStat, infra::Error>;
+
+} // namespace cclone::adapters::fs
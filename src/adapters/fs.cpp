@@ -0,0 +1,498 @@
+#include "fs.hpp"
+#include "output_file.hpp"
+#include "io_buffer.hpp"
+#include "infra/interrupt.hpp"
+#include "infra/monitoring/op_latency.hpp"
+#include "infra/syscall/syscalls.hpp"
+#include "infra/trace/trace.hpp"
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <system_error>
+#include <vector>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fmt/core.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <io.h>
+    #include <fcntl.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#ifdef __linux__
+    #include <liburing.h>
+#endif
+
+namespace cclone::adapters::fs {
+
+namespace {
+
+#ifndef _WIN32
+// Закрывает дескриптор источника при выходе из области видимости
+struct SourceFd {
+    int fd = -1;
+    ~SourceFd() {
+        if (fd != -1) infra::sys::close(fd);
+    }
+};
+
+// Хук работает до публикации: метаданные и сброс на носитель
+// применяются к файлу, которого под своим именем ещё нет
+auto finish_output(const DescriptorHook& hook, const SourceFd& src, OutputFile& out)
+    -> std::expected<void, infra::Error>
+{
+    if (hook) {
+        if (auto done = hook(src.fd, out.fd()); !done) return done;
+    }
+    infra::trace::Span span(infra::trace::Phase::Publish);
+    return out.publish();
+}
+
+// Открытие источника и назначения, чтение и запись — отдельные фазы --trace
+auto open_source(const std::filesystem::path& src, int flags) -> int {
+    infra::trace::Span span(infra::trace::Phase::Open);
+    infra::OpTimer timer(infra::IoOp::Open);
+    return infra::sys::open(src.c_str(), flags | O_CLOEXEC);
+}
+
+auto open_output(const std::filesystem::path& dst, Publish publish, int extra_flags = 0)
+    -> std::expected<OutputFile, infra::Error>
+{
+    infra::trace::Span span(infra::trace::Phase::Open);
+    infra::OpTimer timer(infra::IoOp::Open);
+    return OutputFile::open(dst, publish, extra_flags);
+}
+
+auto read_some(int fd, char* buffer, std::size_t size) -> ssize_t {
+    infra::trace::Span span(infra::trace::Phase::Read);
+    infra::OpTimer timer(infra::IoOp::Read);
+    return infra::sys::read(fd, buffer, size);
+}
+
+auto write_some(int fd, const char* data, std::size_t size) -> ssize_t {
+    infra::trace::Span span(infra::trace::Phase::Write);
+    infra::OpTimer timer(infra::IoOp::Write);
+    const ssize_t n = infra::sys::write(fd, data, size);
+    if (n > 0) infra::note_written(static_cast<std::uint64_t>(n));
+    return n;
+}
+
+auto write_all(int fd, const char* data, std::size_t size) -> bool {
+    infra::trace::Span span(infra::trace::Phase::Write);
+    infra::OpTimer timer(infra::IoOp::Write);
+    while (size > 0) {
+        const ssize_t n = infra::sys::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        infra::note_written(static_cast<std::uint64_t>(n));
+        data += n;
+        size -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+#endif
+
+constexpr std::size_t DIRECT_ALIGN = 4096;
+// Кусок записи из отображения при --bwlimit
+constexpr std::size_t MMAP_PACED_PIECE = 1024 * 1024;
+
+auto aligned_size(std::size_t size) -> std::size_t {
+    return (size + DIRECT_ALIGN - 1) & ~(DIRECT_ALIGN - 1);
+}
+
+} // namespace
+
+auto select_strategy(std::uintmax_t file_size) -> CopyStrategy {
+    if (file_size < 1'000'000) return CopyStrategy::Buffered;      // < 1 MB
+    if (file_size < 100'000'000) return CopyStrategy::MMap;        // < 100 MB
+    return CopyStrategy::DirectIO;                                 // >= 100 MB
+}
+
+auto buffer_footprint(CopyStrategy strategy, std::uintmax_t file_size) -> std::uint64_t {
+    switch (strategy) {
+    case CopyStrategy::MMap:
+        return file_size;
+    case CopyStrategy::DirectIO:
+    case CopyStrategy::Async:
+        return std::min<std::uint64_t>(file_size, DIRECT_BUFFER_SIZE);
+    case CopyStrategy::Buffered:
+        break;
+    }
+    return std::min<std::uint64_t>(file_size, BUFFERED_BUFFER_SIZE);
+}
+
+// =============== Buffered I/O ===============
+auto copy_file_buffered(
+    const std::filesystem::path& src,
+    const std::filesystem::path& dst,
+    const DescriptorHook& on_written,
+    Publish publish,
+    const infra::IoPacer& pacer
+) -> std::expected<void, infra::Error> {
+    constexpr size_t buffer_size = BUFFERED_BUFFER_SIZE;
+#ifndef _WIN32
+    SourceFd in;
+    in.fd = open_source(src, O_RDONLY);
+    if (in.fd == -1) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::FileNotFound,
+                               fmt::format("Failed to open {}: {}", src.string(), std::strerror(errno))));
+    }
+    auto out = open_output(dst, publish);
+    if (!out) {
+        return std::unexpected(std::move(out.error()));
+    }
+
+    char* buffer = thread_io_buffer(buffer_size);
+    if (!buffer) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::Unknown, "Cannot allocate I/O buffer"));
+    }
+    for (;;) {
+        const ssize_t n = read_some(in.fd, buffer, buffer_size);
+        if (n == 0) break;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                                   fmt::format("Read error in {}: {}", src.string(), std::strerror(errno))));
+        }
+        pacer.read(static_cast<std::uint64_t>(n));
+        pacer.write(static_cast<std::uint64_t>(n));
+        if (!write_all(out->fd(), buffer, static_cast<std::size_t>(n))) {
+            return std::unexpected(infra::make_error(errno == ENOSPC ? infra::ErrorCode::DiskFull : infra::ErrorCode::Unknown,
+                                   fmt::format("Write error in {}: {}", dst.string(), std::strerror(errno))));
+        }
+    }
+    return finish_output(on_written, in, *out);
+#else
+    (void)on_written; (void)publish;
+    std::ifstream ifs(src, std::ios::binary);
+    std::ofstream ofs(dst, std::ios::binary);
+    if (!ifs || !ofs) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::FileNotFound, "Failed to open file"));
+    }
+
+    std::vector<char> buffer(buffer_size);
+    while (ifs.read(buffer.data(), buffer_size) || ifs.gcount() > 0) {
+        pacer.read(static_cast<std::uint64_t>(ifs.gcount()));
+        pacer.write(static_cast<std::uint64_t>(ifs.gcount()));
+        ofs.write(buffer.data(), ifs.gcount());
+    }
+    return {};
+#endif
+}
+
+// =============== Memory-mapped I/O ===============
+auto copy_file_mmap(
+    const std::filesystem::path& src,
+    const std::filesystem::path& dst,
+    const DescriptorHook& on_written,
+    Publish publish,
+    const infra::IoPacer& pacer
+) -> std::expected<void, infra::Error> {
+#ifndef _WIN32
+    // Linux/macOS
+    SourceFd in;
+    in.fd = open_source(src, O_RDONLY);
+    if (in.fd == -1) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::FileNotFound, "Cannot open source for mmap"));
+    }
+
+    struct stat sb;
+    if (infra::sys::fstat(in.fd, &sb) == -1) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::Unknown, "fstat failed"));
+    }
+
+    auto out = open_output(dst, publish);
+    if (!out) {
+        return std::unexpected(std::move(out.error()));
+    }
+    if (sb.st_size == 0) {
+        return finish_output(on_written, in, *out);
+    }
+
+    void* src_map = infra::sys::mmap(nullptr, sb.st_size, PROT_READ, MAP_PRIVATE, in.fd, 0);
+    if (src_map == MAP_FAILED) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::Unknown, "mmap failed"));
+    }
+
+    // С ограничением скорости — кусками: одна запись на весь файл
+    // выбрала бы его квоту разом и простояла бы её целиком
+    const auto* data = static_cast<const char*>(src_map);
+    const auto size = static_cast<std::size_t>(sb.st_size);
+    const std::size_t piece = pacer ? MMAP_PACED_PIECE : size;
+    bool written = true;
+    for (std::size_t done = 0; written && done < size; done += piece) {
+        const auto length = std::min(piece, size - done);
+        pacer.read(length);
+        pacer.write(length);
+        written = write_all(out->fd(), data + done, length);
+    }
+    infra::sys::munmap(src_map, sb.st_size);
+
+    if (!written) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::Unknown, "Incomplete write in mmap copy"));
+    }
+    return finish_output(on_written, in, *out);
+#else
+    // Windows fallback to buffered
+    return copy_file_buffered(src, dst, on_written, publish, pacer);
+#endif
+}
+
+// =============== Direct I/O ===============
+auto copy_file_direct(
+    const std::filesystem::path& src,
+    const std::filesystem::path& dst,
+    const DescriptorHook& on_written,
+    Publish publish,
+    const infra::IoPacer& pacer
+) -> std::expected<void, infra::Error> {
+#ifdef __linux__
+    // Linux: O_DIRECT требует выравнивания адреса буфера, длины и смещения
+    const size_t buffer_size = DIRECT_BUFFER_SIZE;
+    char* buffer = thread_io_buffer(aligned_size(buffer_size));
+    if (!buffer) {
+        return copy_file_buffered(src, dst, on_written, publish, pacer);
+    }
+
+    SourceFd in;
+    in.fd = open_source(src, O_RDONLY | O_DIRECT);
+    if (in.fd == -1) {
+        // Fallback to buffered if O_DIRECT not supported
+        return copy_file_buffered(src, dst, on_written, publish, pacer);
+    }
+
+    auto out = open_output(dst, publish, O_DIRECT);
+    if (!out) {
+        infra::sys::close(in.fd);
+        in.fd = -1;
+        return copy_file_buffered(src, dst, on_written, publish, pacer);
+    }
+
+    std::uint64_t total = 0;
+    ssize_t bytes_read;
+    while ((bytes_read = read_some(in.fd, buffer, buffer_size)) > 0) {
+        // Хвост дополняется до границы блока; лишнее срезается ftruncate ниже
+        const size_t aligned_write = (static_cast<size_t>(bytes_read) + DIRECT_ALIGN - 1) & ~(DIRECT_ALIGN - 1);
+        pacer.read(static_cast<std::uint64_t>(bytes_read));
+        pacer.write(aligned_write);
+        if (write_some(out->fd(), buffer, aligned_write) != static_cast<ssize_t>(aligned_write)) {
+            return std::unexpected(infra::make_error(infra::ErrorCode::Unknown, "Direct I/O write failed"));
+        }
+        total += static_cast<std::uint64_t>(bytes_read);
+    }
+    if (bytes_read < 0) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                               fmt::format("Direct I/O read failed: {}", std::strerror(errno))));
+    }
+    if (infra::sys::ftruncate(out->fd(), static_cast<off_t>(total)) != 0) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                               fmt::format("Cannot trim {}: {}", dst.string(), std::strerror(errno))));
+    }
+    return finish_output(on_written, in, *out);
+#else
+    // Windows / macOS: fallback to buffered
+    return copy_file_buffered(src, dst, on_written, publish, pacer);
+#endif
+}
+
+#ifdef __linux__
+namespace {
+    constexpr size_t RING_SIZE = 64;
+    constexpr size_t CHUNK_SIZE = DIRECT_BUFFER_SIZE;
+
+    // Кольцо вызывающего потока, как и thread_io_buffer: создаётся к первому
+    // крупному файлу и живёт вместе с потоком, так что рабочие пула (и
+    // демона) не платят за io_uring_queue_init на каждый файл
+    class ThreadRing {
+    public:
+        ThreadRing() { init(); }
+        ~ThreadRing() { if (ready_) io_uring_queue_exit(&ring_); }
+
+        auto get() -> io_uring* { return ready_ ? &ring_ : nullptr; }
+
+        // После сбоя в кольце могут остаться чужие завершения — заводим новое
+        void reset() {
+            if (ready_) io_uring_queue_exit(&ring_);
+            init();
+        }
+
+    private:
+        void init() { ready_ = io_uring_queue_init(RING_SIZE, &ring_, 0) == 0; }
+
+        io_uring ring_{};
+        bool ready_ = false;
+    };
+
+    auto thread_ring() -> ThreadRing& {
+        thread_local ThreadRing ring;
+        return ring;
+    }
+
+    auto copy_with_uring(const std::filesystem::path& src,
+                         const std::filesystem::path& dst,
+                         const DescriptorHook& on_written,
+                         Publish publish,
+                         const infra::IoPacer& pacer)
+        -> std::expected<void, infra::Error>
+    {
+        auto& owner = thread_ring();
+        io_uring* ring = owner.get();
+        if (!ring) {
+            return copy_file_buffered(src, dst, on_written, publish, pacer); // fallback
+        }
+
+        // Чтение в обход кэша, запись — через кэш: хвост файла не кратен блоку
+        SourceFd in;
+        in.fd = open_source(src, O_RDONLY | O_DIRECT);
+        if (in.fd < 0) {
+            return copy_file_buffered(src, dst, on_written, publish, pacer);
+        }
+        auto out = open_output(dst, publish);
+        if (!out) {
+            return std::unexpected(std::move(out.error()));
+        }
+
+        struct stat sb;
+        if (infra::sys::fstat(in.fd, &sb) < 0) {
+            return std::unexpected(infra::make_error(infra::ErrorCode::Unknown, "fstat failed"));
+        }
+
+        char* buffer = thread_io_buffer(aligned_size(CHUNK_SIZE));
+        if (!buffer) {
+            return copy_file_buffered(src, dst, on_written, publish, pacer);
+        }
+
+        // Выполняет одну операцию и возвращает её результат (байты или -errno)
+        auto run_one = [&](infra::trace::Phase phase, auto prep) -> int {
+            infra::trace::Span span(phase);
+            infra::OpTimer timer(phase == infra::trace::Phase::Read ? infra::IoOp::Read : infra::IoOp::Write);
+            io_uring_sqe* sqe = io_uring_get_sqe(ring);
+            if (!sqe) return -EBUSY;
+            prep(sqe);
+            const int submitted = io_uring_submit_and_wait(ring, 1);
+            infra::sys::note(infra::sys::Syscall::UringEnter, submitted < 0);
+            if (submitted < 0) return submitted;
+            io_uring_cqe* cqe;
+            if (int rc = io_uring_wait_cqe(ring, &cqe); rc < 0) return rc;
+            const int res = cqe->res;
+            io_uring_cqe_seen(ring, cqe);
+            return res;
+        };
+
+        std::expected<void, infra::Error> result{};
+        off_t offset = 0;
+        while (offset < sb.st_size) {
+            const size_t to_read = std::min<size_t>(static_cast<size_t>(sb.st_size - offset), CHUNK_SIZE);
+            const size_t aligned_read = (to_read + DIRECT_ALIGN - 1) & ~(DIRECT_ALIGN - 1);
+
+            const int got = run_one(infra::trace::Phase::Read, [&](io_uring_sqe* sqe) {
+                io_uring_prep_read(sqe, in.fd, buffer, static_cast<unsigned>(aligned_read), offset);
+            });
+            if (got <= 0) {
+                result = std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                                         fmt::format("io_uring read failed at offset {}: {}", offset, std::strerror(-got))));
+                break;
+            }
+
+            pacer.read(static_cast<std::uint64_t>(got));
+            pacer.write(static_cast<std::uint64_t>(got));
+            const int put = run_one(infra::trace::Phase::Write, [&](io_uring_sqe* sqe) {
+                io_uring_prep_write(sqe, out->fd(), buffer, static_cast<unsigned>(got), offset);
+            });
+            if (put != got) {
+                result = std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                                         fmt::format("io_uring write failed at offset {}: {}", offset,
+                                                     put < 0 ? std::strerror(-put) : "short write")));
+                break;
+            }
+            infra::note_written(static_cast<std::uint64_t>(put));
+            offset += got;
+        }
+
+        if (!result) {
+            owner.reset();
+            return result;
+        }
+        return finish_output(on_written, in, *out);
+    }
+}
+#endif
+
+// =============== Unified copy_file ===============
+auto copy_file(
+    const std::filesystem::path& src,
+    const std::filesystem::path& dst,
+    CopyStrategy strategy,
+    const DescriptorHook& on_written,
+    Publish publish,
+    const infra::IoPacer& pacer
+) -> std::expected<void, infra::Error> {
+    switch (strategy) {
+        case CopyStrategy::MMap:
+            return copy_file_mmap(src, dst, on_written, publish, pacer);
+        case CopyStrategy::DirectIO:
+            return copy_file_direct(src, dst, on_written, publish, pacer);
+        case CopyStrategy::Async:
+#ifdef __linux__
+            // io_uring на кольце вызывающего потока, как DirectIO у copy_file_ring
+            return copy_with_uring(src, dst, on_written, publish, pacer);
+#else
+            return copy_file_buffered(src, dst, on_written, publish, pacer);
+#endif
+        case CopyStrategy::Buffered:
+        default:
+            return copy_file_buffered(src, dst, on_written, publish, pacer);
+    }
+}
+
+auto copy_file_ring(
+    const std::filesystem::path& src,
+    const std::filesystem::path& dst,
+    CopyStrategy strategy,
+    const DescriptorHook& on_written,
+    Publish publish,
+    const infra::IoPacer& pacer
+) -> std::expected<void, infra::Error>
+{
+    if (infra::is_interrupted()) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::Interrupted, "Cancelled"));
+    }
+
+#ifdef __linux__
+    if (strategy == CopyStrategy::DirectIO || strategy == CopyStrategy::Async) {
+        return copy_with_uring(src, dst, on_written, publish, pacer);
+    }
+#endif
+
+    return copy_file(src, dst, strategy, on_written, publish, pacer);
+}
+
+auto copy_file_async(
+    const std::filesystem::path& src,
+    const std::filesystem::path& dst,
+    CopyStrategy strategy,
+    DescriptorHook on_written,
+    Publish publish,
+    infra::IoPacer pacer
+) -> std::future<std::expected<void, infra::Error>>
+{
+    // Задержки операций пишутся под файлом, который копирует вызывающий поток,
+    // отмена — по его заданию
+    return std::async(std::launch::async, [=, latency = infra::OpLatency::bound(),
+                                           cancel = infra::CancelScope::current()]()
+        -> std::expected<void, infra::Error> {
+        const infra::OpLatency::Context latency_context(latency);
+        const infra::CancelScope cancel_scope(cancel);
+        return copy_file_ring(src, dst, strategy, on_written, publish, pacer);
+    });
+}
+} // namespace cclone::adapters::fs
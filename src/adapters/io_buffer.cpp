@@ -0,0 +1,30 @@
+#include "io_buffer.hpp"
+#include "infra/numa/numa.hpp"
+
+namespace cclone::adapters::fs {
+
+namespace {
+
+struct ThreadBuffer {
+    void* data = nullptr;
+    std::size_t size = 0;
+
+    ThreadBuffer() = default;
+    ThreadBuffer(const ThreadBuffer&) = delete;
+    ThreadBuffer& operator=(const ThreadBuffer&) = delete;
+    ~ThreadBuffer() { infra::free_numa_memory(data, size); }
+};
+
+} // namespace
+
+auto thread_io_buffer(std::size_t size) -> char* {
+    thread_local ThreadBuffer buffer;
+    if (buffer.size < size) {
+        infra::free_numa_memory(buffer.data, buffer.size);
+        buffer.data = infra::allocate_numa_memory(size, infra::current_numa_node());
+        buffer.size = buffer.data ? size : 0;
+    }
+    return static_cast<char*>(buffer.data);
+}
+
+} // namespace cclone::adapters::fs
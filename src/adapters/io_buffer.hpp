@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+namespace cclone::adapters::fs {
+
+// Буфер ввода-вывода вызывающего потока, выровненный по странице (годится
+// для O_DIRECT). Выделяется при первом запросе на узле NUMA, где поток
+// выполняется, и переиспользуется всеми копированиями этого потока;
+// освобождается с завершением потока. Закреплённый за узлом рабочий
+// (--numa) так копирует только через локальную память.
+//
+// Не больше одного пользователя на поток: указатель действителен до
+// следующего вызова с большим size. nullptr — память не выделилась.
+[[nodiscard]] auto thread_io_buffer(std::size_t size) -> char*;
+
+} // namespace cclone::adapters::fs
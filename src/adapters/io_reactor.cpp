@@ -0,0 +1,317 @@
+#include "io_reactor.hpp"
+#include "infra/syscall/syscalls.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fmt/core.h>
+
+#ifdef __linux__
+    #include <liburing.h>
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace cclone::adapters::fs {
+
+namespace {
+
+// Больше ядро не даёт (IORING_MAX_ENTRIES)
+constexpr unsigned MAX_RING_ENTRIES = 32768;
+// Ни одна операция кольца не передаёт больше за раз
+constexpr std::size_t MAX_IO_LENGTH = 1U << 30;
+
+} // namespace
+
+struct IoReactor::Ring {
+#ifdef __linux__
+    io_uring ring{};
+#endif
+};
+
+auto IoReactor::create(unsigned entries, infra::WorkStealingPool& blocking, bool allow_uring)
+    -> std::expected<std::unique_ptr<IoReactor>, infra::Error>
+{
+#ifdef __linux__
+    const int event_fd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (event_fd == -1) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                               fmt::format("eventfd failed: {}", std::strerror(errno))));
+    }
+
+    if (allow_uring) {
+        auto ring = std::make_unique<Ring>();
+        // +1 — постоянное чтение eventfd
+        const unsigned size = std::clamp(entries + 1, 2U, MAX_RING_ENTRIES);
+        if (io_uring_queue_init(size, &ring->ring, 0) == 0) {
+            std::unique_ptr<IoReactor> reactor(new IoReactor(Backend::Uring, blocking));
+            reactor->ring_ = std::move(ring);
+            reactor->event_fd_ = event_fd;
+            return reactor;
+        }
+        // ENOSYS, EPERM под seccomp, ENOMEM по RLIMIT_MEMLOCK — обойдёмся потоками
+    }
+
+    const int epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    if (epoll_fd == -1 || ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, event_fd, &event) != 0) {
+        const int err = errno;
+        if (epoll_fd != -1) ::close(epoll_fd);
+        ::close(event_fd);
+        return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                               fmt::format("epoll setup failed: {}", std::strerror(err))));
+    }
+    std::unique_ptr<IoReactor> reactor(new IoReactor(Backend::Threads, blocking));
+    reactor->event_fd_ = event_fd;
+    reactor->epoll_fd_ = epoll_fd;
+    return reactor;
+#else
+    (void)entries; (void)blocking; (void)allow_uring;
+    return std::unexpected(infra::make_error(infra::ErrorCode::UnsupportedFeature,
+                           "Async I/O reactor requires Linux"));
+#endif
+}
+
+IoReactor::IoReactor(Backend backend, infra::WorkStealingPool& blocking)
+    : backend_(backend), blocking_(blocking) {}
+
+IoReactor::~IoReactor() {
+#ifdef __linux__
+    // Операций в полёте быть не должно: их кадры принадлежат сопрограммам
+    if (ring_) io_uring_queue_exit(&ring_->ring);
+    if (epoll_fd_ != -1) ::close(epoll_fd_);
+    if (event_fd_ != -1) ::close(event_fd_);
+#endif
+}
+
+auto IoReactor::open(const char* path, int flags, unsigned mode) -> Op {
+    Op op(this, Op::Kind::Open);
+    op.path_ = path;
+    op.flags_ = flags;
+    op.mode_ = mode;
+    return op;
+}
+
+auto IoReactor::read(int fd, void* buffer, std::size_t length, std::uint64_t offset) -> Op {
+    Op op(this, Op::Kind::Read);
+    op.fd_ = fd;
+    op.data_ = buffer;
+    op.length_ = std::min(length, MAX_IO_LENGTH);
+    op.offset_ = offset;
+    return op;
+}
+
+auto IoReactor::write(int fd, const void* buffer, std::size_t length, std::uint64_t offset) -> Op {
+    Op op(this, Op::Kind::Write);
+    op.fd_ = fd;
+    op.data_ = const_cast<void*>(buffer);
+    op.length_ = std::min(length, MAX_IO_LENGTH);
+    op.offset_ = offset;
+    return op;
+}
+
+auto IoReactor::close(int fd) -> Op {
+    Op op(this, Op::Kind::Close);
+    op.fd_ = fd;
+    return op;
+}
+
+auto IoReactor::unlink(const char* path) -> Op {
+    Op op(this, Op::Kind::Unlink);
+    op.path_ = path;
+    return op;
+}
+
+auto IoReactor::sleep(std::chrono::nanoseconds duration) -> Op {
+    Op op(this, Op::Kind::Sleep);
+    const auto ns = std::max<std::int64_t>(duration.count(), 0);
+    op.timeout_.sec = ns / 1'000'000'000;
+    op.timeout_.nsec = ns % 1'000'000'000;
+    return op;
+}
+
+void IoReactor::submit_(Op& op) {
+    ++pending_;
+    if (backend_ == Backend::Threads && op.kind_ == Op::Kind::Sleep) {
+        // Спящая операция не должна занимать поток пула
+        const auto duration = std::chrono::seconds(op.timeout_.sec) + std::chrono::nanoseconds(op.timeout_.nsec);
+        timers_.emplace(std::chrono::steady_clock::now() + duration, &op);
+        return;
+    }
+    if (backend_ == Backend::Threads) {
+        blocking_.enqueue([this, &op] {
+            op.result = perform_(op);
+            post_(&op);
+        });
+        return;
+    }
+    backlog_.push_back(&op);
+}
+
+auto IoReactor::perform_(const Op& op) -> int {
+#ifdef __linux__
+    auto done = [](auto rc) { return rc < 0 ? -errno : static_cast<int>(rc); };
+    for (;;) {
+        int rc = 0;
+        switch (op.kind_) {
+        case Op::Kind::Open:
+            rc = done(infra::sys::open(op.path_, op.flags_, op.mode_));
+            break;
+        case Op::Kind::Read:
+            rc = done(infra::sys::pread(op.fd_, op.data_, op.length_, static_cast<off_t>(op.offset_)));
+            break;
+        case Op::Kind::Write:
+            rc = done(infra::sys::pwrite(op.fd_, op.data_, op.length_, static_cast<off_t>(op.offset_)));
+            break;
+        case Op::Kind::Close:
+            // close(2) не повторяют при EINTR: дескриптор уже освобождён
+            return done(infra::sys::close(op.fd_));
+        case Op::Kind::Unlink:
+            rc = done(infra::sys::unlink(op.path_));
+            break;
+        case Op::Kind::Sleep:
+            return 0;  // паузы ведёт сам реактор (timers_)
+        }
+        if (rc != -EINTR) return rc;
+    }
+#else
+    (void)op;
+    return -ENOSYS;
+#endif
+}
+
+void IoReactor::post_(Completion* completion) {
+    {
+        std::lock_guard lock(posted_mutex_);
+        posted_.push_back(completion);
+    }
+#ifdef __linux__
+    const std::uint64_t one = 1;
+    (void)!::write(event_fd_, &one, sizeof(one));
+#endif
+}
+
+void IoReactor::take_posted_(std::vector<Completion*>& ready) {
+    std::lock_guard lock(posted_mutex_);
+    ready.insert(ready.end(), posted_.begin(), posted_.end());
+    posted_.clear();
+}
+
+auto IoReactor::wait() -> std::size_t {
+    std::vector<Completion*> ready;
+    if (backend_ == Backend::Uring) {
+        wait_uring_(ready);
+    } else {
+        wait_threads_(ready);
+    }
+
+    // Продолжения могут ставить новые операции: они уйдут следующим wait()
+    pending_ -= ready.size();
+    for (auto* completion : ready) {
+        completion->handle.resume();
+    }
+    return ready.size();
+}
+
+void IoReactor::wait_uring_(std::vector<Completion*>& ready) {
+#ifdef __linux__
+    auto& ring = ring_->ring;
+    // Нулевой user_data — чтение eventfd: завершения offload() из пула
+    auto arm_event = [&](io_uring_sqe* sqe) {
+        io_uring_prep_read(sqe, event_fd_, &event_value_, sizeof(event_value_), 0);
+        io_uring_sqe_set_data(sqe, nullptr);
+    };
+    auto get_sqe = [&]() -> io_uring_sqe* {
+        io_uring_sqe* sqe = io_uring_get_sqe(&ring);
+        if (!sqe) {
+            // Очередь отправки полна — отдаём ядру то, что уже в ней
+            infra::sys::note(infra::sys::Syscall::UringEnter, io_uring_submit(&ring) < 0);
+            sqe = io_uring_get_sqe(&ring);
+        }
+        return sqe;
+    };
+
+    if (!event_armed_) {
+        if (auto* sqe = get_sqe()) {
+            arm_event(sqe);
+            event_armed_ = true;
+        }
+    }
+
+    std::size_t queued = 0;
+    for (; queued < backlog_.size(); ++queued) {
+        Op& op = *backlog_[queued];
+        io_uring_sqe* sqe = get_sqe();
+        if (!sqe) break;
+        switch (op.kind_) {
+        case Op::Kind::Open:
+            io_uring_prep_openat(sqe, AT_FDCWD, op.path_, op.flags_, op.mode_);
+            break;
+        case Op::Kind::Read:
+            io_uring_prep_read(sqe, op.fd_, op.data_, static_cast<unsigned>(op.length_), op.offset_);
+            break;
+        case Op::Kind::Write:
+            io_uring_prep_write(sqe, op.fd_, op.data_, static_cast<unsigned>(op.length_), op.offset_);
+            break;
+        case Op::Kind::Close:
+            io_uring_prep_close(sqe, op.fd_);
+            break;
+        case Op::Kind::Unlink:
+            io_uring_prep_unlinkat(sqe, AT_FDCWD, op.path_, 0);
+            break;
+        case Op::Kind::Sleep:
+            static_assert(sizeof(op.timeout_) == sizeof(__kernel_timespec));
+            io_uring_prep_timeout(sqe, reinterpret_cast<__kernel_timespec*>(&op.timeout_), 0, 0);
+            break;
+        }
+        io_uring_sqe_set_data(sqe, &op);
+    }
+    backlog_.erase(backlog_.begin(), backlog_.begin() + static_cast<std::ptrdiff_t>(queued));
+
+    for (;;) {
+        const int rc = io_uring_submit_and_wait(&ring, 1);
+        infra::sys::note(infra::sys::Syscall::UringEnter, rc < 0);
+        if (rc >= 0 || (rc != -EINTR && rc != -EAGAIN && rc != -EBUSY)) break;
+    }
+
+    io_uring_cqe* cqe = nullptr;
+    while (io_uring_peek_cqe(&ring, &cqe) == 0 && cqe) {
+        auto* op = static_cast<Op*>(io_uring_cqe_get_data(cqe));
+        if (op) {
+            // Истёкшая пауза завершается с -ETIME — для неё это успех
+            op->result = op->kind_ == Op::Kind::Sleep && cqe->res == -ETIME ? 0 : cqe->res;
+            ready.push_back(op);
+        } else {
+            event_armed_ = false;  // перевзвести при следующем wait()
+            take_posted_(ready);
+        }
+        io_uring_cqe_seen(&ring, cqe);
+    }
+#else
+    (void)ready;
+#endif
+}
+
+void IoReactor::wait_threads_(std::vector<Completion*>& ready) {
+    using Clock = std::chrono::steady_clock;
+#ifdef __linux__
+    int timeout_ms = -1;
+    if (!timers_.empty()) {
+        const auto left = std::chrono::ceil<std::chrono::milliseconds>(timers_.top().first - Clock::now());
+        timeout_ms = static_cast<int>(std::clamp<std::chrono::milliseconds::rep>(left.count(), 0, INT32_MAX));
+    }
+    epoll_event event{};
+    while (::epoll_wait(epoll_fd_, &event, 1, timeout_ms) < 0 && errno == EINTR) {}
+    std::uint64_t count = 0;
+    (void)!::read(event_fd_, &count, sizeof(count));
+#endif
+    take_posted_(ready);
+    for (const auto now = Clock::now(); !timers_.empty() && timers_.top().first <= now; timers_.pop()) {
+        timers_.top().second->result = 0;
+        ready.push_back(timers_.top().second);
+    }
+}
+
+} // namespace cclone::adapters::fs
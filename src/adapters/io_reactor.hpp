@@ -0,0 +1,180 @@
+#pragma once
+
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "infra/error_handler/error.hpp"
+#include "infra/thread_pool/work_stealing_pool.hpp"
+
+namespace cclone::adapters::fs {
+
+// Реактор ввода-вывода для сопрограмм: одна нить ведёт тысячи файлов,
+// каждая сопрограмма приостанавливается на co_await операции и
+// продолжается в wait() той же нити, когда операция завершилась.
+//
+//   * Uring — операции уходят в кольцо io_uring пачками, ожидание
+//     завершений — один системный вызов на пачку;
+//   * Threads — без io_uring (старое ядро, seccomp, не Linux): операции
+//     выполняет пул блокирующих потоков, о завершении реактор узнаёт
+//     через eventfd в epoll.
+//
+// offload() в обоих случаях выполняет в пуле произвольный блокирующий
+// код — fsync, верификацию, всё, у чего нет асинхронного аналога.
+//
+// Реактор однопоточный: create(), операции и wait() — из одной нити.
+class IoReactor {
+public:
+    enum class Backend { Uring, Threads };
+
+    // Результат завершённой операции и кого продолжить
+    struct Completion {
+        std::coroutine_handle<> handle;
+        int result = 0;
+    };
+
+    // co_await-операция; результат — как у системного вызова: >= 0 или -errno
+    class Op : public Completion {
+    public:
+        enum class Kind { Open, Read, Write, Close, Unlink, Sleep };
+
+        auto await_ready() const noexcept -> bool { return false; }
+        void await_suspend(std::coroutine_handle<> handle) {
+            this->handle = handle;
+            reactor_->submit_(*this);
+        }
+        auto await_resume() const noexcept -> int { return result; }
+
+    private:
+        friend class IoReactor;
+        Op(IoReactor* reactor, Kind kind) : reactor_(reactor), kind_(kind) {}
+
+        IoReactor* reactor_;
+        Kind kind_;
+        int fd_ = -1;
+        const char* path_ = nullptr;
+        void* data_ = nullptr;
+        std::size_t length_ = 0;
+        std::uint64_t offset_ = 0;
+        int flags_ = 0;
+        unsigned mode_ = 0;
+        struct { std::int64_t sec = 0, nsec = 0; } timeout_;  // раскладка __kernel_timespec
+    };
+
+    template<typename F>
+    class Offload : public Completion {
+    public:
+        using Result = std::invoke_result_t<F&>;
+        static_assert(!std::is_void_v<Result>, "offload() returns the function's result");
+
+        auto await_ready() const noexcept -> bool { return false; }
+        void await_suspend(std::coroutine_handle<> handle) {
+            this->handle = handle;
+            reactor_->offload_(*this, [this] {
+                try {
+                    value_.emplace(fn_());
+                } catch (...) {
+                    error_ = std::current_exception();
+                }
+            });
+        }
+        auto await_resume() -> Result {
+            if (error_) std::rethrow_exception(error_);
+            return std::move(*value_);
+        }
+
+    private:
+        friend class IoReactor;
+        Offload(IoReactor* reactor, F fn) : reactor_(reactor), fn_(std::move(fn)) {}
+
+        IoReactor* reactor_;
+        F fn_;
+        std::optional<Result> value_;
+        std::exception_ptr error_;
+    };
+
+    // entries — сколько операций кольца может быть в полёте одновременно.
+    // blocking — пул для offload() и для всех операций бэкенда Threads.
+    // allow_uring = false сразу выбирает Threads (тесты, диагностика)
+    [[nodiscard]] static auto create(unsigned entries, infra::WorkStealingPool& blocking,
+                                     bool allow_uring = true)
+        -> std::expected<std::unique_ptr<IoReactor>, infra::Error>;
+
+    ~IoReactor();
+    IoReactor(const IoReactor&) = delete;
+    IoReactor& operator=(const IoReactor&) = delete;
+
+    [[nodiscard]] auto backend() const -> Backend { return backend_; }
+
+    // path и буфер должны жить до завершения операции — на кадре
+    // ожидающей сопрограммы так и есть
+    [[nodiscard]] auto open(const char* path, int flags, unsigned mode = 0) -> Op;
+    [[nodiscard]] auto read(int fd, void* buffer, std::size_t length, std::uint64_t offset) -> Op;
+    [[nodiscard]] auto write(int fd, const void* buffer, std::size_t length, std::uint64_t offset) -> Op;
+    [[nodiscard]] auto close(int fd) -> Op;
+    [[nodiscard]] auto unlink(const char* path) -> Op;
+    // Пауза без блокировки нити (--bwlimit); результат 0
+    [[nodiscard]] auto sleep(std::chrono::nanoseconds duration) -> Op;
+
+    template<typename F>
+    [[nodiscard]] auto offload(F fn) -> Offload<F> { return Offload<F>(this, std::move(fn)); }
+
+    // Операции в полёте (включая offload)
+    [[nodiscard]] auto pending() const -> std::size_t { return pending_; }
+
+    // Отправляет накопленные операции, ждёт хотя бы одного завершения и
+    // продолжает дождавшиеся сопрограммы. Возвращает, сколько продолжено.
+    // Без операций в полёте не вызывать — ждать будет нечего
+    auto wait() -> std::size_t;
+
+private:
+    struct Ring;
+
+    IoReactor(Backend backend, infra::WorkStealingPool& blocking);
+
+    void submit_(Op& op);
+    template<typename Job>
+    void offload_(Completion& completion, Job job);
+    // Завершение из потока пула: в очередь реактора и разбудить его
+    void post_(Completion* completion);
+    static auto perform_(const Op& op) -> int;
+    void wait_uring_(std::vector<Completion*>& ready);
+    void wait_threads_(std::vector<Completion*>& ready);
+    void take_posted_(std::vector<Completion*>& ready);
+
+    Backend backend_;
+    infra::WorkStealingPool& blocking_;
+    std::unique_ptr<Ring> ring_;
+    int event_fd_ = -1;
+    int epoll_fd_ = -1;
+    std::uint64_t event_value_ = 0;  // приёмник чтения eventfd через кольцо
+    bool event_armed_ = false;
+    std::size_t pending_ = 0;
+    std::vector<Op*> backlog_;       // не влезли в кольцо до следующего wait()
+    // Паузы бэкенда Threads: срок ожидания epoll — ближайшая из них
+    using Timer = std::pair<std::chrono::steady_clock::time_point, Op*>;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<>> timers_;
+
+    std::mutex posted_mutex_;
+    std::vector<Completion*> posted_;
+};
+
+template<typename Job>
+void IoReactor::offload_(Completion& completion, Job job) {
+    ++pending_;
+    blocking_.enqueue([this, &completion, job = std::move(job)]() mutable {
+        job();
+        post_(&completion);
+    });
+}
+
+} // namespace cclone::adapters::fs
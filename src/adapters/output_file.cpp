@@ -0,0 +1,172 @@
+#include "output_file.hpp"
+#include "infra/syscall/syscalls.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+#include <fmt/core.h>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <cstdio>
+#endif
+
+namespace cclone::adapters::fs {
+
+namespace {
+
+#ifndef _WIN32
+constexpr int TEMP_ATTEMPTS = 16;
+
+auto sys_error(std::string_view what, const std::filesystem::path& path, int err = errno) -> infra::Error {
+    const auto code = err == ENOSPC ? infra::ErrorCode::DiskFull
+                    : err == EACCES || err == EPERM ? infra::ErrorCode::PermissionDenied
+                    : infra::ErrorCode::Unknown;
+    return infra::make_error(code, fmt::format("{} {}: {}", what, path.string(), std::strerror(err)));
+}
+
+// Скрытое имя рядом с назначением: тот же каталог — та же ФС, rename атомарен
+auto temp_name(const std::filesystem::path& dst) -> std::filesystem::path {
+    static std::atomic<std::uint64_t> counter{0};
+    return dst.parent_path() / fmt::format(".{}.cclone-{}-{}", dst.filename().string(), ::getpid(),
+                                           counter.fetch_add(1, std::memory_order_relaxed));
+}
+
+auto directory_of(const std::filesystem::path& dst) -> std::filesystem::path {
+    return dst.has_parent_path() ? dst.parent_path() : std::filesystem::path(".");
+}
+
+#ifdef O_TMPFILE
+// Даёт имя файлу из O_TMPFILE. Через /proc права не нужны; без /proc
+// остаётся AT_EMPTY_PATH (требует CAP_DAC_READ_SEARCH)
+auto link_anonymous(int fd, const std::filesystem::path& target) -> int {
+    char proc_path[64];
+    std::snprintf(proc_path, sizeof(proc_path), "/proc/self/fd/%d", fd);
+    if (infra::sys::linkat(AT_FDCWD, proc_path, AT_FDCWD, target.c_str(), AT_SYMLINK_FOLLOW) == 0) return 0;
+    if (errno != ENOENT) return -1;
+    return infra::sys::linkat(fd, "", AT_FDCWD, target.c_str(), AT_EMPTY_PATH);
+}
+#endif
+#endif
+
+} // namespace
+
+auto OutputFile::open(const std::filesystem::path& dst, Publish publish, int extra_flags)
+    -> std::expected<OutputFile, infra::Error>
+{
+#ifndef _WIN32
+    OutputFile out;
+    out.dst_ = dst;
+
+    if (publish == Publish::InPlace) {
+        out.fd_ = infra::sys::open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | extra_flags, 0644);
+        if (out.fd_ == -1) {
+            return std::unexpected(sys_error("Cannot create", dst));
+        }
+        return out;
+    }
+
+    out.pending_ = true;
+#ifdef O_TMPFILE
+    out.fd_ = infra::sys::open(directory_of(dst).c_str(), O_TMPFILE | O_WRONLY | O_CLOEXEC | extra_flags, 0644);
+    if (out.fd_ != -1) {
+        out.anonymous_ = true;
+        return out;
+    }
+    // EOPNOTSUPP/EISDIR/EINVAL: ФС или ядро без O_TMPFILE — именованный файл
+#endif
+    for (int attempt = 0; attempt < TEMP_ATTEMPTS; ++attempt) {
+        out.temp_ = temp_name(dst);
+        out.fd_ = infra::sys::open(out.temp_.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC | extra_flags, 0644);
+        if (out.fd_ != -1) return out;
+        if (errno != EEXIST) break;
+    }
+    const int err = errno;
+    out.temp_.clear();
+    return std::unexpected(sys_error("Cannot create temporary file for", dst, err));
+#else
+    (void)dst; (void)publish; (void)extra_flags;
+    return std::unexpected(infra::make_error(infra::ErrorCode::UnsupportedFeature,
+                           "OutputFile requires POSIX descriptors"));
+#endif
+}
+
+OutputFile::OutputFile(OutputFile&& other) noexcept
+    : dst_(std::move(other.dst_))
+    , temp_(std::move(other.temp_))
+    , fd_(std::exchange(other.fd_, -1))
+    , anonymous_(other.anonymous_)
+    , pending_(std::exchange(other.pending_, false))
+{}
+
+OutputFile& OutputFile::operator=(OutputFile&& other) noexcept {
+    if (this != &other) {
+        reset_();
+        dst_ = std::move(other.dst_);
+        temp_ = std::move(other.temp_);
+        fd_ = std::exchange(other.fd_, -1);
+        anonymous_ = other.anonymous_;
+        pending_ = std::exchange(other.pending_, false);
+    }
+    return *this;
+}
+
+OutputFile::~OutputFile() {
+    reset_();
+}
+
+void OutputFile::reset_() noexcept {
+#ifndef _WIN32
+    if (fd_ != -1) infra::sys::close(fd_);
+    // Безымянный файл исчезает сам, именованный — убираем
+    if (pending_ && !temp_.empty()) infra::sys::unlink(temp_.c_str());
+#endif
+    fd_ = -1;
+    pending_ = false;
+}
+
+auto OutputFile::publish() -> std::expected<void, infra::Error> {
+#ifndef _WIN32
+    if (!pending_) return {};
+
+#ifdef O_TMPFILE
+    if (anonymous_) {
+        // Новый файл: имя появляется сразу готовым
+        if (link_anonymous(fd_, dst_) == 0) {
+            pending_ = false;
+            return {};
+        }
+        if (errno != EEXIST) {
+            return std::unexpected(sys_error("Cannot link", dst_));
+        }
+
+        // Замена: linkat не перезаписывает, поэтому через скрытое имя и rename
+        for (int attempt = 0; attempt < TEMP_ATTEMPTS; ++attempt) {
+            temp_ = temp_name(dst_);
+            if (link_anonymous(fd_, temp_) == 0) break;
+            const int err = errno;
+            temp_.clear();
+            if (err != EEXIST) {
+                return std::unexpected(sys_error("Cannot link temporary file for", dst_, err));
+            }
+        }
+        if (temp_.empty()) {
+            return std::unexpected(sys_error("Cannot link temporary file for", dst_, EEXIST));
+        }
+    }
+#endif
+
+    // rename поверх, а не RENAME_EXCHANGE: обмен оставил бы старый файл
+    // под временным именем и потребовал бы ещё одного unlink
+    if (infra::sys::rename(temp_.c_str(), dst_.c_str()) != 0) {
+        return std::unexpected(sys_error("Cannot replace", dst_));
+    }
+    pending_ = false;
+    return {};
+#else
+    return {};
+#endif
+}
+
+} // namespace cclone::adapters::fs
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <filesystem>
+#include <expected>
+#include "infra/error_handler/error.hpp"
+
+namespace cclone::adapters::fs {
+
+// Как файл назначения появляется под своим именем
+enum class Publish {
+    InPlace, // open(O_TRUNC) поверх существующего: читатели видят недописанный файл
+    Atomic   // запись в безымянный файл каталога, имя появляется готовым (--atomic)
+};
+
+// Файл назначения, открытый на запись.
+//
+// Atomic: O_TMPFILE в каталоге назначения (Linux), иначе скрытое имя
+// ".<имя>.cclone-<pid>-<n>". publish() даёт файлу имя: linkat, если
+// назначения ещё нет, иначе linkat во временное имя и rename поверх —
+// старый файл заменяется одной операцией, без unlink+create, и до этого
+// момента читатели видят прежнее содержимое целиком.
+// Неопубликованный файл исчезает при разрушении объекта.
+class OutputFile {
+public:
+    // extra_flags — дополнительные флаги open(2), например O_DIRECT
+    static auto open(const std::filesystem::path& dst, Publish publish, int extra_flags = 0)
+        -> std::expected<OutputFile, infra::Error>;
+
+    OutputFile(OutputFile&& other) noexcept;
+    OutputFile& operator=(OutputFile&& other) noexcept;
+    OutputFile(const OutputFile&) = delete;
+    OutputFile& operator=(const OutputFile&) = delete;
+    ~OutputFile();
+
+    [[nodiscard]] auto fd() const -> int { return fd_; }
+
+    // Для InPlace ничего не делает
+    [[nodiscard]] auto publish() -> std::expected<void, infra::Error>;
+
+private:
+    OutputFile() = default;
+    void reset_() noexcept;
+
+    std::filesystem::path dst_;
+    std::filesystem::path temp_;  // именованный временный файл (без O_TMPFILE)
+    int fd_ = -1;
+    bool anonymous_ = false;      // O_TMPFILE
+    bool pending_ = false;        // Atomic и ещё не опубликован
+};
+
+} // namespace cclone::adapters::fs
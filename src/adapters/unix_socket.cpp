@@ -0,0 +1,235 @@
+#include "unix_socket.hpp"
+#include <cerrno>
+#include <cstring>
+#include <utility>
+#include <fmt/core.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace cclone::adapters::ipc {
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;  // закрытый собеседник — ошибка, а не SIGPIPE
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+auto socket_error(std::string_view what, const std::filesystem::path& path, int err = errno) -> infra::Error {
+    const auto code = err == ENOENT || err == ECONNREFUSED ? infra::ErrorCode::FileNotFound
+                    : err == EACCES || err == EPERM        ? infra::ErrorCode::PermissionDenied
+                                                           : infra::ErrorCode::Unknown;
+    return infra::make_error(code, fmt::format("{} {}: {}", what, path.string(), std::strerror(err)));
+}
+
+auto make_address(const std::filesystem::path& path) -> std::expected<sockaddr_un, infra::Error> {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    const auto& native = path.native();
+    if (native.empty() || native.size() >= sizeof(address.sun_path)) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::InvalidPath,
+                               fmt::format("Socket path is empty or longer than {} bytes: {}",
+                                           sizeof(address.sun_path) - 1, path.string())));
+    }
+    std::memcpy(address.sun_path, native.c_str(), native.size() + 1);
+    return address;
+}
+
+auto open_socket() -> int {
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0) ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    return fd;
+}
+
+} // namespace
+
+// =============== UnixStream ===============
+
+auto UnixStream::connect(const std::filesystem::path& path) -> std::expected<UnixStream, infra::Error> {
+    auto address = make_address(path);
+    if (!address) return std::unexpected(std::move(address.error()));
+    const int fd = open_socket();
+    if (fd < 0) return std::unexpected(socket_error("Cannot create socket for", path));
+    UnixStream stream(fd);
+    while (::connect(fd, reinterpret_cast<const sockaddr*>(&*address), sizeof(*address)) != 0) {
+        if (errno != EINTR) return std::unexpected(socket_error("Cannot connect to", path));
+    }
+    return stream;
+}
+
+UnixStream::UnixStream(UnixStream&& other) noexcept
+    : fd_(std::exchange(other.fd_, -1))
+    , buffer_(std::move(other.buffer_))
+{}
+
+UnixStream& UnixStream::operator=(UnixStream&& other) noexcept {
+    if (this != &other) {
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = std::exchange(other.fd_, -1);
+        buffer_ = std::move(other.buffer_);
+    }
+    return *this;
+}
+
+UnixStream::~UnixStream() {
+    if (fd_ >= 0) ::close(fd_);
+}
+
+auto UnixStream::read_line() -> std::expected<std::optional<std::string>, infra::Error> {
+    std::size_t scanned = 0;
+    for (;;) {
+        if (const auto newline = buffer_.find('\n', scanned); newline != std::string::npos) {
+            std::string line = buffer_.substr(0, newline);
+            buffer_.erase(0, newline + 1);
+            return line;
+        }
+        scanned = buffer_.size();
+        if (buffer_.size() > MAX_LINE) {
+            return std::unexpected(infra::make_error(infra::ErrorCode::InvalidPath,
+                                   fmt::format("Message longer than {} bytes", MAX_LINE)));
+        }
+
+        char chunk[4096];
+        const ssize_t got = ::recv(fd_, chunk, sizeof(chunk), 0);
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                                   fmt::format("Socket read failed: {}", std::strerror(errno))));
+        }
+        if (got == 0) return std::nullopt;  // недописанная строка без '\n' отбрасывается
+        buffer_.append(chunk, static_cast<std::size_t>(got));
+    }
+}
+
+auto UnixStream::write_line(std::string_view line) -> std::expected<void, infra::Error> {
+    std::string message;
+    message.reserve(line.size() + 1);
+    message.append(line);
+    message.push_back('\n');
+
+    std::size_t sent = 0;
+    while (sent < message.size()) {
+        const ssize_t n = ::send(fd_, message.data() + sent, message.size() - sent, SEND_FLAGS);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                                   fmt::format("Socket write failed: {}", std::strerror(errno))));
+        }
+        sent += static_cast<std::size_t>(n);
+    }
+    return {};
+}
+
+void UnixStream::shutdown() noexcept {
+    if (fd_ >= 0) ::shutdown(fd_, SHUT_RDWR);
+}
+
+auto UnixStream::peer_uid() const -> std::expected<uid_t, infra::Error> {
+#ifdef SO_PEERCRED
+    ucred credentials{};
+    socklen_t length = sizeof(credentials);
+    if (::getsockopt(fd_, SOL_SOCKET, SO_PEERCRED, &credentials, &length) != 0) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                               fmt::format("Cannot get socket peer: {}", std::strerror(errno))));
+    }
+    return credentials.uid;
+#else
+    uid_t uid = 0;
+    gid_t gid = 0;
+    if (::getpeereid(fd_, &uid, &gid) != 0) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                               fmt::format("Cannot get socket peer: {}", std::strerror(errno))));
+    }
+    return uid;
+#endif
+}
+
+// =============== UnixListener ===============
+
+auto UnixListener::bind(const std::filesystem::path& path) -> std::expected<UnixListener, infra::Error> {
+    auto address = make_address(path);
+    if (!address) return std::unexpected(std::move(address.error()));
+
+    struct stat existing{};
+    if (::lstat(path.c_str(), &existing) == 0) {
+        // Удаляем только сокет: путь могли указать на чужой файл
+        if (!S_ISSOCK(existing.st_mode)) {
+            return std::unexpected(infra::make_error(infra::ErrorCode::FileLocked,
+                                   fmt::format("{} exists and is not a socket", path.string())));
+        }
+        if (UnixStream::connect(path)) {
+            return std::unexpected(infra::make_error(infra::ErrorCode::FileLocked,
+                                   fmt::format("Another daemon is listening on {}", path.string())));
+        }
+        // Сокет остался от завершившегося процесса
+        if (::unlink(path.c_str()) != 0) return std::unexpected(socket_error("Cannot remove stale socket", path));
+    }
+
+    const int fd = open_socket();
+    if (fd < 0) return std::unexpected(socket_error("Cannot create socket for", path));
+    UnixListener listener(fd, path);
+    // Задания копируют с правами демона: подключаться может только владелец
+    const auto mask = ::umask(0077);
+    const int bound = ::bind(fd, reinterpret_cast<const sockaddr*>(&*address), sizeof(*address));
+    const int bind_errno = errno;
+    ::umask(mask);
+    if (bound != 0) {
+        listener.path_.clear();  // чужой файл не удаляем
+        return std::unexpected(socket_error("Cannot bind", path, bind_errno));
+    }
+    if (::listen(fd, SOMAXCONN) != 0) return std::unexpected(socket_error("Cannot listen on", path));
+    return listener;
+}
+
+UnixListener::UnixListener(UnixListener&& other) noexcept
+    : fd_(std::exchange(other.fd_, -1))
+    , path_(std::exchange(other.path_, {}))
+{}
+
+UnixListener& UnixListener::operator=(UnixListener&& other) noexcept {
+    if (this != &other) {
+        reset_();
+        fd_ = std::exchange(other.fd_, -1);
+        path_ = std::exchange(other.path_, {});
+    }
+    return *this;
+}
+
+UnixListener::~UnixListener() {
+    reset_();
+}
+
+void UnixListener::reset_() noexcept {
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+    if (!path_.empty()) ::unlink(path_.c_str());
+    path_.clear();
+}
+
+auto UnixListener::accept(std::chrono::milliseconds timeout)
+    -> std::expected<std::optional<UnixStream>, infra::Error>
+{
+    pollfd ready{.fd = fd_, .events = POLLIN, .revents = 0};
+    const int polled = ::poll(&ready, 1, static_cast<int>(timeout.count()));
+    if (polled < 0 && errno != EINTR) {
+        return std::unexpected(socket_error("poll failed on", path_));
+    }
+    if (polled <= 0) return std::nullopt;
+
+    const int fd = ::accept(fd_, nullptr, nullptr);
+    if (fd < 0) {
+        // Клиент успел отключиться или пришёл сигнал — подождём следующего
+        if (errno == EINTR || errno == ECONNABORTED || errno == EAGAIN) return std::nullopt;
+        return std::unexpected(socket_error("accept failed on", path_));
+    }
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    return UnixStream(fd);
+}
+
+} // namespace cclone::adapters::ipc
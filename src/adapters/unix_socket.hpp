@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include "infra/error_handler/error.hpp"
+
+#include <sys/types.h>
+
+namespace cclone::adapters::ipc {
+
+// Соединение через локальный сокет (AF_UNIX, SOCK_STREAM), обмен
+// строками: одно сообщение — одна строка, без '\n' внутри
+class UnixStream {
+public:
+    static auto connect(const std::filesystem::path& path) -> std::expected<UnixStream, infra::Error>;
+
+    UnixStream(UnixStream&& other) noexcept;
+    UnixStream& operator=(UnixStream&& other) noexcept;
+    UnixStream(const UnixStream&) = delete;
+    UnixStream& operator=(const UnixStream&) = delete;
+    ~UnixStream();
+
+    // Строка без '\n'; nullopt — собеседник закрыл соединение
+    [[nodiscard]] auto read_line() -> std::expected<std::optional<std::string>, infra::Error>;
+    [[nodiscard]] auto write_line(std::string_view line) -> std::expected<void, infra::Error>;
+
+    // Прерывает ждущий read_line из другого потока: тот увидит конец потока
+    void shutdown() noexcept;
+
+    // Пользователь процесса на другом конце (SO_PEERCRED): сокет в общем
+    // каталоге мог занять кто угодно
+    [[nodiscard]] auto peer_uid() const -> std::expected<uid_t, infra::Error>;
+
+    // Самая длинная строка, которую примет read_line
+    static constexpr std::size_t MAX_LINE = 1 << 20;
+
+private:
+    friend class UnixListener;
+    explicit UnixStream(int fd) : fd_(fd) {}
+
+    int fd_ = -1;
+    std::string buffer_;   // прочитанное после последней выданной строки
+};
+
+// Слушающий сокет. Файл сокета доступен только владельцу (0600) и
+// удаляется вместе с объектом
+class UnixListener {
+public:
+    // Устаревший файл сокета (никто не слушает) заменяется; если по пути
+    // уже отвечает другой процесс или лежит не сокет — ошибка
+    static auto bind(const std::filesystem::path& path) -> std::expected<UnixListener, infra::Error>;
+
+    UnixListener(UnixListener&& other) noexcept;
+    UnixListener& operator=(UnixListener&& other) noexcept;
+    UnixListener(const UnixListener&) = delete;
+    UnixListener& operator=(const UnixListener&) = delete;
+    ~UnixListener();
+
+    // nullopt — за timeout никто не подключился (или прервано сигналом)
+    [[nodiscard]] auto accept(std::chrono::milliseconds timeout)
+        -> std::expected<std::optional<UnixStream>, infra::Error>;
+
+    [[nodiscard]] auto path() const -> const std::filesystem::path& { return path_; }
+
+private:
+    UnixListener(int fd, std::filesystem::path path) : fd_(fd), path_(std::move(path)) {}
+    void reset_() noexcept;
+
+    int fd_ = -1;
+    std::filesystem::path path_;
+};
+
+} // namespace cclone::adapters::ipc
@@ -8,6 +8,11 @@
 namespace cclone::args_parser {
 
     std::optional<CLIArgs> parse_args(int argc, char const* const* argv)
+    {
+        return parse_args(argc, argv, std::cout, std::cerr);
+    }
+
+    std::optional<CLIArgs> parse_args(int argc, char const* const* argv, std::ostream& out, std::ostream& err)
     {
         CLI::App app{"FCopyRover ---- high-perfomance file copier tools"};
 
@@ -19,14 +24,14 @@ namespace cclone::args_parser {
             "-s, --sources",
             args.sources,
             "Source file(s) or directory (can be used multiple times)"
-        ) -> required();
+        );
 
         // Destination: supporting both -d and last positional argument
         app.add_option(
             "-d, --destination",
             args.destination,
             "Destination file or directory"
-        ) -> required();
+        );
 
         // Flags
 
@@ -43,10 +48,10 @@ namespace cclone::args_parser {
         );
 
         app.add_flag(
-            "--verify",
-            args.verify,
-            "Verify copied files"
-        );
+            "--verify{hash}",
+            args.verify_mode,
+            "Verify copied files: hash (XXH3, default) or compare (byte-by-byte, local paths)"
+        )->check(CLI::IsMember({"hash", "compare"}));
 
         app.add_flag(
             "--no-progress",
@@ -66,6 +71,66 @@ namespace cclone::args_parser {
             "Resume interrupted copy operations"
         );
 
+        app.add_flag(
+            "--incremental",
+            args.incremental,
+            "Skip files unchanged since the last sync (index kept in the destination root)"
+        );
+
+        app.add_flag(
+            "--delta",
+            args.delta,
+            "Rewrite only changed blocks of files that already exist in the destination"
+        );
+
+        app.add_flag(
+            "--delta-cache",
+            args.delta_cache,
+            "Cache destination block hashes so unchanged destinations are not re-read"
+        );
+
+        app.add_flag(
+            "-H, --hard-links",
+            args.hard_links,
+            "Preserve hard links: copy each multiply-linked inode once and link the rest"
+        );
+
+        app.add_flag(
+            "--atomic",
+            args.atomic,
+            "Write each file under a temporary name (O_TMPFILE) and publish it in one step"
+        );
+
+        app.add_flag(
+            "--dedup{reflink}",
+            args.dedup,
+            "Copy identical files once; duplicates become reflinks (default) or hardlinks"
+        )->check(CLI::IsMember({"reflink", "hardlink"}));
+
+        app.add_option(
+            "--durability",
+            args.durability,
+            "Sync copied data to stable storage: none, file (fdatasync each), batch (grouped, background), end (syncfs once)"
+        )->check(CLI::IsMember({"none", "file", "batch", "end"}));
+
+        app.add_option(
+            "--numa",
+            args.numa,
+            "Pin workers to NUMA nodes: off, spread (round-robin over nodes), device (nodes of source/destination controllers)"
+        )->check(CLI::IsMember({"off", "spread", "device"}));
+
+        app.add_option(
+            "--engine",
+            args.engine,
+            "Copy engine: threads (a worker per file in flight) or async (coroutines on io_uring, thousands of files per thread)"
+        )->check(CLI::IsMember({"threads", "async"}));
+
+        app.add_flag(
+            "--adaptive",
+            args.adaptive,
+            "Tune active workers (or files in flight) to the observed throughput; --threads becomes the upper bound"
+        );
+
         app.add_flag(
             "--no-preserve-metadata",
             args.preserve_metadata,
@@ -85,22 +150,178 @@ namespace cclone::args_parser {
             "I/O buffer size in bytes (e.g., 1048576 for 1MB)"
         );
 
+        app.add_option(
+            "--hash-segment-size",
+            args.hash_segment_size,
+            "Segment size in bytes for parallel tree hashing of large files (default: 64MB)"
+        );
+
+        app.add_option(
+            "--delta-block-size",
+            args.delta_block_size,
+            "Block size in bytes for --delta (default: 1MB)"
+        );
+
+        app.add_option(
+            "--max-memory",
+            args.max_memory,
+            "Limit for I/O buffers in flight, bytes or with a suffix (e.g., 256MB)"
+        )->transform(CLI::AsSizeValue(false));
+
+        app.add_option(
+            "--async-depth",
+            args.async_depth,
+            "Files in flight for --engine=async, across all reactor threads (default: 4096)"
+        )->check(CLI::PositiveNumber);
+
+        app.add_option(
+            "--latency-ceiling",
+            args.latency_ceiling,
+            "With --adaptive, back off when the average device operation takes longer than this many ms"
+        )->check(CLI::PositiveNumber);
+
+        app.add_option(
+            "--bwlimit",
+            args.bwlimit,
+            "Limit the job to this many bytes per second, or with a suffix (e.g., 50MB)"
+        )->transform(CLI::AsSizeValue(false));
+
+        app.add_option(
+            "--iops-limit",
+            args.iops_limit,
+            "Limit the job to this many read and write operations per second"
+        )->check(CLI::PositiveNumber);
+
+        app.add_option(
+            "--device-bwlimit",
+            args.device_bwlimit,
+            "Limit each source and destination device to this many bytes per second"
+        )->transform(CLI::AsSizeValue(false));
+
+        app.add_option(
+            "--device-iops-limit",
+            args.device_iops_limit,
+            "Limit each source and destination device to this many operations per second"
+        )->check(CLI::PositiveNumber);
+
+        app.add_option(
+            "--throttle-file",
+            args.throttle_file,
+            "Control file with limits (bwlimit = 20M ...), re-read when it changes or on SIGUSR1"
+        );
+
+        app.add_option(
+            "--metrics-prom",
+            args.metrics_prom,
+            "Export metrics to this file in Prometheus text format (for the node_exporter textfile collector)"
+        );
+
+        app.add_option(
+            "--metrics-json",
+            args.metrics_json,
+            "Append metrics as newline-delimited JSON to this file ('-' for stdout)"
+        );
+
+        app.add_option(
+            "--metrics-interval",
+            args.metrics_interval,
+            "Seconds between metrics exports (default: 10)"
+        )->check(CLI::PositiveNumber);
+
+        app.add_option(
+            "--trace",
+            args.trace,
+            "Record per-phase spans to this file in Chrome trace-event JSON (chrome://tracing, Perfetto)"
+        );
+
+        app.add_option(
+            "--trace-top",
+            args.trace_top,
+            "Slowest files to list in the trace summary (default: 10)"
+        );
+
+        app.add_option(
+            "--manifest",
+            args.manifest,
+            "Write a binary manifest (path, size, mtime, XXH3) of copied files"
+        );
+
+        app.add_option(
+            "--check-manifest",
+            args.check_manifest,
+            "Re-verify the destination against a manifest without reading sources"
+        );
+
+        app.add_option(
+            "--dump-manifest",
+            args.dump_manifest,
+            "Print a manifest as text and exit"
+        );
+
+        app.add_flag(
+            "--daemon",
+            args.daemon,
+            "Run as a daemon: accept copy jobs on a Unix socket and run them on shared warm workers"
+        );
+
+        app.add_option(
+            "--daemon-jobs",
+            args.daemon_jobs,
+            "With --daemon, jobs running at once; the rest wait in the queue (default: 4)"
+        )->check(CLI::PositiveNumber);
+
+        app.add_option(
+            "--socket",
+            args.socket,
+            "Daemon socket (default: $XDG_RUNTIME_DIR/fcopyrover.sock or /tmp/fcopyrover-<uid>.sock)"
+        );
+
+        app.add_flag(
+            "--no-daemon",
+            args.no_daemon,
+            "Copy in this process even if a daemon is listening"
+        );
+
+        app.add_flag(
+            "--jobs",
+            args.list_jobs,
+            "List the daemon's jobs and exit"
+        );
+
+        app.add_option(
+            "--cancel",
+            args.cancel,
+            "Cancel a daemon job and exit"
+        );
 
         /// Help flag is auto-generated by CLI11
         try {
             app.parse(argc, argv);
         } catch (const CLI::CallForHelp&) {
-            std::cout << app.help() << "\n";
+            out << app.help() << "\n";
             return std::nullopt; // Завершить
         } catch (const CLI::ParseError& e) {
-            std::cerr << "Error: " << e.what() << "\n\n";
-            std::cerr << app.help() << "\n";
+            err << "Error: " << e.what() << "\n\n";
+            err << app.help() << "\n";
             return std::nullopt; // Завершить с ошибкой
         }
 
+        /// Validation: sources/destination нужны не во всех режимах
+        const bool needs_destination = args.dump_manifest.empty() && !args.daemon && !args.list_jobs
+                                    && !args.cancel;
+        const bool needs_sources = needs_destination && args.check_manifest.empty();
+        if ((needs_sources && args.sources.empty()) || (needs_destination && args.destination.empty())) {
+            err << "Error: --sources and --destination are required\n\n";
+            err << app.help() << "\n";
+            return std::nullopt;
+        }
+
         /// Postprocessing: invert progress flag
         args.progress = !args.progress;
         
+        /// Postprocessing: --verify без значения означает --verify=hash
+        args.verify = !args.verify_mode.empty();
+
         /// Postprocessing: invert preserve_metadata flag
         args.preserve_metadata = !args.preserve_metadata;
 
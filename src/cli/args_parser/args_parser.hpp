@@ -4,6 +4,7 @@
 #include <vector>
 #include <cstdint>
 #include <optional>
+#include <ostream>
 
 
 
@@ -15,12 +16,47 @@ namespace cclone::args_parser {
     bool recursive{false};                  // -r, --recursive
     bool follow_symlinks{false};            // --follow-symlinks
     bool verify{false};                     // --verify
+    std::string verify_mode;                // --verify[=hash|compare]
     bool progress{false};                   // --progress
     bool quiet{false};                      // -q, --quiet
     bool resume{false};                     // --resume
-    bool preserve_metadata{true};           // --preserve-metadata / --no-preserve-metadata
+    bool incremental{false};                // --incremental
+    bool delta{false};                      // --delta
+    bool delta_cache{false};                // --delta-cache
+    std::string dedup;                      // --dedup[=reflink|hardlink]
+    bool hard_links{false};                 // -H, --hard-links
+    bool atomic{false};                     // --atomic
+    std::string durability{"none"};         // --durability=none|file|batch|end
+    std::string numa{"off"};                // --numa=off|spread|device
+    std::string engine{"threads"};          // --engine=threads|async
+    bool adaptive{false};                   // --adaptive
+    bool preserve_metadata{false};          // --no-preserve-metadata (инвертируется после разбора)
     std::optional<std::uint32_t> threads;   // --threads=N
     std::optional<std::size_t> buffer_size; // --buffer-size=SIZE
+    std::optional<std::uint64_t> hash_segment_size; // --hash-segment-size=SIZE
+    std::optional<std::uint64_t> delta_block_size;  // --delta-block-size=SIZE
+    std::optional<std::uint64_t> max_memory;        // --max-memory=SIZE
+    std::optional<std::uint32_t> async_depth;       // --async-depth=N
+    std::optional<std::uint32_t> latency_ceiling;   // --latency-ceiling=MS
+    std::optional<std::uint64_t> bwlimit;           // --bwlimit=RATE
+    std::optional<std::uint64_t> iops_limit;        // --iops-limit=N
+    std::optional<std::uint64_t> device_bwlimit;    // --device-bwlimit=RATE
+    std::optional<std::uint64_t> device_iops_limit; // --device-iops-limit=N
+    std::string throttle_file;              // --throttle-file=FILE
+    std::string metrics_prom;               // --metrics-prom=FILE
+    std::string metrics_json;               // --metrics-json=FILE
+    std::optional<double> metrics_interval; // --metrics-interval=SECONDS
+    std::string trace;                      // --trace=FILE
+    std::optional<std::uint32_t> trace_top; // --trace-top=N
+    std::string manifest;                   // --manifest=FILE
+    std::string check_manifest;             // --check-manifest=FILE
+    std::string dump_manifest;              // --dump-manifest=FILE
+    bool daemon{false};                     // --daemon
+    std::optional<std::uint32_t> daemon_jobs; // --daemon-jobs=N
+    std::string socket;                     // --socket=PATH
+    bool no_daemon{false};                  // --no-daemon
+    bool list_jobs{false};                  // --jobs
+    std::optional<std::uint64_t> cancel;    // --cancel=JOB
     bool help{false};                       // -h, --help (autogeneration CLI11)
 };
 
@@ -29,6 +65,10 @@ namespace cclone::args_parser {
 /// Parses command-line arguments and returns a CLIArgs struct.
 std::optional<CLIArgs> parse_args(int argc, char const* const* argv);
 
+/// То же, но справка и ошибки разбора уходят в out/err, а не в консоль
+/// (демон возвращает их клиенту)
+std::optional<CLIArgs> parse_args(int argc, char const* const* argv, std::ostream& out, std::ostream& err);
+
 } // namespace cclone::args_parser
 
 using __CLI = cclone::args_parser::CLIArgs;
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include "client.hpp"
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+#include <yaml-cpp/yaml.h>
+#include "infra/interrupt.hpp"
+#include "infra/json.hpp"
+
+#include <unistd.h>
+
+namespace cclone::daemon {
+
+namespace {
+
+// Как часто клиент спрашивает о ходе задания
+constexpr std::chrono::milliseconds POLL_INTERVAL{200};
+
+auto protocol_error(std::string_view message) -> infra::Error {
+    return infra::make_error(infra::ErrorCode::Unknown, fmt::format("Daemon protocol error: {}", message));
+}
+
+// Ответ демона; {"ok":false} становится ошибкой с его текстом
+auto parse_response(const std::string& line) -> std::expected<YAML::Node, infra::Error> {
+    try {
+        auto response = YAML::Load(line);
+        if (!response.IsMap() || !response["ok"]) return std::unexpected(protocol_error(line));
+        if (!response["ok"].as<bool>()) {
+            return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                                   response["error"] ? response["error"].as<std::string>() : "Daemon error"));
+        }
+        return response;
+    } catch (const YAML::Exception& e) {
+        return std::unexpected(protocol_error(e.what()));
+    }
+}
+
+auto parse_status(const YAML::Node& node) -> core::JobStatus {
+    core::JobStatus status{
+        .id = node["id"].as<core::JobId>(),
+        .state = core::parse_job_state(node["state"].as<std::string>()).value_or(core::JobState::Failed),
+        .destination = node["destination"].as<std::string>(),
+        .files_total = node["files_total"].as<std::uint64_t>(),
+        .files_done = node["files_done"].as<std::uint64_t>(),
+        .bytes_total = node["bytes_total"].as<std::uint64_t>(),
+        .bytes_done = node["bytes_done"].as<std::uint64_t>(),
+        .elapsed_s = node["elapsed_s"].as<double>(),
+        .message = node["message"].as<std::string>()
+    };
+    status.stats.files_copied = node["files_copied"].as<std::uint64_t>();
+    status.stats.bytes_copied = node["bytes_copied"].as<std::uint64_t>();
+    status.stats.bytes_written = node["bytes_written"].as<std::uint64_t>();
+    status.stats.files_skipped = node["files_skipped"].as<std::uint64_t>();
+    status.stats.errors = node["errors"].as<std::uint64_t>();
+    return status;
+}
+
+auto megabytes(std::uint64_t bytes) -> double {
+    return static_cast<double>(bytes) / 1024.0 / 1024.0;
+}
+
+} // namespace
+
+auto Client::connect(const std::filesystem::path& socket) -> std::expected<Client, infra::Error> {
+    auto stream = adapters::ipc::UnixStream::connect(socket);
+    if (!stream) return std::unexpected(std::move(stream.error()));
+    // Без XDG_RUNTIME_DIR сокет лежит в общем /tmp: задание с путями
+    // отдаём только демону того же пользователя
+    auto peer = stream->peer_uid();
+    if (!peer) return std::unexpected(std::move(peer.error()));
+    if (*peer != ::getuid()) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::PermissionDenied,
+                               fmt::format("{} is served by uid {}, not by this user", socket.string(), *peer)));
+    }
+    return Client(std::move(*stream));
+}
+
+auto Client::call_(const std::string& request) -> std::expected<std::string, infra::Error> {
+    if (auto sent = stream_.write_line(request); !sent) return std::unexpected(std::move(sent.error()));
+    auto line = stream_.read_line();
+    if (!line) return std::unexpected(std::move(line.error()));
+    if (!*line) return std::unexpected(infra::make_error(infra::ErrorCode::Unknown, "Daemon closed the connection"));
+    return std::move(**line);
+}
+
+auto Client::submit(const std::vector<std::string>& args, const std::filesystem::path& cwd,
+                    const std::string& config)
+    -> std::expected<core::JobId, infra::Error>
+{
+    std::string quoted;
+    for (const auto& arg : args) {
+        quoted += fmt::format(R"({}"{}")", quoted.empty() ? "" : ",", infra::json_escape(arg));
+    }
+    const auto config_field = config.empty() ? std::string{}
+                                             : fmt::format(R"(,"config":"{}")", infra::json_escape(config));
+    auto line = call_(fmt::format(R"({{"op":"submit","cwd":"{}","args":[{}]{}}})",
+                                  infra::json_escape(cwd.string()), quoted, config_field));
+    if (!line) return std::unexpected(std::move(line.error()));
+    auto response = parse_response(*line);
+    if (!response) return std::unexpected(std::move(response.error()));
+    try {
+        return (*response)["job"].as<core::JobId>();
+    } catch (const YAML::Exception& e) {
+        return std::unexpected(protocol_error(e.what()));
+    }
+}
+
+auto Client::status(core::JobId id) -> std::expected<core::JobStatus, infra::Error> {
+    auto line = call_(fmt::format(R"({{"op":"status","job":{}}})", id));
+    if (!line) return std::unexpected(std::move(line.error()));
+    auto response = parse_response(*line);
+    if (!response) return std::unexpected(std::move(response.error()));
+    try {
+        return parse_status((*response)["status"]);
+    } catch (const YAML::Exception& e) {
+        return std::unexpected(protocol_error(e.what()));
+    }
+}
+
+auto Client::list() -> std::expected<std::vector<core::JobStatus>, infra::Error> {
+    auto line = call_(R"({"op":"list"})");
+    if (!line) return std::unexpected(std::move(line.error()));
+    auto response = parse_response(*line);
+    if (!response) return std::unexpected(std::move(response.error()));
+    try {
+        std::vector<core::JobStatus> jobs;
+        for (const auto& node : (*response)["jobs"]) jobs.push_back(parse_status(node));
+        return jobs;
+    } catch (const YAML::Exception& e) {
+        return std::unexpected(protocol_error(e.what()));
+    }
+}
+
+auto Client::cancel(core::JobId id) -> std::expected<void, infra::Error> {
+    auto line = call_(fmt::format(R"({{"op":"cancel","job":{}}})", id));
+    if (!line) return std::unexpected(std::move(line.error()));
+    auto response = parse_response(*line);
+    if (!response) return std::unexpected(std::move(response.error()));
+    return {};
+}
+
+auto run_remote(Client& client, const std::vector<std::string>& args, const std::string& config,
+                bool progress, bool quiet) -> int {
+    std::error_code ec;
+    const auto cwd = std::filesystem::current_path(ec);
+    auto id = client.submit(args, cwd, config);
+    if (!id) {
+        spdlog::error("Daemon rejected the job: {}", id.error().message);
+        return 1;
+    }
+    if (!quiet) spdlog::info("Submitted to the daemon as job {}", *id);
+
+    const bool show_progress = progress && !quiet;
+    bool cancel_sent = false;
+    core::JobStatus status;
+    for (;;) {
+        auto current = client.status(*id);
+        if (!current) {
+            spdlog::error("Lost the daemon: {}", current.error().message);
+            return 1;
+        }
+        status = std::move(*current);
+        if (show_progress && status.files_total > 0) {
+            std::cout << fmt::format("\r[job {}] {}/{} files  {:.1f}/{:.1f} MB", status.id, status.files_done,
+                                     status.files_total, megabytes(status.bytes_done), megabytes(status.bytes_total))
+                      << std::flush;
+        }
+        if (status.finished()) break;
+        // Ctrl-C клиента отменяет его задание на демоне
+        if (infra::is_interrupted() && !cancel_sent) {
+            cancel_sent = true;
+            if (auto cancelled = client.cancel(*id); !cancelled) {
+                spdlog::warn("Cannot cancel job {}: {}", *id, cancelled.error().message);
+            }
+        }
+        std::this_thread::sleep_for(POLL_INTERVAL);
+    }
+    if (show_progress && status.files_total > 0) std::cout << "\n";
+
+    switch (status.state) {
+        case core::JobState::Cancelled:
+            spdlog::warn("Job {} cancelled", status.id);
+            return 130;
+        case core::JobState::Failed:
+            spdlog::error("Copy operation failed: {}", status.message);
+            return 1;
+        default:
+            break;
+    }
+    if (!quiet) {
+        spdlog::info("Files copied: {}", status.stats.files_copied);
+        spdlog::info("Bytes copied: {} ({:.2f} MB)", status.stats.bytes_copied, megabytes(status.stats.bytes_copied));
+        spdlog::info("Files skipped: {}", status.stats.files_skipped);
+        spdlog::info("Errors: {}", status.stats.errors);
+        spdlog::info("Time elapsed: {:.2f} seconds", status.elapsed_s);
+        if (status.stats.bytes_copied > 0 && status.elapsed_s > 0) {
+            spdlog::info("Average speed: {:.2f} MB/s", megabytes(status.stats.bytes_copied) / status.elapsed_s);
+        }
+    }
+    return status.stats.errors > 0 ? 1 : 0;
+}
+
+auto format_jobs(const std::vector<core::JobStatus>& jobs) -> std::vector<std::string> {
+    std::vector<std::string> lines;
+    lines.push_back(fmt::format("{:>6}  {:<9}  {:>17}  {:>19}  {:>9}  {}", "JOB", "STATE", "FILES", "MB",
+                                "ELAPSED", "DESTINATION"));
+    for (const auto& job : jobs) {
+        lines.push_back(fmt::format("{:>6}  {:<9}  {:>17}  {:>19}  {:>8.1f}s  {}", job.id,
+                                    core::job_state_name(job.state),
+                                    fmt::format("{}/{}", job.files_done, job.files_total),
+                                    fmt::format("{:.1f}/{:.1f}", megabytes(job.bytes_done), megabytes(job.bytes_total)),
+                                    job.elapsed_s, job.destination));
+    }
+    return lines;
+}
+
+} // namespace cclone::daemon
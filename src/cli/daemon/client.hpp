@@ -0,0 +1,47 @@
+#pragma once
+
+#include <expected>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "adapters/unix_socket.hpp"
+#include "core/daemon/job_manager.hpp"
+#include "infra/error_handler/error.hpp"
+
+namespace cclone::daemon {
+
+// Клиент демона (протокол — в daemon.hpp). Одно соединение, запросы по очереди
+class Client {
+public:
+    // FileNotFound — демон не запущен; PermissionDenied — сокет слушает
+    // процесс другого пользователя
+    static auto connect(const std::filesystem::path& socket) -> std::expected<Client, infra::Error>;
+
+    // config — текст конфигурационного файла клиента (пусто — файла нет)
+    [[nodiscard]] auto submit(const std::vector<std::string>& args, const std::filesystem::path& cwd,
+                              const std::string& config = {})
+        -> std::expected<core::JobId, infra::Error>;
+    [[nodiscard]] auto status(core::JobId id) -> std::expected<core::JobStatus, infra::Error>;
+    [[nodiscard]] auto list() -> std::expected<std::vector<core::JobStatus>, infra::Error>;
+    [[nodiscard]] auto cancel(core::JobId id) -> std::expected<void, infra::Error>;
+
+private:
+    explicit Client(adapters::ipc::UnixStream stream) : stream_(std::move(stream)) {}
+
+    // Отправляет запрос и возвращает строку ответа
+    [[nodiscard]] auto call_(const std::string& request) -> std::expected<std::string, infra::Error>;
+
+    adapters::ipc::UnixStream stream_;
+};
+
+// Копирование на демоне: ставит задание, показывает ход и ждёт конца.
+// config — текст конфигурационного файла клиента, демон накладывает его
+// под параметрами командной строки, как при локальном прогоне.
+// SIGINT отменяет задание. Код выхода — как у локального прогона
+[[nodiscard]] auto run_remote(Client& client, const std::vector<std::string>& args, const std::string& config,
+                              bool progress, bool quiet) -> int;
+
+// Таблица заданий демона (--jobs)
+[[nodiscard]] auto format_jobs(const std::vector<core::JobStatus>& jobs) -> std::vector<std::string>;
+
+} // namespace cclone::daemon
@@ -0,0 +1,210 @@
+#include "daemon.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+#include <yaml-cpp/yaml.h>
+#include "cli/args_parser/args_parser.hpp"
+#include "infra/interrupt.hpp"
+#include "infra/json.hpp"
+
+#include <unistd.h>
+
+namespace cclone::daemon {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// Как часто цикл приёма проверяет остановку
+constexpr std::chrono::milliseconds ACCEPT_POLL{200};
+
+auto error_json(std::string_view message) -> std::string {
+    return fmt::format(R"({{"ok":false,"error":"{}"}})", infra::json_escape(message));
+}
+
+auto submit(const YAML::Node& request, const infra::Config& base, core::JobManager& jobs) -> std::string {
+    if (!request["args"] || !request["args"].IsSequence() || !request["cwd"]) {
+        return error_json("submit needs args and cwd");
+    }
+    const auto args = request["args"].as<std::vector<std::string>>();
+    const auto config = request["config"] ? request["config"].as<std::string>() : std::string{};
+    auto spec = job_from_args(args, request["cwd"].as<std::string>(), base, config);
+    if (!spec) return error_json(spec.error().message);
+    auto id = jobs.submit(std::move(*spec));
+    if (!id) return error_json(id.error().message);
+    return fmt::format(R"({{"ok":true,"job":{}}})", *id);
+}
+
+} // namespace
+
+auto default_socket_path() -> fs::path {
+    if (const char* runtime = std::getenv("XDG_RUNTIME_DIR"); runtime && *runtime) {
+        return fs::path(runtime) / "fcopyrover.sock";
+    }
+    return fs::temp_directory_path() / fmt::format("fcopyrover-{}.sock", ::getuid());
+}
+
+auto status_json(const core::JobStatus& status) -> std::string {
+    return fmt::format(
+        R"({{"id":{},"state":"{}","destination":"{}","files_total":{},"files_done":{},"bytes_total":{},)"
+        R"("bytes_done":{},"elapsed_s":{:.3f},"files_copied":{},"bytes_copied":{},"bytes_written":{},)"
+        R"("files_skipped":{},"errors":{},"message":"{}"}})",
+        status.id, core::job_state_name(status.state), infra::json_escape(status.destination),
+        status.files_total, status.files_done, status.bytes_total, status.bytes_done, status.elapsed_s,
+        status.stats.files_copied, status.stats.bytes_copied, status.stats.bytes_written,
+        status.stats.files_skipped, status.stats.errors, infra::json_escape(status.message));
+}
+
+auto job_from_args(const std::vector<std::string>& args, const fs::path& cwd, const infra::Config& base,
+                   std::string_view client_config)
+    -> std::expected<core::JobSpec, infra::Error>
+{
+    if (!cwd.is_absolute()) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::InvalidPath,
+                               fmt::format("Client directory must be absolute: {}", cwd.string())));
+    }
+    std::vector<const char*> argv{"fcopyrover"};
+    for (const auto& arg : args) argv.push_back(arg.c_str());
+    std::ostringstream out;
+    std::ostringstream err;
+    auto parsed = args_parser::parse_args(static_cast<int>(argv.size()), argv.data(), out, err);
+    if (!parsed) {
+        // Клиенту — сама ошибка разбора, без следующей за ней справки
+        auto message = err.str();
+        message = message.empty() ? "--help is not available for daemon jobs"
+                                  : message.substr(0, message.find("\n\n"));
+        return std::unexpected(infra::make_error(infra::ErrorCode::InvalidPath, std::move(message)));
+    }
+    auto& cli = *parsed;
+    if (!cli.check_manifest.empty() || !cli.dump_manifest.empty() || cli.daemon || cli.list_jobs || cli.cancel) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::UnsupportedFeature,
+                               "The daemon runs copy jobs only"));
+    }
+
+    // Конфигурация клиента — как при локальном прогоне: его файл, поверх
+    // параметры командной строки
+    infra::Config client{};
+    if (!client_config.empty()) {
+        auto loaded = infra::load_config_from_yaml(client_config, "client config");
+        if (!loaded) return std::unexpected(infra::make_error(infra::ErrorCode::InvalidPath, loaded.error()));
+        client = std::move(*loaded);
+    }
+    client.merge_with(infra::config_from_cli(cli));
+
+    // Сессия трассировки одна на процесс и задания перемешали бы её,
+    // а stdout демона клиент не видит
+    if (!client.trace.empty() || client.trace_top) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::UnsupportedFeature,
+                               "--trace and --trace-top are not supported for daemon jobs"));
+    }
+    if (client.metrics_json == "-") {
+        return std::unexpected(infra::make_error(infra::ErrorCode::UnsupportedFeature,
+                               "--metrics-json - is not supported for daemon jobs, give a file"));
+    }
+
+    // Демон живёт в своём каталоге: пути клиента делаем абсолютными
+    const auto absolute = [&](std::string& path) {
+        if (!path.empty() && path != "-" && fs::path(path).is_relative()) path = (cwd / path).string();
+    };
+    for (auto& source : cli.sources) absolute(source);
+    absolute(cli.destination);
+    absolute(client.manifest);
+    absolute(client.throttle_file);
+    absolute(client.metrics_prom);
+    absolute(client.metrics_json);
+
+    core::JobSpec spec;
+    spec.config = base;
+    spec.config.merge_with(client);
+    spec.config.progress = false;
+    if (!spec.config.trace.empty()) {
+        // trace из конфига самого демона к заданиям не относится
+        spdlog::warn("trace from the daemon config does not apply to jobs, ignoring {}", spec.config.trace);
+        spec.config.trace.clear();
+    }
+    for (const auto& source : cli.sources) spec.sources.emplace_back(source);
+    spec.destination = cli.destination;
+    return spec;
+}
+
+auto handle_request(std::string_view line, const infra::Config& base, core::JobManager& jobs) -> std::string {
+    // JSON — подмножество YAML: запросы разбирает тот же yaml-cpp, что и конфиг
+    try {
+        const auto request = YAML::Load(std::string(line));
+        if (!request.IsMap() || !request["op"]) return error_json("Request must be an object with op");
+        const auto op = request["op"].as<std::string>();
+
+        if (op == "submit") return submit(request, base, jobs);
+        if (op == "list") {
+            std::string json = R"({"ok":true,"jobs":[)";
+            bool first = true;
+            for (const auto& status : jobs.list()) {
+                json += (first ? "" : ",") + status_json(status);
+                first = false;
+            }
+            return json + "]}";
+        }
+        if (!request["job"]) return error_json(fmt::format("{} needs a job", op));
+        const auto id = request["job"].as<core::JobId>();
+        if (op == "status") {
+            const auto status = jobs.status(id);
+            if (!status) return error_json(fmt::format("No job {}", id));
+            return fmt::format(R"({{"ok":true,"status":{}}})", status_json(*status));
+        }
+        if (op == "cancel") {
+            if (!jobs.cancel(id)) return error_json(fmt::format("No queued or running job {}", id));
+            return R"({"ok":true})";
+        }
+        return error_json(fmt::format("Unknown op: {}", op));
+    } catch (const YAML::Exception& e) {
+        return error_json(fmt::format("Malformed request: {}", e.what()));
+    }
+}
+
+auto Server::bind(const fs::path& socket, const infra::Config& base, core::JobManager& jobs)
+    -> std::expected<std::unique_ptr<Server>, infra::Error>
+{
+    auto listener = adapters::ipc::UnixListener::bind(socket);
+    if (!listener) return std::unexpected(std::move(listener.error()));
+    return std::unique_ptr<Server>(new Server(std::move(*listener), base, jobs));
+}
+
+void Server::serve(std::stop_token stop) {
+    spdlog::info("Daemon listening on {}: {} workers shared by jobs", listener_.path().string(), jobs_.threads());
+    while (!stop.stop_requested() && !infra::is_interrupted()) {
+        auto accepted = listener_.accept(ACCEPT_POLL);
+        std::erase_if(sessions_, [](const auto& session) { return session->done.load(); });
+        if (!accepted) {
+            spdlog::error("{}", accepted.error().message);
+            break;
+        }
+        if (!*accepted) continue;
+        auto session = std::make_unique<Session>(std::move(**accepted));
+        session->thread = std::jthread([this, raw = session.get()] {
+            run_session_(*raw);
+            raw->done.store(true);
+        });
+        sessions_.push_back(std::move(session));
+    }
+    for (auto& session : sessions_) session->stream.shutdown();
+    sessions_.clear();
+}
+
+void Server::run_session_(Session& session) {
+    for (;;) {
+        auto line = session.stream.read_line();
+        if (!line) {
+            spdlog::warn("Daemon connection dropped: {}", line.error().message);
+            return;
+        }
+        if (!*line) return;
+        if (auto written = session.stream.write_line(handle_request(**line, base_, jobs_)); !written) {
+            spdlog::warn("Daemon connection dropped: {}", written.error().message);
+            return;
+        }
+    }
+}
+
+} // namespace cclone::daemon
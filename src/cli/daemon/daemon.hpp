@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <stop_token>
+#include <thread>
+#include <vector>
+#include "adapters/unix_socket.hpp"
+#include "core/daemon/job_manager.hpp"
+#include "infra/config/config.hpp"
+#include "infra/error_handler/error.hpp"
+
+namespace cclone::daemon {
+
+// Протокол демона: клиент шлёт по строке JSON на запрос, демон отвечает
+// строкой JSON. Запросы (op):
+//   submit  {"op":"submit","cwd":"/home/u","args":["-s","a","-d","b","-r"],"config":"..."}
+//           → {"ok":true,"job":7}; args — параметры fcopyrover без имени
+//           программы, относительные пути считаются от cwd; config —
+//           необязательный текст конфигурационного файла клиента
+//   status  {"op":"status","job":7}  → {"ok":true,"status":{...}}
+//   list    {"op":"list"}            → {"ok":true,"jobs":[{...},...]}
+//   cancel  {"op":"cancel","job":7}  → {"ok":true}
+// Ошибка — {"ok":false,"error":"..."}.
+
+// $XDG_RUNTIME_DIR/fcopyrover.sock, без него /tmp/fcopyrover-<uid>.sock
+[[nodiscard]] auto default_socket_path() -> std::filesystem::path;
+
+// Объект status: состояние, ход и итоги задания
+[[nodiscard]] auto status_json(const core::JobStatus& status) -> std::string;
+
+// Задание из параметров командной строки и конфигурационного файла
+// клиента (YAML, пусто — нет файла) поверх конфигурации демона
+[[nodiscard]] auto job_from_args(const std::vector<std::string>& args, const std::filesystem::path& cwd,
+                                 const infra::Config& base, std::string_view client_config = {})
+    -> std::expected<core::JobSpec, infra::Error>;
+
+// Ответ на одну строку запроса
+[[nodiscard]] auto handle_request(std::string_view line, const infra::Config& base, core::JobManager& jobs)
+    -> std::string;
+
+// Сервер на локальном сокете: соединение — поток, запросы соединения
+// обрабатываются по порядку
+class Server {
+public:
+    static auto bind(const std::filesystem::path& socket, const infra::Config& base, core::JobManager& jobs)
+        -> std::expected<std::unique_ptr<Server>, infra::Error>;
+
+    // Принимает соединения, пока не запрошена остановка или не пришёл
+    // SIGINT/SIGTERM; открытые соединения закрывает
+    void serve(std::stop_token stop);
+
+private:
+    struct Session {
+        explicit Session(adapters::ipc::UnixStream s) : stream(std::move(s)) {}
+        adapters::ipc::UnixStream stream;
+        std::atomic<bool> done{false};
+        std::jthread thread;    // последним: присоединяется до закрытия stream
+    };
+
+    Server(adapters::ipc::UnixListener listener, const infra::Config& base, core::JobManager& jobs)
+        : listener_(std::move(listener)), base_(base), jobs_(jobs) {}
+
+    void run_session_(Session& session);
+
+    adapters::ipc::UnixListener listener_;
+    const infra::Config base_;
+    core::JobManager& jobs_;
+    std::vector<std::unique_ptr<Session>> sessions_;
+};
+
+} // namespace cclone::daemon
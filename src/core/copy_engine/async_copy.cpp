@@ -0,0 +1,302 @@
+#include "copy_engine.hpp"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <fmt/core.h>
+#include "../../infra/interrupt.hpp"
+#include "../../infra/trace/trace.hpp"
+
+#ifndef _WIN32
+    #include <fcntl.h>
+#endif
+
+// --engine=async: файлы копируются сопрограммами на реакторе
+// (adapters::fs::IoReactor). Поток-реактор держит сотни и тысячи файлов в
+// полёте, не блокируясь ни на одном: открытие, чтение, запись и закрытие
+// идут через io_uring, а всё без асинхронного аналога — через offload в
+// пул блокирующих потоков. Сканирование, фильтры, бюджет памяти и учёт
+// результата (record_result) те же, что у движка на потоках.
+
+namespace cclone::core {
+
+namespace {
+
+#ifndef _WIN32
+auto io_error(std::string_view what, const std::filesystem::path& path, int err) -> infra::Error {
+    const auto code = err == ENOSPC ? infra::ErrorCode::DiskFull
+                    : err == EACCES || err == EPERM ? infra::ErrorCode::PermissionDenied
+                    : err == ENOENT ? infra::ErrorCode::FileNotFound
+                    : infra::ErrorCode::Unknown;
+    return infra::make_error(code, fmt::format("{} {}: {}", what, path.string(), std::strerror(err)));
+}
+
+// Пауза --bwlimit, не занимающая реактор. Пределы могут смениться на
+// лету — спим кусками и сверяемся с ними
+auto pace(adapters::fs::IoReactor& io, const infra::IoPacer& pacer, infra::TokenBucket::Clock::duration delay)
+    -> infra::Task<void>
+{
+    const auto epoch = pacer.epoch();
+    while (delay > infra::TokenBucket::Clock::duration::zero() && !infra::is_interrupted() && pacer.epoch() == epoch) {
+        const auto slice = std::min<infra::TokenBucket::Clock::duration>(delay, infra::TokenBucket::BURST);
+        (void)co_await io.sleep(slice);
+        delay -= slice;
+    }
+}
+
+// Перенос size байт; короткие чтение и запись дочитываются и дописываются.
+// Задержка операции — от отправки до завершения, под ключом latency_key
+auto transfer(adapters::fs::IoReactor& io, int src_fd, int dst_fd, std::uint64_t size,
+              std::size_t buffer_size, const std::filesystem::path& src, const std::filesystem::path& dst,
+              const infra::IoPacer& pacer, infra::OpLatency& latency, infra::LatencyKey latency_key)
+    -> infra::Task<std::expected<void, infra::Error>>
+{
+    if (size == 0) co_return std::expected<void, infra::Error>{};
+
+    const auto capacity = static_cast<std::size_t>(std::min<std::uint64_t>(size, buffer_size));
+    const auto buffer = std::make_unique_for_overwrite<char[]>(capacity);
+    std::uint64_t offset = 0;
+    while (offset < size) {
+        if (infra::is_interrupted()) {
+            co_return std::unexpected(infra::make_error(infra::ErrorCode::Interrupted, "Cancelled"));
+        }
+        const auto want = static_cast<std::size_t>(std::min<std::uint64_t>(capacity, size - offset));
+        auto started = std::chrono::steady_clock::now();
+        const int got = co_await io.read(src_fd, buffer.get(), want, offset);
+        latency.record(infra::IoOp::Read, latency_key, std::chrono::steady_clock::now() - started);
+        if (got < 0) co_return std::unexpected(io_error("Read error in", src, -got));
+        if (got == 0) break;  // файл укоротился после сканирования
+        if (pacer) {
+            const auto bytes = static_cast<std::uint64_t>(got);
+            co_await pace(io, pacer, std::max(pacer.reserve_read(bytes), pacer.reserve_write(bytes)));
+        }
+
+        for (std::size_t done = 0; done < static_cast<std::size_t>(got);) {
+            started = std::chrono::steady_clock::now();
+            const int put = co_await io.write(dst_fd, buffer.get() + done, static_cast<std::size_t>(got) - done,
+                                              offset + done);
+            latency.record(infra::IoOp::Write, latency_key, std::chrono::steady_clock::now() - started);
+            if (put <= 0) co_return std::unexpected(io_error("Write error in", dst, put < 0 ? -put : EIO));
+            latency.add_written(static_cast<std::uint64_t>(put));
+            done += static_cast<std::size_t>(put);
+        }
+        offset += static_cast<std::uint64_t>(got);
+    }
+    co_return std::expected<void, infra::Error>{};
+}
+#endif
+
+} // namespace
+
+bool CopyEngine::async_eligible(const CopyItem& item) const {
+    const auto& file = *item.file;
+    return adapters::fs::DESCRIPTOR_HOOKS
+        && !item.dedup_candidate
+        && !(hardlink_registry_ && file.stat.nlink > 1)
+        && !(journal_ && file.stat.size > CHUNKED_THRESHOLD)
+        && !(config_.resume && !journal_)
+        && !delta_;
+}
+
+void CopyEngine::run_async_worker(infra::BoundedQueue<CopyItem>& queue,
+                                  const std::filesystem::path& destination,
+                                  infra::WorkStealingPool& blocking,
+                                  std::size_t capacity,
+                                  const std::atomic<std::size_t>& max_in_flight)
+{
+    auto reactor = adapters::fs::IoReactor::create(static_cast<unsigned>(capacity), blocking);
+    if (!reactor) {
+        spdlog::warn("Async engine unavailable, copying on this thread: {}", reactor.error().message);
+        while (auto item = queue.pop()) {
+            process_item(*item, destination);
+        }
+        return;
+    }
+    auto& io = **reactor;
+    spdlog::debug("Async reactor: {} backend, up to {} files in flight",
+                  io.backend() == adapters::fs::IoReactor::Backend::Uring ? "io_uring" : "epoll + thread pool",
+                  capacity);
+
+    std::size_t active = 0;
+    std::size_t peak = 0;
+    std::optional<CopyItem> held;  // ждёт места в бюджете памяти
+    for (;;) {
+        // Новые файлы — пока есть место; очередь не ждём, пока есть что продолжать
+        while (active < std::min(capacity, max_in_flight.load(std::memory_order_relaxed))
+               && !infra::is_interrupted()) {
+            auto item = held ? std::exchange(held, std::nullopt) : queue.try_pop();
+            if (!item) break;
+
+            const bool eligible = async_eligible(*item);
+            infra::MemoryBudget::Reservation reservation;
+            if (memory_budget_) {
+                const auto bytes = memory_footprint(*item->file, eligible);
+                // Реактор не должен засыпать на бюджете, пока его файлы ждут продолжения
+                reservation = active == 0 ? memory_budget_->acquire(bytes) : memory_budget_->try_acquire(bytes);
+                if (bytes != 0 && reservation.bytes() == 0) {
+                    held = item;
+                    break;
+                }
+            }
+            ++active;
+            peak = std::max(peak, active);
+            copy_async(io, *item, destination / item->file->relative, std::move(reservation), active);
+        }
+
+        if (active == 0) {
+            // Ждать нечего — блокируемся на очереди. После прерывания
+            // оставшиеся файлы вынимаются без копирования, как у потоков
+            auto item = queue.pop();
+            if (!item) break;
+            if (!infra::is_interrupted()) held = item;
+            continue;
+        }
+        io.wait();
+    }
+    spdlog::debug("Async reactor done: peak {} files in flight", peak);
+}
+
+auto CopyEngine::copy_async(adapters::fs::IoReactor& io, CopyItem item, std::filesystem::path dst,
+                            infra::MemoryBudget::Reservation reservation, std::size_t& active)
+    -> infra::Detached
+{
+    // Деструктор — и при исключении: реактор иначе ждал бы файл вечно
+    struct Finished {
+        std::size_t& active;
+        ~Finished() { --active; }
+    } finished{active};
+
+    const auto started = std::chrono::steady_clock::now();
+    stats_.add(CopyCounter::FilesStarted);
+    if (item.queued != infra::trace::Clock::time_point{}) {
+        infra::trace::record(infra::trace::Phase::Queue, item.queued, started);
+    }
+    const auto& file = *item.file;
+    std::expected<CopyFileResult, infra::Error> res = CopyFileResult{};
+    if (async_eligible(item)) {
+        res = co_await copy_file_async(io, file, dst);
+    } else {
+        // Дедупликация, жёсткие ссылки, дельта и чанки ждут друг друга
+        // и пул хеширования — им место в блокирующем пуле
+        res = co_await io.offload([&] { return copy_item(item, dst, reservation); });
+    }
+    reservation.release();
+    record_result(file, dst, std::move(res), started);
+    if (infra::trace::enabled()) {
+        // Файлы реактора перекрываются: асинхронный интервал, не срез потока
+        infra::trace::record(infra::trace::Phase::File, started, infra::trace::Clock::now(), &file.source, true);
+    }
+}
+
+auto CopyEngine::copy_file_async(adapters::fs::IoReactor& io, const ScanEntry& file,
+                                 const std::filesystem::path& dst)
+    -> infra::Task<std::expected<CopyFileResult, infra::Error>>
+{
+#ifndef _WIN32
+    using Result = std::expected<CopyFileResult, infra::Error>;
+    const bool atomic = config_.atomic;
+    // Файлы реактора перемежаются: задержки пишутся явно, а не через контекст потока
+    const auto started = std::chrono::steady_clock::now();
+    const auto key = latency_key(CopyPath::Async, file);
+    const auto since = [](std::chrono::steady_clock::time_point from) {
+        return std::chrono::steady_clock::now() - from;
+    };
+
+    const int src_fd = co_await io.open(file.source.c_str(), O_RDONLY | O_CLOEXEC);
+    latency_.record(infra::IoOp::Open, key, since(started));
+    if (src_fd < 0) {
+        co_return std::unexpected(io_error("Failed to open", file.source, -src_fd));
+    }
+
+    // InPlace: существующий файл удаляется, как в copy_file, — но только
+    // если он есть: O_EXCL обходится без лишнего stat на новых файлах
+    int dst_fd = -1;
+    std::optional<adapters::fs::OutputFile> output;
+    std::optional<infra::Error> failure;
+    const auto dst_started = std::chrono::steady_clock::now();
+    if (atomic) {
+        auto opened = co_await io.offload([&] {
+            return adapters::fs::OutputFile::open(dst, adapters::fs::Publish::Atomic);
+        });
+        if (opened) {
+            output.emplace(std::move(*opened));
+            dst_fd = output->fd();
+        } else {
+            failure = std::move(opened.error());
+        }
+    } else {
+        constexpr int flags = O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC;
+        dst_fd = co_await io.open(dst.c_str(), flags, 0644);
+        if (dst_fd == -EEXIST) {
+            const int removed = co_await io.unlink(dst.c_str());
+            dst_fd = removed < 0 ? removed : co_await io.open(dst.c_str(), flags, 0644);
+        }
+        if (dst_fd < 0) {
+            failure = io_error("Cannot create", dst, -dst_fd);
+        }
+    }
+    latency_.record(infra::IoOp::Open, key, since(dst_started));
+
+    const auto on_written = descriptor_hook(file, dst);
+    if (!failure) {
+        const auto pacer = io_pacer(file);
+        auto moved = co_await transfer(io, src_fd, dst_fd, file.stat.size, ASYNC_BUFFER_SIZE, file.source, dst,
+                                       pacer, latency_, key);
+        if (moved) {
+            record_path(CopyPath::Async, file.stat.size);
+        } else {
+            failure = std::move(moved.error());
+        }
+    }
+    if (!failure && on_written) {
+        // fsync блокирует надолго; метаданные — пара быстрых вызовов
+        const auto hook = [&] {
+            const infra::OpLatency::Context latency_context(latency_, key);
+            return on_written(src_fd, dst_fd);
+        };
+        auto hooked = durability_ ? co_await io.offload(hook) : hook();
+        if (!hooked) failure = std::move(hooked.error());
+    }
+
+    (void)co_await io.close(src_fd);
+    if (output) {
+        if (!failure) {
+            auto published = co_await io.offload([&] { return output->publish(); });
+            if (!published) failure = std::move(published.error());
+        }
+        output.reset();  // неопубликованный безымянный файл исчезает
+    } else if (dst_fd >= 0) {
+        const int closed = co_await io.close(dst_fd);
+        if (closed < 0 && !failure) failure = io_error("Cannot close", dst, -closed);
+    }
+    if (failure) {
+        co_return Result{std::unexpect, std::move(*failure)};
+    }
+
+    // Верификация, метаданные по пути, fsync по пути и манифест — как у потоков
+    const bool via_descriptor = static_cast<bool>(on_written);
+    const bool needs_finish = config_.verify || manifest_ || (durability_ && (atomic || !via_descriptor))
+                           || (config_.preserve_metadata && !(via_descriptor && metadata_on_descriptor()));
+    std::optional<ContentDigest> digest;
+    if (needs_finish) {
+        auto finished = co_await io.offload([&] {
+            const infra::OpLatency::Context latency_context(latency_, key);
+            if (durability_ && atomic) {
+                durability_->name_published(dst);
+            }
+            return finish_copy(file, dst, via_descriptor);
+        });
+        if (!finished) {
+            co_return std::unexpected(std::move(finished.error()));
+        }
+        digest = *finished;
+    }
+    latency_.record(infra::IoOp::File, key, since(started));
+    co_return CopyFileResult{.copied = true, .digest = digest};
+#else
+    (void)io;
+    co_return copy_file(file, dst);
+#endif
+}
+
+} // namespace cclone::core
@@ -7,34 +7,40 @@
 #include <mutex>
 #include <optional>
 #include <future>
+#include <map>
+#include <set>
+#include <unordered_map>
 #include "../../infra/error_handler/error.hpp"
 #include "../../infra/monitoring/monitoring.hpp"
 #include "../../infra/retry.hpp"
 #include "../../infra/thread_pool/thread_pool.hpp"
+#include "../../infra/thread_pool/work_stealing_pool.hpp"
+#include "../../infra/concurrent/bounded_queue.hpp"
+#include "../../infra/numa/numa.hpp"
+#include "../../infra/tuning/io_probe.hpp"
 #include "../../infra/interrupt.hpp"
+#include "../../infra/trace/trace.hpp"
+#include "../../infra/syscall/syscalls.hpp"
 #include "../../infra/hash/xxhash_verifier.hpp"
+#include "../../infra/hash/tree_hasher.hpp"
+#include "../../infra/compare/byte_comparator.hpp"
 #include "../../adapters/fs.hpp"
 #include "../../extensions/metadata.hpp"
-#include "../../extensions/resumer.hpp"
+#include "../../extensions/journal.hpp"
+#include "../../extensions/dedup.hpp"
+#include "../../extensions/manifest.hpp"
+#include "../../extensions/sync_index.hpp"
 #include <regex>
+#include <fmt/ranges.h>
 
 namespace cclone::core {
 
 namespace {
 
-std::uintmax_t total_size(const std::vector<std::filesystem::path>& files) {
-    std::uintmax_t size = 0;
-    for (const auto& file : files) {
-        std::error_code ec;
-        auto file_size = std::filesystem::file_size(file, ec);
-        if (!ec) {
-            size += file_size;
-        } else {
-            spdlog::warn("Failed to get size for {}: {}", file.string(), ec.message());
-        }
-    }
-    return size;
-}
+// Подписи способов копирования в метриках и отчёте о задержках
+constexpr std::array<std::string_view, static_cast<std::size_t>(CopyPath::Count)> PATH_LABELS{
+    "buffered", "mmap", "direct", "async", "chunked", "delta"
+};
 
 } // namespace
 
@@ -42,29 +48,60 @@ CopyEngine::CopyEngine(const infra::Config& config,
                        infra::ProgressMonitor& monitor)
     : config_(config), monitor_(monitor) {}
 
+CopyEngine::CopyEngine(const infra::Config& config,
+                       infra::ProgressMonitor& monitor,
+                       SharedPools pools)
+    : config_(config), monitor_(monitor), shared_files_(&pools.files), hash_pool_(&pools.hashes) {}
+
 auto CopyEngine::run(const std::vector<std::filesystem::path>& sources,
                     const std::filesystem::path& destination)
     -> std::expected<CopyStatsSnapshot, infra::Error>
 {
-    if (!std::filesystem::exists(destination)) {
+    // Счётчики вызовов общие на процесс: прогон — разность снимков
+    const auto syscalls_before = infra::sys::snapshot();
+    // Отмена задания демона; рабочие и реакторы прогона уносят её с собой
+    const auto* cancel = infra::CancelScope::current();
+    if (!infra::sys::exists(destination)) {
         std::error_code ec;
-        std::filesystem::create_directories(destination, ec);
+        infra::sys::create_directories(destination, ec);
         if (ec) {
             return std::unexpected(infra::make_error(infra::ErrorCode::PermissionDenied,
                                  fmt::format("Cannot create destination: {}", ec.message())));
         }
     }
 
-    // Сканируем файлы
-    std::vector<std::filesystem::path> all_files;
+    // Сканируем файлы: метаданные снимаются один раз и дальше не перечитываются
+    std::vector<ScanEntry> all_files;
+    // После all_files: интервалы файлов ссылаются на их пути до finish()
+    std::optional<infra::trace::Session> trace;
+    if (!config_.trace.empty()) {
+        trace.emplace(infra::trace::Session::Options{
+            .output = config_.trace,
+            .top_files = config_.trace_top.value_or(DEFAULT_TRACE_TOP)
+        });
+    }
+    auto add_file = [&](const std::filesystem::path& file, std::filesystem::path relative) {
+        const auto stat_started = std::chrono::steady_clock::now();
+        auto st = adapters::fs::stat_file(file);
+        if (!st) {
+            spdlog::warn("Failed to stat {}: {}", file.string(), st.error().message);
+            return;
+        }
+        latency_.record(infra::IoOp::Stat,
+                        infra::LatencyKey{.path = infra::OpLatency::NO_PATH, .size = infra::size_class(st->size)},
+                        std::chrono::steady_clock::now() - stat_started);
+        all_files.push_back(ScanEntry{.source = file, .relative = std::move(relative), .stat = *st});
+    };
+
+    std::optional<infra::trace::Span> scan_span(std::in_place, infra::trace::Phase::Scan);
     for (const auto& src : sources) {
-        if (std::filesystem::is_directory(src)) {
+        if (infra::sys::is_directory(src)) {
             if (config_.recursive) {
                 for (const auto& entry : std::filesystem::recursive_directory_iterator(src)) {
                     if (should_exclude(entry.path())) continue;
                     if (!should_include(entry.path()) && !config_.include_patterns.empty()) continue;
                     if (entry.is_regular_file() || entry.is_symlink()) {
-                        all_files.push_back(entry.path());
+                        add_file(entry.path(), entry.path().lexically_relative(src));
                     }
                 }
             } else {
@@ -73,53 +110,402 @@ auto CopyEngine::run(const std::vector<std::filesystem::path>& sources,
                     if (should_exclude(entry.path())) continue;
                     if (!should_include(entry.path()) && !config_.include_patterns.empty()) continue;
                     if (entry.is_regular_file() || entry.is_symlink()) {
-                        all_files.push_back(entry.path());
+                        add_file(entry.path(), entry.path().filename());
                     }
                 }
             }
-        } else if (std::filesystem::is_regular_file(src)) {
-            all_files.push_back(src);
+        } else if (infra::sys::is_regular_file(src)) {
+            add_file(src, src.filename());
         } else {
             spdlog::warn("Skipping non-file: {}", src.string());
         }
     }
 
-    monitor_.set_total(all_files.size(), total_size(all_files));
+    scan_span.reset();
+
+    std::uint64_t total_bytes = 0;
+    for (const auto& file : all_files) {
+        total_bytes += file.stat.size;
+    }
+    monitor_.set_total(all_files.size(), total_bytes);
+
+    // Инкрементальный режим: индекс прошлой синхронизации в корне назначения
+    std::optional<extensions::SyncIndex> sync_index;
+    if (config_.incremental) {
+        auto loaded = extensions::SyncIndex::load(destination / extensions::SyncIndex::FILE_NAME);
+        if (!loaded) {
+            spdlog::warn("Ignoring sync index: {}", loaded.error().message);
+            loaded = extensions::SyncIndex{};
+        }
+        sync_index = std::move(*loaded);
+        sync_builder_ = std::make_unique<extensions::SyncIndexBuilder>();
+        sync_builder_->reserve(all_files.size());
+        spdlog::debug("Loaded sync index with {} entries", sync_index->size());
+    }
+
+    // Создаём пул потоков: по задаче на файл, поэтому планировщик
+    // с раздельными очередями, без общей блокировки на задачу
+    // С --adaptive пул создаётся с запасом, а активных рабочих выбирает регулятор
+    const std::size_t hardware_threads = std::max(1u, std::jthread::hardware_concurrency());
+    const std::size_t num_threads = config_.threads.value_or(config_.adaptive ? ADAPTIVE_MAX_WORKERS
+                                                                              : hardware_threads);
+    const auto worker_init = numa_worker_init(sources, destination);
+    const bool async = config_.engine == infra::EngineBackend::Async;
 
-    // Создаём пул потоков
-    infra::ThreadPool pool{config_.threads.value_or(std::jthread::hardware_concurrency())};
+    // Задание демона копирует на общем пуле, по задаче на файл; --threads
+    // ограничивает его долю. Реакторам, регулятору и закреплению за NUMA
+    // нужны свои рабочие
+    std::unique_ptr<infra::FairPool::Lane> lane;
+    std::optional<infra::WorkStealingPool> pool;
+    if (shared_files_ && !async && !config_.adaptive && config_.numa == infra::NumaPolicy::Off) {
+        // Очередь задания ограничена так же, как copy_queue ниже
+        lane = shared_files_->open_lane(config_.threads.value_or(0), COPY_QUEUE_DEPTH);
+    } else {
+        if (shared_files_) {
+            spdlog::info("Job runs on its own {} workers (--engine=async, --adaptive or --numa)", num_threads);
+        }
+        pool.emplace(num_threads, worker_init);
+    }
+    const std::size_t workers = lane ? lane->size() : pool->size();
+
+    // Отдельный пул для сегментного хеширования больших файлов:
+    // рабочие потоки копирования блокируются на его futures,
+    // поэтому делить с ними один пул нельзя
+    const bool needs_hashes = (config_.verify && config_.verify_mode == infra::VerifyMode::Hash)
+                           || !config_.manifest.empty()
+                           || config_.delta
+                           || config_.resume;
+    if (needs_hashes && !hash_pool_) {
+        // Хеширование упирается в процессор, а не в устройство
+        const auto hash_threads = config_.adaptive ? std::min(num_threads, hardware_threads) : num_threads;
+        own_hash_pool_ = std::make_unique<infra::ThreadPool>(hash_threads, worker_init);
+        hash_pool_ = own_hash_pool_.get();
+    }
+
+    destination_root_ = destination;
+    if (config_.resume) {
+        auto journal = extensions::JobJournal::open(destination / extensions::JobJournal::FILE_NAME);
+        if (journal) {
+            journal_ = std::move(*journal);
+            if (journal_->replayed_files() > 0) {
+                spdlog::info("Resuming job: {} files known from the journal", journal_->replayed_files());
+            }
+        } else {
+            spdlog::warn("Job journal unavailable, resuming by destination size: {}", journal.error().message);
+        }
+    }
+    if (config_.dedup) {
+        dedup_registry_ = std::make_unique<DedupRegistry>();
+    }
+    if (config_.hard_links) {
+        hardlink_registry_ = std::make_unique<HardlinkRegistry>();
+    }
+    if (config_.delta) {
+        delta_ = std::make_unique<extensions::DeltaCopier>(
+            *hash_pool_, destination,
+            config_.delta_block_size.value_or(extensions::DeltaCopier::DEFAULT_BLOCK_SIZE),
+            config_.delta_cache);
+    }
+    if (config_.max_memory) {
+        memory_budget_ = std::make_unique<infra::MemoryBudget>(*config_.max_memory);
+        memory_share_ = memory_budget_->limit() / std::max<std::size_t>(1, workers);
+    }
+    const infra::IoLimits limits{
+        .bwlimit = config_.bwlimit.value_or(0),
+        .iops_limit = config_.iops_limit.value_or(0),
+        .device_bwlimit = config_.device_bwlimit.value_or(0),
+        .device_iops_limit = config_.device_iops_limit.value_or(0)
+    };
+    if (limits.any() || !config_.throttle_file.empty()) {
+        io_limiter_ = std::make_unique<infra::IoLimiter>(limits);
+        if (auto st = adapters::fs::stat_file(destination)) {
+            destination_device_ = st->device;
+        }
+        if (!config_.throttle_file.empty()) {
+            io_limiter_->watch(config_.throttle_file);  // действующие пределы пишет при чтении файла
+        } else {
+            spdlog::info("Throttle: bwlimit {} B/s, iops {}, per device {} B/s, {} iops",
+                         limits.bwlimit, limits.iops_limit, limits.device_bwlimit, limits.device_iops_limit);
+        }
+    }
+    if (config_.durability != infra::Durability::None) {
+        auto tracker = extensions::DurabilityTracker::create(config_.durability, destination);
+        if (tracker) {
+            durability_ = std::move(*tracker);
+        } else {
+            spdlog::warn("Durability mode ignored: {}", tracker.error().message);
+        }
+    }
+    if (!config_.manifest.empty()) {
+        auto writer = extensions::ManifestWriter::create(config_.manifest);
+        if (!writer) {
+            return std::unexpected(std::move(writer.error()));
+        }
+        manifest_ = std::move(*writer);
+    }
 
+    // Неизменные файлы решаются по метаданным сканирования и индексу,
+    // без системных вызовов к назначению. Остальные уходят в пул.
+    std::vector<const ScanEntry*> pending;
+    std::set<std::filesystem::path> parent_dirs;
+    pending.reserve(all_files.size());
     for (const auto& file : all_files) {
-        pool.enqueue([&, file]() {
-            if (infra::is_interrupted()) {
-                return;
+        if (journal_ && journal_->is_complete(extensions::SyncIndex::path_hash(file.relative),
+                                              file.stat.size, file.stat.mtime_ns)) {
+            if (sync_builder_) {
+                sync_builder_->record(extensions::SyncIndexEntry{
+                    .path_hash = extensions::SyncIndex::path_hash(file.relative),
+                    .size = file.stat.size,
+                    .mtime_ns = file.stat.mtime_ns,
+                    .inode = file.stat.inode,
+                    .content_hash = 0
+                });
             }
+            stats_.add(CopyCounter::FilesSkipped);
+            monitor_.update(1, file.stat.size);
+            continue;
+        }
+        if (sync_index) {
+            const auto* previous = sync_index->lookup(extensions::SyncIndex::path_hash(file.relative));
+            if (previous
+                && previous->size == file.stat.size
+                && previous->mtime_ns == file.stat.mtime_ns
+                && previous->inode == file.stat.inode) {
+                sync_builder_->record(*previous);
+                stats_.add(CopyCounter::FilesSkipped);
+                monitor_.update(1, file.stat.size);
+                continue;
+            }
+        }
+        pending.push_back(&file);
+        parent_dirs.insert(file.relative.parent_path());
+    }
 
-            auto dst = destination / std::filesystem::relative(file, sources[0]);
-            if (file == sources[0]) { // если source — файл, а не директория
-                dst = destination / file.filename();
+    // Каталоги назначения создаются один раз до копирования
+    for (const auto& dir : parent_dirs) {
+        if (dir.empty()) continue;
+        std::error_code ec;
+        infra::sys::create_directories(destination / dir, ec);
+        if (ec) {
+            spdlog::error("Failed to create dir {}: {}", (destination / dir).string(), ec.message());
+        } else if (durability_) {
+            for (auto level = dir; !level.empty(); level = level.parent_path()) {
+                durability_->directory_created(destination / level);
             }
+        }
+    }
 
-            auto file_size = std::filesystem::file_size(file);
-            auto res = copy_file(file, dst);
-            
-            if (res) {
-                if (res->copied) {
-                    stats_.files_copied.fetch_add(1, std::memory_order_relaxed);
-                    stats_.bytes_copied.fetch_add(file_size, std::memory_order_relaxed);
-                } else {
-                    stats_.files_skipped.fetch_add(1, std::memory_order_relaxed);
+    // Сканирование и копирование разделены ограниченной очередью:
+    // в полёте не больше COPY_QUEUE_DEPTH файлов на поток, а не всё дерево
+    infra::BoundedQueue<CopyItem> copy_queue{workers * COPY_QUEUE_DEPTH};
+    std::unique_ptr<infra::WorkStealingPool> blocking_pool;
+    const auto reactors = std::min(workers, MAX_ASYNC_REACTORS);
+    const std::size_t depth = config_.async_depth.value_or(DEFAULT_ASYNC_DEPTH);
+    const auto per_reactor = std::max<std::size_t>(1, depth / reactors);
+    // Текущий предел файлов в полёте на реактор и активных рабочих; их двигает --adaptive
+    std::atomic<std::size_t> reactor_depth{per_reactor};
+    std::optional<infra::ConcurrencyGate> gate;
+    if (config_.adaptive && !async) {
+        gate.emplace(workers);
+    }
+
+    // Метрики читают шарды счётчиков из своего потока, рабочие их не ждут
+    std::unique_ptr<infra::MetricsExporter> metrics;
+    if (!config_.metrics_prom.empty() || !config_.metrics_json.empty()) {
+        infra::MetricsExporter::Options options;
+        if (!config_.metrics_prom.empty()) options.prometheus_file = config_.metrics_prom;
+        if (!config_.metrics_json.empty()) options.json_file = config_.metrics_json;
+        options.interval = std::chrono::milliseconds(
+            static_cast<std::int64_t>(config_.metrics_interval.value_or(DEFAULT_METRICS_INTERVAL) * 1000));
+        auto exporter = infra::MetricsExporter::create(options, [&, reactors, async] {
+            auto snapshot = metrics_snapshot(copy_queue);
+            const auto limit = async ? reactor_depth.load(std::memory_order_relaxed) * reactors
+                                     : gate ? gate->limit() : workers;
+            snapshot.gauge("cclone_concurrency_limit",
+                           async ? "Files in flight allowed across reactors" : "Workers allowed to copy at once",
+                           static_cast<double>(limit));
+            return snapshot;
+        });
+        if (!exporter) {
+            return std::unexpected(std::move(exporter.error()));
+        }
+        metrics = std::move(*exporter);
+    }
+    if (async) {
+        // Реакторов немного, в полёте — тысячи файлов; блокирующие вызовы
+        // (fsync, верификация, дедупликация) уходят в отдельный пул
+        blocking_pool = std::make_unique<infra::WorkStealingPool>(num_threads, worker_init);
+        spdlog::info("Async engine: {} reactor threads, up to {} files in flight", reactors, per_reactor * reactors);
+        for (std::size_t reactor = 0; reactor < reactors; ++reactor) {
+            pool->enqueue([&, per_reactor] {
+                const infra::CancelScope cancel_scope(cancel);
+                run_async_worker(copy_queue, destination, *blocking_pool, per_reactor, reactor_depth);
+            });
+        }
+    } else if (!lane) {
+        for (std::size_t worker = 0; worker < pool->size(); ++worker) {
+            pool->enqueue([&] {
+                const infra::CancelScope cancel_scope(cancel);
+                for (;;) {
+                    // Лишние при --adaptive рабочие ждут у шлюза, не держа файла
+                    auto slot = gate ? gate->enter() : infra::ConcurrencyGate::Slot{};
+                    auto item = copy_queue.pop();
+                    if (!item) break;
+                    process_item(*item, destination);
                 }
-                monitor_.update(1, file_size);
+            });
+        }
+    }
+
+    std::unique_ptr<infra::ConcurrencyController> controller;
+    if (config_.adaptive) {
+        const infra::ConcurrencyController::Options options{
+            .min_level = async ? reactors : 1,
+            .max_level = async ? per_reactor * reactors : workers,
+            .initial_level = async ? std::min(per_reactor * reactors, ADAPTIVE_ASYNC_START) : hardware_threads,
+            .latency_ceiling_ms = config_.latency_ceiling_ms
+                                      ? std::optional<double>(*config_.latency_ceiling_ms) : std::nullopt
+        };
+        controller = std::make_unique<infra::ConcurrencyController>(options);
+        auto apply = [&, reactors, async](std::size_t level) {
+            if (async) {
+                reactor_depth.store(std::max<std::size_t>(1, level / reactors), std::memory_order_relaxed);
             } else {
-                stats_.errors.fetch_add(1, std::memory_order_relaxed);
-                (void)infra::log_and_return(std::move(res.error()));
-                monitor_.update(1, 0); // учитываем файл как обработанный
+                gate->set_limit(level);
             }
-        });
+        };
+        spdlog::info("Adaptive concurrency: {} to {} {}, starting at {}", options.min_level, options.max_level,
+                     async ? "files in flight" : "workers", controller->level());
+        controller->start(io_sampler(sources, destination), apply, ADAPTIVE_INTERVAL,
+                          async ? "files in flight" : "workers");
     }
 
-    pool.wait();
+    auto dispatch = [&](const ScanEntry* file, bool dedup_candidate) {
+        CopyItem item{
+            .file = file,
+            .dedup_candidate = dedup_candidate,
+            .queued = infra::trace::enabled() ? infra::trace::Clock::now() : infra::trace::Clock::time_point{}
+        };
+        if (lane) {
+            // Файлы ждут в очереди задания общего пула (на пределе её длины
+            // сканирование ждёт рабочих); ScanEntry живут до конца прогона
+            lane->enqueue([this, item, &destination, cancel] {
+                const infra::CancelScope cancel_scope(cancel);
+                process_item(item, destination);
+            });
+        } else {
+            (void)copy_queue.push(item);
+        }
+    };
+
+    if (dedup_registry_) {
+        // Кандидаты в дубликаты — файлы, чей размер встречается больше одного раза.
+        // Остальные уходят в пул сразу, и пока он копирует, этот поток
+        // считает для кандидатов предфильтр по голове/хвосту.
+        // Полный хеш считают рабочие потоки уже в конвейере копирования.
+        std::unordered_map<std::uint64_t, std::size_t> size_counts;
+        for (const auto* file : pending) {
+            if (file->stat.size >= extensions::DEDUP_MIN_SIZE) ++size_counts[file->stat.size];
+        }
+
+        // Жёсткие ссылки источника воссоздаются отдельно (--hard-links)
+        std::vector<const ScanEntry*> candidates;
+        for (const auto* file : pending) {
+            const bool hardlinked = hardlink_registry_ && file->stat.nlink > 1;
+            if (!hardlinked && file->stat.size >= extensions::DEDUP_MIN_SIZE && size_counts[file->stat.size] > 1) {
+                candidates.push_back(file);
+            } else {
+                dispatch(file, false);
+            }
+        }
+
+        std::map<std::pair<std::uint64_t, std::uint64_t>, std::vector<const ScanEntry*>> groups;
+        for (const auto* file : candidates) {
+            if (infra::is_interrupted()) break;
+            auto prefilter = extensions::head_tail_digest(file->source, file->stat.size);
+            if (!prefilter) {
+                dispatch(file, false);
+                continue;
+            }
+            groups[{file->stat.size, *prefilter}].push_back(file);
+        }
+        for (const auto& [key, group] : groups) {
+            for (const auto* file : group) {
+                dispatch(file, group.size() > 1);
+            }
+        }
+    } else {
+        for (const auto* file : pending) {
+            dispatch(file, false);
+        }
+    }
+
+    copy_queue.close();
+    if (lane) {
+        lane->wait();
+    } else {
+        pool->wait();
+    }
+    controller.reset();
+    metrics.reset();  // итоговые значения
+    blocking_pool.reset();
+    io_limiter_.reset();
+
+    if (trace) {
+        if (auto summary = trace->finish()) {
+            infra::trace::log_summary(*summary);
+            spdlog::info("Trace written: {}", config_.trace);
+        } else {
+            spdlog::warn("{}", summary.error().message);
+        }
+    }
+
+    if (memory_budget_) {
+        spdlog::info("Memory budget: peak {} of {} bytes in flight, {} waits",
+                     memory_budget_->peak(), memory_budget_->limit(), memory_budget_->stalls());
+    }
+
+    // До журнала и индекса: они не должны опережать данные на носителе
+    if (durability_) {
+        if (auto synced = durability_->finish(); !synced) {
+            stats_.add(CopyCounter::Errors);
+            (void)infra::log_and_return(std::move(synced.error()));
+        }
+        const auto synced = durability_->stats();
+        spdlog::info("Durability: {} files, {} directories, {} filesystems synced ({} batches)",
+                     synced.files, synced.directories, synced.filesystems, synced.batches);
+        durability_.reset();
+    }
+
+    if (manifest_) {
+        auto closed = manifest_->close();
+        if (!closed) {
+            return std::unexpected(std::move(closed.error()));
+        }
+        spdlog::info("Manifest written: {} ({} entries)", config_.manifest, manifest_->entry_count());
+        manifest_.reset();
+    }
+
+    // Журнал нужен только незавершённому заданию
+    if (journal_) {
+        if (!infra::is_interrupted() && stats_.load(CopyCounter::Errors) == 0) {
+            if (auto discarded = journal_->discard(); !discarded) {
+                spdlog::warn("{}", discarded.error().message);
+            }
+        } else {
+            spdlog::info("Job journal kept in {}, rerun with --resume to continue", destination.string());
+        }
+        journal_.reset();
+    }
+
+    // Индекс сохраняется и после прерывания: в нём только завершённые файлы
+    if (sync_builder_) {
+        auto saved = sync_builder_->save(destination / extensions::SyncIndex::FILE_NAME);
+        if (!saved) {
+            spdlog::warn("Failed to save sync index: {}", saved.error().message);
+        }
+        sync_builder_.reset();
+    }
 
     if (infra::is_interrupted()) {
         return std::unexpected(infra::make_error(infra::ErrorCode::Interrupted, "User interrupted"));
@@ -127,10 +513,15 @@ auto CopyEngine::run(const std::vector<std::filesystem::path>& sources,
 
     // Возвращаем снимок статистики
     return CopyStatsSnapshot{
-        .files_copied = stats_.files_copied.load(),
-        .bytes_copied = stats_.bytes_copied.load(),
-        .files_skipped = stats_.files_skipped.load(),
-        .errors = stats_.errors.load()
+        .files_copied = stats_.load(CopyCounter::FilesCopied),
+        .bytes_copied = stats_.load(CopyCounter::BytesCopied),
+        .bytes_written = stats_.load(CopyCounter::BytesWritten),
+        .bytes_deduped = stats_.load(CopyCounter::BytesDeduped),
+        .hardlinks = stats_.load(CopyCounter::Hardlinks),
+        .files_skipped = stats_.load(CopyCounter::FilesSkipped),
+        .errors = stats_.load(CopyCounter::Errors),
+        .latency = infra::summarize(latency_.merge(), PATH_LABELS),
+        .syscalls = infra::sys::snapshot() - syscalls_before
     };
 }
 
@@ -138,7 +529,7 @@ void CopyEngine::copy_directory(const std::filesystem::path& src_dir,
                                 const std::filesystem::path& dst_dir)
 {
     std::error_code ec;
-    std::filesystem::create_directories(dst_dir, ec);
+    infra::sys::create_directories(dst_dir, ec);
     if (ec) {
         spdlog::error("Failed to create dir {}: {}", dst_dir.string(), ec.message());
         return;
@@ -147,16 +538,23 @@ void CopyEngine::copy_directory(const std::filesystem::path& src_dir,
     for (const auto& entry : std::filesystem::directory_iterator(src_dir)) {
         if (entry.is_regular_file()) {
             auto dst = dst_dir / entry.path().filename();
-            auto res = copy_file(entry.path(), dst);
+            auto st = adapters::fs::stat_file(entry.path());
+            if (!st) {
+                stats_.add(CopyCounter::Errors);
+                (void)infra::log_and_return(std::move(st.error()));
+                continue;
+            }
+            const ScanEntry file{.source = entry.path(), .relative = entry.path().filename(), .stat = *st};
+            auto res = copy_file(file, dst);
             if (res) {
                 if (res->copied) {
-                    stats_.files_copied.fetch_add(1, std::memory_order_relaxed);
-                    stats_.bytes_copied.fetch_add(std::filesystem::file_size(entry.path()), std::memory_order_relaxed);
+                    stats_.add(CopyCounter::FilesCopied);
+                    stats_.add(CopyCounter::BytesCopied, file.stat.size);
                 } else {
-                    stats_.files_skipped.fetch_add(1, std::memory_order_relaxed);
+                    stats_.add(CopyCounter::FilesSkipped);
                 }
             } else {
-                stats_.errors.fetch_add(1, std::memory_order_relaxed);
+                stats_.add(CopyCounter::Errors);
                 (void)infra::log_and_return(std::move(res.error()));
             }
         } else if (entry.is_directory()) {
@@ -165,20 +563,48 @@ void CopyEngine::copy_directory(const std::filesystem::path& src_dir,
     }
 }
 
-auto CopyEngine::copy_file(const std::filesystem::path& src,
+auto CopyEngine::copy_file(const ScanEntry& file,
                            const std::filesystem::path& dst)
     -> std::expected<CopyFileResult, infra::Error>
 {
-    if (std::filesystem::exists(dst)) {
-        if (config_.resume) {
+    const auto& src = file.source;
+    const auto started = std::chrono::steady_clock::now();
+    // Способ копирования известен до открытия: операции файла пишутся под ним
+    const auto strategy = file.stat.size > CHUNKED_THRESHOLD ? adapters::fs::CopyStrategy::DirectIO
+                                                              : copy_strategy(file);
+    const auto path = static_cast<CopyPath>(strategy);
+    const infra::OpLatency::Context latency_context(latency_, latency_key(path, file));
+
+    // С --atomic существующий файл заменяется при публикации, и смотреть
+    // на него нужно только ради --resume и --delta
+    const auto publish = config_.atomic ? adapters::fs::Publish::Atomic : adapters::fs::Publish::InPlace;
+    const bool inspect_existing = !config_.atomic || config_.resume || delta_;
+    if (inspect_existing && infra::sys::exists(dst)) {
+        if (config_.resume && !journal_) {
             // Проверяем, можно ли возобновить (по размеру или checksum)
             // Для простоты — пропускаем, если файл полный
-            if (std::filesystem::file_size(src) == std::filesystem::file_size(dst)) {
+            if (file.stat.size == infra::sys::file_size(dst)) {
                 return CopyFileResult{.copied = false}; // файл пропущен
             }
-        } else {
+        } else if (delta_ && file.stat.size > delta_->block_size()
+                   && infra::sys::is_regular_file(dst)) {
+            const infra::OpLatency::Context delta_context(latency_, latency_key(CopyPath::Delta, file));
+            auto res = copy_delta(file, dst, publish);
+            if (res && res->copied) {
+                record_path(CopyPath::Delta, res->bytes_written.value_or(file.stat.size));
+                latency_.record(infra::IoOp::File, latency_key(CopyPath::Delta, file),
+                                std::chrono::steady_clock::now() - started);
+            }
+            if (res || res.error().code != infra::ErrorCode::UnsupportedFeature) {
+                return res;
+            }
+        }
+
+        // Дельта недоступна на платформе — переписываем файл целиком.
+        // С журналом сюда попадают только незавершённые файлы.
+        if ((!config_.resume || journal_) && publish == adapters::fs::Publish::InPlace) {
             std::error_code ec;
-            std::filesystem::remove(dst, ec);
+            infra::sys::remove(dst, ec);
             if (ec) {
                 return std::unexpected(infra::make_error(infra::ErrorCode::PermissionDenied,
                                      fmt::format("Cannot remove existing file: {}", ec.message())));
@@ -186,243 +612,695 @@ auto CopyEngine::copy_file(const std::filesystem::path& src,
         }
     }
 
-    if (std::filesystem::file_size(src) > 100'000'000) { // >100MB
-        // Для больших файлов используем асинхронное копирование с DirectIO
-        const auto strategy = adapters::fs::CopyStrategy::DirectIO;
-        auto future = adapters::fs::copy_file_async(src, dst, strategy);
-        auto res = future.get();
+    const auto on_written = descriptor_hook(file, dst);
+    const auto pacer = io_pacer(file);
+
+    if (file.stat.size > CHUNKED_THRESHOLD) {
+        // Большие файлы — DirectIO через io_uring в этом же потоке, на его кольце
+        auto res = adapters::fs::copy_file_ring(src, dst, strategy, on_written, publish, pacer);
         if (!res) {
             return std::unexpected(std::move(res.error()));
         }
-        
-        if (config_.verify) {
-            auto verify_result = infra::XXHashVerifier::verify_files(src, dst);
-            if (!verify_result) {
-                return std::unexpected(std::move(verify_result.error()));
-            }
-            if (!*verify_result) {
-                return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
-                                     fmt::format("Verification failed for {}", src.string())));
-            }
-        }
-        
-        // Копируем метаданные после успешной верификации
-        if (config_.preserve_metadata) {
-            auto metadata_res = extensions::copy_metadata(src, dst);
-            if (!metadata_res) {
-                spdlog::warn("Failed to copy metadata for {}: {}", 
-                            src.string(), metadata_res.error().message);
-            }
+        record_path(CopyPath::DirectIO, file.stat.size);
+    } else {
+        // Буферизованное копирование для маленьких файлов
+        // Повторяются только временные ошибки (Error::is_transient)
+        auto res = infra::with_retry([&] {
+            return adapters::fs::copy_file(src, dst, strategy, on_written, publish, pacer);
+        }, infra::RetryPolicy{.on_retry = [&](int, const infra::Error&) {
+            path_stats_[static_cast<std::size_t>(path)].add(PathCounter::Retries);
+        }});
+        if (!res) {
+            return std::unexpected(std::move(res.error()));
         }
-        
-        return CopyFileResult{.copied = true};
+        record_path(path, file.stat.size);
+    }
+    if (durability_ && publish == adapters::fs::Publish::Atomic) {
+        durability_->name_published(dst);
     }
 
-    // Буферизованное копирование для маленьких файлов
-    const auto file_size = std::filesystem::file_size(src);
-    const auto strategy = adapters::fs::select_strategy(file_size);
+    auto finished = finish_copy(file, dst, static_cast<bool>(on_written));
+    if (!finished) {
+        return std::unexpected(std::move(finished.error()));
+    }
+    latency_.record(infra::IoOp::File, latency_key(path, file), std::chrono::steady_clock::now() - started);
+
+    return CopyFileResult{.copied = true, .digest = *finished};
+}
 
-    auto res = adapters::fs::copy_file(src, dst, strategy);
-    if (!res) {
-        return std::unexpected(std::move(res.error()));
+void CopyEngine::process_item(const CopyItem& item, const std::filesystem::path& destination) {
+    if (infra::is_interrupted()) {
+        return;
     }
 
-    if (config_.verify) {
-        auto verify_result = infra::XXHashVerifier::verify_files(src, dst);
-        if (!verify_result) {
-            return std::unexpected(std::move(verify_result.error()));
-        }
-        if (!*verify_result) {
-            return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
-                                 fmt::format("Verification failed for {}", src.string())));
-        }
+    // Буферы этого файла ждут места в бюджете; занятые потоки
+    // копирования тормозят очередь, а с ней и сканирование
+    auto reservation = reserve_memory(*item.file);
+    const auto started = std::chrono::steady_clock::now();
+    stats_.add(CopyCounter::FilesStarted);
+    if (item.queued != infra::trace::Clock::time_point{}) {
+        infra::trace::record(infra::trace::Phase::Queue, item.queued, started);
     }
-    
-    // Копируем метаданные после успешной верификации
-    if (config_.preserve_metadata) {
-        auto metadata_res = extensions::copy_metadata(src, dst);
-        if (!metadata_res) {
-            spdlog::warn("Failed to copy metadata for {}: {}", 
-                        src.string(), metadata_res.error().message);
-        }
+    const auto dst = destination / item.file->relative;
+    record_result(*item.file, dst, copy_item(item, dst, reservation), started);
+    if (infra::trace::enabled()) {
+        infra::trace::record(infra::trace::Phase::File, started, infra::trace::Clock::now(), &item.file->source);
     }
+}
 
-    return CopyFileResult{.copied = true};
+auto CopyEngine::copy_item(const CopyItem& item, const std::filesystem::path& dst,
+                           infra::MemoryBudget::Reservation& reservation)
+    -> std::expected<CopyFileResult, infra::Error>
+{
+    const auto& file = *item.file;
+    if (hardlink_registry_ && file.stat.nlink > 1) {
+        return copy_hardlinked(file, dst, reservation);
+    }
+    return item.dedup_candidate ? copy_dedup(file, dst, reservation) : copy_entry(file, dst);
 }
 
-auto CopyEngine::copy_chunked(const std::filesystem::path& src,
-                              const std::filesystem::path& dst)
-    -> std::expected<void, infra::Error>
+void CopyEngine::record_result(const ScanEntry& file, const std::filesystem::path& dst,
+                               std::expected<CopyFileResult, infra::Error> res,
+                               std::chrono::steady_clock::time_point started)
 {
-    const size_t chunk_size = config_.buffer_size.value_or(4 * 1024 * 1024); // 4MB per chunk
-    const auto file_size = std::filesystem::file_size(src);
-    const size_t num_chunks = (file_size + chunk_size - 1) / chunk_size;
-    
-    // Для маленьких файлов или если threads == 1, используем однопоточное копирование
-    const size_t num_threads = config_.threads.value_or(1);
-    if (num_threads == 1 || num_chunks <= 1) {
-        // Используем асинхронное копирование даже для однопоточного режима
-        const auto strategy = adapters::fs::CopyStrategy::DirectIO;
-        auto future = adapters::fs::copy_file_async(src, dst, strategy);
-        auto res = future.get();
-        if (!res) return res;
-        
-        if (config_.verify) {
-            auto verify_result = infra::XXHashVerifier::verify_files(src, dst);
-            if (!verify_result) {
-                return std::unexpected(std::move(verify_result.error()));
+    const auto file_size = file.stat.size;
+    file_latency_.record(std::chrono::steady_clock::now() - started);
+    stats_.add(CopyCounter::FilesFinished);
+    if (res) {
+        if (res->copied) {
+            stats_.add(CopyCounter::FilesCopied);
+            stats_.add(CopyCounter::BytesCopied, file_size);
+            stats_.add(CopyCounter::BytesWritten, res->bytes_written.value_or(file_size));
+            if (journal_) {
+                journal_->file_done(extensions::SyncIndex::path_hash(file.relative),
+                                    file.stat.size, file.stat.mtime_ns, dst);
             }
-            if (!*verify_result) {
-                return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
-                                     fmt::format("Chunked copy verification failed for {}", src.string())));
+        } else {
+            stats_.add(CopyCounter::FilesSkipped);
+        }
+        if (sync_builder_) {
+            sync_builder_->record(extensions::SyncIndexEntry{
+                .path_hash = extensions::SyncIndex::path_hash(file.relative),
+                .size = file.stat.size,
+                .mtime_ns = file.stat.mtime_ns,
+                .inode = file.stat.inode,
+                .content_hash = res->digest ? res->digest->hash : 0
+            });
+        }
+        monitor_.update(1, file_size);
+    } else {
+        stats_.add(CopyCounter::Errors);
+        (void)infra::log_and_return(std::move(res.error()));
+        monitor_.update(1, 0); // учитываем файл как обработанный
+    }
+}
+
+auto CopyEngine::copy_entry(const ScanEntry& file,
+                            const std::filesystem::path& dst)
+    -> std::expected<CopyFileResult, infra::Error>
+{
+    if (journal_ && file.stat.size > CHUNKED_THRESHOLD) {
+        return copy_chunked(file, dst);
+    }
+    return copy_file(file, dst);
+}
+
+auto CopyEngine::copy_dedup(const ScanEntry& file,
+                            const std::filesystem::path& dst,
+                            infra::MemoryBudget::Reservation& reservation)
+    -> std::expected<CopyFileResult, infra::Error>
+{
+    auto key = extensions::content_key(file.source, file.stat.size);
+    if (!key) {
+        return std::unexpected(std::move(key.error()));
+    }
+
+    auto claim = dedup_registry_->claim(*key);
+    if (claim.owner) {
+        auto res = copy_entry(file, dst);
+        dedup_registry_->publish(*key, res && res->copied ? std::optional(dst) : std::nullopt);
+        return res;
+    }
+
+    // Ждём, пока владелец допишет свою копию, и ссылаемся на неё. Бюджет
+    // на это время отпускается: владелец может сам ждать его (copy_chunked)
+    reservation.release();
+    const auto origin = claim.origin.get();
+    if (origin) {
+        std::error_code ec;
+        infra::sys::remove(dst, ec);
+        auto linked = extensions::link_file(*origin, dst, config_.dedup_policy);
+        if (linked) {
+            auto finished = finish_copy(file, dst);
+            if (!finished) {
+                return std::unexpected(std::move(finished.error()));
             }
+            stats_.add(CopyCounter::BytesDeduped, file.stat.size);
+            return CopyFileResult{.copied = true, .digest = *finished, .bytes_written = 0};
         }
-        
-        // Копируем метаданные после успешной верификации
-        if (config_.preserve_metadata) {
-            auto metadata_res = extensions::copy_metadata(src, dst);
-            if (!metadata_res) {
-                spdlog::warn("Failed to copy metadata for {}: {}", 
-                            src.string(), metadata_res.error().message);
+        spdlog::debug("{}, copying instead", linked.error().message);
+    }
+    reservation = reserve_memory(file);
+    return copy_entry(file, dst);
+}
+
+auto CopyEngine::copy_hardlinked(const ScanEntry& file,
+                                 const std::filesystem::path& dst,
+                                 infra::MemoryBudget::Reservation& reservation)
+    -> std::expected<CopyFileResult, infra::Error>
+{
+    const extensions::InodeKey key{.device = file.stat.device, .inode = file.stat.inode};
+    auto claim = hardlink_registry_->claim(key);
+    if (claim.owner) {
+        auto res = copy_entry(file, dst);
+        hardlink_registry_->publish(key, res && res->copied ? std::optional(dst) : std::nullopt);
+        return res;
+    }
+
+    // Остальные имена того же inode — ссылки на первую копию;
+    // её ждём без бюджета, как и в copy_dedup
+    reservation.release();
+    const auto origin = claim.origin.get();
+    if (origin) {
+        std::error_code ec;
+        infra::sys::remove(dst, ec);
+        auto linked = extensions::link_file(*origin, dst, infra::DedupPolicy::Hardlink);
+        if (linked) {
+            auto finished = finish_copy(file, dst);
+            if (!finished) {
+                return std::unexpected(std::move(finished.error()));
             }
+            stats_.add(CopyCounter::Hardlinks);
+            return CopyFileResult{.copied = true, .digest = *finished, .bytes_written = 0};
         }
-        
-        return {};
+        spdlog::warn("{}, copying instead", linked.error().message);
+    }
+    reservation = reserve_memory(file);
+    return copy_entry(file, dst);
+}
+
+auto CopyEngine::copy_delta(const ScanEntry& file,
+                            const std::filesystem::path& dst,
+                            adapters::fs::Publish publish)
+    -> std::expected<CopyFileResult, infra::Error>
+{
+    infra::trace::Span span(infra::trace::Phase::Delta);
+    auto delta = delta_->copy(file.source, dst, publish);
+    if (!delta) {
+        return std::unexpected(std::move(delta.error()));
+    }
+
+    auto finished = finish_copy(file, dst);
+    if (!finished) {
+        return std::unexpected(std::move(finished.error()));
+    }
+
+    // Кэш пишется после метаданных: его ключ — итоговые size/mtime/inode
+    if (auto cached = delta_->store_cache(dst, delta->block_signatures); !cached) {
+        spdlog::warn("Failed to store block cache for {}: {}", dst.string(), cached.error().message);
+    }
+
+    return CopyFileResult{.copied = true, .digest = *finished, .bytes_written = delta->bytes_written};
+}
+
+auto CopyEngine::copy_chunked(const ScanEntry& file,
+                              const std::filesystem::path& dst)
+    -> std::expected<CopyFileResult, infra::Error>
+{
+    const auto started = std::chrono::steady_clock::now();
+    const infra::OpLatency::Context latency_context(latency_, latency_key(CopyPath::Chunked, file));
+    const std::uint64_t chunk_size = config_.buffer_size.value_or(4 * 1024 * 1024); // 4MB per chunk
+    const auto file_size = file.stat.size;
+    const auto mtime_ns = file.stat.mtime_ns;
+    const auto num_chunks = static_cast<std::size_t>((file_size + chunk_size - 1) / chunk_size);
+    const auto key = extensions::SyncIndex::path_hash(file.relative);
+
+    // Продолжаем с последнего записанного чанка, если журнал знает этот файл
+    auto completed = journal_->completed_chunks(key, file_size, mtime_ns, chunk_size);
+    if (!completed.empty() && !infra::sys::exists(dst)) {
+        completed.clear();
     }
 
-    // Создаём выходной файл нужного размера
-    {
-        std::ofstream ofs(dst, std::ios::binary);
-        if (!ofs) {
-            return std::unexpected(infra::make_error(infra::ErrorCode::FileNotFound, 
-                                 "Cannot create destination file"));
+    if (completed.empty()) {
+        completed.assign(num_chunks, false);
+
+        // Создаём выходной файл нужного размера
+        {
+            std::ofstream ofs(dst, std::ios::binary | std::ios::trunc);
+            infra::sys::note(infra::sys::Syscall::Open, !ofs);
+            if (!ofs) {
+                return std::unexpected(infra::make_error(infra::ErrorCode::FileNotFound,
+                                     fmt::format("Cannot create destination file: {}", dst.string())));
+            }
+        }
+        std::error_code ec;
+        infra::sys::resize_file(dst, file_size, ec);
+        if (ec) {
+            return std::unexpected(infra::make_error(infra::ErrorCode::DiskFull,
+                                 fmt::format("Cannot preallocate {}: {}", dst.string(), ec.message())));
         }
-        // Устанавливаем размер файла
-        ofs.seekp(file_size - 1);
-        ofs.write("", 1);
+        journal_->file_begin(key, file_size, mtime_ns, chunk_size, dst);
+    } else {
+        const auto done = std::count(completed.begin(), completed.end(), true);
+        spdlog::info("Resuming {}: {} of {} chunks already copied", dst.string(), done, num_chunks);
     }
 
-    // Многопоточное копирование чанков
+    // Чанки раздаются диапазонами во вспомогательный пул; каждая задача
+    // держит свои потоки чтения/записи. Чанк попадает в журнал после записи,
+    // а на диск — только после сброса своих данных (JobJournal::commit).
+    std::atomic<std::uint64_t> bytes_written{0};
+    const auto pacer = io_pacer(file);
+    const std::size_t chunks_per_task = static_cast<std::size_t>(
+        std::max<std::uint64_t>(1, (64ull * 1024 * 1024) / chunk_size));
     std::vector<std::future<std::expected<void, infra::Error>>> futures;
-    std::vector<int> completed_chunks;
-    std::mutex completed_mutex;
-    futures.reserve(num_chunks);
 
-    for (size_t i = 0; i < num_chunks; ++i) {
-        futures.push_back(std::async(std::launch::async, [&, i, chunk_size, file_size]() 
+    for (std::size_t first = 0; first < num_chunks; first += chunks_per_task) {
+        const std::size_t last = std::min(num_chunks, first + chunks_per_task);
+        // Бюджет буфера берётся здесь, а не в задаче: задача, ждущая
+        // бюджета, заняла бы поток hash_pool_, нужный хешированию
+        auto reservation = memory_budget_ ? memory_budget_->acquire(chunk_size)
+                                          : infra::MemoryBudget::Reservation{};
+        futures.push_back(hash_pool_->enqueue_with_future([&, first, last,
+                                                           reservation = std::move(reservation),
+                                                           cancel = infra::CancelScope::current()]() mutable
             -> std::expected<void, infra::Error> {
-            
-            if (infra::is_interrupted()) {
-                return std::unexpected(infra::make_error(infra::ErrorCode::Interrupted, "Interrupted"));
+            // Бюджет отпускается с концом задачи: сама лямбда живёт в общем
+            // состоянии future, пока цикл ниже не дождётся всех задач
+            const auto held = std::move(reservation);
+            const infra::OpLatency::Context latency_context(latency_, latency_key(CopyPath::Chunked, file));
+            const infra::CancelScope cancel_scope(cancel);
+
+            // Потоки ввода-вывода не ходят через обёртки sys: их вызовы
+            // учитываются по операциям потока
+            std::ifstream ifs(file.source, std::ios::binary);
+            infra::sys::note(infra::sys::Syscall::Open, !ifs);
+            if (!ifs) {
+                return std::unexpected(infra::make_error(infra::ErrorCode::FileNotFound,
+                                         "Cannot open source file"));
+            }
+            std::fstream ofs(dst, std::ios::binary | std::ios::in | std::ios::out);
+            infra::sys::note(infra::sys::Syscall::Open, !ofs);
+            if (!ofs) {
+                return std::unexpected(infra::make_error(infra::ErrorCode::FileNotFound,
+                                         "Cannot open destination file"));
             }
 
-            const size_t offset = i * chunk_size;
-            const size_t current_chunk_size = std::min(chunk_size, file_size - offset);
-            
-            std::vector<char> buffer(current_chunk_size);
-
-            // Читаем чанк из исходного файла
-            {
-                std::ifstream ifs(src, std::ios::binary);
-                if (!ifs) {
-                    return std::unexpected(infra::make_error(infra::ErrorCode::FileNotFound, 
-                                             "Cannot open source file"));
+            std::vector<char> buffer(chunk_size);
+            for (std::size_t i = first; i < last; ++i) {
+                if (completed[i]) continue;
+                if (infra::is_interrupted()) {
+                    return std::unexpected(infra::make_error(infra::ErrorCode::Interrupted, "Interrupted"));
                 }
-                
-                ifs.seekg(offset);
-                if (!ifs.read(buffer.data(), current_chunk_size)) {
-                    return std::unexpected(infra::make_error(infra::ErrorCode::Unknown, 
+
+                const std::uint64_t offset = i * chunk_size;
+                const auto current_chunk_size = static_cast<std::streamsize>(std::min(chunk_size, file_size - offset));
+
+                ifs.seekg(static_cast<std::streamoff>(offset));
+                const bool got = [&] {
+                    infra::trace::Span span(infra::trace::Phase::Read);
+                    infra::OpTimer timer(infra::IoOp::Read);
+                    return static_cast<bool>(ifs.read(buffer.data(), current_chunk_size));
+                }();
+                infra::sys::note(infra::sys::Syscall::Read, !got);
+                if (!got) {
+                    return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
                                              fmt::format("Read error at offset {}", offset)));
                 }
-            }
+                pacer.read(static_cast<std::uint64_t>(current_chunk_size));
+                pacer.write(static_cast<std::uint64_t>(current_chunk_size));
 
-            // Записываем чанк в выходной файл
-            {
-                std::fstream ofs(dst, std::ios::binary | std::ios::in | std::ios::out);
-                if (!ofs) {
-                    return std::unexpected(infra::make_error(infra::ErrorCode::FileNotFound, 
-                                             "Cannot open destination file"));
-                }
-                
-                ofs.seekp(offset);
-                if (!ofs.write(buffer.data(), current_chunk_size)) {
-                    return std::unexpected(infra::make_error(infra::ErrorCode::Unknown, 
+                ofs.seekp(static_cast<std::streamoff>(offset));
+                const bool put = [&] {
+                    infra::trace::Span span(infra::trace::Phase::Write);
+                    infra::OpTimer timer(infra::IoOp::Write);
+                    return ofs.write(buffer.data(), current_chunk_size) && ofs.flush();
+                }();
+                infra::sys::note(infra::sys::Syscall::Write, !put);
+                if (!put) {
+                    return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
                                              fmt::format("Write error at offset {}", offset)));
                 }
+
+                infra::note_written(static_cast<std::uint64_t>(current_chunk_size));
+                journal_->chunk_done(key, file_size, mtime_ns, i, dst);
+                bytes_written.fetch_add(static_cast<std::uint64_t>(current_chunk_size), std::memory_order_relaxed);
             }
-            
-            // Отмечаем чанк как завершённый
-            {
-                std::lock_guard lock(completed_mutex);
-                completed_chunks.push_back(static_cast<int>(i));
-            }
-            
             return {};
         }));
     }
 
-    // Ждём завершения всех futures и проверяем ошибки
-    std::uint64_t copied_bytes = 0;
-    for (size_t i = 0; i < futures.size(); ++i) {
-        auto result = futures[i].get();
-        if (!result) {
-            // При ошибке сохраняем resume info
-            if (config_.resume) {
-                extensions::ResumeInfo resume_info{
-                    .source = src,
-                    .destination = dst,
-                    .copied_bytes = copied_bytes,
-                    .total_bytes = file_size,
-                    .completed_chunks = completed_chunks
-                };
-                extensions::save_resume_info(resume_info);
-                spdlog::info("Saved resume info to .cclone.resume");
+    // Ждём все задачи; при ошибке файл назначения остаётся на месте —
+    // записанные чанки продолжатся при следующем запуске
+    std::optional<infra::Error> first_error;
+    for (auto& future : futures) {
+        auto result = future.get();
+        if (!result && !first_error) first_error = std::move(result.error());
+    }
+    if (first_error) {
+        return std::unexpected(std::move(*first_error));
+    }
+
+    auto finished = finish_copy(file, dst);
+    if (!finished) {
+        return std::unexpected(std::move(finished.error()));
+    }
+
+    record_path(CopyPath::Chunked, bytes_written.load());
+    latency_.record(infra::IoOp::File, latency_key(CopyPath::Chunked, file), std::chrono::steady_clock::now() - started);
+    return CopyFileResult{.copied = true, .digest = *finished, .bytes_written = bytes_written.load()};
+}
+
+bool CopyEngine::metadata_on_descriptor() const {
+    // С верификацией метаданные по-прежнему ставятся после неё (finish_copy)
+    return adapters::fs::DESCRIPTOR_HOOKS && config_.preserve_metadata && !config_.verify;
+}
+
+auto CopyEngine::numa_worker_init(const std::vector<std::filesystem::path>& sources,
+                                  const std::filesystem::path& destination) const
+    -> std::function<void(std::size_t)>
+{
+    if (config_.numa == infra::NumaPolicy::Off) {
+        return {};
+    }
+    auto topology = infra::NumaTopology::discover();
+    if (topology.node_count() < 2) {
+        spdlog::debug("NUMA: single node, workers are not pinned");
+        return {};
+    }
+
+    // device: узлы контроллеров, к которым идёт ввод-вывод; остальное — по кругу
+    std::vector<int> nodes;
+    if (config_.numa == infra::NumaPolicy::Device) {
+        auto add_device_node = [&](const std::filesystem::path& path) {
+            const auto st = adapters::fs::stat_file(path);
+            if (!st) return;
+            const auto node = topology.device_node(st->device);
+            if (node && std::find(nodes.begin(), nodes.end(), *node) == nodes.end()) {
+                nodes.push_back(*node);
             }
-            std::filesystem::remove(dst);
-            return result;
+        };
+        for (const auto& src : sources) add_device_node(src);
+        add_device_node(destination);
+        if (nodes.empty()) {
+            spdlog::info("NUMA: sysfs does not report device nodes, spreading workers");
         }
-        copied_bytes += std::min(chunk_size, file_size - i * chunk_size);
     }
+    if (nodes.empty()) {
+        for (const auto& node : topology.nodes()) nodes.push_back(node.id);
+    }
+    spdlog::info("NUMA: {} nodes, workers pinned to node(s) {}", topology.node_count(), fmt::join(nodes, ","));
 
-    if (infra::is_interrupted()) {
-        // Сохраняем resume info при прерывании
-        if (config_.resume) {
-            extensions::ResumeInfo resume_info{
-                .source = src,
-                .destination = dst,
-                .copied_bytes = copied_bytes,
-                .total_bytes = file_size,
-                .completed_chunks = completed_chunks
-            };
-            extensions::save_resume_info(resume_info);
-            spdlog::info("Interrupted: Saved resume info to .cclone.resume");
-        }
-        std::filesystem::remove(dst);
-        return std::unexpected(infra::make_error(infra::ErrorCode::Interrupted, 
-                             "Interrupted during chunked copy"));
+    // Буферы рабочих (thread_io_buffer) выделяются уже на закреплённом узле
+    return [topology = std::move(topology), nodes = std::move(nodes)](std::size_t worker) {
+        const auto* node = topology.find(nodes[worker % nodes.size()]);
+        if (auto pinned = infra::pin_current_thread(node->cpus); !pinned) {
+            spdlog::debug("NUMA: {}", pinned.error().message);
+        }
+    };
+}
+
+auto CopyEngine::copy_strategy(const ScanEntry& file) const -> adapters::fs::CopyStrategy {
+    const auto strategy = adapters::fs::select_strategy(file.stat.size);
+    // Отображение целиком не помещается в долю потока — копируем через буфер
+    if (memory_share_ != 0 && strategy == adapters::fs::CopyStrategy::MMap
+        && adapters::fs::buffer_footprint(strategy, file.stat.size) > memory_share_) {
+        return adapters::fs::CopyStrategy::Buffered;
+    }
+    return strategy;
+}
+
+auto CopyEngine::io_sampler(const std::vector<std::filesystem::path>& sources,
+                            const std::filesystem::path& destination) const
+    -> infra::ConcurrencyController::Sampler
+{
+    // Задержка — по устройствам источника и назначения вместе
+    std::vector<std::uint64_t> devices;
+    auto add_device = [&](const std::filesystem::path& path) {
+        const auto st = adapters::fs::stat_file(path);
+        if (st && std::find(devices.begin(), devices.end(), st->device) == devices.end()
+            && infra::read_device_counters(st->device)) {
+            devices.push_back(st->device);
+        }
+    };
+    for (const auto& src : sources) add_device(src);
+    add_device(destination);
+    if (devices.empty() && config_.latency_ceiling_ms) {
+        spdlog::warn("Adaptive concurrency: no block device statistics, --latency-ceiling is ignored");
+    }
+
+    return [this, devices = std::move(devices)] {
+        infra::ConcurrencyController::Sample sample;
+        // Байты каждой записи этого задания; BytesWritten растёт лишь по
+        // завершении файлов, а wchar процесса не видит записей io_uring
+        // и включает чужие (журнал, метрики, другие задания демона)
+        sample.bytes = latency_.written();
+        for (const auto device : devices) {
+            if (const auto counters = infra::read_device_counters(device)) {
+                sample.ios = sample.ios.value_or(0) + counters->ios;
+                sample.io_ticks_ms += counters->ticks_ms;
+            }
+        }
+        return sample;
+    };
+}
+
+static_assert(static_cast<std::size_t>(adapters::fs::CopyStrategy::Buffered) == static_cast<std::size_t>(CopyPath::Buffered)
+              && static_cast<std::size_t>(adapters::fs::CopyStrategy::MMap) == static_cast<std::size_t>(CopyPath::MMap)
+              && static_cast<std::size_t>(adapters::fs::CopyStrategy::DirectIO) == static_cast<std::size_t>(CopyPath::DirectIO)
+              && static_cast<std::size_t>(adapters::fs::CopyStrategy::Async) == static_cast<std::size_t>(CopyPath::Async),
+              "CopyPath must start with CopyStrategy");
+
+auto CopyEngine::latency_key(CopyPath path, const ScanEntry& file) -> infra::LatencyKey {
+    return infra::LatencyKey{.path = static_cast<std::size_t>(path), .size = infra::size_class(file.stat.size)};
+}
+
+void CopyEngine::record_path(CopyPath path, std::uint64_t bytes) {
+    auto& counters = path_stats_[static_cast<std::size_t>(path)];
+    counters.add(PathCounter::Files);
+    counters.add(PathCounter::Bytes, bytes);
+}
+
+auto CopyEngine::metrics_snapshot(const infra::BoundedQueue<CopyItem>& queue) const -> infra::MetricsSnapshot {
+    const auto totals = stats_.load_all();
+    const auto total = [&](CopyCounter counter) {
+        return static_cast<double>(totals[static_cast<std::size_t>(counter)]);
+    };
+
+    infra::MetricsSnapshot snapshot;
+    snapshot.counter("cclone_files_copied_total", "Files copied", total(CopyCounter::FilesCopied));
+    snapshot.counter("cclone_files_skipped_total", "Files skipped as unchanged", total(CopyCounter::FilesSkipped));
+    snapshot.counter("cclone_errors_total", "Files that failed to copy", total(CopyCounter::Errors));
+    snapshot.counter("cclone_bytes_copied_total", "Logical size of copied files", total(CopyCounter::BytesCopied));
+    snapshot.counter("cclone_bytes_written_total", "Bytes actually written", total(CopyCounter::BytesWritten));
+    snapshot.counter("cclone_bytes_deduped_total", "Bytes not written thanks to --dedup",
+                     total(CopyCounter::BytesDeduped));
+    snapshot.counter("cclone_hardlinks_total", "Hard links recreated", total(CopyCounter::Hardlinks));
+
+    for (std::size_t path = 0; path < PATH_LABELS.size(); ++path) {
+        const auto counters = path_stats_[path].load_all();
+        const infra::MetricsSnapshot::Labels labels{{"strategy", std::string(PATH_LABELS[path])}};
+        snapshot.counter("cclone_strategy_files_total", "Files copied by strategy",
+                         static_cast<double>(counters[static_cast<std::size_t>(PathCounter::Files)]), labels);
+        snapshot.counter("cclone_strategy_bytes_total", "Bytes copied by strategy",
+                         static_cast<double>(counters[static_cast<std::size_t>(PathCounter::Bytes)]), labels);
+        snapshot.counter("cclone_retries_total", "Retried transient failures by strategy",
+                         static_cast<double>(counters[static_cast<std::size_t>(PathCounter::Retries)]), labels);
     }
 
+    const auto progress = monitor_.get_stats();
+    snapshot.gauge("cclone_files_planned", "Files found by the scan to copy", static_cast<double>(progress.total_files));
+    snapshot.gauge("cclone_bytes_planned", "Bytes found by the scan to copy", static_cast<double>(progress.total_bytes));
+    snapshot.gauge("cclone_files_in_flight", "Files being copied right now",
+                   std::max(0.0, total(CopyCounter::FilesStarted) - total(CopyCounter::FilesFinished)));
+    snapshot.gauge("cclone_copy_queue_depth", "Scanned files waiting for a worker",
+                   static_cast<double>(queue.size_approx()));
+    if (memory_budget_) {
+        snapshot.gauge("cclone_memory_in_use_bytes", "I/O buffers reserved under --max-memory",
+                       static_cast<double>(memory_budget_->in_use()));
+        snapshot.counter("cclone_memory_stalls_total", "Waits for --max-memory budget",
+                         static_cast<double>(memory_budget_->stalls()));
+    }
+    snapshot.histogram("cclone_file_copy_duration_seconds", "Time to copy one file", file_latency_.snapshot());
+
+    const auto syscalls = infra::sys::snapshot();
+    for (std::size_t i = 0; i < infra::sys::SYSCALL_COUNT; ++i) {
+        if (syscalls.calls[i] == 0) continue;
+        const infra::MetricsSnapshot::Labels labels{
+            {"syscall", std::string(infra::sys::syscall_name(static_cast<infra::sys::Syscall>(i)))}};
+        snapshot.counter("cclone_syscalls_total", "Filesystem syscalls made by the process",
+                         static_cast<double>(syscalls.calls[i]), labels);
+        snapshot.counter("cclone_syscall_errors_total", "Filesystem syscalls that failed",
+                         static_cast<double>(syscalls.errors[i]), labels);
+    }
+    return snapshot;
+}
+
+auto CopyEngine::io_pacer(const ScanEntry& file) -> infra::IoPacer {
+    return io_limiter_ ? io_limiter_->pacer(file.stat.device, destination_device_) : infra::IoPacer{};
+}
+
+auto CopyEngine::memory_footprint(const ScanEntry& file, bool async) const -> std::uint64_t {
+    const auto size = file.stat.size;
+    // Чанки резервируют свои буферы сами (copy_chunked)
+    if (journal_ && size > CHUNKED_THRESHOLD) return 0;
+
+    const auto strategy = size > CHUNKED_THRESHOLD ? adapters::fs::CopyStrategy::DirectIO : copy_strategy(file);
+    auto bytes = async ? std::min<std::uint64_t>(size, ASYNC_BUFFER_SIZE)
+                       : adapters::fs::buffer_footprint(strategy, size);
+    // Последовательное хеширование для --verify и манифеста читает своим буфером
+    if ((config_.verify && config_.verify_mode == infra::VerifyMode::Hash) || manifest_) {
+        bytes += std::min<std::uint64_t>(size, infra::XXHashVerifier::BUFFER_SIZE);
+    }
+    return bytes;
+}
+
+auto CopyEngine::reserve_memory(const ScanEntry& file) -> infra::MemoryBudget::Reservation {
+    return memory_budget_ ? memory_budget_->acquire(memory_footprint(file)) : infra::MemoryBudget::Reservation{};
+}
+
+auto CopyEngine::descriptor_hook(const ScanEntry& file, const std::filesystem::path& dst) const
+    -> adapters::fs::DescriptorHook
+{
+    // Метаданные ставятся на ещё открытый дескриптор назначения — без
+    // повторного stat источника и разрешения путей
+    const bool metadata = metadata_on_descriptor();
+    if (!metadata && !durability_) {
+        return {};
+    }
+    return [this, &file, &dst, metadata](int src_fd, int dst_fd) -> std::expected<void, infra::Error> {
+        if (metadata) {
+            infra::trace::Span span(infra::trace::Phase::Metadata);
+            infra::OpTimer timer(infra::IoOp::Metadata);
+            if (auto applied = extensions::apply_metadata(src_fd, dst_fd, file.stat); !applied) {
+                spdlog::warn("Failed to copy metadata for {}: {}", file.source.string(), applied.error().message);
+            }
+        }
+        if (durability_) {
+            infra::trace::Span span(infra::trace::Phase::Fsync);
+            infra::OpTimer timer(infra::IoOp::Fsync);
+            return durability_->file_written(dst_fd, dst);
+        }
+        return {};
+    };
+}
+
+auto CopyEngine::finish_copy(const ScanEntry& file,
+                             const std::filesystem::path& dst,
+                             bool via_descriptor)
+    -> std::expected<std::optional<ContentDigest>, infra::Error>
+{
+    const auto& src = file.source;
+    std::optional<ContentDigest> digest;
     if (config_.verify) {
-        auto verify_result = infra::XXHashVerifier::verify_files(src, dst);
+        infra::trace::Span span(infra::trace::Phase::Verify);
+        auto verify_result = verify_copy(src, dst);
         if (!verify_result) {
             return std::unexpected(std::move(verify_result.error()));
         }
-        if (!*verify_result) {
-            return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
-                                 fmt::format("Chunked verification failed for {}", src.string())));
-        }
+        digest = *verify_result;
     }
-    
+
     // Копируем метаданные после успешной верификации
-    if (config_.preserve_metadata) {
-        auto metadata_res = extensions::copy_metadata(src, dst);
+    if (config_.preserve_metadata && !(via_descriptor && metadata_on_descriptor())) {
+        infra::trace::Span span(infra::trace::Phase::Metadata);
+        infra::OpTimer timer(infra::IoOp::Metadata);
+        auto metadata_res = extensions::copy_metadata(src, dst, file.stat);
         if (!metadata_res) {
             spdlog::warn("Failed to copy metadata for {}: {}", 
                         src.string(), metadata_res.error().message);
         }
     }
 
-    return {};
+    if (durability_ && !via_descriptor) {
+        infra::trace::Span span(infra::trace::Phase::Fsync);
+        infra::OpTimer timer(infra::IoOp::Fsync);
+        if (auto synced = durability_->file_written(dst); !synced) {
+            return std::unexpected(std::move(synced.error()));
+        }
+    }
+
+    if (manifest_) {
+        // Хеш, посчитанный при верификации, переиспользуется;
+        // без него хешируем уже записанный (и ещё горячий в кэше) файл
+        if (!digest) {
+            auto computed = digest_file(dst);
+            if (!computed) {
+                return std::unexpected(std::move(computed.error()));
+            }
+            digest = *computed;
+        }
+        auto entry = extensions::make_manifest_entry(dst.lexically_relative(destination_root_), dst,
+                                                     digest->hash, digest->segment_size);
+        if (!entry) {
+            return std::unexpected(std::move(entry.error()));
+        }
+        manifest_->append(std::move(*entry));
+    }
+
+    return digest;
+}
+
+auto CopyEngine::digest_file(const std::filesystem::path& path)
+    -> std::expected<ContentDigest, infra::Error>
+{
+    infra::trace::Span span(infra::trace::Phase::Hash);
+    std::error_code ec;
+    const auto file_size = infra::sys::file_size(path, ec);
+    const std::uint64_t segment_size = config_.hash_segment_size.value_or(
+        infra::TreeHasher::DEFAULT_SEGMENT_SIZE);
+
+    // Файлы от двух сегментов хешируются параллельно по дереву,
+    // остальные — последовательно
+    if (!ec && hash_pool_ && file_size >= 2 * segment_size) {
+        infra::TreeHasher hasher(*hash_pool_, segment_size);
+        auto digest = hasher.hash_file(path);
+        if (!digest) {
+            return std::unexpected(std::move(digest.error()));
+        }
+        return ContentDigest{.hash = digest->root, .segment_size = segment_size};
+    }
+
+    auto hash = infra::XXHashVerifier::hash_file(path);
+    if (!hash) {
+        return std::unexpected(std::move(hash.error()));
+    }
+    return ContentDigest{.hash = *hash, .segment_size = 0};
+}
+
+auto CopyEngine::verify_copy(const std::filesystem::path& src,
+                             const std::filesystem::path& dst)
+    -> std::expected<std::optional<ContentDigest>, infra::Error>
+{
+    if (config_.verify_mode == infra::VerifyMode::Compare) {
+        auto compare_result = infra::ByteComparator::compare_files(src, dst);
+        if (!compare_result) {
+            return std::unexpected(std::move(compare_result.error()));
+        }
+        if (!compare_result->equal) {
+            return std::unexpected(infra::make_error(infra::ErrorCode::ChecksumMismatch,
+                                 fmt::format("Verification failed for {}: first difference at offset {}",
+                                             src.string(), compare_result->first_mismatch.value_or(0))));
+        }
+        return std::nullopt;
+    }
+
+    auto src_digest = digest_file(src);
+    if (!src_digest) {
+        return std::unexpected(std::move(src_digest.error()));
+    }
+    auto dst_digest = digest_file(dst);
+    if (!dst_digest) {
+        return std::unexpected(std::move(dst_digest.error()));
+    }
+
+    if (src_digest->hash != dst_digest->hash) {
+        spdlog::warn("Hash mismatch: {} (src: {:016x}) vs {} (dst: {:016x})",
+                     src.string(), src_digest->hash,
+                     dst.string(), dst_digest->hash);
+        return std::unexpected(infra::make_error(infra::ErrorCode::ChecksumMismatch,
+                             fmt::format("Verification failed for {}", src.string())));
+    }
+    return *src_digest;
 }
 
 bool CopyEngine::should_exclude(const std::filesystem::path& path) const {
@@ -2,68 +2,292 @@
 
 #include <filesystem>
 #include <string>
+#include <array>
 #include <vector>
 #include <expected>
 #include <atomic>
+#include <memory>
+#include <optional>
+#include <functional>
 #include "../../infra/config/config.hpp"
 #include "../../infra/error_handler/error.hpp"
 #include "../../infra/monitoring/monitoring.hpp"
+#include "../../infra/monitoring/metrics.hpp"
+#include "../../infra/monitoring/op_latency.hpp"
+#include "../../infra/syscall/syscalls.hpp"
 #include "../../infra/thread_pool/thread_pool.hpp"
+#include "../../infra/thread_pool/work_stealing_pool.hpp"
+#include "../../infra/thread_pool/fair_pool.hpp"
+#include "../../infra/concurrent/bounded_queue.hpp"
+#include "../../infra/concurrent/memory_budget.hpp"
+#include "../../infra/concurrent/concurrency_gate.hpp"
+#include "../../infra/concurrent/sharded_counters.hpp"
+#include "../../infra/tuning/concurrency_controller.hpp"
+#include "../../infra/async/task.hpp"
+#include "../../infra/throttle/io_limiter.hpp"
+#include "../../extensions/manifest.hpp"
+#include "../../extensions/sync_index.hpp"
+#include "../../extensions/delta.hpp"
+#include "../../extensions/journal.hpp"
+#include "../../extensions/dedup.hpp"
+#include "../../extensions/origin_registry.hpp"
+#include "../../extensions/durability.hpp"
+#include "../../adapters/file_stat.hpp"
+#include "../../adapters/fs.hpp"
+#include "../../adapters/io_reactor.hpp"
 
 namespace cclone::core {
 
+// Хеш содержимого в том виде, в каком его считает движок
+struct ContentDigest {
+    std::uint64_t hash = 0;
+    std::uint64_t segment_size = 0; // 0 — плоский XXH3, иначе корень TreeHasher
+};
+
 struct CopyFileResult {
     bool copied = true; // true если файл скопирован, false если пропущен
+    std::optional<ContentDigest> digest; // если хеш считался (verify / manifest)
+    std::optional<std::uint64_t> bytes_written; // при дельта-передаче; иначе записан весь файл
+};
+
+// Файл, найденный при сканировании
+struct ScanEntry {
+    std::filesystem::path source;
+    std::filesystem::path relative; // путь относительно корня назначения
+    adapters::fs::FileStat stat;
 };
 
 struct CopyStatsSnapshot {
     std::uint64_t files_copied = 0;
-    std::uint64_t bytes_copied = 0;
+    std::uint64_t bytes_copied = 0;   // логический объём скопированных файлов
+    std::uint64_t bytes_written = 0;  // фактически записано (меньше при --delta)
+    std::uint64_t bytes_deduped = 0;  // не записано благодаря ссылкам на дубликаты (--dedup)
+    std::uint64_t hardlinks = 0;      // воссозданные жёсткие ссылки источника (--hard-links)
     std::uint64_t files_skipped = 0;
     std::uint64_t errors = 0;
+    std::vector<infra::LatencySummary> latency;  // квантили задержек операций
+    infra::sys::Counts syscalls;                 // системные вызовы за прогон
 };
 
-struct CopyStats {
-    std::atomic<std::uint64_t> files_copied{0};
-    std::atomic<std::uint64_t> bytes_copied{0};
-    std::atomic<std::uint64_t> files_skipped{0};
-    std::atomic<std::uint64_t> errors{0};
-    
-    // Конструктор по умолчанию
-    CopyStats() = default;
-    
-    // Запрещаем копирование и перемещение (из-за atomic)
-    CopyStats(const CopyStats&) = delete;
-    CopyStats& operator=(const CopyStats&) = delete;
-    CopyStats(CopyStats&&) = delete;
-    CopyStats& operator=(CopyStats&&) = delete;
+// Счётчики движка; рабочие прибавляют к своим шардам, снимок суммирует
+enum class CopyCounter : std::size_t {
+    FilesCopied,
+    BytesCopied,
+    BytesWritten,
+    BytesDeduped,
+    Hardlinks,
+    FilesSkipped,
+    Errors,
+    FilesStarted,   // в полёте = начатые − завершённые
+    FilesFinished,
+    Count
+};
+
+using CopyStats = infra::ShardedCounters<CopyCounter>;
+
+// Чем скопирован файл — подпись strategy у метрик. Первые четыре
+// совпадают с adapters::fs::CopyStrategy
+enum class CopyPath : std::size_t {
+    Buffered,
+    MMap,
+    DirectIO,
+    Async,          // реактор --engine=async
+    Chunked,        // чанки --resume
+    Delta,          // --delta
+    Count
+};
+
+enum class PathCounter : std::size_t {
+    Files,
+    Bytes,
+    Retries,
+    Count
+};
+
+// Прогретые пулы, которые делят задания демона (см. core/daemon)
+struct SharedPools {
+    infra::FairPool& files;     // копирование файлов, задания по очереди
+    infra::ThreadPool& hashes;  // сегментное хеширование
 };
 
 class CopyEngine {
 public:
     explicit CopyEngine(const infra::Config& config,
                         infra::ProgressMonitor& monitor);
+    // Задание демона: файлы копируются на общем пуле, а не на своих потоках
+    CopyEngine(const infra::Config& config,
+               infra::ProgressMonitor& monitor,
+               SharedPools pools);
 
     [[nodiscard]] auto run(const std::vector<std::filesystem::path>& sources,
                            const std::filesystem::path& destination)
         -> std::expected<CopyStatsSnapshot, infra::Error>;
 
+    // Фильтры --exclude/--include по имени файла; открыты для бенчмарков
+    bool should_exclude(const std::filesystem::path& path) const;
+    bool should_include(const std::filesystem::path& path) const;
+
 private:
     const infra::Config& config_;
     infra::ProgressMonitor& monitor_;
 
+    // Файл в очереди сканирование → копирование
+    struct CopyItem {
+        const ScanEntry* file;
+        bool dedup_candidate;
+        std::chrono::steady_clock::time_point queued{};  // только при --trace
+    };
+
     // Внутренние методы
     void copy_directory(const std::filesystem::path& src_dir,
                         const std::filesystem::path& dst_dir);
-    std::expected<CopyFileResult, infra::Error> copy_file(const std::filesystem::path& src,
-                                                const std::filesystem::path& dst);
-    std::expected<void, infra::Error> copy_chunked(const std::filesystem::path& src,
-                                                   const std::filesystem::path& dst);
-    bool should_exclude(const std::filesystem::path& path) const;
-    bool should_include(const std::filesystem::path& path) const;
+    std::expected<CopyFileResult, infra::Error> copy_file(const ScanEntry& file,
+                                                          const std::filesystem::path& dst);
+    // Один файл из очереди целиком: бюджет памяти, копирование, учёт результата
+    void process_item(const CopyItem& item, const std::filesystem::path& destination);
+    // Копирование файла из очереди: ссылка, дубликат или обычная копия;
+    // reservation — бюджет памяти файла, на время ожидания первой копии отпускается
+    std::expected<CopyFileResult, infra::Error> copy_item(const CopyItem& item,
+                                                          const std::filesystem::path& dst,
+                                                          infra::MemoryBudget::Reservation& reservation);
+    // Статистика, журнал, индекс и прогресс по итогу одного файла — общие для обоих движков;
+    // dst — путь назначения, started — начало копирования файла (гистограмма задержек)
+    void record_result(const ScanEntry& file, const std::filesystem::path& dst,
+                       std::expected<CopyFileResult, infra::Error> res,
+                       std::chrono::steady_clock::time_point started);
+    // Учёт файла, скопированного способом path
+    void record_path(CopyPath path, std::uint64_t bytes);
+    // Ключ гистограмм задержек для файла, копируемого способом path
+    static infra::LatencyKey latency_key(CopyPath path, const ScanEntry& file);
+    // Снимок метрик для --metrics-prom / --metrics-json
+    infra::MetricsSnapshot metrics_snapshot(const infra::BoundedQueue<CopyItem>& queue) const;
+    // --engine=async: реактор в рабочем потоке пула ведёт до max_in_flight файлов
+    // (не больше capacity; предел меняет --adaptive)
+    void run_async_worker(infra::BoundedQueue<CopyItem>& queue,
+                          const std::filesystem::path& destination,
+                          infra::WorkStealingPool& blocking,
+                          std::size_t capacity,
+                          const std::atomic<std::size_t>& max_in_flight);
+    // Корневая сопрограмма файла; active уменьшается по её завершении
+    infra::Detached copy_async(adapters::fs::IoReactor& io, CopyItem item, std::filesystem::path dst,
+                               infra::MemoryBudget::Reservation reservation, std::size_t& active);
+    // Данные через реактор, остальное (метаданные, fsync, верификация) — через offload
+    infra::Task<std::expected<CopyFileResult, infra::Error>> copy_file_async(adapters::fs::IoReactor& io,
+                                                                              const ScanEntry& file,
+                                                                              const std::filesystem::path& dst);
+    // Обычная копия без дельты, дедупликации, ссылок и чанков — её ведёт реактор
+    bool async_eligible(const CopyItem& item) const;
+    // Выбор способа копирования одного файла из сканирования
+    std::expected<CopyFileResult, infra::Error> copy_entry(const ScanEntry& file,
+                                                           const std::filesystem::path& dst);
+    // Первый из одинаковых файлов копируется, остальные становятся ссылками на него
+    std::expected<CopyFileResult, infra::Error> copy_dedup(const ScanEntry& file,
+                                                           const std::filesystem::path& dst,
+                                                           infra::MemoryBudget::Reservation& reservation);
+    // Первое имя inode с nlink > 1 копируется, остальные — linkat на него
+    std::expected<CopyFileResult, infra::Error> copy_hardlinked(const ScanEntry& file,
+                                                                const std::filesystem::path& dst,
+                                                                infra::MemoryBudget::Reservation& reservation);
+    // С Publish::Atomic (--atomic) изменённый файл собирается во временном
+    // и заменяет назначение, а не правится на месте
+    std::expected<CopyFileResult, infra::Error> copy_delta(const ScanEntry& file,
+                                                           const std::filesystem::path& dst,
+                                                           adapters::fs::Publish publish);
+    // Поблочное копирование большого файла с отметкой чанков в журнале (--resume)
+    std::expected<CopyFileResult, infra::Error> copy_chunked(const ScanEntry& file,
+                                                             const std::filesystem::path& dst);
+    // Верификация, метаданные, durability и запись в манифест после копирования данных;
+    // via_descriptor — данные писались с DescriptorHook (см. descriptor_hook)
+    std::expected<std::optional<ContentDigest>, infra::Error> finish_copy(const ScanEntry& file,
+                                                                          const std::filesystem::path& dst,
+                                                                          bool via_descriptor = false);
+    // Работа над ещё открытыми дескрипторами: метаданные (без --verify) и durability
+    adapters::fs::DescriptorHook descriptor_hook(const ScanEntry& file, const std::filesystem::path& dst) const;
+    bool metadata_on_descriptor() const;
+    // Закрепление рабочих потоков за узлами NUMA (--numa); пустая — не закреплять
+    std::function<void(std::size_t)> numa_worker_init(const std::vector<std::filesystem::path>& sources,
+                                                      const std::filesystem::path& destination) const;
+    // Снимки записанных байтов и счётчиков устройств для регулятора --adaptive
+    infra::ConcurrencyController::Sampler io_sampler(const std::vector<std::filesystem::path>& sources,
+                                                     const std::filesystem::path& destination) const;
+    // Вёдра --bwlimit/--iops-limit для файла; пустой — без ограничений
+    infra::IoPacer io_pacer(const ScanEntry& file);
+    // Стратегия копирования с учётом --max-memory
+    adapters::fs::CopyStrategy copy_strategy(const ScanEntry& file) const;
+    // Буферы, которые копирование файла держит до конца (см. MemoryBudget);
+    // async — файл копирует реактор своим буфером
+    std::uint64_t memory_footprint(const ScanEntry& file, bool async = false) const;
+    // Резерв memory_footprint в бюджете --max-memory; пустой без него
+    infra::MemoryBudget::Reservation reserve_memory(const ScanEntry& file);
+    std::expected<std::optional<ContentDigest>, infra::Error> verify_copy(const std::filesystem::path& src,
+                                                                          const std::filesystem::path& dst);
+    std::expected<ContentDigest, infra::Error> digest_file(const std::filesystem::path& path);
+
+    static constexpr std::uint64_t CHUNKED_THRESHOLD = 100'000'000; // >100MB — крупный файл
+    // Глубина очереди сканирование → копирование на рабочий поток
+    static constexpr std::size_t COPY_QUEUE_DEPTH = 4;
+    // --engine=async: файлов в полёте по умолчанию, потоков-реакторов
+    // не больше стольких и буфер файла у реактора
+    static constexpr std::size_t DEFAULT_ASYNC_DEPTH = 4096;
+    static constexpr std::size_t MAX_ASYNC_REACTORS = 4;
+    static constexpr std::size_t ASYNC_BUFFER_SIZE = 256 * 1024;
+    // --adaptive: потоков в пуле без --threads, с какого числа файлов в
+    // полёте начинает async и как часто регулятор смотрит на счётчики
+    static constexpr std::size_t ADAPTIVE_MAX_WORKERS = 64;
+    static constexpr std::size_t ADAPTIVE_ASYNC_START = 64;
+    static constexpr std::chrono::milliseconds ADAPTIVE_INTERVAL{300};
+    // Секунд между выгрузками метрик без --metrics-interval
+    static constexpr double DEFAULT_METRICS_INTERVAL = 10.0;
+    // Самых медленных файлов в итогах --trace без --trace-top
+    static constexpr std::size_t DEFAULT_TRACE_TOP = 10;
+
+    // Общий пул файлов демона; nullptr — у прогона свои рабочие
+    infra::FairPool* shared_files_ = nullptr;
+
+    // Пул для параллельной обработки частей одного файла:
+    // хеширование сегментов, дельта, чанки (свой создаётся по требованию,
+    // у задания демона — общий)
+    infra::ThreadPool* hash_pool_ = nullptr;
+    std::unique_ptr<infra::ThreadPool> own_hash_pool_;
+
+    // Манифест скопированных файлов (--manifest)
+    std::filesystem::path destination_root_;
+    std::unique_ptr<extensions::ManifestWriter> manifest_;
+
+    // Индекс следующей синхронизации (--incremental)
+    std::unique_ptr<extensions::SyncIndexBuilder> sync_builder_;
+
+    // Первые копии одинакового содержимого (--dedup)
+    using DedupRegistry = extensions::OriginRegistry<extensions::ContentKey, extensions::ContentKeyHash>;
+    std::unique_ptr<DedupRegistry> dedup_registry_;
+
+    // Первые копии inode источника с несколькими именами (--hard-links)
+    using HardlinkRegistry = extensions::OriginRegistry<extensions::InodeKey, extensions::InodeKeyHash>;
+    std::unique_ptr<HardlinkRegistry> hardlink_registry_;
+
+    // Журнал задания (--resume)
+    std::unique_ptr<extensions::JobJournal> journal_;
+
+    // Поблочная дельта-передача в существующие файлы (--delta)
+    std::unique_ptr<extensions::DeltaCopier> delta_;
+
+    // Сброс записанного на носитель (--durability)
+    std::unique_ptr<extensions::DurabilityTracker> durability_;
+
+    // Предел буферов в полёте (--max-memory) и его доля на рабочий поток
+    std::unique_ptr<infra::MemoryBudget> memory_budget_;
+    std::uint64_t memory_share_ = 0;
+
+    // Ограничение скорости ввода-вывода (--bwlimit, --iops-limit, --throttle-file);
+    // устройство назначения — устройство его корня
+    std::unique_ptr<infra::IoLimiter> io_limiter_;
+    std::uint64_t destination_device_ = 0;
 
     // Статистика
     CopyStats stats_{};
+    std::array<infra::ShardedCounters<PathCounter>, static_cast<std::size_t>(CopyPath::Count)> path_stats_{};
+    infra::LatencyHistogram file_latency_;
+    infra::OpLatency latency_;
 };
 
 } // namespace cclone::core
\ No newline at end of file
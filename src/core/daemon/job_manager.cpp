@@ -0,0 +1,206 @@
+#include "job_manager.hpp"
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+#include "../../infra/interrupt.hpp"
+#include "../../infra/syscall/syscalls.hpp"
+
+namespace cclone::core {
+
+namespace {
+
+constexpr std::array<std::string_view, 5> STATE_NAMES{"queued", "running", "done", "failed", "cancelled"};
+
+auto pool_threads(std::size_t requested) -> std::size_t {
+    return requested ? requested : std::max(1u, std::jthread::hardware_concurrency());
+}
+
+} // namespace
+
+auto job_state_name(JobState state) -> std::string_view {
+    return STATE_NAMES[static_cast<std::size_t>(state)];
+}
+
+auto parse_job_state(std::string_view name) -> std::optional<JobState> {
+    const auto it = std::ranges::find(STATE_NAMES, name);
+    if (it == STATE_NAMES.end()) return std::nullopt;
+    return static_cast<JobState>(it - STATE_NAMES.begin());
+}
+
+JobManager::JobManager(Options options)
+    : options_(options)
+    , files_(pool_threads(options.threads))
+    , hashes_(pool_threads(options.threads))
+{
+    const auto runners = std::max<std::size_t>(1, options_.max_running);
+    runners_.reserve(runners);
+    for (std::size_t i = 0; i < runners; ++i) {
+        runners_.emplace_back([this](std::stop_token stop) { run_runner_(stop); });
+    }
+}
+
+JobManager::~JobManager() {
+    {
+        std::lock_guard lock(mutex_);
+        for (auto& job : queue_) {
+            finish_(*job, JobState::Cancelled);
+        }
+        queue_.clear();
+        for (auto& [id, job] : jobs_) {
+            if (job->state == JobState::Running) job->cancel.store(true, std::memory_order_relaxed);
+        }
+    }
+    runners_.clear();  // request_stop будит ждущих очереди; выполняемые видят флаги
+}
+
+auto JobManager::submit(JobSpec spec) -> std::expected<JobId, infra::Error> {
+    if (spec.sources.empty() || spec.destination.empty()) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::InvalidPath,
+                               "A job needs sources and a destination"));
+    }
+    for (const auto& source : spec.sources) {
+        if (!infra::sys::exists(source)) {
+            return std::unexpected(infra::make_error(infra::ErrorCode::FileNotFound,
+                                   fmt::format("Source does not exist: {}", source.string())));
+        }
+    }
+
+    auto job = std::make_shared<Job>();
+    job->spec = std::move(spec);
+    std::lock_guard lock(mutex_);
+    job->id = next_id_++;
+    jobs_.emplace(job->id, job);
+    queue_.push_back(job);
+    queued_cv_.notify_one();
+    spdlog::info("Job {} queued: {} source(s) -> {}", job->id, job->spec.sources.size(),
+                 job->spec.destination.string());
+    return job->id;
+}
+
+auto JobManager::status(JobId id) const -> std::optional<JobStatus> {
+    std::lock_guard lock(mutex_);
+    const auto it = jobs_.find(id);
+    if (it == jobs_.end()) return std::nullopt;
+    return status_of_(*it->second);
+}
+
+auto JobManager::list() const -> std::vector<JobStatus> {
+    std::lock_guard lock(mutex_);
+    std::vector<JobStatus> all;
+    all.reserve(jobs_.size());
+    for (const auto& [id, job] : jobs_) {
+        all.push_back(status_of_(*job));
+    }
+    return all;
+}
+
+auto JobManager::cancel(JobId id) -> bool {
+    std::lock_guard lock(mutex_);
+    const auto it = jobs_.find(id);
+    if (it == jobs_.end()) return false;
+    auto& job = *it->second;
+    if (job.state == JobState::Queued) {
+        std::erase(queue_, it->second);
+        finish_(job, JobState::Cancelled);
+        return true;
+    }
+    if (job.state != JobState::Running) return false;
+    job.cancel.store(true, std::memory_order_relaxed);
+    spdlog::info("Job {} cancellation requested", id);
+    return true;
+}
+
+auto JobManager::wait(JobId id) -> std::optional<JobStatus> {
+    std::unique_lock lock(mutex_);
+    const auto it = jobs_.find(id);
+    if (it == jobs_.end()) return std::nullopt;
+    // Завершённое задание может быть вытеснено из jobs_ — держим его сами
+    const auto job = it->second;
+    finished_cv_.wait(lock, [&] { return status_of_(*job).finished(); });
+    return status_of_(*job);
+}
+
+void JobManager::run_runner_(std::stop_token stop) {
+    for (;;) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock lock(mutex_);
+            if (!queued_cv_.wait(lock, stop, [&] { return !queue_.empty(); })) return;
+            job = std::move(queue_.front());
+            queue_.pop_front();
+            job->state = JobState::Running;
+            job->started = std::chrono::steady_clock::now();
+            job->monitor = std::make_unique<infra::ProgressMonitor>(false, true);
+        }
+        run_job_(*job);
+    }
+}
+
+void JobManager::run_job_(Job& job) {
+    spdlog::info("Job {} started", job.id);
+    const infra::CancelScope cancel_scope(&job.cancel);
+
+    std::expected<CopyStatsSnapshot, infra::Error> result = std::unexpected(
+        infra::make_error(infra::ErrorCode::Unknown, "Job did not run"));
+    try {
+        CopyEngine engine(job.spec.config, *job.monitor, SharedPools{.files = files_, .hashes = hashes_});
+        result = engine.run(job.spec.sources, job.spec.destination);
+    } catch (const std::exception& e) {
+        result = std::unexpected(infra::make_error(infra::ErrorCode::Unknown, e.what()));
+    }
+
+    std::lock_guard lock(mutex_);
+    if (result) {
+        job.stats = std::move(*result);
+        finish_(job, JobState::Done);
+    } else if (result.error().code == infra::ErrorCode::Interrupted || infra::is_interrupted()) {
+        finish_(job, JobState::Cancelled);
+    } else {
+        job.message = result.error().message;
+        finish_(job, JobState::Failed);
+    }
+}
+
+void JobManager::finish_(Job& job, JobState state) {
+    job.state = state;
+    job.finished = std::chrono::steady_clock::now();
+    if (state == JobState::Done) {
+        spdlog::info("Job {} done: {} files copied, {} skipped, {} errors", job.id, job.stats.files_copied,
+                     job.stats.files_skipped, job.stats.errors);
+    } else {
+        spdlog::info("Job {} {}{}{}", job.id, job_state_name(state), job.message.empty() ? "" : ": ", job.message);
+    }
+    finished_cv_.notify_all();
+
+    finished_.push_back(job.id);
+    while (finished_.size() > options_.keep_finished) {
+        jobs_.erase(finished_.front());
+        finished_.pop_front();
+    }
+}
+
+auto JobManager::status_of_(const Job& job) const -> JobStatus {
+    JobStatus status{
+        .id = job.id,
+        .state = job.state,
+        .destination = job.spec.destination.string(),
+        .stats = job.stats,
+        .message = job.message
+    };
+    if (job.monitor) {
+        const auto progress = job.monitor->get_stats();
+        status.files_total = progress.total_files;
+        status.files_done = progress.processed_files;
+        status.bytes_total = progress.total_bytes;
+        status.bytes_done = progress.processed_bytes;
+    }
+    if (job.started != std::chrono::steady_clock::time_point{}) {
+        const auto end = status.finished() ? job.finished : std::chrono::steady_clock::now();
+        status.elapsed_s = std::chrono::duration<double>(end - job.started).count();
+    }
+    return status;
+}
+
+} // namespace cclone::core
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "../copy_engine/copy_engine.hpp"
+#include "../../infra/config/config.hpp"
+#include "../../infra/error_handler/error.hpp"
+#include "../../infra/monitoring/monitoring.hpp"
+#include "../../infra/thread_pool/fair_pool.hpp"
+#include "../../infra/thread_pool/thread_pool.hpp"
+
+namespace cclone::core {
+
+using JobId = std::uint64_t;
+
+enum class JobState {
+    Queued,     // ждёт свободного места среди выполняемых
+    Running,
+    Done,       // прогон завершён; ошибки отдельных файлов — в errors
+    Failed,     // прогон не состоялся (манифест, метрики, исключение)
+    Cancelled
+};
+
+// "queued" | "running" | "done" | "failed" | "cancelled"
+[[nodiscard]] auto job_state_name(JobState state) -> std::string_view;
+[[nodiscard]] auto parse_job_state(std::string_view name) -> std::optional<JobState>;
+
+struct JobSpec {
+    std::vector<std::filesystem::path> sources;
+    std::filesystem::path destination;
+    infra::Config config;
+};
+
+// Снимок задания для клиентов демона
+struct JobStatus {
+    JobId id = 0;
+    JobState state = JobState::Queued;
+    std::string destination;
+    std::uint64_t files_total = 0;      // известно после сканирования
+    std::uint64_t files_done = 0;
+    std::uint64_t bytes_total = 0;
+    std::uint64_t bytes_done = 0;
+    double elapsed_s = 0;               // с начала выполнения
+    CopyStatsSnapshot stats;            // итоги, когда прогон завершён
+    std::string message;                // причина Failed
+
+    [[nodiscard]] auto finished() const -> bool {
+        return state == JobState::Done || state == JobState::Failed || state == JobState::Cancelled;
+    }
+};
+
+// Очередь заданий демона. Задания выполняются не больше max_running
+// одновременно, остальные ждут в порядке поступления. Выполняемые делят
+// один прогретый пул файлов (FairPool: по файлу от каждого задания по
+// очереди) и один пул хеширования; буферы и кольца io_uring живут в
+// потоках пула и переходят от задания к заданию.
+//
+// Каждое задание отменяется своим флагом (infra::CancelScope): движок и
+// адаптеры видят его через is_interrupted(), как SIGINT.
+class JobManager {
+public:
+    struct Options {
+        std::size_t threads = 0;            // рабочих общих пулов; 0 — по числу ядер
+        std::size_t max_running = 4;        // заданий одновременно
+        std::size_t keep_finished = 1000;   // завершённых, о которых помнит status()
+    };
+
+    explicit JobManager(Options options);
+    // Отменяет ждущие и выполняемые задания и дожидается их
+    ~JobManager();
+
+    JobManager(const JobManager&) = delete;
+    JobManager& operator=(const JobManager&) = delete;
+
+    // Ставит задание в очередь; источники должны существовать
+    [[nodiscard]] auto submit(JobSpec spec) -> std::expected<JobId, infra::Error>;
+
+    [[nodiscard]] auto status(JobId id) const -> std::optional<JobStatus>;
+    [[nodiscard]] auto list() const -> std::vector<JobStatus>;
+
+    // Ждущее задание снимается сразу, выполняемое — как только движок
+    // заметит флаг. false — задания нет или оно уже завершено
+    auto cancel(JobId id) -> bool;
+
+    // Ждёт завершения задания; nullopt — такого задания нет
+    [[nodiscard]] auto wait(JobId id) -> std::optional<JobStatus>;
+
+    [[nodiscard]] auto threads() const -> std::size_t { return files_.size(); }
+
+private:
+    struct Job {
+        JobId id = 0;
+        JobSpec spec;
+        JobState state = JobState::Queued;
+        std::atomic<bool> cancel{false};
+        std::unique_ptr<infra::ProgressMonitor> monitor;  // с начала выполнения
+        CopyStatsSnapshot stats;
+        std::string message;
+        std::chrono::steady_clock::time_point started{};
+        std::chrono::steady_clock::time_point finished{};
+    };
+
+    void run_runner_(std::stop_token stop);
+    void run_job_(Job& job);
+    void finish_(Job& job, JobState state);             // под mutex_
+    [[nodiscard]] auto status_of_(const Job& job) const -> JobStatus;  // под mutex_
+
+    const Options options_;
+    infra::FairPool files_;
+    infra::ThreadPool hashes_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable_any queued_cv_;
+    std::condition_variable finished_cv_;
+    std::deque<std::shared_ptr<Job>> queue_;
+    std::map<JobId, std::shared_ptr<Job>> jobs_;
+    std::deque<JobId> finished_;    // порядок вытеснения завершённых
+    JobId next_id_ = 1;
+
+    std::vector<std::jthread> runners_;  // последними: останавливаются первыми
+};
+
+} // namespace cclone::core
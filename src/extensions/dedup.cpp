@@ -0,0 +1,134 @@
+// dedup.cpp
+#include "dedup.hpp"
+#include "../infra/syscall/syscalls.hpp"
+// XXH3_state_t для потокового XXH3-128
+#define XXH_STATIC_LINKING_ONLY
+#include <xxhash.h>
+#include <fmt/core.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+#ifdef __linux__
+    #include <sys/ioctl.h>
+    #include <linux/fs.h>
+#endif
+
+namespace cclone::extensions {
+
+namespace {
+
+constexpr std::size_t PREFILTER_SIZE = 4096;
+constexpr std::size_t READ_SIZE = 4 * 1024 * 1024;
+
+auto open_error(const std::filesystem::path& path) -> infra::Error {
+    return infra::make_error(infra::ErrorCode::FileNotFound,
+                             fmt::format("Cannot open file for dedup hashing: {}", path.string()));
+}
+
+} // namespace
+
+auto head_tail_digest(const std::filesystem::path& path, std::uint64_t size)
+    -> std::expected<std::uint64_t, infra::Error>
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return std::unexpected(open_error(path));
+
+    std::array<char, PREFILTER_SIZE * 2> buffer{};
+    const auto head = static_cast<std::size_t>(std::min<std::uint64_t>(size, PREFILTER_SIZE));
+    in.read(buffer.data(), static_cast<std::streamsize>(head));
+
+    std::size_t tail = 0;
+    if (size > PREFILTER_SIZE) {
+        tail = static_cast<std::size_t>(std::min<std::uint64_t>(size - PREFILTER_SIZE, PREFILTER_SIZE));
+        in.seekg(static_cast<std::streamoff>(size - tail));
+        in.read(buffer.data() + head, static_cast<std::streamsize>(tail));
+    }
+    if (!in) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                               fmt::format("Short read while prefiltering {}", path.string())));
+    }
+    return XXH3_64bits_withSeed(buffer.data(), head + tail, size);
+}
+
+auto content_key(const std::filesystem::path& path, std::uint64_t size)
+    -> std::expected<ContentKey, infra::Error>
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return std::unexpected(open_error(path));
+
+    XXH3_state_t state;
+    XXH3_128bits_reset(&state);
+    auto buffer = std::make_unique<char[]>(READ_SIZE);
+    while (in) {
+        in.read(buffer.get(), READ_SIZE);
+        const auto got = in.gcount();
+        if (got > 0) XXH3_128bits_update(&state, buffer.get(), static_cast<std::size_t>(got));
+    }
+    if (in.bad()) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                               fmt::format("Error reading {}", path.string())));
+    }
+
+    const auto digest = XXH3_128bits_digest(&state);
+    return ContentKey{.size = size, .low = digest.low64, .high = digest.high64};
+}
+
+auto link_file(const std::filesystem::path& origin,
+               const std::filesystem::path& dst,
+               infra::DedupPolicy policy)
+    -> std::expected<void, infra::Error>
+{
+    if (policy == infra::DedupPolicy::Hardlink) {
+#ifndef _WIN32
+        if (infra::sys::linkat(AT_FDCWD, origin.c_str(), AT_FDCWD, dst.c_str(), 0) != 0) {
+            return std::unexpected(infra::make_error(infra::ErrorCode::UnsupportedFeature,
+                                   fmt::format("Cannot hardlink {} -> {}: {}", dst.string(), origin.string(), std::strerror(errno))));
+        }
+#else
+        std::error_code ec;
+        infra::sys::create_hard_link(origin, dst, ec);
+        if (ec) {
+            return std::unexpected(infra::make_error(infra::ErrorCode::UnsupportedFeature,
+                                   fmt::format("Cannot hardlink {} -> {}: {}", dst.string(), origin.string(), ec.message())));
+        }
+#endif
+        return {};
+    }
+
+#ifdef __linux__
+    const int src_fd = infra::sys::open(origin.c_str(), O_RDONLY | O_CLOEXEC);
+    if (src_fd == -1) return std::unexpected(open_error(origin));
+    const int dst_fd = infra::sys::open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (dst_fd == -1) {
+        infra::sys::close(src_fd);
+        return std::unexpected(infra::make_error(infra::ErrorCode::PermissionDenied,
+                               fmt::format("Cannot create destination: {}", dst.string())));
+    }
+    const int rc = infra::sys::ioctl(dst_fd, FICLONE, src_fd);
+    const int err = errno;
+    infra::sys::close(src_fd);
+    infra::sys::close(dst_fd);
+    if (rc != 0) {
+        std::error_code ec;
+        infra::sys::remove(dst, ec);
+        return std::unexpected(infra::make_error(infra::ErrorCode::UnsupportedFeature,
+                               fmt::format("Reflink {} -> {} failed: {}", dst.string(), origin.string(), std::strerror(err))));
+    }
+    return {};
+#else
+    (void)origin; (void)dst;
+    return std::unexpected(infra::make_error(infra::ErrorCode::UnsupportedFeature,
+                           "Reflinks are supported on Linux only"));
+#endif
+}
+
+} // namespace cclone::extensions
@@ -0,0 +1,47 @@
+// include/cclone/extensions/dedup.hpp
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include "../infra/config/config.hpp"
+#include "../infra/error_handler/error.hpp"
+
+namespace cclone::extensions {
+
+// Ключ дедупликации: размер + XXH3-128 всего содержимого
+struct ContentKey {
+    std::uint64_t size = 0;
+    std::uint64_t low = 0;
+    std::uint64_t high = 0;
+
+    friend bool operator==(const ContentKey&, const ContentKey&) = default;
+};
+
+struct ContentKeyHash {
+    auto operator()(const ContentKey& key) const noexcept -> std::size_t {
+        return static_cast<std::size_t>(key.low ^ (key.size * 0x9E3779B97F4A7C15ull));
+    }
+};
+
+// Файлы меньше этого размера копируются как есть: ссылка не дешевле копии
+inline constexpr std::uint64_t DEDUP_MIN_SIZE = 4096;
+
+// Дешёвый предфильтр: XXH3 первых и последних 4KB.
+// Разный результат при одинаковом размере — заведомо разные файлы.
+[[nodiscard]] auto head_tail_digest(const std::filesystem::path& path, std::uint64_t size)
+    -> std::expected<std::uint64_t, infra::Error>;
+
+// Полный ключ содержимого (читает файл целиком)
+[[nodiscard]] auto content_key(const std::filesystem::path& path, std::uint64_t size)
+    -> std::expected<ContentKey, infra::Error>;
+
+// Создаёт dst как ссылку на уже записанный origin.
+// Reflink: общий экстент (FICLONE), независимые метаданные; UnsupportedFeature,
+// если ФС не умеет. Hardlink: общий inode.
+[[nodiscard]] auto link_file(const std::filesystem::path& origin,
+                             const std::filesystem::path& dst,
+                             infra::DedupPolicy policy)
+    -> std::expected<void, infra::Error>;
+
+} // namespace cclone::extensions
@@ -0,0 +1,607 @@
+// delta.cpp
+#include "delta.hpp"
+#include "sync_index.hpp"
+#include "../adapters/file_stat.hpp"
+#include "../infra/monitoring/op_latency.hpp"
+#include "../infra/syscall/syscalls.hpp"
+#include <xxhash.h>
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+#ifdef __linux__
+    #include <sys/ioctl.h>
+    #include <linux/fs.h>
+#endif
+
+namespace cclone::extensions {
+
+namespace {
+
+constexpr std::array<char, 8> CACHE_MAGIC = {'C', 'C', 'B', 'L', 'K', '0', '0', '2'};
+
+// Заголовок файла кэша; за ним следуют count подписей BlockSignature
+struct CacheHeader {
+    std::array<char, 8> magic;
+    std::uint64_t block_size;
+    std::uint64_t dst_size;
+    std::int64_t dst_mtime_ns;
+    std::uint64_t dst_inode;
+    std::uint64_t count;
+};
+
+static_assert(std::is_trivially_copyable_v<CacheHeader>);
+static_assert(std::is_trivially_copyable_v<BlockSignature>);
+
+// Подписи назначения из кэша, если он соответствует текущему состоянию файла
+auto load_cache(const std::filesystem::path& path,
+                std::uint64_t block_size,
+                const adapters::fs::FileStat& dst) -> std::optional<std::vector<BlockSignature>>
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return std::nullopt;
+
+    CacheHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return std::nullopt;
+    if (header.magic != CACHE_MAGIC
+        || header.block_size != block_size
+        || header.dst_size != dst.size
+        || header.dst_mtime_ns != dst.mtime_ns
+        || header.dst_inode != dst.inode) {
+        return std::nullopt;
+    }
+    // Число подписей задаётся размером назначения: испорченный счётчик
+    // не должен стать размером выделения
+    if (header.count != (dst.size + block_size - 1) / block_size) return std::nullopt;
+
+    std::vector<BlockSignature> blocks(header.count);
+    if (!in.read(reinterpret_cast<char*>(blocks.data()),
+                 static_cast<std::streamsize>(blocks.size() * sizeof(BlockSignature)))) {
+        return std::nullopt;
+    }
+    return blocks;
+}
+
+#ifndef _WIN32
+class FileHandle {
+public:
+    FileHandle(const std::filesystem::path& path, int flags)
+        : fd_(infra::sys::open(path.c_str(), flags | O_CLOEXEC)) {}
+    ~FileHandle() { if (fd_ != -1) infra::sys::close(fd_); }
+
+    FileHandle(const FileHandle&) = delete;
+    FileHandle& operator=(const FileHandle&) = delete;
+
+    [[nodiscard]] auto get() const -> int { return fd_; }
+    [[nodiscard]] auto is_open() const -> bool { return fd_ != -1; }
+
+private:
+    int fd_ = -1;
+};
+
+auto read_full(int fd, char* buffer, std::size_t length, std::uint64_t offset) -> bool {
+    std::size_t done = 0;
+    while (done < length) {
+        ssize_t n = infra::sys::pread(fd, buffer + done, length - done, static_cast<off_t>(offset + done));
+        if (n == 0) return false;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        done += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+auto write_full(int fd, const char* buffer, std::size_t length, std::uint64_t offset) -> bool {
+    std::size_t done = 0;
+    while (done < length) {
+        ssize_t n = infra::sys::pwrite(fd, buffer + done, length - done, static_cast<off_t>(offset + done));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        infra::note_written(static_cast<std::uint64_t>(n));
+        done += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+// Переносит length байт из in (со смещения from) в out (на смещение to)
+// через буфер вызывающего
+auto transfer(int in, const std::filesystem::path& in_path, std::uint64_t from,
+              int out, const std::filesystem::path& out_path, std::uint64_t to,
+              std::uint64_t length, std::span<char> buffer) -> std::expected<void, infra::Error>
+{
+    while (length > 0) {
+        const auto n = static_cast<std::size_t>(std::min<std::uint64_t>(length, buffer.size()));
+        if (!read_full(in, buffer.data(), n, from)) {
+            return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                                   fmt::format("Error reading {} at offset {}", in_path.string(), from)));
+        }
+        if (!write_full(out, buffer.data(), n, to)) {
+            return std::unexpected(infra::make_error(
+                errno == ENOSPC ? infra::ErrorCode::DiskFull : infra::ErrorCode::Unknown,
+                fmt::format("Error writing {} at offset {}: {}", out_path.string(), to, std::strerror(errno))));
+        }
+        from += n;
+        to += n;
+        length -= n;
+    }
+    return {};
+}
+
+// Слабая сумма окна, как в rsync: s1 — сумма байт, s2 — сумма префиксных
+// s1, обе по модулю 2^16. Сдвиг окна на байт — O(1)
+class RollingSum {
+public:
+    RollingSum(const char* data, std::size_t length)
+        : length_(static_cast<std::uint32_t>(length))
+    {
+        for (std::size_t i = 0; i < length; ++i) {
+            s1_ += static_cast<unsigned char>(data[i]);
+            s2_ += s1_;
+        }
+    }
+
+    void roll(char out, char in) {
+        const auto leaving = static_cast<unsigned char>(out);
+        s1_ += static_cast<unsigned char>(in) - std::uint32_t{leaving};
+        s2_ += s1_ - length_ * leaving;
+    }
+
+    [[nodiscard]] auto digest() const -> std::uint32_t { return (s1_ & 0xffff) | (s2_ << 16); }
+
+private:
+    std::uint32_t length_;
+    std::uint32_t s1_ = 0;
+    std::uint32_t s2_ = 0;
+};
+
+auto signature(const char* data, std::size_t length) -> BlockSignature {
+    return BlockSignature{.weak = RollingSum(data, length).digest(), .strong = XXH3_64bits(data, length)};
+}
+
+// Полные блоки старого назначения по слабой сумме. Битовый фильтр
+// отсекает почти все окна без поиска по отсортированному массиву
+class BlockIndex {
+public:
+    explicit BlockIndex(std::span<const BlockSignature> blocks)
+        : blocks_(blocks)
+        , filter_(FILTER_BITS)
+    {
+        entries_.reserve(blocks.size());
+        for (std::size_t i = 0; i < blocks.size(); ++i) {
+            entries_.push_back(Entry{.weak = blocks[i].weak, .block = i});
+            filter_[blocks[i].weak & (FILTER_BITS - 1)] = true;
+        }
+        std::ranges::sort(entries_);
+    }
+
+    [[nodiscard]] auto empty() const -> bool { return entries_.empty(); }
+
+    // Номер блока с тем же содержимым, что у окна
+    [[nodiscard]] auto find(std::uint32_t weak, const char* window, std::size_t length) const
+        -> std::optional<std::size_t>
+    {
+        if (!filter_[weak & (FILTER_BITS - 1)]) return std::nullopt;
+        const auto candidates = std::ranges::equal_range(entries_, weak, {}, &Entry::weak);
+        if (candidates.empty()) return std::nullopt;
+        const auto strong = XXH3_64bits(window, length);
+        for (const auto& entry : candidates) {
+            if (blocks_[entry.block].strong == strong) return entry.block;
+        }
+        return std::nullopt;
+    }
+
+private:
+    struct Entry {
+        std::uint32_t weak;
+        std::size_t block;
+
+        auto operator<=>(const Entry&) const = default;
+    };
+
+    static constexpr std::size_t FILTER_BITS = std::size_t{1} << 20;
+
+    std::span<const BlockSignature> blocks_;
+    std::vector<Entry> entries_;
+    std::vector<bool> filter_;
+};
+
+// Участок итогового файла: данные источника или блоки старого назначения
+struct Piece {
+    std::uint64_t offset;                // в источнике и в итоговом файле
+    std::uint64_t length;
+    std::optional<std::uint64_t> from;   // смещение в старом назначении
+};
+
+// Соседние участки одного вида сливаются в один
+void append(std::vector<Piece>& pieces, const Piece& piece) {
+    if (piece.length == 0) return;
+    if (!pieces.empty()) {
+        auto& last = pieces.back();
+        const bool joins = last.offset + last.length == piece.offset
+            && last.from.has_value() == piece.from.has_value()
+            && (!piece.from || *last.from + last.length == *piece.from);
+        if (joins) {
+            last.length += piece.length;
+            return;
+        }
+    }
+    pieces.push_back(piece);
+}
+
+// Запас буфера поиска сверх окна: перечитывается только окно при сдвиге буфера
+constexpr std::uint64_t SEARCH_LOOKAHEAD = 4 * 1024 * 1024;
+
+// Делит участок [begin, end) источника на данные источника и полные блоки
+// старого назначения: без совпадения окно сдвигается на байт, после
+// совпадения — на блок
+auto match_blocks(int src_fd, const std::filesystem::path& src, const BlockIndex& index,
+                  std::uint64_t block_size, std::uint64_t begin, std::uint64_t end)
+    -> std::expected<std::vector<Piece>, infra::Error>
+{
+    std::vector<Piece> pieces;
+    if (index.empty() || end - begin < block_size) {
+        append(pieces, Piece{.offset = begin, .length = end - begin, .from = std::nullopt});
+        return pieces;
+    }
+
+    const auto window = static_cast<std::size_t>(block_size);
+    const auto capacity = static_cast<std::size_t>(
+        std::min(end - begin, block_size + std::max(block_size, SEARCH_LOOKAHEAD)));
+    auto buffer = std::make_unique<char[]>(capacity);
+    std::uint64_t buffer_offset = 0;
+    std::uint64_t buffer_end = 0;
+    const auto fill = [&](std::uint64_t offset) {
+        buffer_offset = offset;
+        buffer_end = offset + std::min<std::uint64_t>(capacity, end - offset);
+        return read_full(src_fd, buffer.get(), static_cast<std::size_t>(buffer_end - offset), offset);
+    };
+    const auto at = [&](std::uint64_t offset) { return buffer.get() + (offset - buffer_offset); };
+    const auto read_error = [&](std::uint64_t offset) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                               fmt::format("Error reading {} at offset {}", src.string(), offset)));
+    };
+
+    std::uint64_t position = begin;
+    std::uint64_t literal = begin;
+    if (!fill(position)) return read_error(position);
+    RollingSum sum(at(position), window);
+    for (;;) {
+        if (const auto block = index.find(sum.digest(), at(position), window)) {
+            append(pieces, Piece{.offset = literal, .length = position - literal, .from = std::nullopt});
+            append(pieces, Piece{.offset = position, .length = block_size, .from = *block * block_size});
+            position += block_size;
+            literal = position;
+            if (end - position < block_size) break;
+            if (position + block_size > buffer_end && !fill(position)) return read_error(position);
+            sum = RollingSum(at(position), window);
+            continue;
+        }
+        if (end - position == block_size) break;
+        // Для сдвига нужны и первый байт окна, и следующий за ним
+        if (position + block_size >= buffer_end && !fill(position)) return read_error(position);
+        sum.roll(*at(position), *at(position + block_size));
+        ++position;
+    }
+    append(pieces, Piece{.offset = literal, .length = end - literal, .from = std::nullopt});
+    return pieces;
+}
+
+// Вызывает fn(first, last) задачами пула по диапазонам из per_task блоков
+// и дожидается всех: задачи ссылаются на локальные переменные вызывающего
+template<typename Fn>
+auto for_each_range(infra::ThreadPool& pool, std::size_t count, std::size_t per_task, const Fn& fn)
+    -> std::expected<void, infra::Error>
+{
+    std::vector<std::future<std::expected<void, infra::Error>>> futures;
+    for (std::size_t first = 0; first < count; first += per_task) {
+        const std::size_t last = std::min(count, first + per_task);
+        // Записи задачи учитываются за файлом вызывающего потока
+        futures.push_back(pool.enqueue_with_future([&fn, first, last, latency = infra::OpLatency::bound()]()
+                                                   -> std::expected<void, infra::Error> {
+            const infra::OpLatency::Context latency_context(latency);
+            return fn(first, last);
+        }));
+    }
+
+    std::optional<infra::Error> first_error;
+    for (auto& future : futures) {
+        auto done = future.get();
+        if (!done && !first_error) first_error = std::move(done.error());
+    }
+    if (first_error) {
+        return std::unexpected(std::move(*first_error));
+    }
+    return {};
+}
+#endif
+
+} // namespace
+
+DeltaCopier::DeltaCopier(infra::ThreadPool& pool,
+                         std::filesystem::path root,
+                         std::uint64_t block_size,
+                         bool use_cache)
+    : pool_(pool)
+    , root_(std::move(root))
+    , block_size_(block_size > 0 ? block_size : DEFAULT_BLOCK_SIZE)
+    , use_cache_(use_cache)
+{}
+
+auto DeltaCopier::cache_path(const std::filesystem::path& dst) const -> std::filesystem::path {
+    const auto key = SyncIndex::path_hash(dst.lexically_relative(root_));
+    return root_ / CACHE_DIR / fmt::format("{:016x}", key);
+}
+
+auto DeltaCopier::copy(const std::filesystem::path& src,
+                       const std::filesystem::path& dst,
+                       adapters::fs::Publish publish)
+    -> std::expected<DeltaResult, infra::Error>
+{
+#ifdef _WIN32
+    (void)src; (void)dst; (void)publish;
+    return std::unexpected(infra::make_error(infra::ErrorCode::UnsupportedFeature,
+                           "Delta transfer requires pread/pwrite"));
+#else
+    auto src_stat = adapters::fs::stat_file(src);
+    if (!src_stat) return std::unexpected(std::move(src_stat.error()));
+    auto dst_stat = adapters::fs::stat_file(dst);
+    if (!dst_stat) return std::unexpected(std::move(dst_stat.error()));
+
+    FileHandle src_fd(src, O_RDONLY);
+    if (!src_fd.is_open()) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::FileNotFound,
+                               fmt::format("Cannot open source for delta: {}", src.string())));
+    }
+    FileHandle dst_fd(dst, O_RDWR);
+    if (!dst_fd.is_open()) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::PermissionDenied,
+                               fmt::format("Cannot open destination for delta: {}", dst.string())));
+    }
+
+    const std::uint64_t src_size = src_stat->size;
+    const std::uint64_t dst_size = dst_stat->size;
+    const auto blocks_of = [&](std::uint64_t size) {
+        return static_cast<std::size_t>((size + block_size_ - 1) / block_size_);
+    };
+    const std::size_t blocks = blocks_of(src_size);
+    const std::size_t dst_blocks = blocks_of(dst_size);
+    const std::size_t blocks_per_task = static_cast<std::size_t>(
+        std::max<std::uint64_t>(1, BYTES_PER_TASK / block_size_));
+
+    std::optional<std::vector<BlockSignature>> cached;
+    if (use_cache_) {
+        cached = load_cache(cache_path(dst), block_size_, *dst_stat);
+    }
+
+    DeltaResult result;
+    result.logical_size = src_size;
+    result.blocks_total = blocks;
+    result.cache_hit = cached.has_value();
+    result.block_signatures.resize(blocks);
+
+    std::vector<BlockSignature> old_blocks = cached ? std::move(*cached) : std::vector<BlockSignature>(dst_blocks);
+    std::vector<std::uint8_t> unchanged(blocks, 0);
+
+    // Выровненный проход: подписи источника, сравнение с назначением на том
+    // же смещении (или с его подписью из кэша), подписи назначения для поиска
+    auto aligned = for_each_range(pool_, std::max(blocks, dst_blocks), blocks_per_task,
+                                  [&](std::size_t first, std::size_t last) -> std::expected<void, infra::Error> {
+        auto src_buf = std::make_unique<char[]>(block_size_);
+        auto dst_buf = result.cache_hit ? nullptr : std::make_unique<char[]>(block_size_);
+
+        for (std::size_t i = first; i < last; ++i) {
+            const std::uint64_t offset = static_cast<std::uint64_t>(i) * block_size_;
+            const auto length = offset < src_size
+                ? static_cast<std::size_t>(std::min(block_size_, src_size - offset))
+                : std::size_t{0};
+            const auto dst_length = offset < dst_size
+                ? static_cast<std::size_t>(std::min(block_size_, dst_size - offset))
+                : std::size_t{0};
+
+            if (length > 0) {
+                if (!read_full(src_fd.get(), src_buf.get(), length, offset)) {
+                    return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                                           fmt::format("Error reading {} at offset {}", src.string(), offset)));
+                }
+                result.block_signatures[i] = signature(src_buf.get(), length);
+            }
+            if (!result.cache_hit && dst_length > 0) {
+                if (!read_full(dst_fd.get(), dst_buf.get(), dst_length, offset)) {
+                    return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                                           fmt::format("Error reading {} at offset {}", dst.string(), offset)));
+                }
+                old_blocks[i] = signature(dst_buf.get(), dst_length);
+            }
+            if (length > 0 && dst_length == length) {
+                unchanged[i] = result.cache_hit
+                    ? old_blocks[i] == result.block_signatures[i]
+                    : std::memcmp(src_buf.get(), dst_buf.get(), length) == 0;
+            }
+        }
+        return {};
+    });
+    if (!aligned) return std::unexpected(std::move(aligned.error()));
+
+    result.blocks_changed = static_cast<std::size_t>(std::ranges::count(unchanged, std::uint8_t{0}));
+
+    // Отличающиеся участки источника ищутся среди полных блоков назначения
+    // с любого смещения. Участок не выходит за диапазон задачи: совпадение
+    // на стыке диапазонов теряется, как и в любом разбиении на части
+    std::vector<std::vector<Piece>> pieces((blocks + blocks_per_task - 1) / blocks_per_task);
+    if (result.blocks_changed > 0) {
+        const BlockIndex index(std::span<const BlockSignature>(old_blocks).first(
+            static_cast<std::size_t>(dst_size / block_size_)));
+        auto matched = for_each_range(pool_, blocks, blocks_per_task,
+                                      [&](std::size_t first, std::size_t last) -> std::expected<void, infra::Error> {
+            auto& out = pieces[first / blocks_per_task];
+            for (std::size_t i = first; i < last;) {
+                if (unchanged[i]) {
+                    ++i;
+                    continue;
+                }
+                const std::size_t run = i;
+                while (i < last && !unchanged[i]) ++i;
+                const std::uint64_t begin = static_cast<std::uint64_t>(run) * block_size_;
+                const std::uint64_t end = std::min<std::uint64_t>(src_size, static_cast<std::uint64_t>(i) * block_size_);
+                auto found = match_blocks(src_fd.get(), src, index, block_size_, begin, end);
+                if (!found) return std::unexpected(std::move(found.error()));
+                out.insert(out.end(), found->begin(), found->end());
+            }
+            return {};
+        });
+        if (!matched) return std::unexpected(std::move(matched.error()));
+    }
+
+    // С --atomic назначение не трогается на месте; неизменное остаётся как есть
+    const auto moves = [](const Piece& piece) { return piece.from && *piece.from != piece.offset; };
+    result.replaced = std::ranges::any_of(pieces, [&](const auto& range) {
+        return std::ranges::any_of(range, moves);
+    }) || (publish == adapters::fs::Publish::Atomic && (result.blocks_changed > 0 || dst_size != src_size));
+
+    std::atomic<std::uint64_t> bytes_written{0};
+    std::atomic<std::uint64_t> bytes_moved{0};
+
+    if (!result.replaced) {
+        // Совпавшие блоки на своих местах: отличия пишутся прямо в назначение
+        auto written = for_each_range(pool_, blocks, blocks_per_task,
+                                      [&](std::size_t first, std::size_t) -> std::expected<void, infra::Error> {
+            auto buffer = std::make_unique<char[]>(block_size_);
+            for (const auto& piece : pieces[first / blocks_per_task]) {
+                if (piece.from) continue;
+                auto done = transfer(src_fd.get(), src, piece.offset, dst_fd.get(), dst, piece.offset,
+                                     piece.length, std::span(buffer.get(), block_size_));
+                if (!done) return done;
+                bytes_written.fetch_add(piece.length, std::memory_order_relaxed);
+            }
+            return {};
+        });
+        if (!written) return std::unexpected(std::move(written.error()));
+
+        if (dst_size != src_size && infra::sys::ftruncate(dst_fd.get(), static_cast<off_t>(src_size)) != 0) {
+            return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                                   fmt::format("Cannot truncate {}: {}", dst.string(), std::strerror(errno))));
+        }
+    } else {
+        // Блоки переезжают или нужна атомарная замена: итог собирается
+        // рядом и заменяет назначение целиком
+        auto out = adapters::fs::OutputFile::open(dst, adapters::fs::Publish::Atomic);
+        if (!out) return std::unexpected(std::move(out.error()));
+
+        // Клон делит экстенты с назначением: дописываются только отличия
+        bool cloned = false;
+#ifdef FICLONE
+        cloned = infra::sys::ioctl(out->fd(), FICLONE, dst_fd.get()) == 0;
+#endif
+
+        auto written = for_each_range(pool_, blocks, blocks_per_task,
+                                      [&](std::size_t first, std::size_t last) -> std::expected<void, infra::Error> {
+            auto buffer = std::make_unique<char[]>(block_size_);
+            const std::span<char> view(buffer.get(), block_size_);
+            if (!cloned) {
+                for (std::size_t i = first; i < last; ++i) {
+                    if (!unchanged[i]) continue;
+                    const std::uint64_t offset = static_cast<std::uint64_t>(i) * block_size_;
+                    const auto length = std::min(block_size_, src_size - offset);
+                    auto done = transfer(dst_fd.get(), dst, offset, out->fd(), dst, offset, length, view);
+                    if (!done) return done;
+                    bytes_written.fetch_add(length, std::memory_order_relaxed);
+                }
+            }
+            for (const auto& piece : pieces[first / blocks_per_task]) {
+                if (cloned && piece.from && !moves(piece)) continue;
+                auto done = piece.from
+                    ? transfer(dst_fd.get(), dst, *piece.from, out->fd(), dst, piece.offset, piece.length, view)
+                    : transfer(src_fd.get(), src, piece.offset, out->fd(), dst, piece.offset, piece.length, view);
+                if (!done) return done;
+                bytes_written.fetch_add(piece.length, std::memory_order_relaxed);
+                if (moves(piece)) bytes_moved.fetch_add(piece.length, std::memory_order_relaxed);
+            }
+            return {};
+        });
+        if (!written) return std::unexpected(std::move(written.error()));
+
+        if (infra::sys::ftruncate(out->fd(), static_cast<off_t>(src_size)) != 0) {
+            return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                                   fmt::format("Cannot truncate {}: {}", dst.string(), std::strerror(errno))));
+        }
+        if (auto published = out->publish(); !published) {
+            return std::unexpected(std::move(published.error()));
+        }
+    }
+
+    result.bytes_written = bytes_written.load();
+    result.bytes_moved = bytes_moved.load();
+    spdlog::debug("Delta {}: {} of {} blocks changed, {} of {} bytes written ({} moved){}{}",
+                  dst.string(), result.blocks_changed, result.blocks_total,
+                  result.bytes_written, result.logical_size, result.bytes_moved,
+                  result.replaced ? ", rebuilt in a temporary file" : "",
+                  result.cache_hit ? " (cached signatures)" : "");
+    return result;
+#endif
+}
+
+auto DeltaCopier::store_cache(const std::filesystem::path& dst,
+                              std::span<const BlockSignature> blocks)
+    -> std::expected<void, infra::Error>
+{
+    if (!use_cache_) return {};
+
+    auto dst_stat = adapters::fs::stat_file(dst);
+    if (!dst_stat) return std::unexpected(std::move(dst_stat.error()));
+
+    const auto path = cache_path(dst);
+    std::error_code ec;
+    infra::sys::create_directories(path.parent_path(), ec);
+    if (ec) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::PermissionDenied,
+                               fmt::format("Cannot create block cache dir: {}", ec.message())));
+    }
+
+    const CacheHeader header{
+        .magic = CACHE_MAGIC,
+        .block_size = block_size_,
+        .dst_size = dst_stat->size,
+        .dst_mtime_ns = dst_stat->mtime_ns,
+        .dst_inode = dst_stat->inode,
+        .count = blocks.size()
+    };
+
+    auto tmp = path;
+    tmp += ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(blocks.data()),
+                  static_cast<std::streamsize>(blocks.size_bytes()));
+        if (!out) {
+            return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                                   fmt::format("Cannot write block cache: {}", tmp.string())));
+        }
+    }
+    infra::sys::rename(tmp, path, ec);
+    if (ec) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                               fmt::format("Cannot replace block cache {}: {}", path.string(), ec.message())));
+    }
+    return {};
+}
+
+} // namespace cclone::extensions
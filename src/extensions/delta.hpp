@@ -0,0 +1,93 @@
+// include/cclone/extensions/delta.hpp
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "../adapters/output_file.hpp"
+#include "../infra/error_handler/error.hpp"
+#include "../infra/thread_pool/thread_pool.hpp"
+
+namespace cclone::extensions {
+
+// Подпись блока: слабая скользящая сумма (как в rsync) и XXH3
+struct BlockSignature {
+    std::uint32_t weak = 0;
+    std::uint64_t strong = 0;
+
+    auto operator==(const BlockSignature&) const -> bool = default;
+};
+
+struct DeltaResult {
+    std::uint64_t logical_size = 0;   // размер файла-источника
+    std::uint64_t bytes_written = 0;  // фактически записано в назначение
+    std::uint64_t bytes_moved = 0;    // из них — блоки старого назначения с другого смещения
+    std::size_t blocks_total = 0;
+    std::size_t blocks_changed = 0;
+    bool cache_hit = false;           // подписи назначения взяты из кэша
+    bool replaced = false;            // итог собран во временном файле и заменил назначение
+    std::vector<BlockSignature> block_signatures; // блоки итогового файла
+};
+
+// Поблочная дельта-передача для файлов, существующих с обеих сторон.
+// Источник делится на выровненные блоки block_size; задачи пула хешируют
+// их (XXH3) и сравнивают с блоком назначения на том же смещении.
+//
+// В отличающихся участках источника, как в rsync, скользит окно размером
+// в блок: слабая сумма сдвигается на байт за O(1) и отбирает кандидатов
+// среди полных блоков назначения с любого смещения, XXH3 подтверждает
+// совпадение. Вставка в середину файла стоит вставленных байт, а не всего
+// хвоста после неё.
+//
+// Если совпавшие блоки остаются на своих местах, отличия пишутся в
+// назначение через pwrite. Если блоки нужно сдвинуть, запись на месте
+// затёрла бы ещё не прочитанные: итог собирается во временном файле
+// (OutputFile, Publish::Atomic) — клоне назначения (FICLONE), где ФС это
+// умеет, иначе в копии, — и заменяет назначение через rename.
+// С Publish::Atomic (--atomic) так собирается любое изменённое назначение:
+// читатели видят либо старый файл, либо новый целиком.
+//
+// Подписи назначения могут кэшироваться в <root>/.cclone.blocks: кэш действителен,
+// пока размер, mtime и inode файла назначения совпадают с записанными,
+// и тогда назначение читается только ради сдвинутых блоков.
+class DeltaCopier {
+public:
+    static constexpr std::uint64_t DEFAULT_BLOCK_SIZE = 1024 * 1024; // 1MB
+    static constexpr std::string_view CACHE_DIR = ".cclone.blocks";
+
+    // root — корень назначения (ключ кэша — относительный путь);
+    // use_cache == false отключает и чтение, и запись кэша
+    DeltaCopier(infra::ThreadPool& pool,
+                std::filesystem::path root,
+                std::uint64_t block_size = DEFAULT_BLOCK_SIZE,
+                bool use_cache = false);
+
+    [[nodiscard]] auto copy(const std::filesystem::path& src,
+                            const std::filesystem::path& dst,
+                            adapters::fs::Publish publish = adapters::fs::Publish::InPlace)
+        -> std::expected<DeltaResult, infra::Error>;
+
+    // Сохраняет подписи блоков после того, как назначение окончательно записано
+    // (в т.ч. восстановлены метаданные), чтобы ключ кэша совпал со следующим stat
+    [[nodiscard]] auto store_cache(const std::filesystem::path& dst,
+                                   std::span<const BlockSignature> blocks)
+        -> std::expected<void, infra::Error>;
+
+    [[nodiscard]] auto block_size() const -> std::uint64_t { return block_size_; }
+    [[nodiscard]] auto caching() const -> bool { return use_cache_; }
+
+private:
+    [[nodiscard]] auto cache_path(const std::filesystem::path& dst) const -> std::filesystem::path;
+
+    infra::ThreadPool& pool_;
+    const std::filesystem::path root_;
+    const std::uint64_t block_size_;
+    const bool use_cache_;
+
+    static constexpr std::uint64_t BYTES_PER_TASK = 64ull * 1024 * 1024; // 64MB на задачу пула
+};
+
+} // namespace cclone::extensions
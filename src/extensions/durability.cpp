@@ -0,0 +1,305 @@
+// durability.cpp
+#include "durability.hpp"
+#include "../infra/syscall/syscalls.hpp"
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+#include <cstring>
+#include <utility>
+
+#ifndef _WIN32
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+namespace cclone::extensions {
+
+namespace {
+
+#ifndef _WIN32
+auto sys_error(std::string_view what, const std::filesystem::path& path, int err = errno) -> infra::Error {
+    return infra::make_error(err == ENOSPC ? infra::ErrorCode::DiskFull : infra::ErrorCode::Unknown,
+                             fmt::format("{} {}: {}", what, path.string(), std::strerror(err)));
+}
+
+// Только данные и размер: время модификации на носитель не требуется
+auto sync_data(int fd) -> int {
+#ifdef __APPLE__
+    return infra::sys::fsync(fd);
+#else
+    return infra::sys::fdatasync(fd);
+#endif
+}
+
+auto device_of(const std::filesystem::path& path) -> std::optional<std::uint64_t> {
+    struct stat st{};
+    if (infra::sys::stat(path.c_str(), &st) != 0) return std::nullopt;
+    return static_cast<std::uint64_t>(st.st_dev);
+}
+#endif
+
+} // namespace
+
+DurabilityTracker::DurabilityTracker(infra::Durability mode)
+    : mode_(mode)
+{}
+
+auto DurabilityTracker::create(infra::Durability mode, const std::filesystem::path& root)
+    -> std::expected<std::unique_ptr<DurabilityTracker>, infra::Error>
+{
+#ifdef _WIN32
+    (void)mode; (void)root;
+    return std::unexpected(infra::make_error(infra::ErrorCode::UnsupportedFeature,
+                           "Durability modes are supported on POSIX only"));
+#else
+    std::unique_ptr<DurabilityTracker> tracker(new DurabilityTracker(mode));
+    if (mode == infra::Durability::End) {
+        const auto device = device_of(root);
+        if (!device) {
+            return std::unexpected(sys_error("Cannot stat destination", root));
+        }
+        tracker->filesystems_.emplace(*device, root);
+    }
+    if (mode == infra::Durability::Batch) {
+        tracker->flusher_ = std::jthread([raw = tracker.get()](std::stop_token stop) {
+            raw->flush_loop_(stop);
+        });
+    }
+    return tracker;
+#endif
+}
+
+DurabilityTracker::~DurabilityTracker() {
+    flusher_ = {};
+    for (const auto& pending : pending_) {
+#ifndef _WIN32
+        infra::sys::close(pending.fd);
+#endif
+    }
+}
+
+auto DurabilityTracker::file_written(int fd, const std::filesystem::path& path)
+    -> std::expected<void, infra::Error>
+{
+#ifndef _WIN32
+    switch (mode_) {
+    case infra::Durability::File:
+        if (sync_data(fd) != 0) {
+            return std::unexpected(sys_error("fdatasync failed for", path));
+        }
+        files_.fetch_add(1, std::memory_order_relaxed);
+        sync_directory_(path.parent_path());
+        return {};
+
+    case infra::Durability::Batch: {
+#ifdef __linux__
+        // Запускаем writeback сейчас: к fdatasync в окне данные уже в пути
+        (void)infra::sys::sync_file_range(fd, 0, 0, SYNC_FILE_RANGE_WRITE);
+#endif
+        const int dup = infra::sys::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+        if (dup == -1) {
+            // Дескрипторы кончились — сбрасываем синхронно, как в режиме file
+            if (sync_data(fd) != 0) {
+                return std::unexpected(sys_error("fdatasync failed for", path));
+            }
+            files_.fetch_add(1, std::memory_order_relaxed);
+            std::lock_guard lock(dirs_mutex_);
+            created_parents_.insert(path.parent_path());
+            return {};
+        }
+
+        std::unique_lock lock(pending_mutex_);
+        space_cv_.wait(lock, [&] { return pending_.size() < MAX_PENDING; });
+        pending_.push_back(Pending{.fd = dup, .parent = path.parent_path()});
+        if (pending_.size() >= BATCH_FILES) {
+            pending_cv_.notify_one();
+        }
+        return {};
+    }
+
+    case infra::Durability::End:
+    case infra::Durability::None:
+        return {};
+    }
+#else
+    (void)fd; (void)path;
+#endif
+    return {};
+}
+
+auto DurabilityTracker::file_written(const std::filesystem::path& path)
+    -> std::expected<void, infra::Error>
+{
+#ifndef _WIN32
+    if (mode_ != infra::Durability::File && mode_ != infra::Durability::Batch) {
+        return {};
+    }
+    const int fd = infra::sys::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return std::unexpected(sys_error("Cannot open for sync", path));
+    }
+    auto result = file_written(fd, path);
+    infra::sys::close(fd);
+    return result;
+#else
+    (void)path;
+    return {};
+#endif
+}
+
+void DurabilityTracker::directory_created(const std::filesystem::path& dir) {
+#ifndef _WIN32
+    std::lock_guard lock(dirs_mutex_);
+    if (mode_ == infra::Durability::End) {
+        // Точка монтирования внутри назначения — отдельный syncfs
+        if (const auto device = device_of(dir)) {
+            filesystems_.try_emplace(*device, dir);
+        }
+        return;
+    }
+    created_parents_.insert(dir.parent_path());
+#else
+    (void)dir;
+#endif
+}
+
+void DurabilityTracker::name_published(const std::filesystem::path& path) {
+    switch (mode_) {
+    case infra::Durability::File:
+        sync_directory_(path.parent_path());
+        return;
+    case infra::Durability::Batch: {
+        std::lock_guard lock(dirs_mutex_);
+        created_parents_.insert(path.parent_path());
+        return;
+    }
+    case infra::Durability::End:
+    case infra::Durability::None:
+        return;
+    }
+}
+
+auto DurabilityTracker::finish() -> std::expected<void, infra::Error> {
+#ifndef _WIN32
+    // Поток сбрасывает остаток очереди и завершается
+    if (flusher_.joinable()) {
+        flusher_.request_stop();
+        flusher_.join();
+    }
+
+    std::set<std::filesystem::path> parents;
+    std::map<std::uint64_t, std::filesystem::path> filesystems;
+    {
+        std::lock_guard lock(dirs_mutex_);
+        parents.swap(created_parents_);
+        filesystems.swap(filesystems_);
+    }
+    for (const auto& dir : parents) {
+        sync_directory_(dir);
+    }
+
+    for (const auto& [device, path] : filesystems) {
+        const int fd = infra::sys::open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd == -1) {
+            record_error_(sys_error("Cannot open for syncfs", path));
+            continue;
+        }
+#ifdef __linux__
+        if (infra::sys::syncfs(fd) != 0) {
+            record_error_(sys_error("syncfs failed for", path));
+        }
+#else
+        ::sync();
+#endif
+        infra::sys::close(fd);
+        filesystems_synced_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::lock_guard lock(error_mutex_);
+    if (first_error_) {
+        auto error = std::move(*first_error_);
+        if (error_count_ > 1) {
+            error.message = fmt::format("{} (and {} more sync errors)", error.message, error_count_ - 1);
+        }
+        first_error_.reset();
+        return std::unexpected(std::move(error));
+    }
+#endif
+    return {};
+}
+
+auto DurabilityTracker::stats() const -> Stats {
+    return Stats{
+        .files = files_.load(std::memory_order_relaxed),
+        .directories = directories_.load(std::memory_order_relaxed),
+        .filesystems = filesystems_synced_.load(std::memory_order_relaxed),
+        .batches = batches_.load(std::memory_order_relaxed),
+    };
+}
+
+void DurabilityTracker::flush_loop_(std::stop_token stop) {
+    std::unique_lock lock(pending_mutex_);
+    for (;;) {
+        pending_cv_.wait_for(lock, stop, BATCH_INTERVAL, [&] { return pending_.size() >= BATCH_FILES; });
+        if (pending_.empty()) {
+            if (stop.stop_requested()) return;
+            continue;
+        }
+        auto batch = std::exchange(pending_, {});
+        lock.unlock();
+        space_cv_.notify_all();
+        flush_batch_(batch);
+        lock.lock();
+    }
+}
+
+void DurabilityTracker::flush_batch_(std::vector<Pending>& batch) {
+#ifndef _WIN32
+    // Writeback всего окна уже запущен; fdatasync подряд ждут его
+    // завершения, а журнал ФС фиксирует их одной транзакцией
+    std::set<std::filesystem::path> parents;
+    for (auto& pending : batch) {
+        if (sync_data(pending.fd) != 0) {
+            record_error_(sys_error("fdatasync failed in", pending.parent));
+        }
+        infra::sys::close(pending.fd);
+        parents.insert(std::move(pending.parent));
+    }
+    files_.fetch_add(batch.size(), std::memory_order_relaxed);
+    batches_.fetch_add(1, std::memory_order_relaxed);
+
+    for (const auto& dir : parents) {
+        sync_directory_(dir);
+    }
+#else
+    (void)batch;
+#endif
+}
+
+void DurabilityTracker::sync_directory_(const std::filesystem::path& dir) {
+#ifndef _WIN32
+    const auto& target = dir.empty() ? std::filesystem::path(".") : dir;
+    const int fd = infra::sys::open(target.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd == -1) {
+        record_error_(sys_error("Cannot open directory for fsync", target));
+        return;
+    }
+    if (infra::sys::fsync(fd) != 0) {
+        record_error_(sys_error("fsync failed for directory", target));
+    }
+    infra::sys::close(fd);
+    directories_.fetch_add(1, std::memory_order_relaxed);
+#else
+    (void)dir;
+#endif
+}
+
+void DurabilityTracker::record_error_(infra::Error error) {
+    spdlog::debug("{}", error.message);
+    std::lock_guard lock(error_mutex_);
+    ++error_count_;
+    if (!first_error_) first_error_ = std::move(error);
+}
+
+} // namespace cclone::extensions
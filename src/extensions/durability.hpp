@@ -0,0 +1,115 @@
+// include/cclone/extensions/durability.hpp
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <thread>
+#include <vector>
+#include "../infra/error_handler/error.hpp"
+#include "../infra/config/config.hpp"
+
+namespace cclone::extensions {
+
+// Делает записанное в назначение устойчивым к потере питания (--durability).
+//
+//   file  — fdatasync каждого файла и fsync его каталога сразу после записи;
+//   batch — при записи только запускается writeback (sync_file_range),
+//           дубликат дескриптора уходит фоновому потоку, который окнами
+//           делает fdatasync накопившихся файлов и один fsync на каталог;
+//   end   — ничего во время копирования, в конце один syncfs на каждую
+//           файловую систему назначения.
+//
+// Ошибки batch/end выявляются в finish(): fsync, вернувший ошибку,
+// означает, что данные могли не дойти до носителя.
+class DurabilityTracker {
+public:
+    static constexpr std::size_t BATCH_FILES = 128;    // окно группового сброса
+    static constexpr std::size_t MAX_PENDING = 1024;   // предел удерживаемых дескрипторов
+    static constexpr std::chrono::milliseconds BATCH_INTERVAL{20};
+
+    struct Stats {
+        std::uint64_t files = 0;        // файлов сброшено fdatasync
+        std::uint64_t directories = 0;  // каталогов сброшено fsync
+        std::uint64_t filesystems = 0;  // вызовов syncfs
+        std::uint64_t batches = 0;      // окон фонового потока
+    };
+
+    // root — корень назначения; его файловая система сбрасывается в режиме end.
+    // На Windows — UnsupportedFeature.
+    static auto create(infra::Durability mode, const std::filesystem::path& root)
+        -> std::expected<std::unique_ptr<DurabilityTracker>, infra::Error>;
+
+    ~DurabilityTracker();
+
+    DurabilityTracker(const DurabilityTracker&) = delete;
+    DurabilityTracker& operator=(const DurabilityTracker&) = delete;
+
+    [[nodiscard]] auto mode() const -> infra::Durability { return mode_; }
+
+    // Данные файла записаны, fd ещё открыт (вызывается из DescriptorHook)
+    [[nodiscard]] auto file_written(int fd, const std::filesystem::path& path)
+        -> std::expected<void, infra::Error>;
+
+    // То же для файлов, записанных без хука (дельта, чанки, ссылки)
+    [[nodiscard]] auto file_written(const std::filesystem::path& path)
+        -> std::expected<void, infra::Error>;
+
+    // Каталог создан копированием: его запись в родителе тоже должна уцелеть
+    void directory_created(const std::filesystem::path& dir);
+
+    // Файл получил имя уже после file_written (--atomic): запись каталога
+    // появилась позже сброса данных, и каталог нужно сбросить ещё раз
+    void name_published(const std::filesystem::path& path);
+
+    // Дожидается сброса всего записанного; вызывается один раз в конце задания
+    [[nodiscard]] auto finish() -> std::expected<void, infra::Error>;
+
+    [[nodiscard]] auto stats() const -> Stats;
+
+private:
+    struct Pending {
+        int fd;
+        std::filesystem::path parent;
+    };
+
+    DurabilityTracker(infra::Durability mode);
+
+    void flush_loop_(std::stop_token stop);
+    void flush_batch_(std::vector<Pending>& batch);
+    void sync_directory_(const std::filesystem::path& dir);
+    void record_error_(infra::Error error);
+
+    const infra::Durability mode_;
+
+    // batch: очередь фонового потока
+    std::mutex pending_mutex_;
+    std::condition_variable_any pending_cv_;  // есть полное окно / остановка
+    std::condition_variable space_cv_;        // очередь ниже MAX_PENDING
+    std::vector<Pending> pending_;
+    std::jthread flusher_;
+
+    // file/batch: родители созданных каталогов; end: по пути на каждое устройство
+    std::mutex dirs_mutex_;
+    std::set<std::filesystem::path> created_parents_;
+    std::map<std::uint64_t, std::filesystem::path> filesystems_;
+
+    std::mutex error_mutex_;
+    std::optional<infra::Error> first_error_;
+    std::uint64_t error_count_ = 0;
+
+    std::atomic<std::uint64_t> files_{0};
+    std::atomic<std::uint64_t> directories_{0};
+    std::atomic<std::uint64_t> filesystems_synced_{0};
+    std::atomic<std::uint64_t> batches_{0};
+};
+
+} // namespace cclone::extensions
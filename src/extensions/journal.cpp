@@ -0,0 +1,407 @@
+// journal.cpp
+#include "journal.hpp"
+#include "../infra/syscall/syscalls.hpp"
+#include <xxhash.h>
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+#include <array>
+#include <cstring>
+#include <set>
+#include <type_traits>
+
+#ifndef _WIN32
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+namespace cclone::extensions {
+
+namespace {
+
+constexpr std::array<char, 8> MAGIC = {'C', 'C', 'J', 'R', 'N', 'L', '0', '1'};
+constexpr std::uint32_t VERSION = 1;
+constexpr std::uint64_t HEADER_SIZE = 16;
+constexpr std::uint64_t GROW_SIZE = 1024 * 1024; // ~26k записей на приращение
+
+enum RecordType : std::uint32_t {
+    FileBegin = 1,
+    ChunkDone = 2,
+    FileDone = 3,
+};
+
+auto sys_error(std::string_view what, const std::filesystem::path& path) -> infra::Error {
+    return infra::make_error(infra::ErrorCode::Unknown,
+                             fmt::format("{} {}: {}", what, path.string(), std::strerror(errno)));
+}
+
+} // namespace
+
+JobJournal::JobJournal(std::filesystem::path path, int fd, std::chrono::milliseconds commit_interval)
+    : path_(std::move(path))
+    , fd_(fd)
+    , commit_interval_(commit_interval)
+{}
+
+auto JobJournal::open(const std::filesystem::path& journal_path,
+                      std::chrono::milliseconds commit_interval)
+    -> std::expected<std::unique_ptr<JobJournal>, infra::Error>
+{
+#ifdef _WIN32
+    (void)journal_path; (void)commit_interval;
+    return std::unexpected(infra::make_error(infra::ErrorCode::UnsupportedFeature,
+                           "Job journal requires mmap"));
+#else
+    static_assert(std::is_trivially_copyable_v<Record>);
+    static_assert(sizeof(Record) == 40, "on-disk layout of journal record");
+
+    const int fd = infra::sys::open(journal_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        return std::unexpected(sys_error("Cannot open journal", journal_path));
+    }
+    std::unique_ptr<JobJournal> journal(new JobJournal(journal_path, fd, commit_interval));
+
+    struct stat st{};
+    if (infra::sys::fstat(fd, &st) != 0) {
+        return std::unexpected(sys_error("Cannot stat journal", journal_path));
+    }
+
+    const auto existing = static_cast<std::uint64_t>(st.st_size);
+    bool fresh = existing < HEADER_SIZE;
+    if (!fresh) {
+        std::array<char, HEADER_SIZE> header{};
+        if (infra::sys::pread(fd, header.data(), header.size(), 0) != static_cast<ssize_t>(header.size())
+            || std::memcmp(header.data(), MAGIC.data(), MAGIC.size()) != 0) {
+            spdlog::warn("Journal {} is not readable, starting a new one", journal_path.string());
+            fresh = true;
+        }
+    }
+
+    if (fresh) {
+        if (infra::sys::ftruncate(fd, 0) != 0) {
+            return std::unexpected(sys_error("Cannot reset journal", journal_path));
+        }
+        if (auto mapped = journal->map_(GROW_SIZE); !mapped) {
+            return std::unexpected(std::move(mapped.error()));
+        }
+        const std::uint32_t layout[2] = {VERSION, static_cast<std::uint32_t>(sizeof(Record))};
+        std::memcpy(journal->mapping_, MAGIC.data(), MAGIC.size());
+        std::memcpy(journal->mapping_ + MAGIC.size(), layout, sizeof(layout));
+        journal->tail_ = HEADER_SIZE;
+        if (infra::sys::fdatasync(fd) != 0) {
+            return std::unexpected(sys_error("Cannot sync journal", journal_path));
+        }
+    } else {
+        if (auto mapped = journal->map_(existing); !mapped) {
+            return std::unexpected(std::move(mapped.error()));
+        }
+        journal->replay_();
+    }
+    journal->committed_ = journal->tail_;
+
+    journal->committer_ = std::jthread([raw = journal.get()](std::stop_token stop) {
+        std::mutex wait_mutex;
+        std::unique_lock lock(wait_mutex);
+        while (!stop.stop_requested()) {
+            raw->commit_cv_.wait_for(lock, stop, raw->commit_interval_, [] { return false; });
+            if (auto committed = raw->commit(); !committed) {
+                spdlog::warn("Journal commit failed: {}", committed.error().message);
+            }
+        }
+    });
+
+    return journal;
+#endif
+}
+
+JobJournal::~JobJournal() {
+    committer_ = {};
+    if (fd_ != -1) {
+        (void)commit();
+    }
+    close_();
+}
+
+auto JobJournal::map_(std::uint64_t capacity) -> std::expected<void, infra::Error> {
+#ifndef _WIN32
+    if (infra::sys::ftruncate(fd_, static_cast<off_t>(capacity)) != 0) {
+        return std::unexpected(sys_error("Cannot grow journal", path_));
+    }
+    if (mapping_) {
+        infra::sys::munmap(mapping_, capacity_);
+        mapping_ = nullptr;
+    }
+    void* addr = infra::sys::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+        capacity_ = 0;
+        return std::unexpected(sys_error("Cannot map journal", path_));
+    }
+    mapping_ = static_cast<char*>(addr);
+    capacity_ = capacity;
+#endif
+    return {};
+}
+
+void JobJournal::replay_() {
+    std::uint64_t offset = HEADER_SIZE;
+    std::size_t records = 0;
+    while (offset + sizeof(Record) <= capacity_) {
+        Record record;
+        std::memcpy(&record, mapping_ + offset, sizeof(record));
+        if (record.type == 0) break; // незаписанная (нулевая) часть файла
+
+        const auto check = record.check;
+        record.check = 0;
+        if (static_cast<std::uint32_t>(XXH3_64bits(&record, sizeof(record))) != check) {
+            spdlog::warn("Journal {}: torn record at offset {}, dropping the tail", path_.string(), offset);
+            break;
+        }
+
+        auto& file = state_[record.path_hash];
+        const bool same_source = file.size == record.size && file.mtime_ns == record.mtime_ns;
+        switch (record.type) {
+            case FileBegin:
+                file = FileState{.size = record.size, .mtime_ns = record.mtime_ns, .chunk_size = record.value};
+                if (record.value > 0) {
+                    file.chunks.assign(static_cast<std::size_t>((record.size + record.value - 1) / record.value), false);
+                }
+                break;
+            case ChunkDone:
+                if (same_source && !file.done && record.value < file.chunks.size()) {
+                    file.chunks[static_cast<std::size_t>(record.value)] = true;
+                }
+                break;
+            case FileDone:
+                file = FileState{.size = record.size, .mtime_ns = record.mtime_ns, .done = true};
+                break;
+            default:
+                break;
+        }
+        offset += sizeof(Record);
+        ++records;
+    }
+    tail_ = offset;
+    spdlog::debug("Journal {}: replayed {} records for {} files", path_.string(), records, state_.size());
+}
+
+auto JobJournal::is_complete(std::uint64_t path_hash,
+                             std::uint64_t size,
+                             std::int64_t mtime_ns) const -> bool
+{
+    const auto it = state_.find(path_hash);
+    return it != state_.end()
+        && it->second.done
+        && it->second.size == size
+        && it->second.mtime_ns == mtime_ns;
+}
+
+auto JobJournal::completed_chunks(std::uint64_t path_hash,
+                                  std::uint64_t size,
+                                  std::int64_t mtime_ns,
+                                  std::uint64_t chunk_size) const -> std::vector<bool>
+{
+    const auto it = state_.find(path_hash);
+    if (it == state_.end()) return {};
+    const auto& file = it->second;
+    if (file.done || file.size != size || file.mtime_ns != mtime_ns || file.chunk_size != chunk_size) {
+        return {};
+    }
+    return file.chunks;
+}
+
+void JobJournal::file_begin(std::uint64_t path_hash, std::uint64_t size, std::int64_t mtime_ns,
+                            std::uint64_t chunk_size, const std::filesystem::path& data)
+{
+    defer_(make_record_(FileBegin, path_hash, size, mtime_ns, chunk_size), data);
+}
+
+void JobJournal::chunk_done(std::uint64_t path_hash, std::uint64_t size, std::int64_t mtime_ns,
+                            std::uint64_t chunk_index, const std::filesystem::path& data)
+{
+    defer_(make_record_(ChunkDone, path_hash, size, mtime_ns, chunk_index), data);
+}
+
+void JobJournal::file_done(std::uint64_t path_hash, std::uint64_t size, std::int64_t mtime_ns,
+                           const std::filesystem::path& data)
+{
+    defer_(make_record_(FileDone, path_hash, size, mtime_ns, 0), data);
+}
+
+auto JobJournal::make_record_(std::uint32_t type, std::uint64_t path_hash, std::uint64_t size,
+                              std::int64_t mtime_ns, std::uint64_t value) -> Record
+{
+    Record record{.type = type, .check = 0, .path_hash = path_hash,
+                  .size = size, .mtime_ns = mtime_ns, .value = value};
+    record.check = static_cast<std::uint32_t>(XXH3_64bits(&record, sizeof(record)));
+    return record;
+}
+
+void JobJournal::append_(const Record& record) {
+    std::lock_guard lock(append_mutex_);
+    if (!mapping_) return;
+    if (tail_ + sizeof(Record) > capacity_) {
+        if (auto grown = map_(capacity_ + GROW_SIZE); !grown) {
+            // Без журнала копирование продолжается, теряется только возобновляемость
+            spdlog::error("Journal disabled: {}", grown.error().message);
+            return;
+        }
+    }
+    std::memcpy(mapping_ + tail_, &record, sizeof(record));
+    tail_ += sizeof(Record);
+}
+
+void JobJournal::defer_(const Record& record, const std::filesystem::path& data) {
+    // В отображение запись попадёт только после сброса данных: страницы
+    // MAP_SHARED ядро может записать на диск в любой момент
+    std::lock_guard lock(pending_mutex_);
+    pending_[data].push_back(record);
+}
+
+void JobJournal::sync_data_(std::map<std::filesystem::path, std::vector<Record>>& pending) {
+#ifndef _WIN32
+    struct stat journal_st{};
+    const bool whole_fs =
+#ifdef __linux__
+        pending.size() >= SYNCFS_FILES && infra::sys::fstat(fd_, &journal_st) == 0;
+#else
+        false;
+#endif
+
+    std::size_t dropped = 0;
+    std::set<std::filesystem::path> parents;
+    std::vector<std::filesystem::path> via_syncfs;
+    for (auto it = pending.begin(); it != pending.end();) {
+        const auto& data = it->first;
+        struct stat st{};
+        if (infra::sys::lstat(data.c_str(), &st) != 0) {
+            // Файла нет — и записывать о нём нечего
+            dropped += it->second.size();
+            it = pending.erase(it);
+            continue;
+        }
+        if (whole_fs && st.st_dev == journal_st.st_dev) {
+            // Один syncfs ниже сбросит и данные, и записи каталогов
+            via_syncfs.push_back(data);
+            ++it;
+            continue;
+        }
+        parents.insert(data.parent_path());
+        if (S_ISREG(st.st_mode)) {
+            const int fd = infra::sys::open(data.c_str(), O_RDONLY | O_CLOEXEC | O_NOFOLLOW);
+            const bool synced = fd != -1 && infra::sys::fdatasync(fd) == 0;
+            if (fd != -1) infra::sys::close(fd);
+            if (!synced) {
+                dropped += it->second.size();
+                it = pending.erase(it);
+                continue;
+            }
+        }
+        ++it;
+    }
+
+#ifdef __linux__
+    if (!via_syncfs.empty() && infra::sys::syncfs(fd_) != 0) {
+        for (const auto& data : via_syncfs) {
+            dropped += pending[data].size();
+            pending.erase(data);
+        }
+    }
+#endif
+
+    // Запись каталога нужна, чтобы после сбоя файл вообще нашёлся по имени
+    for (const auto& dir : parents) {
+        const auto& target = dir.empty() ? std::filesystem::path(".") : dir;
+        const int fd = infra::sys::open(target.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd != -1 && infra::sys::fsync(fd) == 0) {
+            infra::sys::close(fd);
+            continue;
+        }
+        if (fd != -1) infra::sys::close(fd);
+        for (auto it = pending.begin(); it != pending.end();) {
+            if (it->first.parent_path() == dir) {
+                dropped += it->second.size();
+                it = pending.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    if (dropped > 0) {
+        // Данные не подтверждены: эти файлы/чанки скопируются заново при --resume
+        spdlog::warn("Journal {}: {} records dropped, their data could not be synced", path_.string(), dropped);
+    }
+#else
+    (void)pending;
+#endif
+}
+
+auto JobJournal::commit() -> std::expected<void, infra::Error> {
+#ifndef _WIN32
+    std::lock_guard commit_lock(commit_mutex_);
+
+    std::map<std::filesystem::path, std::vector<Record>> pending;
+    {
+        std::lock_guard lock(pending_mutex_);
+        pending.swap(pending_);
+    }
+    if (!pending.empty()) {
+        sync_data_(pending);
+        for (const auto& [data, records] : pending) {
+            for (const auto& record : records) {
+                append_(record);
+            }
+        }
+    }
+
+    std::uint64_t tail = 0;
+    {
+        std::lock_guard lock(append_mutex_);
+        tail = tail_;
+    }
+    if (tail == committed_) return {};
+
+    // Запись в MAP_SHARED попадает в page cache файла,
+    // fdatasync сбрасывает её вместе с изменением размера
+#if defined(__linux__)
+    const int rc = infra::sys::fdatasync(fd_);
+#else
+    const int rc = infra::sys::fsync(fd_);
+#endif
+    if (rc != 0) {
+        return std::unexpected(sys_error("Cannot sync journal", path_));
+    }
+    committed_ = tail;
+#endif
+    return {};
+}
+
+auto JobJournal::discard() -> std::expected<void, infra::Error> {
+    committer_ = {};
+    close_();
+    std::error_code ec;
+    infra::sys::remove(path_, ec);
+    if (ec) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                               fmt::format("Cannot remove journal {}: {}", path_.string(), ec.message())));
+    }
+    return {};
+}
+
+void JobJournal::close_() {
+#ifndef _WIN32
+    std::lock_guard lock(append_mutex_);
+    if (mapping_) {
+        infra::sys::munmap(mapping_, capacity_);
+        mapping_ = nullptr;
+    }
+    if (fd_ != -1) {
+        infra::sys::close(fd_);
+        fd_ = -1;
+    }
+#endif
+}
+
+} // namespace cclone::extensions
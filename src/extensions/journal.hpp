@@ -0,0 +1,142 @@
+// include/cclone/extensions/journal.hpp
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "../infra/error_handler/error.hpp"
+
+namespace cclone::extensions {
+
+// Журнал задания копирования: append-only лог фиксированных записей
+// в корне назначения (.cclone.journal), отображённый в память.
+//
+// Записи: FileBegin (начато поблочное копирование), ChunkDone (чанк записан),
+// FileDone (файл полностью скопирован). Каждая запись несёт size/mtime_ns
+// источника, так что изменившийся источник автоматически обесценивает
+// старые записи. Целостность записи — по контрольной сумме: оборванный
+// хвост после сбоя отбрасывается при открытии.
+//
+// Фиксация групповая: фоновый поток раз в commit_interval делает один
+// fdatasync на все накопившиеся записи. Потерянные после сбоя записи
+// означают лишь повторное копирование соответствующих файлов/чанков.
+//
+// Записи описывают данные в файле назначения, поэтому до фиксации
+// лежат в памяти (для каждого файла — в порядке поступления): поток
+// сначала сбрасывает сами данные (fdatasync файлов и fsync их каталогов,
+// а при SYNCFS_FILES и более файлах в окне — один syncfs), и только
+// потом кладёт записи в журнал.
+// Запись не может оказаться на диске раньше своих данных: иначе после
+// потери питания --resume пропустил бы недописанный файл.
+//
+// Формат (little-endian):
+//   header: magic "CCJRNL01", u32 version, u32 record_size
+//   record: u32 type, u32 check, u64 path_hash, u64 size, i64 mtime_ns, u64 value
+//           (value: chunk_size для FileBegin, номер чанка для ChunkDone)
+class JobJournal {
+public:
+    static constexpr std::string_view FILE_NAME = ".cclone.journal";
+    static constexpr std::chrono::milliseconds DEFAULT_COMMIT_INTERVAL{50};
+    static constexpr std::size_t SYNCFS_FILES = 32;
+
+    // Открывает журнал, воспроизводя уже записанное, или создаёт новый
+    static auto open(const std::filesystem::path& journal_path,
+                     std::chrono::milliseconds commit_interval = DEFAULT_COMMIT_INTERVAL)
+        -> std::expected<std::unique_ptr<JobJournal>, infra::Error>;
+
+    ~JobJournal();
+
+    JobJournal(const JobJournal&) = delete;
+    JobJournal& operator=(const JobJournal&) = delete;
+
+    // --- Состояние прошлых запусков (не меняется после open) ---
+
+    [[nodiscard]] auto is_complete(std::uint64_t path_hash,
+                                   std::uint64_t size,
+                                   std::int64_t mtime_ns) const -> bool;
+
+    // Битовая карта чанков незавершённого файла; пусто, если продолжать нечего
+    // (файла нет в журнале, источник изменился или другой размер чанка)
+    [[nodiscard]] auto completed_chunks(std::uint64_t path_hash,
+                                        std::uint64_t size,
+                                        std::int64_t mtime_ns,
+                                        std::uint64_t chunk_size) const -> std::vector<bool>;
+
+    [[nodiscard]] auto replayed_files() const -> std::size_t { return state_.size(); }
+
+    // --- Запись (потокобезопасна) ---
+
+    // data — файл назначения, к которому относится запись
+    void file_begin(std::uint64_t path_hash, std::uint64_t size, std::int64_t mtime_ns,
+                    std::uint64_t chunk_size, const std::filesystem::path& data);
+    void chunk_done(std::uint64_t path_hash, std::uint64_t size, std::int64_t mtime_ns,
+                    std::uint64_t chunk_index, const std::filesystem::path& data);
+    void file_done(std::uint64_t path_hash, std::uint64_t size, std::int64_t mtime_ns,
+                   const std::filesystem::path& data);
+
+    // Синхронно фиксирует всё, что дописано к этому моменту
+    [[nodiscard]] auto commit() -> std::expected<void, infra::Error>;
+
+    // Задание завершено: журнал больше не нужен
+    [[nodiscard]] auto discard() -> std::expected<void, infra::Error>;
+
+private:
+    struct Record {
+        std::uint32_t type;
+        std::uint32_t check;
+        std::uint64_t path_hash;
+        std::uint64_t size;
+        std::int64_t mtime_ns;
+        std::uint64_t value;
+    };
+
+    struct FileState {
+        std::uint64_t size = 0;
+        std::int64_t mtime_ns = 0;
+        std::uint64_t chunk_size = 0;
+        bool done = false;
+        std::vector<bool> chunks;
+    };
+
+    JobJournal(std::filesystem::path path, int fd, std::chrono::milliseconds commit_interval);
+
+    auto map_(std::uint64_t capacity) -> std::expected<void, infra::Error>;
+    void replay_();
+    static auto make_record_(std::uint32_t type, std::uint64_t path_hash, std::uint64_t size,
+                             std::int64_t mtime_ns, std::uint64_t value) -> Record;
+    void append_(const Record& record);
+    void defer_(const Record& record, const std::filesystem::path& data);
+    void sync_data_(std::map<std::filesystem::path, std::vector<Record>>& pending);
+    void close_();
+
+    const std::filesystem::path path_;
+    int fd_ = -1;
+    char* mapping_ = nullptr;
+    std::uint64_t capacity_ = 0;
+
+    std::mutex append_mutex_;            // хвост и перемапливание при росте
+    std::uint64_t tail_ = 0;
+    std::mutex commit_mutex_;            // один fdatasync за раз
+    std::uint64_t committed_ = 0;
+
+    // Записи, ждущие сброса своих данных, по файлу назначения
+    std::mutex pending_mutex_;
+    std::map<std::filesystem::path, std::vector<Record>> pending_;
+
+    std::unordered_map<std::uint64_t, FileState> state_;
+
+    const std::chrono::milliseconds commit_interval_;
+    std::condition_variable_any commit_cv_;
+    std::jthread committer_;
+};
+
+} // namespace cclone::extensions
@@ -0,0 +1,340 @@
+// manifest.cpp
+#include "manifest.hpp"
+#include "../infra/hash/tree_hasher.hpp"
+#include "../infra/hash/xxhash_verifier.hpp"
+#include "../infra/syscall/syscalls.hpp"
+#include "../infra/thread_pool/thread_pool.hpp"
+#include "../infra/thread_pool/work_stealing_pool.hpp"
+#include <spdlog/spdlog.h>
+#include <fmt/core.h>
+#include <fmt/ostream.h>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <ostream>
+
+#ifndef _WIN32
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace cclone::extensions {
+
+namespace {
+
+constexpr std::array<char, 8> MAGIC = {'C', 'C', 'M', 'A', 'N', 'I', 'F', '1'};
+constexpr std::uint32_t VERSION = 1;
+constexpr std::size_t HEADER_SIZE = 24;        // magic + version + reserved + entry_count
+constexpr std::size_t RECORD_FIXED_SIZE = 40;  // 4 x u64 + u32 path_len + u32 reserved
+constexpr std::streamoff COUNT_OFFSET = 16;
+
+auto padded(std::size_t length) -> std::size_t {
+    return (length + 7) & ~std::size_t{7};
+}
+
+template<typename T>
+void put(std::string& buffer, T value) {
+    char raw[sizeof(T)];
+    std::memcpy(raw, &value, sizeof(T));
+    buffer.append(raw, sizeof(T));
+}
+
+template<typename T>
+auto get(const char* data) -> T {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+void serialize(const ManifestEntry& entry, std::string& buffer) {
+    put<std::uint64_t>(buffer, entry.size);
+    put<std::int64_t>(buffer, entry.mtime_ns);
+    put<std::uint64_t>(buffer, entry.hash);
+    put<std::uint64_t>(buffer, entry.segment_size);
+    put<std::uint32_t>(buffer, static_cast<std::uint32_t>(entry.path.size()));
+    put<std::uint32_t>(buffer, 0);
+    buffer.append(entry.path);
+    buffer.append(padded(entry.path.size()) - entry.path.size(), '\0');
+}
+
+auto parse(const char* data, std::size_t size, const std::filesystem::path& manifest_path)
+    -> std::expected<std::vector<ManifestEntry>, infra::Error>
+{
+    auto corrupt = [&](std::string_view what) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::InvalidPath,
+                               fmt::format("Corrupt manifest {}: {}", manifest_path.string(), what)));
+    };
+
+    if (size < HEADER_SIZE || std::memcmp(data, MAGIC.data(), MAGIC.size()) != 0) {
+        return corrupt("bad header");
+    }
+    if (get<std::uint32_t>(data + 8) != VERSION) {
+        return corrupt("unsupported version");
+    }
+    const auto count = get<std::uint64_t>(data + COUNT_OFFSET);
+
+    std::vector<ManifestEntry> entries;
+    entries.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(count, size / RECORD_FIXED_SIZE)));
+    std::size_t offset = HEADER_SIZE;
+    for (std::uint64_t i = 0; i < count; ++i) {
+        if (offset + RECORD_FIXED_SIZE > size) {
+            return corrupt("truncated record");
+        }
+        const char* record = data + offset;
+        ManifestEntry entry;
+        entry.size = get<std::uint64_t>(record);
+        entry.mtime_ns = get<std::int64_t>(record + 8);
+        entry.hash = get<std::uint64_t>(record + 16);
+        entry.segment_size = get<std::uint64_t>(record + 24);
+        const auto path_len = get<std::uint32_t>(record + 32);
+        offset += RECORD_FIXED_SIZE;
+        if (offset + padded(path_len) > size) {
+            return corrupt("truncated path");
+        }
+        entry.path.assign(data + offset, path_len);
+        offset += padded(path_len);
+        entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+auto mtime_ns_of(const std::filesystem::path& path, std::error_code& ec) -> std::int64_t {
+    const auto time = infra::sys::last_write_time(path, ec);
+    if (ec) return 0;
+    const auto sys = std::chrono::file_clock::to_sys(time);
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(sys.time_since_epoch()).count();
+}
+
+} // namespace
+
+// =============== ManifestWriter ===============
+
+auto ManifestWriter::create(const std::filesystem::path& manifest_path)
+    -> std::expected<std::unique_ptr<ManifestWriter>, infra::Error>
+{
+    std::ofstream out(manifest_path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::PermissionDenied,
+                               fmt::format("Cannot create manifest: {}", manifest_path.string())));
+    }
+
+    std::string header(MAGIC.data(), MAGIC.size());
+    put<std::uint32_t>(header, VERSION);
+    put<std::uint32_t>(header, 0);
+    put<std::uint64_t>(header, 0); // число записей дописывается в close()
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    return std::unique_ptr<ManifestWriter>(new ManifestWriter(std::move(out)));
+}
+
+ManifestWriter::ManifestWriter(std::ofstream&& out)
+    : out_(std::move(out))
+{
+    flusher_ = std::jthread([this](std::stop_token st) {
+        while (!st.stop_requested()) {
+            flush_pending_();
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        }
+    });
+}
+
+ManifestWriter::~ManifestWriter() {
+    if (!closed_) {
+        auto res = close();
+        if (!res) {
+            spdlog::warn("Failed to finalize manifest: {}", res.error().message);
+        }
+    }
+}
+
+void ManifestWriter::append(ManifestEntry entry) {
+    auto* node = new Node{std::move(entry), head_.load(std::memory_order_relaxed)};
+    while (!head_.compare_exchange_weak(node->next, node,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+    }
+}
+
+void ManifestWriter::flush_pending_() {
+    Node* batch = head_.exchange(nullptr, std::memory_order_acquire);
+    if (!batch) return;
+
+    // Стек отдаёт записи в обратном порядке — разворачиваем
+    Node* ordered = nullptr;
+    while (batch) {
+        Node* next = batch->next;
+        batch->next = ordered;
+        ordered = batch;
+        batch = next;
+    }
+
+    std::string buffer;
+    while (ordered) {
+        serialize(ordered->entry, buffer);
+        ++written_;
+        Node* done = ordered;
+        ordered = ordered->next;
+        delete done;
+    }
+    out_.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+auto ManifestWriter::close() -> std::expected<void, infra::Error> {
+    if (closed_) return {};
+    closed_ = true;
+
+    if (flusher_.joinable()) {
+        flusher_.request_stop();
+        flusher_.join();
+    }
+    flush_pending_();
+
+    out_.seekp(COUNT_OFFSET);
+    std::string count;
+    put<std::uint64_t>(count, written_);
+    out_.write(count.data(), static_cast<std::streamsize>(count.size()));
+    out_.flush();
+    if (!out_) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::DiskFull, "Failed to write manifest"));
+    }
+    out_.close();
+    return {};
+}
+
+// =============== Чтение и экспорт ===============
+
+auto load_manifest(const std::filesystem::path& manifest_path)
+    -> std::expected<std::vector<ManifestEntry>, infra::Error>
+{
+#ifndef _WIN32
+    int fd = infra::sys::open(manifest_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::FileNotFound,
+                               fmt::format("Cannot open manifest: {}", manifest_path.string())));
+    }
+    struct stat sb;
+    if (infra::sys::fstat(fd, &sb) == -1) {
+        infra::sys::close(fd);
+        return std::unexpected(infra::make_error(infra::ErrorCode::Unknown, "fstat failed"));
+    }
+    const auto size = static_cast<std::size_t>(sb.st_size);
+    if (size == 0) {
+        infra::sys::close(fd);
+        return parse(nullptr, 0, manifest_path);
+    }
+    void* map = infra::sys::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    infra::sys::close(fd);
+    if (map == MAP_FAILED) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::Unknown, "mmap failed"));
+    }
+    auto entries = parse(static_cast<const char*>(map), size, manifest_path);
+    infra::sys::munmap(map, size);
+    return entries;
+#else
+    std::ifstream in(manifest_path, std::ios::binary);
+    if (!in) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::FileNotFound,
+                               fmt::format("Cannot open manifest: {}", manifest_path.string())));
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return parse(data.data(), data.size(), manifest_path);
+#endif
+}
+
+void export_manifest_text(const std::vector<ManifestEntry>& entries, std::ostream& out) {
+    for (const auto& entry : entries) {
+        fmt::print(out, "{:016x}  {}  {}  {}\n", entry.hash, entry.size, entry.mtime_ns, entry.path);
+    }
+}
+
+// =============== Проверка ===============
+
+auto check_manifest(const std::filesystem::path& manifest_path,
+                    const std::filesystem::path& destination_root,
+                    std::size_t threads)
+    -> std::expected<ManifestCheckResult, infra::Error>
+{
+    auto entries = load_manifest(manifest_path);
+    if (!entries) {
+        return std::unexpected(std::move(entries.error()));
+    }
+
+    std::atomic<std::uint64_t> ok{0}, missing{0}, mismatched{0}, errors{0};
+
+    // Файлы проверяются на file_pool; большие файлы с деревом
+    // хешируют сегменты на hash_pool, чтобы не блокировать сами себя
+    infra::ThreadPool hash_pool{threads};
+    {
+        infra::WorkStealingPool file_pool{threads};
+        for (const auto& entry : *entries) {
+            file_pool.enqueue([&, entry]() {
+                const auto path = destination_root / std::filesystem::path(entry.path);
+
+                std::error_code ec;
+                const auto size = infra::sys::file_size(path, ec);
+                if (ec) {
+                    spdlog::warn("Missing: {}", path.string());
+                    missing.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                if (size != entry.size) {
+                    spdlog::warn("Size mismatch: {} ({} != {})", path.string(), size, entry.size);
+                    mismatched.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+
+                std::expected<std::uint64_t, infra::Error> hash;
+                if (entry.segment_size == 0) {
+                    hash = infra::XXHashVerifier::hash_file(path);
+                } else {
+                    infra::TreeHasher hasher(hash_pool, entry.segment_size);
+                    auto digest = hasher.hash_file(path);
+                    if (digest) hash = digest->root;
+                    else hash = std::unexpected(std::move(digest.error()));
+                }
+
+                if (!hash) {
+                    (void)infra::log_and_return(std::move(hash.error()));
+                    errors.fetch_add(1, std::memory_order_relaxed);
+                } else if (*hash != entry.hash) {
+                    spdlog::warn("Hash mismatch: {} ({:016x} != {:016x})", path.string(), *hash, entry.hash);
+                    mismatched.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    ok.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+        file_pool.wait();
+    }
+
+    return ManifestCheckResult{
+        .files_ok = ok.load(),
+        .files_missing = missing.load(),
+        .files_mismatched = mismatched.load(),
+        .errors = errors.load()
+    };
+}
+
+auto make_manifest_entry(const std::filesystem::path& relative_path,
+                         const std::filesystem::path& file,
+                         std::uint64_t hash,
+                         std::uint64_t segment_size)
+    -> std::expected<ManifestEntry, infra::Error>
+{
+    std::error_code ec;
+    ManifestEntry entry;
+    entry.path = relative_path.generic_string();
+    entry.size = infra::sys::file_size(file, ec);
+    if (!ec) entry.mtime_ns = mtime_ns_of(file, ec);
+    if (ec) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::FileNotFound,
+                               fmt::format("Cannot stat {} for manifest: {}", file.string(), ec.message())));
+    }
+    entry.hash = hash;
+    entry.segment_size = segment_size;
+    return entry;
+}
+
+} // namespace cclone::extensions
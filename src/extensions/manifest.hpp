@@ -0,0 +1,98 @@
+// include/cclone/extensions/manifest.hpp
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../infra/error_handler/error.hpp"
+
+namespace cclone::extensions {
+
+// Запись манифеста: состояние одного скопированного файла
+struct ManifestEntry {
+    std::string path;               // относительно корня назначения, '/' как разделитель
+    std::uint64_t size = 0;
+    std::int64_t mtime_ns = 0;      // наносекунды от Unix epoch
+    std::uint64_t hash = 0;         // XXH3-64 содержимого
+    std::uint64_t segment_size = 0; // 0 — плоский XXH3, иначе корень TreeHasher с этим сегментом
+};
+
+struct ManifestCheckResult {
+    std::uint64_t files_ok = 0;
+    std::uint64_t files_missing = 0;
+    std::uint64_t files_mismatched = 0;
+    std::uint64_t errors = 0;
+};
+
+// Пишет бинарный манифест во время копирования.
+// append() вызывается рабочими потоками и не берёт блокировок:
+// записи попадают в lock-free стек, который фоновый поток
+// периодически забирает целиком и сбрасывает на диск.
+//
+// Формат (little-endian):
+//   header: magic "CCMANIF1", u32 version, u32 reserved, u64 entry_count
+//   record: u64 size, i64 mtime_ns, u64 hash, u64 segment_size,
+//           u32 path_len, u32 reserved, path (дополнен нулями до 8 байт)
+class ManifestWriter {
+public:
+    static auto create(const std::filesystem::path& manifest_path)
+        -> std::expected<std::unique_ptr<ManifestWriter>, infra::Error>;
+
+    ~ManifestWriter();
+
+    ManifestWriter(const ManifestWriter&) = delete;
+    ManifestWriter& operator=(const ManifestWriter&) = delete;
+
+    void append(ManifestEntry entry);
+
+    // Сбрасывает оставшиеся записи и дописывает число записей в заголовок
+    [[nodiscard]] auto close() -> std::expected<void, infra::Error>;
+
+    [[nodiscard]] auto entry_count() const -> std::uint64_t { return written_; }
+
+private:
+    struct Node {
+        ManifestEntry entry;
+        Node* next = nullptr;
+    };
+
+    explicit ManifestWriter(std::ofstream&& out);
+
+    void flush_pending_();
+
+    std::ofstream out_;
+    std::atomic<Node*> head_{nullptr};
+    std::uint64_t written_ = 0; // меняется только потоком сброса
+    bool closed_ = false;
+    std::jthread flusher_;
+};
+
+// Собирает запись по файлу назначения и уже посчитанному хешу
+[[nodiscard]] auto make_manifest_entry(const std::filesystem::path& relative_path,
+                                       const std::filesystem::path& file,
+                                       std::uint64_t hash,
+                                       std::uint64_t segment_size)
+    -> std::expected<ManifestEntry, infra::Error>;
+
+// Загружает бинарный манифест (через mmap там, где он доступен)
+[[nodiscard]] auto load_manifest(const std::filesystem::path& manifest_path)
+    -> std::expected<std::vector<ManifestEntry>, infra::Error>;
+
+// Текстовый экспорт: "<hash>  <size>  <mtime_ns>  <path>" на строку
+void export_manifest_text(const std::vector<ManifestEntry>& entries, std::ostream& out);
+
+// Перепроверяет назначение по манифесту, не обращаясь к источнику.
+// Файлы проверяются параллельно на threads потоках.
+[[nodiscard]] auto check_manifest(const std::filesystem::path& manifest_path,
+                                  const std::filesystem::path& destination_root,
+                                  std::size_t threads)
+    -> std::expected<ManifestCheckResult, infra::Error>;
+
+} // namespace cclone::extensions
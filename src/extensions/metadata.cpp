@@ -1,34 +1,192 @@
 // metadata.cpp
 #include <filesystem>
 #include <expected>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cerrno>
+#include <cstring>
 #include "metadata.hpp"
+#include "../infra/syscall/syscalls.hpp"
+
+#ifndef _WIN32
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#ifdef __linux__
+    #include <sys/xattr.h>
+#endif
+
 namespace cclone::extensions {
 
+namespace {
+
+#ifdef __linux__
+// Ошибки, при которых атрибут пропускается, а не проваливает файл:
+// ФС назначения не поддерживает xattr/ACL или нет прав на пространство имён
+bool skippable_xattr_error(int err) {
+    return err == ENOTSUP || err == EPERM || err == EACCES;
+}
+
+// Список атрибутов источника; пустая строка-разделитель — '\0'
+auto list_xattrs(int fd) -> std::expected<std::vector<char>, int> {
+    std::vector<char> names;
+    for (;;) {
+        const ssize_t size = infra::sys::flistxattr(fd, nullptr, 0);
+        if (size < 0) return std::unexpected(errno);
+        if (size == 0) return names;
+        names.resize(static_cast<std::size_t>(size));
+        const ssize_t got = infra::sys::flistxattr(fd, names.data(), names.size());
+        if (got >= 0) {
+            names.resize(static_cast<std::size_t>(got));
+            return names;
+        }
+        if (errno != ERANGE) return std::unexpected(errno); // ERANGE — список вырос, повторяем
+    }
+}
+
+auto copy_xattrs(int src_fd, int dst_fd) -> std::expected<void, infra::Error> {
+    auto names = list_xattrs(src_fd);
+    if (!names) {
+        if (skippable_xattr_error(names.error())) return {};
+        return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                               fmt::format("flistxattr failed: {}", std::strerror(names.error()))));
+    }
+
+    std::vector<char> value;
+    for (const char* name = names->data(); name < names->data() + names->size(); name += std::strlen(name) + 1) {
+        ssize_t size = infra::sys::fgetxattr(src_fd, name, nullptr, 0);
+        if (size >= 0) {
+            value.resize(static_cast<std::size_t>(size));
+            size = infra::sys::fgetxattr(src_fd, name, value.data(), value.size());
+        }
+        if (size < 0) {
+            spdlog::debug("Skipping xattr {}: {}", name, std::strerror(errno));
+            continue;
+        }
+        // system.posix_acl_* переносятся тем же вызовом — ядро разбирает их как ACL
+        if (infra::sys::fsetxattr(dst_fd, name, value.data(), static_cast<std::size_t>(size), 0) != 0) {
+            if (!skippable_xattr_error(errno)) {
+                return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                                       fmt::format("fsetxattr {} failed: {}", name, std::strerror(errno))));
+            }
+            spdlog::debug("Skipping xattr {}: {}", name, std::strerror(errno));
+        }
+    }
+    return {};
+}
+#endif
+
+#ifndef _WIN32
+auto to_timespec(std::int64_t ns) -> timespec {
+    timespec ts{};
+    ts.tv_sec = static_cast<time_t>(ns / 1'000'000'000);
+    ts.tv_nsec = static_cast<long>(ns % 1'000'000'000);
+    if (ts.tv_nsec < 0) { // время до 1970 года
+        ts.tv_nsec += 1'000'000'000;
+        ts.tv_sec -= 1;
+    }
+    return ts;
+}
+#endif
+
+} // namespace
+
+auto apply_metadata(int src_fd, int dst_fd, const adapters::fs::FileStat& stat)
+    -> std::expected<void, infra::Error>
+{
+#ifndef _WIN32
+    // Владелец — до прав: chown сбрасывает setuid/setgid
+    if (::geteuid() == 0 && infra::sys::fchown(dst_fd, stat.uid, stat.gid) != 0) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::PermissionDenied,
+                               fmt::format("fchown failed: {}", std::strerror(errno))));
+    }
+
+    if (infra::sys::fchmod(dst_fd, static_cast<mode_t>(stat.mode & 07777)) != 0) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::PermissionDenied,
+                               fmt::format("fchmod failed: {}", std::strerror(errno))));
+    }
+
+#ifdef __linux__
+    if (auto xattrs = copy_xattrs(src_fd, dst_fd); !xattrs) {
+        return xattrs;
+    }
+#else
+    (void)src_fd;
+#endif
+
+    // Время — последним: любая запись выше сдвинула бы mtime
+    const timespec times[2] = {to_timespec(stat.atime_ns), to_timespec(stat.mtime_ns)};
+    if (infra::sys::futimens(dst_fd, times) != 0) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                               fmt::format("futimens failed: {}", std::strerror(errno))));
+    }
+    return {};
+#else
+    (void)src_fd; (void)dst_fd; (void)stat;
+    return std::unexpected(infra::make_error(infra::ErrorCode::UnsupportedFeature,
+                           "Descriptor-based metadata is POSIX only"));
+#endif
+}
+
+auto copy_metadata(const std::filesystem::path& src,
+                   const std::filesystem::path& dst,
+                   const adapters::fs::FileStat& stat)
+    -> std::expected<void, infra::Error>
+{
+#ifndef _WIN32
+    // Открытие без чтения не сдвигает atime источника
+    const int src_fd = infra::sys::open(src.c_str(), O_RDONLY | O_CLOEXEC);
+    if (src_fd == -1) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::FileNotFound,
+                               fmt::format("Metadata copy failed: cannot open {}: {}", src.string(), std::strerror(errno))));
+    }
+    // Назначение тоже только на чтение: права уже могли стать 0444
+    // (повторная ссылка на готовую копию), а f*-вызовам запись не нужна
+    const int dst_fd = infra::sys::open(dst.c_str(), O_RDONLY | O_CLOEXEC);
+    if (dst_fd == -1) {
+        const int err = errno;
+        infra::sys::close(src_fd);
+        return std::unexpected(infra::make_error(infra::ErrorCode::PermissionDenied,
+                               fmt::format("Metadata copy failed: cannot open {}: {}", dst.string(), std::strerror(err))));
+    }
+    auto result = apply_metadata(src_fd, dst_fd, stat);
+    infra::sys::close(src_fd);
+    infra::sys::close(dst_fd);
+    return result;
+#else
+    (void)stat;
+    return copy_metadata(src, dst);
+#endif
+}
+
 auto copy_metadata(const std::filesystem::path& src,
                    const std::filesystem::path& dst)
     -> std::expected<void, infra::Error>
 {
+#ifndef _WIN32
+    auto stat = adapters::fs::stat_file(src);
+    if (!stat) {
+        return std::unexpected(std::move(stat.error()));
+    }
+    return copy_metadata(src, dst, *stat);
+#else
     std::error_code ec;
 
     // Временные метки
-    auto time = std::filesystem::last_write_time(src, ec);
+    auto time = infra::sys::last_write_time(src, ec);
     if (!ec) {
-        std::filesystem::last_write_time(dst, time, ec);
+        infra::sys::last_write_time(dst, time, ec);
     }
 
-    // Права (только POSIX)
-#ifndef _WIN32
-    auto perms = std::filesystem::status(src, ec).permissions();
-    if (!ec) {
-        std::filesystem::permissions(dst, perms, ec);
-    }
-#endif
-
     if (ec) {
         return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
                              fmt::format("Metadata copy failed: {}", ec.message())));
     }
     return {};
+#endif
 }
 
-} // namespace cclone::extensions
\ No newline at end of file
+} // namespace cclone::extensions
@@ -3,11 +3,27 @@
 
 #include <filesystem>
 #include "../infra/error_handler/error.hpp"
+#include "../adapters/file_stat.hpp"
 
 namespace cclone::extensions {
 
+// Переносит метаданные источника на уже открытый файл назначения:
+// владелец (только от root), права, расширенные атрибуты и ACL (Linux),
+// atime/mtime последними. Значения берутся из статистики сканирования,
+// поэтому источник не перечитывается; src_fd нужен только для xattr.
+// На Windows — UnsupportedFeature.
+[[nodiscard]] auto apply_metadata(int src_fd, int dst_fd,
+                                  const adapters::fs::FileStat& stat)
+    -> std::expected<void, infra::Error>;
+
+// То же по путям: открывает оба файла один раз и вызывает apply_metadata
+[[nodiscard]] auto copy_metadata(const std::filesystem::path& src,
+                                 const std::filesystem::path& dst,
+                                 const adapters::fs::FileStat& stat)
+    -> std::expected<void, infra::Error>;
+
 [[nodiscard]] auto copy_metadata(const std::filesystem::path& src,
                                  const std::filesystem::path& dst)
     -> std::expected<void, infra::Error>;
 
-} // namespace cclone::extensions
\ No newline at end of file
+} // namespace cclone::extensions
@@ -0,0 +1,67 @@
+// include/cclone/extensions/origin_registry.hpp
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include "../infra/concurrent/sharded_map.hpp"
+
+namespace cclone::extensions {
+
+// Идентичность inode источника: (st_dev, st_ino)
+struct InodeKey {
+    std::uint64_t device = 0;
+    std::uint64_t inode = 0;
+
+    friend bool operator==(const InodeKey&, const InodeKey&) = default;
+};
+
+struct InodeKeyHash {
+    auto operator()(const InodeKey& key) const noexcept -> std::size_t {
+        return static_cast<std::size_t>(key.inode ^ (key.device * 0x9E3779B97F4A7C15ull));
+    }
+};
+
+// Реестр «первой копии»: для группы файлов с одинаковым ключом
+// (одно содержимое, один inode источника) ровно один рабочий поток
+// становится владельцем и копирует данные, остальные ждут его результата
+// и ссылаются на готовый файл назначения.
+//
+// Владелец обязан вызвать publish() — с путём при успехе или с nullopt
+// при ошибке (тогда остальные копируют сами).
+template <typename Key, typename Hash = std::hash<Key>>
+class OriginRegistry {
+public:
+    using Origin = std::optional<std::filesystem::path>;
+
+    struct Claim {
+        bool owner = false;
+        std::shared_future<Origin> origin; // для не-владельцев
+    };
+
+    auto claim(const Key& key) -> Claim {
+        auto [entry, created] = entries_.get_or_create(key, [] { return std::make_shared<Entry>(); });
+        return Claim{.owner = created, .origin = entry->future};
+    }
+
+    void publish(const Key& key, Origin origin) {
+        if (auto entry = entries_.find(key)) {
+            (*entry)->promise.set_value(std::move(origin));
+        }
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t { return entries_.size(); }
+
+private:
+    struct Entry {
+        std::promise<Origin> promise;
+        std::shared_future<Origin> future = promise.get_future().share();
+    };
+
+    infra::ShardedMap<Key, std::shared_ptr<Entry>, Hash> entries_;
+};
+
+} // namespace cclone::extensions
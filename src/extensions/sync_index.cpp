@@ -0,0 +1,193 @@
+// sync_index.cpp
+#include "sync_index.hpp"
+#include "../infra/syscall/syscalls.hpp"
+#include <xxhash.h>
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <utility>
+
+#ifndef _WIN32
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace cclone::extensions {
+
+namespace {
+
+constexpr std::array<char, 8> MAGIC = {'C', 'C', 'S', 'I', 'D', 'X', '0', '1'};
+constexpr std::size_t HEADER_SIZE = 16; // magic + u64 count
+
+static_assert(std::is_trivially_copyable_v<SyncIndexEntry>);
+static_assert(sizeof(SyncIndexEntry) == 40, "on-disk layout of SyncIndexEntry");
+
+auto corrupt(const std::filesystem::path& path) -> infra::Error {
+    return infra::make_error(infra::ErrorCode::InvalidPath,
+                             fmt::format("Corrupt sync index: {}", path.string()));
+}
+
+} // namespace
+
+SyncIndex::SyncIndex() = default;
+
+SyncIndex::~SyncIndex() {
+#ifndef _WIN32
+    if (mapping_) infra::sys::munmap(mapping_, mapping_size_);
+#endif
+}
+
+SyncIndex::SyncIndex(SyncIndex&& other) noexcept {
+    *this = std::move(other);
+}
+
+SyncIndex& SyncIndex::operator=(SyncIndex&& other) noexcept {
+    if (this != &other) {
+#ifndef _WIN32
+        if (mapping_) infra::sys::munmap(mapping_, mapping_size_);
+#endif
+        owned_ = std::move(other.owned_);
+        mapping_ = std::exchange(other.mapping_, nullptr);
+        mapping_size_ = std::exchange(other.mapping_size_, 0);
+        count_ = std::exchange(other.count_, 0);
+        entries_ = mapping_ ? std::exchange(other.entries_, nullptr) : owned_.data();
+        other.entries_ = nullptr;
+    }
+    return *this;
+}
+
+auto SyncIndex::load(const std::filesystem::path& index_path)
+    -> std::expected<SyncIndex, infra::Error>
+{
+    SyncIndex index;
+    std::error_code ec;
+    if (!infra::sys::exists(index_path, ec)) {
+        return index;
+    }
+
+#ifndef _WIN32
+    int fd = infra::sys::open(index_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::FileNotFound,
+                               fmt::format("Cannot open sync index: {}", index_path.string())));
+    }
+    struct stat sb;
+    if (infra::sys::fstat(fd, &sb) == -1) {
+        infra::sys::close(fd);
+        return std::unexpected(infra::make_error(infra::ErrorCode::Unknown, "fstat failed"));
+    }
+    const auto size = static_cast<std::size_t>(sb.st_size);
+    if (size < HEADER_SIZE) {
+        infra::sys::close(fd);
+        return std::unexpected(corrupt(index_path));
+    }
+    void* map = infra::sys::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    infra::sys::close(fd);
+    if (map == MAP_FAILED) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::Unknown, "mmap failed for sync index"));
+    }
+    index.mapping_ = map;
+    index.mapping_size_ = size;
+    const auto* data = static_cast<const char*>(map);
+#else
+    std::ifstream in(index_path, std::ios::binary);
+    std::string raw((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const auto size = raw.size();
+    if (size < HEADER_SIZE) {
+        return std::unexpected(corrupt(index_path));
+    }
+    const auto* data = raw.data();
+#endif
+
+    std::uint64_t count = 0;
+    std::memcpy(&count, data + MAGIC.size(), sizeof(count));
+    // size >= HEADER_SIZE проверен выше; деление не переполняется при мусорном count
+    if (std::memcmp(data, MAGIC.data(), MAGIC.size()) != 0
+        || count > (size - HEADER_SIZE) / sizeof(SyncIndexEntry)) {
+        return std::unexpected(corrupt(index_path));
+    }
+    index.count_ = static_cast<std::size_t>(count);
+
+#ifndef _WIN32
+    // Записи выровнены по 8 байт: заголовок 16 байт, mmap выровнен по странице
+    index.entries_ = reinterpret_cast<const SyncIndexEntry*>(data + HEADER_SIZE);
+#else
+    index.owned_.resize(index.count_);
+    std::memcpy(index.owned_.data(), data + HEADER_SIZE, index.count_ * sizeof(SyncIndexEntry));
+    index.entries_ = index.owned_.data();
+#endif
+    return index;
+}
+
+auto SyncIndex::lookup(std::uint64_t path_hash) const -> const SyncIndexEntry* {
+    const auto* end = entries_ + count_;
+    const auto* it = std::lower_bound(entries_, end, path_hash,
+        [](const SyncIndexEntry& entry, std::uint64_t hash) { return entry.path_hash < hash; });
+    if (it == end || it->path_hash != path_hash) {
+        return nullptr;
+    }
+    return it;
+}
+
+auto SyncIndex::path_hash(const std::filesystem::path& relative_path) -> std::uint64_t {
+    const auto generic = relative_path.generic_string();
+    return XXH3_64bits(generic.data(), generic.size());
+}
+
+void SyncIndexBuilder::reserve(std::size_t count) {
+    std::lock_guard lock(mutex_);
+    entries_.reserve(count);
+}
+
+void SyncIndexBuilder::record(const SyncIndexEntry& entry) {
+    std::lock_guard lock(mutex_);
+    entries_.push_back(entry);
+}
+
+auto SyncIndexBuilder::size() const -> std::size_t {
+    std::lock_guard lock(mutex_);
+    return entries_.size();
+}
+
+auto SyncIndexBuilder::save(const std::filesystem::path& index_path)
+    -> std::expected<void, infra::Error>
+{
+    std::lock_guard lock(mutex_);
+    std::sort(entries_.begin(), entries_.end(),
+              [](const SyncIndexEntry& a, const SyncIndexEntry& b) { return a.path_hash < b.path_hash; });
+
+    auto tmp_path = index_path;
+    tmp_path += ".tmp";
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return std::unexpected(infra::make_error(infra::ErrorCode::PermissionDenied,
+                                   fmt::format("Cannot write sync index: {}", tmp_path.string())));
+        }
+        const std::uint64_t count = entries_.size();
+        out.write(MAGIC.data(), MAGIC.size());
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        out.write(reinterpret_cast<const char*>(entries_.data()),
+                  static_cast<std::streamsize>(entries_.size() * sizeof(SyncIndexEntry)));
+        if (!out.flush()) {
+            return std::unexpected(infra::make_error(infra::ErrorCode::DiskFull,
+                                   fmt::format("Failed to write sync index: {}", tmp_path.string())));
+        }
+    }
+
+    std::error_code ec;
+    infra::sys::rename(tmp_path, index_path, ec);
+    if (ec) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::PermissionDenied,
+                               fmt::format("Cannot replace sync index: {}", ec.message())));
+    }
+    return {};
+}
+
+} // namespace cclone::extensions
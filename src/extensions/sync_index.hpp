@@ -0,0 +1,75 @@
+// include/cclone/extensions/sync_index.hpp
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+#include "../infra/error_handler/error.hpp"
+
+namespace cclone::extensions {
+
+// Состояние файла на момент последней успешной синхронизации.
+// size/mtime_ns/inode — метаданные ИСТОЧНИКА: неизменность решается
+// по данным сканирования без единого обращения к назначению.
+struct SyncIndexEntry {
+    std::uint64_t path_hash = 0;     // XXH3 относительного пути
+    std::uint64_t size = 0;
+    std::int64_t mtime_ns = 0;
+    std::uint64_t inode = 0;
+    std::uint64_t content_hash = 0;  // 0, если хеш не считался
+};
+
+// Индекс синхронизации, хранящийся в корне назначения (.cclone.index).
+// Формат: magic "CCSIDX01", u64 count, затем count записей SyncIndexEntry,
+// отсортированных по path_hash. Файл отображается в память как есть,
+// поиск — бинарный по отображению, без разбора.
+class SyncIndex {
+public:
+    static constexpr std::string_view FILE_NAME = ".cclone.index";
+
+    // Отсутствующий файл — пустой индекс (первая синхронизация)
+    static auto load(const std::filesystem::path& index_path)
+        -> std::expected<SyncIndex, infra::Error>;
+
+    SyncIndex();
+    ~SyncIndex();
+    SyncIndex(SyncIndex&& other) noexcept;
+    SyncIndex& operator=(SyncIndex&& other) noexcept;
+    SyncIndex(const SyncIndex&) = delete;
+    SyncIndex& operator=(const SyncIndex&) = delete;
+
+    [[nodiscard]] auto lookup(std::uint64_t path_hash) const -> const SyncIndexEntry*;
+    [[nodiscard]] auto size() const -> std::size_t { return count_; }
+
+    [[nodiscard]] static auto path_hash(const std::filesystem::path& relative_path) -> std::uint64_t;
+
+private:
+    const SyncIndexEntry* entries_ = nullptr;
+    std::size_t count_ = 0;
+    void* mapping_ = nullptr;              // mmap всего файла (POSIX)
+    std::size_t mapping_size_ = 0;
+    std::vector<SyncIndexEntry> owned_;    // копия в памяти там, где mmap недоступен
+};
+
+// Собирает индекс следующего прогона. record() потокобезопасен.
+class SyncIndexBuilder {
+public:
+    void reserve(std::size_t count);
+    void record(const SyncIndexEntry& entry);
+
+    // Сортирует записи и атомарно заменяет файл индекса (tmp + rename)
+    [[nodiscard]] auto save(const std::filesystem::path& index_path)
+        -> std::expected<void, infra::Error>;
+
+    [[nodiscard]] auto size() const -> std::size_t;
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<SyncIndexEntry> entries_;
+};
+
+} // namespace cclone::extensions
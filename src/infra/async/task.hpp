@@ -0,0 +1,144 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace cclone::infra {
+
+// Ленивая сопрограмма: тело начинает выполняться при первом co_await,
+// по завершении управление сразу (symmetric transfer) переходит к
+// ожидающему — без очереди и без роста стека на длинных цепочках.
+//
+// Task владеет кадром; ждать его можно один раз.
+template<typename T>
+class Task;
+
+namespace detail {
+
+template<typename T>
+class TaskPromiseBase {
+public:
+    auto initial_suspend() noexcept -> std::suspend_always { return {}; }
+
+    struct FinalAwaiter {
+        auto await_ready() noexcept -> bool { return false; }
+        template<typename Promise>
+        auto await_suspend(std::coroutine_handle<Promise> self) noexcept -> std::coroutine_handle<> {
+            const auto next = self.promise().continuation_;
+            return next ? next : std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+    };
+    auto final_suspend() noexcept -> FinalAwaiter { return {}; }
+
+    void unhandled_exception() noexcept { error_ = std::current_exception(); }
+
+    void set_continuation(std::coroutine_handle<> next) noexcept { continuation_ = next; }
+
+protected:
+    void rethrow_if_failed() const {
+        if (error_) std::rethrow_exception(error_);
+    }
+
+private:
+    std::coroutine_handle<> continuation_;
+    std::exception_ptr error_;
+};
+
+template<typename T>
+class TaskPromise : public TaskPromiseBase<T> {
+public:
+    auto get_return_object() noexcept -> Task<T>;
+
+    template<typename U>
+    void return_value(U&& value) { value_.emplace(std::forward<U>(value)); }
+
+    auto result() -> T {
+        this->rethrow_if_failed();
+        return std::move(*value_);
+    }
+
+private:
+    std::optional<T> value_;
+};
+
+template<>
+class TaskPromise<void> : public TaskPromiseBase<void> {
+public:
+    auto get_return_object() noexcept -> Task<void>;
+    void return_void() noexcept {}
+    void result() { rethrow_if_failed(); }
+};
+
+} // namespace detail
+
+template<typename T = void>
+class [[nodiscard]] Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() {
+        if (handle_) handle_.destroy();
+    }
+
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            Handle handle;
+            auto await_ready() noexcept -> bool { return !handle || handle.done(); }
+            auto await_suspend(std::coroutine_handle<> caller) noexcept -> std::coroutine_handle<> {
+                handle.promise().set_continuation(caller);
+                return handle;
+            }
+            auto await_resume() -> T { return handle.promise().result(); }
+        };
+        return Awaiter{handle_};
+    }
+
+private:
+    friend class detail::TaskPromise<T>;
+    explicit Task(Handle handle) noexcept : handle_(handle) {}
+
+    Handle handle_;
+};
+
+namespace detail {
+
+template<typename T>
+auto TaskPromise<T>::get_return_object() noexcept -> Task<T> {
+    return Task<T>{std::coroutine_handle<TaskPromise<T>>::from_promise(*this)};
+}
+
+inline auto TaskPromise<void>::get_return_object() noexcept -> Task<void> {
+    return Task<void>{std::coroutine_handle<TaskPromise<void>>::from_promise(*this)};
+}
+
+} // namespace detail
+
+// Корневая сопрограмма «запустил и забыл»: выполняется сразу до первой
+// приостановки, кадр освобождается сам по завершении. Исключение
+// теряется, как в задаче ThreadPool без future, — учёт завершения
+// держите в деструкторе локального объекта, а не в конце тела.
+struct Detached {
+    struct promise_type {
+        auto get_return_object() noexcept -> Detached { return {}; }
+        auto initial_suspend() noexcept -> std::suspend_never { return {}; }
+        auto final_suspend() noexcept -> std::suspend_never { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {}
+    };
+};
+
+} // namespace cclone::infra
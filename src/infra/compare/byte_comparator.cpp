@@ -0,0 +1,256 @@
+#include "byte_comparator.hpp"
+#include "infra/syscall/syscalls.hpp"
+#include <spdlog/spdlog.h>
+#include <fmt/core.h>
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <memory>
+#include <new>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+    #define CCLONE_CMP_SSE2 1
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    #define CCLONE_CMP_AVX2 1
+#endif
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+namespace cclone::infra {
+
+namespace {
+
+// =============== Ядра сравнения ===============
+
+auto mismatch_scalar(const unsigned char* a, const unsigned char* b,
+                     std::size_t i, std::size_t size) noexcept -> std::size_t
+{
+    for (; i < size; ++i) {
+        if (a[i] != b[i]) return i;
+    }
+    return size;
+}
+
+#ifdef CCLONE_CMP_SSE2
+auto mismatch_sse2(const unsigned char* a, const unsigned char* b,
+                   std::size_t size) noexcept -> std::size_t
+{
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        const auto eq = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)));
+        if (eq != 0xFFFFu) {
+            return i + static_cast<std::size_t>(std::countr_zero(~eq & 0xFFFFu));
+        }
+    }
+    return mismatch_scalar(a, b, i, size);
+}
+#endif
+
+#ifdef CCLONE_CMP_AVX2
+__attribute__((target("avx2")))
+auto mismatch_avx2(const unsigned char* a, const unsigned char* b,
+                   std::size_t size) noexcept -> std::size_t
+{
+    std::size_t i = 0;
+    // 64 байта за итерацию: два сравнения сводятся в одну маску
+    for (; i + 64 <= size; i += 64) {
+        const __m256i x0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i y0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        const __m256i x1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 32));
+        const __m256i y1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i + 32));
+        const __m256i eq0 = _mm256_cmpeq_epi8(x0, y0);
+        const __m256i eq1 = _mm256_cmpeq_epi8(x1, y1);
+        if (static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(eq0, eq1))) != 0xFFFFFFFFu) {
+            const auto m0 = static_cast<unsigned>(_mm256_movemask_epi8(eq0));
+            if (m0 != 0xFFFFFFFFu) {
+                return i + static_cast<std::size_t>(std::countr_zero(~m0));
+            }
+            const auto m1 = static_cast<unsigned>(_mm256_movemask_epi8(eq1));
+            return i + 32 + static_cast<std::size_t>(std::countr_zero(~m1));
+        }
+    }
+    for (; i + 32 <= size; i += 32) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        const auto eq = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+        if (eq != 0xFFFFFFFFu) {
+            return i + static_cast<std::size_t>(std::countr_zero(~eq));
+        }
+    }
+    return mismatch_scalar(a, b, i, size);
+}
+#endif
+
+using MismatchKernel = std::size_t (*)(const unsigned char*, const unsigned char*, std::size_t) noexcept;
+
+auto select_kernel() -> MismatchKernel {
+#ifdef CCLONE_CMP_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        return &mismatch_avx2;
+    }
+#endif
+#ifdef CCLONE_CMP_SSE2
+    return &mismatch_sse2;
+#else
+    return [](const unsigned char* a, const unsigned char* b, std::size_t size) noexcept {
+        return mismatch_scalar(a, b, 0, size);
+    };
+#endif
+}
+
+// =============== Чтение окнами ===============
+
+struct AlignedDeleter {
+    std::size_t alignment;
+    void operator()(char* ptr) const noexcept {
+        ::operator delete[](ptr, std::align_val_t{alignment});
+    }
+};
+
+using AlignedBuffer = std::unique_ptr<char[], AlignedDeleter>;
+
+auto make_aligned_buffer(std::size_t size, std::size_t alignment) -> AlignedBuffer {
+    auto* raw = static_cast<char*>(::operator new[](size, std::align_val_t{alignment}));
+    return AlignedBuffer(raw, AlignedDeleter{alignment});
+}
+
+class WindowReader {
+public:
+    explicit WindowReader(const std::filesystem::path& path) {
+#ifndef _WIN32
+        fd_ = sys::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    #ifdef __linux__
+        if (fd_ != -1) sys::fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+    #endif
+#else
+        stream_.open(path, std::ios::binary);
+#endif
+    }
+
+    ~WindowReader() {
+#ifndef _WIN32
+        if (fd_ != -1) sys::close(fd_);
+#endif
+    }
+
+    WindowReader(const WindowReader&) = delete;
+    WindowReader& operator=(const WindowReader&) = delete;
+
+    [[nodiscard]] auto is_open() const -> bool {
+#ifndef _WIN32
+        return fd_ != -1;
+#else
+        return stream_.is_open();
+#endif
+    }
+
+    // Читает следующее окно целиком (короче только в конце файла); -1 при ошибке
+    auto read(char* buffer, std::size_t length) -> std::int64_t {
+#ifndef _WIN32
+        std::size_t done = 0;
+        while (done < length) {
+            ssize_t n = sys::read(fd_, buffer + done, length - done);
+            if (n == 0) break;
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return -1;
+            }
+            done += static_cast<std::size_t>(n);
+        }
+        return static_cast<std::int64_t>(done);
+#else
+        stream_.read(buffer, static_cast<std::streamsize>(length));
+        if (stream_.bad()) return -1;
+        return static_cast<std::int64_t>(stream_.gcount());
+#endif
+    }
+
+private:
+#ifndef _WIN32
+    int fd_ = -1;
+#else
+    std::ifstream stream_;
+#endif
+};
+
+} // namespace
+
+auto ByteComparator::first_mismatch(const void* lhs, const void* rhs,
+                                    std::size_t size) noexcept -> std::size_t
+{
+    static const MismatchKernel kernel = select_kernel();
+    return kernel(static_cast<const unsigned char*>(lhs),
+                  static_cast<const unsigned char*>(rhs),
+                  size);
+}
+
+auto ByteComparator::compare_files(const std::filesystem::path& src,
+                                   const std::filesystem::path& dst)
+    -> std::expected<CompareResult, Error>
+{
+    WindowReader src_reader(src);
+    if (!src_reader.is_open()) {
+        return std::unexpected(make_error(ErrorCode::FileNotFound,
+                               fmt::format("Cannot open file for comparison: {}", src.string())));
+    }
+    WindowReader dst_reader(dst);
+    if (!dst_reader.is_open()) {
+        return std::unexpected(make_error(ErrorCode::FileNotFound,
+                               fmt::format("Cannot open file for comparison: {}", dst.string())));
+    }
+
+    auto src_buffer = make_aligned_buffer(WINDOW_SIZE, ALIGNMENT);
+    auto dst_buffer = make_aligned_buffer(WINDOW_SIZE, ALIGNMENT);
+
+    std::uint64_t offset = 0;
+    while (true) {
+        const auto src_read = src_reader.read(src_buffer.get(), WINDOW_SIZE);
+        if (src_read < 0) {
+            return std::unexpected(make_error(ErrorCode::Unknown,
+                                   fmt::format("Error reading {} at offset {}", src.string(), offset)));
+        }
+        const auto dst_read = dst_reader.read(dst_buffer.get(), WINDOW_SIZE);
+        if (dst_read < 0) {
+            return std::unexpected(make_error(ErrorCode::Unknown,
+                                   fmt::format("Error reading {} at offset {}", dst.string(), offset)));
+        }
+
+        const auto common = static_cast<std::size_t>(std::min(src_read, dst_read));
+        const auto index = first_mismatch(src_buffer.get(), dst_buffer.get(), common);
+        if (index != common || src_read != dst_read) {
+            // Расхождение в данных или один из файлов короче
+            return CompareResult{.equal = false, .first_mismatch = offset + index};
+        }
+        if (static_cast<std::size_t>(src_read) < WINDOW_SIZE) {
+            return CompareResult{.equal = true, .first_mismatch = std::nullopt};
+        }
+        offset += WINDOW_SIZE;
+    }
+}
+
+auto ByteComparator::verify_files(const std::filesystem::path& src,
+                                  const std::filesystem::path& dst)
+    -> std::expected<bool, Error>
+{
+    auto result = compare_files(src, dst);
+    if (!result) {
+        return std::unexpected(std::move(result.error()));
+    }
+
+    if (!result->equal) {
+        spdlog::warn("Content mismatch: {} vs {} at offset {}",
+                     src.string(), dst.string(), result->first_mismatch.value_or(0));
+    }
+    return result->equal;
+}
+
+} // namespace cclone::infra
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <filesystem>
+#include <expected>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
+#include "../error_handler/error.hpp"
+
+namespace cclone::infra {
+
+struct CompareResult {
+    bool equal = true;
+    std::optional<std::uint64_t> first_mismatch; // смещение первого отличающегося байта
+};
+
+// Прямое побайтовое сравнение двух локальных файлов.
+// Дешевле хеширования обоих файлов: данные читаются по одному разу,
+// сравнение останавливается на первом расхождении.
+class ByteComparator {
+public:
+    // Сравнивает файлы окнами по WINDOW_SIZE байт
+    static auto compare_files(const std::filesystem::path& src,
+                              const std::filesystem::path& dst)
+        -> std::expected<CompareResult, Error>;
+
+    // Аналог XXHashVerifier::verify_files
+    static auto verify_files(const std::filesystem::path& src,
+                             const std::filesystem::path& dst)
+        -> std::expected<bool, Error>;
+
+    // Индекс первого отличающегося байта или size, если блоки равны.
+    // AVX2 выбирается во время выполнения, SSE2 — базовый путь x86-64.
+    [[nodiscard]] static auto first_mismatch(const void* lhs, const void* rhs,
+                                             std::size_t size) noexcept -> std::size_t;
+
+private:
+    static constexpr std::size_t WINDOW_SIZE = 4 * 1024 * 1024; // 4MB
+    static constexpr std::size_t ALIGNMENT = 4096;
+};
+
+} // namespace cclone::infra
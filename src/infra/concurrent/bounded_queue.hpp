@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+
+namespace cclone::infra {
+
+// Ограниченная MPMC-очередь между стадиями конвейера (кольцо Вьюкова:
+// у каждой ячейки свой номер последовательности, производители и
+// потребители расходятся одним CAS на своём счётчике).
+//
+// push() при полной очереди и pop() при пустой сначала уступают
+// процессор (SPIN_YIELDS раз), затем засыпают на атомике — так быстрая
+// стадия упирается в медленную, а не копит работу в памяти.
+// close() завершает поток данных: pop() вычерпывает остаток и
+// возвращает nullopt, push() возвращает false.
+template <typename T>
+class BoundedQueue {
+public:
+    static constexpr int SPIN_YIELDS = 16;
+
+    explicit BoundedQueue(std::size_t capacity)
+        : capacity_(round_up(capacity))
+        , mask_(capacity_ - 1)
+        , cells_(new Cell[capacity_])
+    {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~BoundedQueue() {
+        while (try_pop()) {}
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    [[nodiscard]] auto capacity() const -> std::size_t { return capacity_; }
+
+    // false — очередь полна; value при этом не тронут
+    [[nodiscard]] auto try_push(T& value) -> bool {
+        auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const auto seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        ::new (cell->storage) T(std::move(value));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        signal_(items_epoch_, pop_waiters_);
+        return true;
+    }
+
+    [[nodiscard]] auto try_pop() -> std::optional<T> {
+        auto pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const auto seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return std::nullopt;
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        auto* item = std::launder(reinterpret_cast<T*>(cell->storage));
+        std::optional<T> value(std::move(*item));
+        item->~T();
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        signal_(space_epoch_, push_waiters_);
+        return value;
+    }
+
+    // Ждёт места. false — очередь закрыта
+    auto push(T value) -> bool {
+        for (int spin = 0;; ++spin) {
+            if (closed_.load(std::memory_order_acquire)) return false;
+            if (spin < SPIN_YIELDS) {
+                if (try_push(value)) return true;
+                std::this_thread::yield();
+                continue;
+            }
+            const auto epoch = space_epoch_.load(std::memory_order_seq_cst);
+            push_waiters_.fetch_add(1, std::memory_order_seq_cst);
+            const bool pushed = try_push(value);
+            if (!pushed && !closed_.load(std::memory_order_seq_cst)) {
+                space_epoch_.wait(epoch, std::memory_order_seq_cst);
+            }
+            push_waiters_.fetch_sub(1, std::memory_order_relaxed);
+            if (pushed) return true;
+        }
+    }
+
+    // Ждёт элемента. nullopt — очередь закрыта и пуста
+    [[nodiscard]] auto pop() -> std::optional<T> {
+        for (int spin = 0;; ++spin) {
+            if (auto value = try_pop()) return value;
+            if (closed_.load(std::memory_order_acquire)) return try_pop();
+            if (spin < SPIN_YIELDS) {
+                std::this_thread::yield();
+                continue;
+            }
+            const auto epoch = items_epoch_.load(std::memory_order_seq_cst);
+            pop_waiters_.fetch_add(1, std::memory_order_seq_cst);
+            auto value = try_pop();
+            if (!value && !closed_.load(std::memory_order_seq_cst)) {
+                items_epoch_.wait(epoch, std::memory_order_seq_cst);
+            }
+            pop_waiters_.fetch_sub(1, std::memory_order_relaxed);
+            if (value) return value;
+        }
+    }
+
+    void close() {
+        closed_.store(true, std::memory_order_seq_cst);
+        items_epoch_.fetch_add(1, std::memory_order_seq_cst);
+        items_epoch_.notify_all();
+        space_epoch_.fetch_add(1, std::memory_order_seq_cst);
+        space_epoch_.notify_all();
+    }
+
+    [[nodiscard]] auto closed() const -> bool { return closed_.load(std::memory_order_acquire); }
+
+    // Приблизительная глубина очереди — для метрик, не для решений
+    [[nodiscard]] auto size_approx() const -> std::size_t {
+        const auto tail = dequeue_pos_.load(std::memory_order_relaxed);
+        const auto head = enqueue_pos_.load(std::memory_order_relaxed);
+        return head > tail ? std::min(head - tail, capacity_) : 0;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    static auto round_up(std::size_t n) -> std::size_t {
+        std::size_t cap = 2;
+        while (cap < n) cap <<= 1;
+        return cap;
+    }
+
+    // Будим, только если кто-то уже спит: без ждущих — ни одного futex
+    static void signal_(std::atomic<std::uint32_t>& epoch, const std::atomic<std::uint32_t>& waiters) {
+        epoch.fetch_add(1, std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_seq_cst) != 0) {
+            epoch.notify_all();
+        }
+    }
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    alignas(64) std::atomic<std::size_t> enqueue_pos_{0};
+    alignas(64) std::atomic<std::size_t> dequeue_pos_{0};
+    alignas(64) std::atomic<std::uint32_t> items_epoch_{0};
+    std::atomic<std::uint32_t> pop_waiters_{0};
+    alignas(64) std::atomic<std::uint32_t> space_epoch_{0};
+    std::atomic<std::uint32_t> push_waiters_{0};
+    std::atomic<bool> closed_{false};
+};
+
+} // namespace cclone::infra
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace cclone::infra {
+
+// Дек Chase-Lev (Lê и др., «Correct and Efficient Work-Stealing for Weak
+// Memory Models», 2013). Владелец кладёт и забирает с нижнего конца без
+// CAS — кроме борьбы за последний элемент; остальные потоки крадут с
+// верхнего одним CAS. Хранит указатели: пустое значение — nullptr.
+//
+// Массив растёт только у владельца. Старые массивы живут до разрушения
+// дека: вор мог успеть прочитать указатель на них.
+template <typename T>
+class ChaseLevDeque {
+public:
+    explicit ChaseLevDeque(std::size_t capacity = 1024)
+        : array_(new Array(round_up(capacity)))
+    {
+        array_owner_.emplace_back(array_.load(std::memory_order_relaxed));
+    }
+
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+    // Только владелец
+    void push(T* item) {
+        const auto bottom = bottom_.load(std::memory_order_relaxed);
+        const auto top = top_.load(std::memory_order_acquire);
+        auto* array = array_.load(std::memory_order_relaxed);
+        if (bottom - top > static_cast<std::int64_t>(array->capacity) - 1) {
+            array = grow(array, top, bottom);
+        }
+        array->put(bottom, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    // Только владелец: последний положенный (LIFO — горячий кэш)
+    [[nodiscard]] auto pop() -> T* {
+        const auto bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        auto* array = array_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto top = top_.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        T* item = array->get(bottom);
+        if (top == bottom) {
+            // Последний элемент: соревнуемся с ворами
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                              std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // Любой поток: самый старый элемент. nullptr — пусто или проиграна гонка
+    [[nodiscard]] auto steal() -> T* {
+        auto top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const auto bottom = bottom_.load(std::memory_order_acquire);
+        if (top >= bottom) return nullptr;
+
+        auto* array = array_.load(std::memory_order_acquire);
+        T* item = array->get(top);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    // Приблизительно: для эвристик, не для решений о корректности
+    [[nodiscard]] auto size_approx() const -> std::size_t {
+        const auto bottom = bottom_.load(std::memory_order_relaxed);
+        const auto top = top_.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<std::size_t>(bottom - top) : 0;
+    }
+
+    [[nodiscard]] auto empty() const -> bool { return size_approx() == 0; }
+
+private:
+    struct Array {
+        explicit Array(std::size_t cap)
+            : capacity(cap), mask(cap - 1), slots(new std::atomic<T*>[cap])
+        {}
+
+        void put(std::int64_t index, T* item) {
+            slots[static_cast<std::size_t>(index) & mask].store(item, std::memory_order_relaxed);
+        }
+        auto get(std::int64_t index) const -> T* {
+            return slots[static_cast<std::size_t>(index) & mask].load(std::memory_order_relaxed);
+        }
+
+        const std::size_t capacity;
+        const std::size_t mask;
+        std::unique_ptr<std::atomic<T*>[]> slots;
+    };
+
+    static auto round_up(std::size_t n) -> std::size_t {
+        std::size_t cap = 2;
+        while (cap < n) cap <<= 1;
+        return cap;
+    }
+
+    auto grow(Array* old, std::int64_t top, std::int64_t bottom) -> Array* {
+        auto* bigger = new Array(old->capacity * 2);
+        for (auto i = top; i < bottom; ++i) {
+            bigger->put(i, old->get(i));
+        }
+        array_owner_.emplace_back(bigger);
+        array_.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    // Владелец пишет bottom_, воры — top_: разные строки кэша
+    alignas(64) std::atomic<std::int64_t> top_{0};
+    alignas(64) std::atomic<std::int64_t> bottom_{0};
+    alignas(64) std::atomic<Array*> array_;
+    std::vector<std::unique_ptr<Array>> array_owner_;
+};
+
+} // namespace cclone::infra
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+namespace cclone::infra {
+
+// Сколько рабочих пула копируют одновременно (--adaptive). Пул создаётся
+// с запасом потоков, а лишние ждут здесь, не держа файлов. Предел меняет
+// регулятор на лету: уменьшение не прерывает работающих — они просто не
+// возьмут следующий файл.
+class ConcurrencyGate {
+public:
+    class Slot {
+    public:
+        Slot() = default;
+        Slot(Slot&& other) noexcept : gate_(other.gate_) { other.gate_ = nullptr; }
+        Slot& operator=(Slot&& other) noexcept {
+            if (this != &other) {
+                release();
+                gate_ = other.gate_;
+                other.gate_ = nullptr;
+            }
+            return *this;
+        }
+        ~Slot() { release(); }
+
+        void release() {
+            if (gate_) gate_->leave_();
+            gate_ = nullptr;
+        }
+
+    private:
+        friend class ConcurrencyGate;
+        explicit Slot(ConcurrencyGate* gate) : gate_(gate) {}
+        ConcurrencyGate* gate_ = nullptr;
+    };
+
+    explicit ConcurrencyGate(std::size_t limit) : limit_(limit ? limit : 1) {}
+
+    ConcurrencyGate(const ConcurrencyGate&) = delete;
+    ConcurrencyGate& operator=(const ConcurrencyGate&) = delete;
+
+    // Ждёт, пока занятых меньше предела
+    [[nodiscard]] auto enter() -> Slot {
+        std::unique_lock lock(mutex_);
+        cv_.wait(lock, [&] { return active_ < limit_; });
+        ++active_;
+        return Slot(this);
+    }
+
+    void set_limit(std::size_t limit) {
+        {
+            std::lock_guard lock(mutex_);
+            limit_ = limit ? limit : 1;
+        }
+        cv_.notify_all();
+    }
+
+    [[nodiscard]] auto limit() const -> std::size_t {
+        std::lock_guard lock(mutex_);
+        return limit_;
+    }
+
+private:
+    void leave_() {
+        {
+            std::lock_guard lock(mutex_);
+            --active_;
+        }
+        cv_.notify_one();
+    }
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::size_t limit_;
+    std::size_t active_ = 0;
+};
+
+} // namespace cclone::infra
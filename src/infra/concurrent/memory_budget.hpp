@@ -0,0 +1,113 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+namespace cclone::infra {
+
+// Общий бюджет байт «в полёте» (--max-memory): буферы, отображения и
+// чанки, которые задания держат одновременно. acquire() ждёт, пока
+// занятое плюс запрошенное не уложится в предел; запрос больше предела
+// урезается до него и выполняется в одиночку, а не ждёт вечно.
+//
+// Резервирование, которое держит задача, не должно ждать других
+// резервирований — иначе две задачи могут ждать друг друга.
+class MemoryBudget {
+public:
+    class Reservation {
+    public:
+        Reservation() = default;
+        Reservation(Reservation&& other) noexcept
+            : budget_(std::exchange(other.budget_, nullptr)), bytes_(other.bytes_) {}
+        Reservation& operator=(Reservation&& other) noexcept {
+            if (this != &other) {
+                release();
+                budget_ = std::exchange(other.budget_, nullptr);
+                bytes_ = other.bytes_;
+            }
+            return *this;
+        }
+        Reservation(const Reservation&) = delete;
+        Reservation& operator=(const Reservation&) = delete;
+        ~Reservation() { release(); }
+
+        [[nodiscard]] auto bytes() const -> std::uint64_t { return budget_ ? bytes_ : 0; }
+
+        void release() {
+            if (budget_) std::exchange(budget_, nullptr)->release_(bytes_);
+        }
+
+    private:
+        friend class MemoryBudget;
+        Reservation(MemoryBudget* budget, std::uint64_t bytes) : budget_(budget), bytes_(bytes) {}
+
+        MemoryBudget* budget_ = nullptr;
+        std::uint64_t bytes_ = 0;
+    };
+
+    explicit MemoryBudget(std::uint64_t limit) : limit_(std::max<std::uint64_t>(limit, 1)) {}
+
+    MemoryBudget(const MemoryBudget&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+    [[nodiscard]] auto limit() const -> std::uint64_t { return limit_; }
+    [[nodiscard]] auto in_use() const -> std::uint64_t { return in_use_.load(std::memory_order_relaxed); }
+    [[nodiscard]] auto peak() const -> std::uint64_t { return peak_.load(std::memory_order_relaxed); }
+    // Сколько раз acquire() пришлось ждать
+    [[nodiscard]] auto stalls() const -> std::uint64_t { return stalls_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] auto acquire(std::uint64_t bytes) -> Reservation {
+        bytes = std::min(bytes, limit_);
+        if (bytes == 0) return {};
+        if (try_take_(bytes)) return Reservation(this, bytes);
+
+        stalls_.fetch_add(1, std::memory_order_relaxed);
+        std::unique_lock lock(mutex_);
+        ++waiters_;
+        freed_.wait(lock, [&] { return try_take_(bytes); });
+        --waiters_;
+        return Reservation(this, bytes);
+    }
+
+    [[nodiscard]] auto try_acquire(std::uint64_t bytes) -> Reservation {
+        bytes = std::min(bytes, limit_);
+        if (bytes == 0 || !try_take_(bytes)) return {};
+        return Reservation(this, bytes);
+    }
+
+private:
+    auto try_take_(std::uint64_t bytes) -> bool {
+        auto used = in_use_.load(std::memory_order_relaxed);
+        do {
+            if (used + bytes > limit_) return false;
+        } while (!in_use_.compare_exchange_weak(used, used + bytes, std::memory_order_acquire,
+                                                std::memory_order_relaxed));
+        auto peak = peak_.load(std::memory_order_relaxed);
+        while (used + bytes > peak
+               && !peak_.compare_exchange_weak(peak, used + bytes, std::memory_order_relaxed)) {}
+        return true;
+    }
+
+    void release_(std::uint64_t bytes) {
+        in_use_.fetch_sub(bytes, std::memory_order_release);
+        // Под мьютексом: иначе освобождение может проскочить между
+        // неудачным try_take_ ждущего и его засыпанием
+        std::lock_guard lock(mutex_);
+        if (waiters_ != 0) freed_.notify_all();
+    }
+
+    const std::uint64_t limit_;
+    std::atomic<std::uint64_t> in_use_{0};
+    std::atomic<std::uint64_t> peak_{0};
+    std::atomic<std::uint64_t> stalls_{0};
+
+    std::mutex mutex_;
+    std::condition_variable freed_;
+    std::size_t waiters_ = 0;
+};
+
+} // namespace cclone::infra
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace cclone::infra {
+
+// Номер потока для выбора шарда: раздаётся по кругу при первом обращении
+// и одинаков во всех шардированных структурах
+[[nodiscard]] inline auto this_thread_slot() -> std::size_t {
+    static std::atomic<std::size_t> next{0};
+    thread_local const std::size_t slot = next.fetch_add(1, std::memory_order_relaxed);
+    return slot;
+}
+
+// Набор счётчиков статистики, разложенный по шардам в отдельных кеш-линиях.
+// Поток прибавляет только к своему шарду, так что рабочие не делят между
+// собой линии и не гоняют их между ядрами; сумма считается при чтении.
+// Key — перечисление с последним элементом Count; новая метрика —
+// новый элемент перечисления, все счётчики потока остаются в одной линии.
+template <typename Key, std::size_t Shards = 64>
+class ShardedCounters {
+    static_assert(std::is_enum_v<Key>, "Key must be an enum with a trailing Count");
+
+public:
+    static constexpr std::size_t COUNT = static_cast<std::size_t>(Key::Count);
+
+    ShardedCounters() = default;
+    ShardedCounters(const ShardedCounters&) = delete;
+    ShardedCounters& operator=(const ShardedCounters&) = delete;
+
+    void add(Key key, std::uint64_t delta = 1) {
+        // Шард делят лишь потоки сверх Shards, поэтому fetch_add почти
+        // всегда попадает в линию, уже лежащую в кеше этого ядра
+        shards_[this_thread_slot() % Shards].values[index(key)].fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] auto load(Key key) const -> std::uint64_t {
+        std::uint64_t sum = 0;
+        for (const auto& shard : shards_) {
+            sum += shard.values[index(key)].load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+
+    // Все счётчики за один проход по шардам
+    [[nodiscard]] auto load_all() const -> std::array<std::uint64_t, COUNT> {
+        std::array<std::uint64_t, COUNT> sums{};
+        for (const auto& shard : shards_) {
+            for (std::size_t i = 0; i < COUNT; ++i) {
+                sums[i] += shard.values[i].load(std::memory_order_relaxed);
+            }
+        }
+        return sums;
+    }
+
+private:
+    static constexpr auto index(Key key) -> std::size_t { return static_cast<std::size_t>(key); }
+
+    struct alignas(64) Shard {
+        std::array<std::atomic<std::uint64_t>, COUNT> values{};
+    };
+
+    std::array<Shard, Shards> shards_{};
+};
+
+} // namespace cclone::infra
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace cclone::infra {
+
+// Хеш-таблица, разбитая на независимые шарды со своими мьютексами.
+// Рабочие потоки, обращающиеся к разным ключам, почти никогда не
+// встречаются на одной блокировке. Значения возвращаются копиями,
+// поэтому Value обычно — лёгкий дескриптор (shared_ptr, путь, число).
+template <typename Key, typename Value, typename Hash = std::hash<Key>, std::size_t Shards = 64>
+class ShardedMap {
+public:
+    ShardedMap() = default;
+    ShardedMap(const ShardedMap&) = delete;
+    ShardedMap& operator=(const ShardedMap&) = delete;
+
+    // Возвращает значение по ключу, создавая его factory(), если ключа нет.
+    // second == true, если значение создано этим вызовом.
+    template <typename Factory>
+    auto get_or_create(const Key& key, Factory&& factory) -> std::pair<Value, bool> {
+        auto& shard = shard_for(key);
+        std::lock_guard lock(shard.mutex);
+        auto it = shard.map.find(key);
+        if (it != shard.map.end()) {
+            return {it->second, false};
+        }
+        it = shard.map.emplace(key, std::forward<Factory>(factory)()).first;
+        return {it->second, true};
+    }
+
+    [[nodiscard]] auto find(const Key& key) const -> std::optional<Value> {
+        const auto& shard = shard_for(key);
+        std::lock_guard lock(shard.mutex);
+        const auto it = shard.map.find(key);
+        if (it == shard.map.end()) return std::nullopt;
+        return it->second;
+    }
+
+    auto erase(const Key& key) -> bool {
+        auto& shard = shard_for(key);
+        std::lock_guard lock(shard.mutex);
+        return shard.map.erase(key) > 0;
+    }
+
+    // fn(key, value) под блокировкой шарда; в fn не обращаться к этой же таблице
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const auto& shard : shards_) {
+            std::lock_guard lock(shard.mutex);
+            for (const auto& [key, value] : shard.map) fn(key, value);
+        }
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t {
+        std::size_t total = 0;
+        for (const auto& shard : shards_) {
+            std::lock_guard lock(shard.mutex);
+            total += shard.map.size();
+        }
+        return total;
+    }
+
+private:
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<Key, Value, Hash> map;
+    };
+
+    // Старшие биты подмешиваются: у std::hash для целых младшие биты — это сам ключ
+    [[nodiscard]] static auto shard_index(const Key& key) -> std::size_t {
+        const auto h = static_cast<std::size_t>(Hash{}(key));
+        return (h ^ (h >> 29) ^ (h >> 47)) % Shards;
+    }
+
+    auto shard_for(const Key& key) -> Shard& { return shards_[shard_index(key)]; }
+    auto shard_for(const Key& key) const -> const Shard& { return shards_[shard_index(key)]; }
+
+    std::array<Shard, Shards> shards_;
+};
+
+} // namespace cclone::infra
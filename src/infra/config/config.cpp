@@ -19,14 +19,46 @@ namespace cclone::infra {
     void Config::merge_with(const Config& other) {
         if (other.threads) threads = other.threads;
         if (other.buffer_size) buffer_size = other.buffer_size;
+        if (other.hash_segment_size) hash_segment_size = other.hash_segment_size;
+        if (other.delta_block_size) delta_block_size = other.delta_block_size;
+        if (other.max_memory) max_memory = other.max_memory;
+        if (other.async_depth) async_depth = other.async_depth;
+        if (other.latency_ceiling_ms) latency_ceiling_ms = other.latency_ceiling_ms;
+        if (other.metrics_interval) metrics_interval = other.metrics_interval;
+        if (other.trace_top) trace_top = other.trace_top;
+        if (other.bwlimit) bwlimit = other.bwlimit;
+        if (other.iops_limit) iops_limit = other.iops_limit;
+        if (other.device_bwlimit) device_bwlimit = other.device_bwlimit;
+        if (other.device_iops_limit) device_iops_limit = other.device_iops_limit;
         if (other.recursive) recursive = true;
         if (other.follow_symlinks) follow_symlinks = true;
-        if (other.verify) verify = true;
+        if (other.verify) {
+            verify = true;
+            verify_mode = other.verify_mode;
+        }
         if (other.resume) resume = true;
+        if (other.incremental) incremental = true;
+        if (other.delta) delta = true;
+        if (other.delta_cache) delta_cache = true;
+        if (other.hard_links) hard_links = true;
+        if (other.atomic) atomic = true;
+        if (other.dedup) {
+            dedup = true;
+            dedup_policy = other.dedup_policy;
+        }
+        if (other.durability != Durability::None) durability = other.durability;
+        if (other.numa != NumaPolicy::Off) numa = other.numa;
+        if (other.engine != EngineBackend::Threads) engine = other.engine;
+        if (other.adaptive) adaptive = true;
         if (!other.progress) progress = false; // CLI может отключить
         if (other.quiet) quiet = true;
         if (!other.preserve_metadata) preserve_metadata = false; // CLI может отключить
 
+        if (!other.manifest.empty()) manifest = other.manifest;
+        if (!other.throttle_file.empty()) throttle_file = other.throttle_file;
+        if (!other.metrics_prom.empty()) metrics_prom = other.metrics_prom;
+        if (!other.metrics_json.empty()) metrics_json = other.metrics_json;
+        if (!other.trace.empty()) trace = other.trace;
         if (!other.exclude_patterns.empty()) exclude_patterns = other.exclude_patterns;
         if (!other.include_patterns.empty()) include_patterns = other.include_patterns;
     }
@@ -59,45 +91,138 @@ namespace cclone::infra {
         return paths;
     }
 
-    auto load_config_from_file() -> std::expected<Config, std::string> {
-        for (const auto& path : get_config_paths()) {
-            if (!std::filesystem::exists(path)) continue;
-
-            try {
-                YAML::Node config = YAML::LoadFile(path.string());
-                Config cfg{};
-
-                if (config["threads"]) cfg.threads = config["threads"].as<uint32_t>();
-                if (config["buffer_size"]) cfg.buffer_size = config["buffer_size"].as<size_t>();
-
-                if (config["recursive"]) cfg.recursive = config["recursive"].as<bool>();
-                if (config["follow_symlinks"]) cfg.follow_symlinks = config["follow_symlinks"].as<bool>();
-                if (config["verify"]) cfg.verify = config["verify"].as<bool>();
-                if (config["resume"]) cfg.resume = config["resume"].as<bool>();
-                if (config["progress"]) cfg.progress = config["progress"].as<bool>();
-                if (config["quiet"]) cfg.quiet = config["quiet"].as<bool>();
-
-                if (config["exclude"]) {
-                    for (const auto& pat : config["exclude"]) {
-                        cfg.exclude_patterns.push_back(pat.as<std::string>());
-                    }
-                }
-                if (config["include"]) {
-                    for (const auto& pat : config["include"]) {
-                        cfg.include_patterns.push_back(pat.as<std::string>());
-                    }
-                }
-
-                spdlog::debug("Loaded config from {}", path.string());
-                return cfg;
-
-            } catch (const std::exception& e) {
-                return std::unexpected(fmt::format("Failed to parse {}: {}", path.string(), e.what()));
+    auto parse_durability(std::string_view name) -> std::optional<Durability> {
+        if (name == "none") return Durability::None;
+        if (name == "file") return Durability::File;
+        if (name == "batch") return Durability::Batch;
+        if (name == "end") return Durability::End;
+        return std::nullopt;
+    }
+
+    auto parse_numa_policy(std::string_view name) -> std::optional<NumaPolicy> {
+        if (name == "off") return NumaPolicy::Off;
+        if (name == "spread") return NumaPolicy::Spread;
+        if (name == "device") return NumaPolicy::Device;
+        return std::nullopt;
+    }
+
+    auto parse_engine_backend(std::string_view name) -> std::optional<EngineBackend> {
+        if (name == "threads") return EngineBackend::Threads;
+        if (name == "async") return EngineBackend::Async;
+        return std::nullopt;
+    }
+
+    // Поля конфигурации из разобранного YAML; origin — откуда он, для ошибок
+    static auto config_from_node(const YAML::Node& config, std::string_view origin)
+        -> std::expected<Config, std::string>
+    {
+        Config cfg{};
+
+        if (config["threads"]) cfg.threads = config["threads"].as<uint32_t>();
+        if (config["buffer_size"]) cfg.buffer_size = config["buffer_size"].as<size_t>();
+        if (config["hash_segment_size"]) cfg.hash_segment_size = config["hash_segment_size"].as<std::uint64_t>();
+        if (config["delta_block_size"]) cfg.delta_block_size = config["delta_block_size"].as<std::uint64_t>();
+        if (config["max_memory"]) cfg.max_memory = config["max_memory"].as<std::uint64_t>();
+        if (config["async_depth"]) cfg.async_depth = config["async_depth"].as<std::uint32_t>();
+        if (config["latency_ceiling_ms"]) cfg.latency_ceiling_ms = config["latency_ceiling_ms"].as<std::uint32_t>();
+        if (config["metrics_interval"]) cfg.metrics_interval = config["metrics_interval"].as<double>();
+        if (config["trace_top"]) cfg.trace_top = config["trace_top"].as<std::uint32_t>();
+        if (config["bwlimit"]) cfg.bwlimit = config["bwlimit"].as<std::uint64_t>();
+        if (config["iops_limit"]) cfg.iops_limit = config["iops_limit"].as<std::uint64_t>();
+        if (config["device_bwlimit"]) cfg.device_bwlimit = config["device_bwlimit"].as<std::uint64_t>();
+        if (config["device_iops_limit"]) cfg.device_iops_limit = config["device_iops_limit"].as<std::uint64_t>();
+
+        if (config["recursive"]) cfg.recursive = config["recursive"].as<bool>();
+        if (config["follow_symlinks"]) cfg.follow_symlinks = config["follow_symlinks"].as<bool>();
+        if (config["verify"]) cfg.verify = config["verify"].as<bool>();
+        if (config["verify_mode"]) {
+            const auto mode = config["verify_mode"].as<std::string>();
+            if (mode == "compare") cfg.verify_mode = VerifyMode::Compare;
+            else if (mode == "hash") cfg.verify_mode = VerifyMode::Hash;
+            else return std::unexpected(fmt::format("Unknown verify_mode '{}' in {}", mode, origin));
+        }
+        if (config["resume"]) cfg.resume = config["resume"].as<bool>();
+        if (config["incremental"]) cfg.incremental = config["incremental"].as<bool>();
+        if (config["delta"]) cfg.delta = config["delta"].as<bool>();
+        if (config["delta_cache"]) cfg.delta_cache = config["delta_cache"].as<bool>();
+        if (config["hard_links"]) cfg.hard_links = config["hard_links"].as<bool>();
+        if (config["atomic"]) cfg.atomic = config["atomic"].as<bool>();
+        if (config["adaptive"]) cfg.adaptive = config["adaptive"].as<bool>();
+        if (config["dedup"]) cfg.dedup = config["dedup"].as<bool>();
+        if (config["dedup_policy"]) {
+            const auto policy = config["dedup_policy"].as<std::string>();
+            if (policy == "reflink") cfg.dedup_policy = DedupPolicy::Reflink;
+            else if (policy == "hardlink") cfg.dedup_policy = DedupPolicy::Hardlink;
+            else return std::unexpected(fmt::format("Unknown dedup_policy '{}' in {}", policy, origin));
+        }
+        if (config["durability"]) {
+            const auto mode = config["durability"].as<std::string>();
+            const auto durability = parse_durability(mode);
+            if (!durability) return std::unexpected(fmt::format("Unknown durability '{}' in {}", mode, origin));
+            cfg.durability = *durability;
+        }
+        if (config["numa"]) {
+            const auto name = config["numa"].as<std::string>();
+            const auto numa = parse_numa_policy(name);
+            if (!numa) return std::unexpected(fmt::format("Unknown numa policy '{}' in {}", name, origin));
+            cfg.numa = *numa;
+        }
+        if (config["engine"]) {
+            const auto name = config["engine"].as<std::string>();
+            const auto engine = parse_engine_backend(name);
+            if (!engine) return std::unexpected(fmt::format("Unknown engine '{}' in {}", name, origin));
+            cfg.engine = *engine;
+        }
+        if (config["progress"]) cfg.progress = config["progress"].as<bool>();
+        if (config["quiet"]) cfg.quiet = config["quiet"].as<bool>();
+
+        if (config["manifest"]) cfg.manifest = config["manifest"].as<std::string>();
+        if (config["throttle_file"]) cfg.throttle_file = config["throttle_file"].as<std::string>();
+        if (config["metrics_prom"]) cfg.metrics_prom = config["metrics_prom"].as<std::string>();
+        if (config["metrics_json"]) cfg.metrics_json = config["metrics_json"].as<std::string>();
+        if (config["trace"]) cfg.trace = config["trace"].as<std::string>();
+
+        if (config["exclude"]) {
+            for (const auto& pat : config["exclude"]) {
+                cfg.exclude_patterns.push_back(pat.as<std::string>());
+            }
+        }
+        if (config["include"]) {
+            for (const auto& pat : config["include"]) {
+                cfg.include_patterns.push_back(pat.as<std::string>());
             }
         }
 
+        return cfg;
+    }
+
+    auto find_config_file() -> std::optional<std::filesystem::path> {
+        for (const auto& path : get_config_paths()) {
+            if (std::filesystem::exists(path)) return path;
+        }
+        return std::nullopt;
+    }
+
+    auto load_config_from_file() -> std::expected<Config, std::string> {
+        const auto path = find_config_file();
         // Файл не найден — возвращаем пустой конфиг (не ошибка!)
-        return Config{};
+        if (!path) return Config{};
+
+        try {
+            auto cfg = config_from_node(YAML::LoadFile(path->string()), path->string());
+            if (cfg) spdlog::debug("Loaded config from {}", path->string());
+            return cfg;
+        } catch (const std::exception& e) {
+            return std::unexpected(fmt::format("Failed to parse {}: {}", path->string(), e.what()));
+        }
+    }
+
+    auto load_config_from_yaml(std::string_view yaml, std::string_view origin) -> std::expected<Config, std::string> {
+        try {
+            return config_from_node(YAML::Load(std::string(yaml)), origin);
+        } catch (const std::exception& e) {
+            return std::unexpected(fmt::format("Failed to parse {}: {}", origin, e.what()));
+        }
     }
 
   
@@ -106,13 +231,41 @@ namespace cclone::infra {
         Config cfg{};
         cfg.threads = args.threads;
         cfg.buffer_size = args.buffer_size;
+        cfg.hash_segment_size = args.hash_segment_size;
+        cfg.delta_block_size = args.delta_block_size;
+        cfg.max_memory = args.max_memory;
+        cfg.async_depth = args.async_depth;
+        cfg.latency_ceiling_ms = args.latency_ceiling;
+        cfg.bwlimit = args.bwlimit;
+        cfg.iops_limit = args.iops_limit;
+        cfg.device_bwlimit = args.device_bwlimit;
+        cfg.device_iops_limit = args.device_iops_limit;
+        cfg.throttle_file = args.throttle_file;
+        cfg.metrics_prom = args.metrics_prom;
+        cfg.metrics_json = args.metrics_json;
+        cfg.metrics_interval = args.metrics_interval;
+        cfg.trace = args.trace;
+        cfg.trace_top = args.trace_top;
         cfg.recursive = args.recursive;
         cfg.follow_symlinks = args.follow_symlinks;
         cfg.verify = args.verify;
+        cfg.verify_mode = args.verify_mode == "compare" ? VerifyMode::Compare : VerifyMode::Hash;
         cfg.resume = args.resume;
+        cfg.incremental = args.incremental;
+        cfg.delta = args.delta;
+        cfg.delta_cache = args.delta_cache;
+        cfg.hard_links = args.hard_links;
+        cfg.atomic = args.atomic;
+        cfg.adaptive = args.adaptive;
+        cfg.dedup = !args.dedup.empty();
+        cfg.dedup_policy = args.dedup == "hardlink" ? DedupPolicy::Hardlink : DedupPolicy::Reflink;
+        cfg.durability = parse_durability(args.durability).value_or(Durability::None);
+        cfg.numa = parse_numa_policy(args.numa).value_or(NumaPolicy::Off);
+        cfg.engine = parse_engine_backend(args.engine).value_or(EngineBackend::Threads);
         cfg.progress = args.progress;
         cfg.quiet = args.quiet;
         cfg.preserve_metadata = args.preserve_metadata;
+        cfg.manifest = args.manifest;
         // include/exclude можно добавить позже
         return cfg;
     }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 #include <cstdint>
@@ -13,22 +14,82 @@ namespace cclone::args_parser{
 
 namespace cclone::infra {
 
-    
+// Чем становятся дубликаты в назначении (--dedup)
+enum class DedupPolicy {
+    Reflink,  // общий экстент, независимые метаданные (btrfs, XFS); иначе обычная копия
+    Hardlink  // общий inode
+};
+
+// Способ проверки скопированного файла
+enum class VerifyMode {
+    Hash,     // XXH3 обоих файлов (TreeHasher для больших)
+    Compare   // прямое побайтовое сравнение, только для локальных путей
+};
+
+// Когда записанное становится устойчивым к потере питания (--durability)
+enum class Durability {
+    None,   // как раньше: решает ОС
+    File,   // fdatasync каждого файла сразу после записи
+    Batch,  // групповой fdatasync окнами в фоновом потоке
+    End     // один syncfs на файловую систему в конце задания
+};
+
+// Размещение рабочих потоков по узлам NUMA (--numa)
+enum class NumaPolicy {
+    Off,     // потоки не закрепляются, решает планировщик ОС
+    Spread,  // рабочие по кругу закрепляются за узлами
+    Device   // рабочие на узлах контроллеров устройств источника и назначения
+};
+
+// Модель выполнения копирования (--engine)
+enum class EngineBackend {
+    Threads, // рабочий поток на каждый файл в полёте
+    Async    // сопрограммы на реакторе io_uring (или epoll + пул): тысячи файлов на поток
+};
+
 struct Config {
     // I/O
     std::optional<std::uint32_t> threads;
     std::optional<std::size_t> buffer_size;   // bytes
+    std::optional<std::uint64_t> hash_segment_size; // bytes, сегмент параллельного хеширования
+    std::optional<std::uint64_t> delta_block_size;  // bytes, блок дельта-передачи
+    std::optional<std::uint64_t> max_memory;        // bytes, предел буферов в полёте
+    std::optional<std::uint32_t> async_depth;       // файлов в полёте у --engine=async
+    std::optional<std::uint32_t> latency_ceiling_ms; // потолок задержки устройства для --adaptive
+    std::optional<std::uint64_t> bwlimit;           // байт/с на задание
+    std::optional<std::uint64_t> iops_limit;        // операций в секунду на задание
+    std::optional<std::uint64_t> device_bwlimit;    // байт/с на каждое устройство
+    std::optional<std::uint64_t> device_iops_limit; // операций в секунду на каждое устройство
+    std::optional<double> metrics_interval;         // секунд между выгрузками метрик
+    std::optional<std::uint32_t> trace_top;         // самых медленных файлов в итогах --trace
 
     // Behavior
     bool recursive = false;
     bool follow_symlinks = false;
     bool verify = false;
+    VerifyMode verify_mode = VerifyMode::Hash;
     bool resume = false;
+    bool incremental = false;      // пропуск неизменных файлов по индексу в корне назначения
+    bool delta = false;            // переписывать только изменённые блоки существующих файлов
+    bool delta_cache = false;      // кэшировать хеши блоков назначения
+    bool dedup = false;            // копировать одинаковое содержимое один раз
+    bool hard_links = false;       // сохранять жёсткие ссылки источника
+    bool atomic = false;           // файл появляется под своим именем только целиком
+    DedupPolicy dedup_policy = DedupPolicy::Reflink;
+    Durability durability = Durability::None;
+    NumaPolicy numa = NumaPolicy::Off;
+    EngineBackend engine = EngineBackend::Threads;
+    bool adaptive = false;         // подбирать параллелизм по пропускной способности
     bool progress = true;
     bool quiet = false;
     bool preserve_metadata = true; // По умолчанию сохраняем метаданные
 
     // Paths
+    std::string manifest;                     // бинарный манифест скопированных файлов
+    std::string throttle_file;                // пределы скорости, перечитываемые на лету
+    std::string metrics_prom;                 // метрики для textfile collector Prometheus
+    std::string metrics_json;                 // поток метрик NDJSON ("-" — stdout)
+    std::string trace;                        // трасса фаз в формате Chrome trace-event
     std::vector<std::string> exclude_patterns;
     std::vector<std::string> include_patterns;
 
@@ -44,6 +105,23 @@ struct Config {
 /// Возвращает пустой Config, если файл не найден.
 [[nodiscard]] auto load_config_from_file() -> std::expected<Config, std::string>;
 
+/// Файл, который прочитает load_config_from_file(), если он есть
+[[nodiscard]] auto find_config_file() -> std::optional<std::filesystem::path>;
+
+/// Конфигурация из текста YAML (файл клиента, пересланный демону);
+/// origin называет источник в сообщениях об ошибках
+[[nodiscard]] auto load_config_from_yaml(std::string_view yaml, std::string_view origin)
+    -> std::expected<Config, std::string>;
+
+/// "none" | "file" | "batch" | "end"
+[[nodiscard]] auto parse_durability(std::string_view name) -> std::optional<Durability>;
+
+/// "off" | "spread" | "device"
+[[nodiscard]] auto parse_numa_policy(std::string_view name) -> std::optional<NumaPolicy>;
+
+/// "threads" | "async"
+[[nodiscard]] auto parse_engine_backend(std::string_view name) -> std::optional<EngineBackend>;
+
 /// Создаёт Config из CLI аргументов (структура из args_parser)
 [[nodiscard]] auto config_from_cli(const struct cclone::args_parser::CLIArgs& args) -> Config;
 
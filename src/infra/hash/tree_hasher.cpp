@@ -0,0 +1,274 @@
+// XXH3 подключается inline: векторная ветка (SSE2 / AVX2 / AVX-512 / NEON)
+// выбирается флагами компиляции этого TU, а не сборкой пакета xxHash.
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
+#include "tree_hasher.hpp"
+#include "infra/syscall/syscalls.hpp"
+#include <spdlog/spdlog.h>
+#include <fmt/core.h>
+#include <algorithm>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <optional>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+namespace cclone::infra {
+
+namespace {
+
+// RAII-обёртка над дескриптором только для чтения
+class ReadHandle {
+public:
+    explicit ReadHandle(const std::filesystem::path& path) {
+#ifndef _WIN32
+        fd_ = sys::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+#else
+        stream_.open(path, std::ios::binary);
+#endif
+    }
+
+    ~ReadHandle() {
+#ifndef _WIN32
+        if (fd_ != -1) sys::close(fd_);
+#endif
+    }
+
+    ReadHandle(const ReadHandle&) = delete;
+    ReadHandle& operator=(const ReadHandle&) = delete;
+
+    [[nodiscard]] auto is_open() const -> bool {
+#ifndef _WIN32
+        return fd_ != -1;
+#else
+        return stream_.is_open();
+#endif
+    }
+
+    // Читает до length байт со смещения offset; возвращает прочитанное или -1
+    auto read_at(char* buffer, std::size_t length, std::uint64_t offset) -> std::int64_t {
+#ifndef _WIN32
+        std::size_t done = 0;
+        while (done < length) {
+            ssize_t n = sys::pread(fd_, buffer + done, length - done,
+                                static_cast<off_t>(offset + done));
+            if (n == 0) break;
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return -1;
+            }
+            done += static_cast<std::size_t>(n);
+        }
+        return static_cast<std::int64_t>(done);
+#else
+        stream_.clear();
+        stream_.seekg(static_cast<std::streamoff>(offset));
+        stream_.read(buffer, static_cast<std::streamsize>(length));
+        if (stream_.bad()) return -1;
+        return static_cast<std::int64_t>(stream_.gcount());
+#endif
+    }
+
+    void advise_sequential(std::uint64_t offset, std::uint64_t length) {
+#if defined(__linux__)
+        sys::fadvise(fd_, static_cast<off_t>(offset), static_cast<off_t>(length),
+                        POSIX_FADV_SEQUENTIAL);
+#else
+        (void)offset; (void)length;
+#endif
+    }
+
+private:
+#ifndef _WIN32
+    int fd_ = -1;
+#else
+    std::ifstream stream_;
+#endif
+};
+
+// Хеширует один сегмент [offset, offset + length) собственным дескриптором,
+// чтобы задачи пула не делили позицию чтения
+auto hash_range(const std::filesystem::path& path,
+                std::uint64_t offset,
+                std::uint64_t length,
+                std::size_t read_size) -> std::expected<XXH64_hash_t, Error>
+{
+    ReadHandle handle(path);
+    if (!handle.is_open()) {
+        return std::unexpected(make_error(ErrorCode::FileNotFound,
+                               fmt::format("Cannot open file for hashing: {}", path.string())));
+    }
+    handle.advise_sequential(offset, length);
+
+    XXH3_state_t state;
+    XXH3_64bits_reset(&state);
+
+    auto buffer = std::make_unique<char[]>(read_size);
+    std::uint64_t remaining = length;
+    std::uint64_t position = offset;
+    while (remaining > 0) {
+        const auto want = static_cast<std::size_t>(std::min<std::uint64_t>(remaining, read_size));
+        const auto got = handle.read_at(buffer.get(), want, position);
+        if (got < 0) {
+            return std::unexpected(make_error(ErrorCode::Unknown,
+                                   fmt::format("Error reading {} at offset {}", path.string(), position)));
+        }
+        if (got == 0) {
+            return std::unexpected(make_error(ErrorCode::Unknown,
+                                   fmt::format("Unexpected EOF in {} at offset {}", path.string(), position)));
+        }
+        XXH3_64bits_update(&state, buffer.get(), static_cast<std::size_t>(got));
+        remaining -= static_cast<std::uint64_t>(got);
+        position += static_cast<std::uint64_t>(got);
+    }
+
+    return XXH3_64bits_digest(&state);
+}
+
+} // namespace
+
+auto TreeDigest::diff(const TreeDigest& other) const -> std::vector<std::size_t> {
+    std::vector<std::size_t> changed;
+    const bool same_shape = file_size == other.file_size
+                         && segment_size == other.segment_size
+                         && segments.size() == other.segments.size();
+    for (std::size_t i = 0; i < segments.size(); ++i) {
+        if (!same_shape || segments[i] != other.segments[i]) {
+            changed.push_back(i);
+        }
+    }
+    return changed;
+}
+
+TreeHasher::TreeHasher(ThreadPool& pool, std::uint64_t segment_size)
+    : pool_(pool)
+    , segment_size_(segment_size > 0 ? segment_size : DEFAULT_SEGMENT_SIZE)
+{}
+
+auto TreeHasher::combine(std::span<const XXH64_hash_t> leaves, std::uint64_t file_size)
+    -> XXH64_hash_t
+{
+    std::vector<XXH64_hash_t> level(leaves.begin(), leaves.end());
+    while (level.size() > 1) {
+        std::vector<XXH64_hash_t> next;
+        next.reserve((level.size() + 1) / 2);
+        for (std::size_t i = 0; i + 1 < level.size(); i += 2) {
+            const XXH64_hash_t pair[2] = {level[i], level[i + 1]};
+            next.push_back(XXH3_64bits(pair, sizeof(pair)));
+        }
+        if (level.size() % 2 != 0) {
+            next.push_back(level.back()); // нечётный узел поднимается без изменений
+        }
+        level = std::move(next);
+    }
+    const XXH64_hash_t top = level.empty() ? XXH3_64bits(nullptr, 0) : level.front();
+    return XXH3_64bits_withSeed(&top, sizeof(top), file_size);
+}
+
+auto TreeHasher::hash_segments(const std::filesystem::path& path,
+                               std::span<const std::size_t> indices)
+    -> std::expected<std::vector<XXH64_hash_t>, Error>
+{
+    std::error_code ec;
+    const auto file_size = sys::file_size(path, ec);
+    if (ec) {
+        return std::unexpected(make_error(ErrorCode::FileNotFound,
+                               fmt::format("Cannot stat file for hashing: {}: {}", path.string(), ec.message())));
+    }
+
+    for (const auto index : indices) {
+        const std::uint64_t offset = static_cast<std::uint64_t>(index) * segment_size_;
+        if (offset >= file_size && !(offset == 0 && file_size == 0)) {
+            return std::unexpected(make_error(ErrorCode::InvalidPath,
+                                   fmt::format("Segment {} is out of range for {}", index, path.string())));
+        }
+    }
+
+    std::vector<std::future<std::expected<XXH64_hash_t, Error>>> futures;
+    futures.reserve(indices.size());
+    for (const auto index : indices) {
+        const std::uint64_t offset = static_cast<std::uint64_t>(index) * segment_size_;
+        const std::uint64_t length = std::min(segment_size_, file_size - offset);
+        futures.push_back(pool_.enqueue_with_future([path, offset, length]() {
+            return hash_range(path, offset, length, READ_SIZE);
+        }));
+    }
+
+    std::vector<XXH64_hash_t> hashes;
+    hashes.reserve(futures.size());
+    std::optional<Error> first_error;
+    for (auto& future : futures) {
+        auto result = future.get(); // дожидаемся всех задач даже после ошибки
+        if (!result) {
+            if (!first_error) first_error = std::move(result.error());
+            continue;
+        }
+        hashes.push_back(*result);
+    }
+    if (first_error) {
+        return std::unexpected(std::move(*first_error));
+    }
+    return hashes;
+}
+
+auto TreeHasher::hash_file(const std::filesystem::path& path)
+    -> std::expected<TreeDigest, Error>
+{
+    std::error_code ec;
+    const auto file_size = sys::file_size(path, ec);
+    if (ec) {
+        return std::unexpected(make_error(ErrorCode::FileNotFound,
+                               fmt::format("Cannot stat file for hashing: {}: {}", path.string(), ec.message())));
+    }
+
+    const std::size_t count = file_size == 0
+        ? 1
+        : static_cast<std::size_t>((file_size + segment_size_ - 1) / segment_size_);
+    std::vector<std::size_t> indices(count);
+    for (std::size_t i = 0; i < count; ++i) indices[i] = i;
+
+    auto leaves = hash_segments(path, indices);
+    if (!leaves) {
+        return std::unexpected(std::move(leaves.error()));
+    }
+
+    TreeDigest digest;
+    digest.file_size = file_size;
+    digest.segment_size = segment_size_;
+    digest.segments = std::move(*leaves);
+    digest.root = combine(digest.segments, file_size);
+    return digest;
+}
+
+auto TreeHasher::verify_files(const std::filesystem::path& src,
+                              const std::filesystem::path& dst)
+    -> std::expected<bool, Error>
+{
+    auto src_digest = hash_file(src);
+    if (!src_digest) {
+        return std::unexpected(std::move(src_digest.error()));
+    }
+
+    auto dst_digest = hash_file(dst);
+    if (!dst_digest) {
+        return std::unexpected(std::move(dst_digest.error()));
+    }
+
+    const bool match = src_digest->root == dst_digest->root;
+    if (!match) {
+        const auto changed = src_digest->diff(*dst_digest);
+        spdlog::warn("Tree hash mismatch: {} (root: {:016x}) vs {} (root: {:016x}), {} of {} segments differ",
+                     src.string(), src_digest->root,
+                     dst.string(), dst_digest->root,
+                     changed.size(), src_digest->segment_count());
+    }
+    return match;
+}
+
+} // namespace cclone::infra
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <filesystem>
+#include <expected>
+#include <vector>
+#include <span>
+#include <cstdint>
+#include "../error_handler/error.hpp"
+#include "../thread_pool/thread_pool.hpp"
+#include <xxhash.h>
+
+namespace cclone::infra {
+
+// Дайджест файла, разбитого на сегменты фиксированного размера.
+// Листья — XXH3-64 каждого сегмента, корень — Merkle-свёртка листьев.
+struct TreeDigest {
+    std::uint64_t file_size = 0;
+    std::uint64_t segment_size = 0;
+    std::vector<XXH64_hash_t> segments;
+    XXH64_hash_t root = 0;
+
+    [[nodiscard]] auto segment_count() const -> std::size_t { return segments.size(); }
+
+    // Индексы сегментов, отличающихся от other.
+    // При разной геометрии (размер файла / сегмента) отличаются все сегменты.
+    [[nodiscard]] auto diff(const TreeDigest& other) const -> std::vector<std::size_t>;
+};
+
+// Параллельное хеширование одного большого файла:
+// сегменты читаются через pread и хешируются задачами пула,
+// после чего листья сворачиваются в корень.
+class TreeHasher {
+public:
+    static constexpr std::uint64_t DEFAULT_SEGMENT_SIZE = 64ull * 1024 * 1024; // 64MB
+
+    explicit TreeHasher(ThreadPool& pool, std::uint64_t segment_size = DEFAULT_SEGMENT_SIZE);
+
+    // Полный дайджест файла
+    [[nodiscard]] auto hash_file(const std::filesystem::path& path)
+        -> std::expected<TreeDigest, Error>;
+
+    // Перехеширует только указанные сегменты (частичная повторная проверка,
+    // докопирование по чанкам). Результат — в порядке indices.
+    [[nodiscard]] auto hash_segments(const std::filesystem::path& path,
+                                     std::span<const std::size_t> indices)
+        -> std::expected<std::vector<XXH64_hash_t>, Error>;
+
+    // Сравнивает корни дайджестов двух файлов
+    [[nodiscard]] auto verify_files(const std::filesystem::path& src,
+                                    const std::filesystem::path& dst)
+        -> std::expected<bool, Error>;
+
+    // Merkle-свёртка листьев; размер файла входит в корень,
+    // чтобы файлы с одинаковыми листьями, но разной длиной не совпадали
+    [[nodiscard]] static auto combine(std::span<const XXH64_hash_t> leaves,
+                                      std::uint64_t file_size) -> XXH64_hash_t;
+
+    [[nodiscard]] auto segment_size() const -> std::uint64_t { return segment_size_; }
+
+private:
+    ThreadPool& pool_;
+    const std::uint64_t segment_size_;
+
+    static constexpr std::size_t READ_SIZE = 4 * 1024 * 1024; // 4MB на один pread
+};
+
+} // namespace cclone::infra
@@ -1,3 +1,6 @@
+// XXH3 подключается inline, чтобы использовать векторные инструкции,
+// доступные при компиляции этого TU (см. CCLONE_ENABLE_NATIVE_ARCH)
+#define XXH_INLINE_ALL
 #include "xxhash_verifier.hpp"
 #include <spdlog/spdlog.h>
 
@@ -12,20 +15,20 @@ auto XXHashVerifier::hash_file(const std::filesystem::path& path)
                                          fmt::format("Cannot open file for hashing: {}", path.string())));
     }
 
-    XXH64_state_t* state = XXH64_createState();
+    XXH3_state_t* state = XXH3_createState();
     if (!state) {
-        return std::unexpected(make_error(ErrorCode::Unknown, "Failed to create XXH64 state"));
+        return std::unexpected(make_error(ErrorCode::Unknown, "Failed to create XXH3 state"));
     }
 
-    XXH64_reset(state, 0); // seed = 0
+    XXH3_64bits_reset(state); // seed = 0
 
     std::vector<char> buffer(BUFFER_SIZE);
     while (file.read(buffer.data(), buffer.size()) || file.gcount() > 0) {
-        XXH64_update(state, buffer.data(), file.gcount());
+        XXH3_64bits_update(state, buffer.data(), file.gcount());
     }
 
-    XXH64_hash_t hash = XXH64_digest(state);
-    XXH64_freeState(state);
+    XXH64_hash_t hash = XXH3_64bits_digest(state);
+    XXH3_freeState(state);
 
     if (file.bad() && !file.eof()) {
         return std::unexpected(make_error(ErrorCode::Unknown,
@@ -11,7 +11,9 @@ namespace cclone::infra {
 
 class XXHashVerifier {
 public:
-    // Вычисляет xxHash64 для файла
+    static constexpr size_t BUFFER_SIZE = 4 * 1024 * 1024; // 4MB buffer
+
+    // Вычисляет XXH3-64 для файла
     static auto hash_file(const std::filesystem::path& path) 
         -> std::expected<XXH64_hash_t, Error>;
 
@@ -19,9 +21,6 @@ public:
     static auto verify_files(const std::filesystem::path& src,
                             const std::filesystem::path& dst)
         -> std::expected<bool, Error>;
-
-private:
-    static constexpr size_t BUFFER_SIZE = 4 * 1024 * 1024; // 4MB buffer
 };
 
 } // namespace cclone::infra
@@ -4,6 +4,15 @@
 namespace cclone::infra {
 
 std::atomic<bool> g_interrupted{false};
+thread_local const std::atomic<bool>* t_cancel = nullptr;
+
+namespace {
+std::atomic<bool> g_reload_requested{false};
+
+void reload_handler(int) {
+    g_reload_requested.store(true, std::memory_order_relaxed);
+}
+} // namespace
 
 void signal_handler(int sig) {
     if (sig == SIGINT || sig == SIGTERM) {
@@ -17,4 +26,14 @@ void install_signal_handler() {
     std::signal(SIGTERM, signal_handler);
 }
 
+void install_reload_handler() {
+#ifdef SIGUSR1
+    std::signal(SIGUSR1, reload_handler);
+#endif
+}
+
+bool take_reload_request() {
+    return g_reload_requested.exchange(false, std::memory_order_relaxed);
+}
+
 } // namespace cclone::infra
\ No newline at end of file
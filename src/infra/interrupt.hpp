@@ -7,10 +7,43 @@ namespace cclone::infra {
 
 extern std::atomic<bool> g_interrupted;
 
+// Флаг отмены задания, которое выполняет этот поток (режим демона):
+// его видит is_interrupted() наравне с сигналом. Ставится CancelScope
+extern thread_local const std::atomic<bool>* t_cancel;
+
 void install_signal_handler();
 
 inline bool is_interrupted() {
-    return g_interrupted.load(std::memory_order_relaxed);
+    return g_interrupted.load(std::memory_order_relaxed)
+        || (t_cancel && t_cancel->load(std::memory_order_relaxed));
 }
 
+// Привязывает поток к флагу отмены задания на время области; вложенные
+// области восстанавливают прежний. Задачи, уходящие в другие потоки,
+// уносят флаг с собой: CancelScope scope(CancelScope::current())
+class CancelScope {
+public:
+    explicit CancelScope(const std::atomic<bool>* cancel)
+        : previous_(t_cancel)
+    {
+        t_cancel = cancel;
+    }
+    ~CancelScope() { t_cancel = previous_; }
+
+    CancelScope(const CancelScope&) = delete;
+    CancelScope& operator=(const CancelScope&) = delete;
+
+    [[nodiscard]] static auto current() -> const std::atomic<bool>* { return t_cancel; }
+
+private:
+    const std::atomic<bool>* previous_;
+};
+
+// SIGUSR1 — перечитать файл управления (--throttle-file). Ставится только
+// вместе с ним: без обработчика сигнал, как обычно, завершает процесс
+void install_reload_handler();
+
+// Был ли SIGUSR1 с прошлого вызова
+bool take_reload_request();
+
 } // namespace cclone::infra
\ No newline at end of file
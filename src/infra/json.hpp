@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <fmt/core.h>
+
+namespace cclone::infra {
+
+// Экранирование строки для JSON (метрики, трассировка); кавычки не добавляет
+[[nodiscard]] inline auto json_escape(std::string_view text) -> std::string {
+    std::string out;
+    out.reserve(text.size());
+    for (const char c : text) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) out += fmt::format("\\u{:04x}", c);
+                else out += c;
+        }
+    }
+    return out;
+}
+
+} // namespace cclone::infra
@@ -0,0 +1,27 @@
+#include "hdr_histogram.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace cclone::infra {
+
+void HdrHistogram::merge(const HdrHistogram& other) {
+    for (std::size_t i = 0; i < BUCKETS; ++i) {
+        counts_[i] += other.counts_[i];
+    }
+    count_ += other.count_;
+    max_ = std::max(max_, other.max_);
+}
+
+auto HdrHistogram::percentile(double q) const -> std::uint64_t {
+    if (count_ == 0) return 0;
+    const auto rank = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(count_))));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < BUCKETS; ++i) {
+        seen += counts_[i];
+        if (seen >= rank) return std::min(bucket_high(i), max_);
+    }
+    return max_;
+}
+
+} // namespace cclone::infra
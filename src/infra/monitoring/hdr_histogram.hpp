@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace cclone::infra {
+
+// Гистограмма в духе HdrHistogram: на каждую степень двойки по SUB_COUNT
+// линейных корзин, так что относительная погрешность квантиля не больше
+// 1/SUB_COUNT на всём диапазоне — от наносекунд до часа. Значения до
+// 2*SUB_COUNT хранятся точно, больше MAX_VALUE — в последней корзине.
+// Не потокобезопасна: один писатель, слияние — когда писатели закончили
+class HdrHistogram {
+public:
+    static constexpr unsigned SUB_BITS = 5;
+    static constexpr std::uint64_t SUB_COUNT = std::uint64_t{1} << SUB_BITS;
+    static constexpr unsigned MAX_BITS = 42;   // ~73 минуты в наносекундах
+    static constexpr std::uint64_t MAX_VALUE = (std::uint64_t{1} << MAX_BITS) - 1;
+    static constexpr std::size_t BUCKETS = (MAX_BITS - SUB_BITS + 1) * SUB_COUNT;
+
+    [[nodiscard]] static constexpr auto bucket_of(std::uint64_t value) -> std::size_t {
+        if (value > MAX_VALUE) value = MAX_VALUE;
+        if (value < 2 * SUB_COUNT) return static_cast<std::size_t>(value);
+        const auto shift = static_cast<unsigned>(std::bit_width(value)) - SUB_BITS - 1;
+        return static_cast<std::size_t>(shift * SUB_COUNT + (value >> shift));
+    }
+
+    // Наибольшее значение, попадающее в корзину
+    [[nodiscard]] static constexpr auto bucket_high(std::size_t bucket) -> std::uint64_t {
+        if (bucket < 2 * SUB_COUNT) return bucket;
+        const auto shift = bucket / SUB_COUNT - 1;
+        const auto mantissa = bucket - shift * SUB_COUNT;
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    void record(std::uint64_t value) {
+        ++counts_[bucket_of(value)];
+        ++count_;
+        if (value > max_) max_ = value;
+    }
+
+    void merge(const HdrHistogram& other);
+
+    // Значение, не меньше которого доля q записей (0 < q <= 1); верхняя
+    // граница корзины, но не больше наибольшего записанного
+    [[nodiscard]] auto percentile(double q) const -> std::uint64_t;
+
+    [[nodiscard]] auto count() const -> std::uint64_t { return count_; }
+    [[nodiscard]] auto max() const -> std::uint64_t { return max_; }
+
+private:
+    std::array<std::uint64_t, BUCKETS> counts_{};
+    std::uint64_t count_ = 0;
+    std::uint64_t max_ = 0;
+};
+
+} // namespace cclone::infra
@@ -0,0 +1,269 @@
+#include "metrics.hpp"
+#include "../concurrent/sharded_counters.hpp"
+#include "../json.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+
+#ifndef _WIN32
+    #include <unistd.h>
+#endif
+
+namespace cclone::infra {
+
+namespace {
+
+// Экранирование значения подписи Prometheus: \, " и перевод строки
+auto prometheus_escape(std::string_view text) -> std::string {
+    std::string out;
+    out.reserve(text.size());
+    for (const char c : text) {
+        if (c == '\\') out += "\\\\";
+        else if (c == '"') out += "\\\"";
+        else if (c == '\n') out += "\\n";
+        else out += c;
+    }
+    return out;
+}
+
+auto type_name(MetricsSnapshot::Type type) -> std::string_view {
+    switch (type) {
+        case MetricsSnapshot::Type::Counter:   return "counter";
+        case MetricsSnapshot::Type::Gauge:     return "gauge";
+        case MetricsSnapshot::Type::Histogram: return "histogram";
+    }
+    return "untyped";
+}
+
+// {a="x",b="y"}; extra — дополнительная подпись (le у корзин)
+auto prometheus_labels(const MetricsSnapshot::Labels& labels, std::string_view extra = {}) -> std::string {
+    if (labels.empty() && extra.empty()) return {};
+    std::string out = "{";
+    for (const auto& [key, value] : labels) {
+        if (out.size() > 1) out += ',';
+        out += fmt::format("{}=\"{}\"", key, prometheus_escape(value));
+    }
+    if (!extra.empty()) {
+        if (out.size() > 1) out += ',';
+        out += extra;
+    }
+    return out + "}";
+}
+
+auto json_labels(const MetricsSnapshot::Labels& labels) -> std::string {
+    std::string out = "{";
+    for (const auto& [key, value] : labels) {
+        if (out.size() > 1) out += ',';
+        out += fmt::format("\"{}\":\"{}\"", json_escape(key), json_escape(value));
+    }
+    return out + "}";
+}
+
+} // namespace
+
+void LatencyHistogram::record(std::chrono::nanoseconds latency) {
+    const double seconds = std::chrono::duration<double>(latency).count();
+    const auto bucket = static_cast<std::size_t>(
+        std::lower_bound(BOUNDS.begin(), BOUNDS.end(), seconds) - BOUNDS.begin());
+    auto& shard = shards_[this_thread_slot() % SHARDS];
+    shard.counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    shard.sum_ns.fetch_add(static_cast<std::uint64_t>(std::max<std::int64_t>(0, latency.count())),
+                           std::memory_order_relaxed);
+}
+
+auto LatencyHistogram::snapshot() const -> Snapshot {
+    Snapshot result;
+    std::uint64_t sum_ns = 0;
+    for (const auto& shard : shards_) {
+        for (std::size_t i = 0; i < BUCKETS; ++i) {
+            result.counts[i] += shard.counts[i].load(std::memory_order_relaxed);
+        }
+        sum_ns += shard.sum_ns.load(std::memory_order_relaxed);
+    }
+    for (const auto count : result.counts) result.count += count;
+    result.sum = static_cast<double>(sum_ns) / 1e9;
+    return result;
+}
+
+auto MetricsSnapshot::family_(std::string_view name, std::string_view help, Type type) -> Family& {
+    const auto it = std::find_if(families_.begin(), families_.end(),
+                                 [&](const Family& family) { return family.name == name; });
+    if (it != families_.end()) return *it;
+    return families_.emplace_back(Family{.name = std::string(name), .help = std::string(help), .type = type});
+}
+
+void MetricsSnapshot::counter(std::string_view name, std::string_view help, double value, Labels labels) {
+    family_(name, help, Type::Counter).samples.push_back(Sample{.labels = std::move(labels), .value = value});
+}
+
+void MetricsSnapshot::gauge(std::string_view name, std::string_view help, double value, Labels labels) {
+    family_(name, help, Type::Gauge).samples.push_back(Sample{.labels = std::move(labels), .value = value});
+}
+
+void MetricsSnapshot::histogram(std::string_view name, std::string_view help,
+                                const LatencyHistogram::Snapshot& histogram, Labels labels)
+{
+    family_(name, help, Type::Histogram).samples.push_back(
+        Sample{.labels = std::move(labels), .value = 0, .histogram = histogram});
+}
+
+auto to_prometheus(const MetricsSnapshot& snapshot) -> std::string {
+    std::string out;
+    for (const auto& family : snapshot.families()) {
+        out += fmt::format("# HELP {} {}\n# TYPE {} {}\n", family.name, family.help, family.name,
+                           type_name(family.type));
+        for (const auto& sample : family.samples) {
+            if (family.type != MetricsSnapshot::Type::Histogram) {
+                out += fmt::format("{}{} {}\n", family.name, prometheus_labels(sample.labels), sample.value);
+                continue;
+            }
+            // Корзины Prometheus накопительные
+            std::uint64_t cumulative = 0;
+            for (std::size_t i = 0; i < LatencyHistogram::BUCKETS; ++i) {
+                cumulative += sample.histogram.counts[i];
+                const auto le = i < LatencyHistogram::BOUNDS.size()
+                                    ? fmt::format("le=\"{}\"", LatencyHistogram::BOUNDS[i])
+                                    : std::string("le=\"+Inf\"");
+                out += fmt::format("{}_bucket{} {}\n", family.name, prometheus_labels(sample.labels, le),
+                                   cumulative);
+            }
+            out += fmt::format("{}_sum{} {}\n", family.name, prometheus_labels(sample.labels), sample.histogram.sum);
+            out += fmt::format("{}_count{} {}\n", family.name, prometheus_labels(sample.labels),
+                               sample.histogram.count);
+        }
+    }
+    return out;
+}
+
+auto to_json_line(const MetricsSnapshot& snapshot, std::chrono::system_clock::time_point when) -> std::string {
+    const double timestamp = std::chrono::duration<double>(when.time_since_epoch()).count();
+    std::string out = fmt::format("{{\"timestamp\":{:.3f},\"metrics\":[", timestamp);
+    bool first = true;
+    for (const auto& family : snapshot.families()) {
+        for (const auto& sample : family.samples) {
+            if (!first) out += ',';
+            first = false;
+            out += fmt::format("{{\"name\":\"{}\",\"type\":\"{}\",\"labels\":{}", family.name,
+                               type_name(family.type), json_labels(sample.labels));
+            if (family.type != MetricsSnapshot::Type::Histogram) {
+                out += fmt::format(",\"value\":{}}}", sample.value);
+                continue;
+            }
+            out += fmt::format(",\"count\":{},\"sum\":{},\"buckets\":[", sample.histogram.count, sample.histogram.sum);
+            std::uint64_t cumulative = 0;
+            for (std::size_t i = 0; i < LatencyHistogram::BUCKETS; ++i) {
+                cumulative += sample.histogram.counts[i];
+                if (i != 0) out += ',';
+                if (i < LatencyHistogram::BOUNDS.size()) {
+                    out += fmt::format("{{\"le\":{},\"count\":{}}}", LatencyHistogram::BOUNDS[i], cumulative);
+                } else {
+                    out += fmt::format("{{\"le\":\"+Inf\",\"count\":{}}}", cumulative);
+                }
+            }
+            out += "]}";
+        }
+    }
+    return out + "]}\n";
+}
+
+auto MetricsExporter::create(const Options& options, Collector collector)
+    -> std::expected<std::unique_ptr<MetricsExporter>, Error>
+{
+    std::FILE* json = nullptr;
+    if (options.json_file) {
+        if (*options.json_file == "-") {
+            json = stdout;
+        } else {
+            json = std::fopen(options.json_file->c_str(), "a");
+            if (!json) {
+                return std::unexpected(make_error(ErrorCode::InvalidPath,
+                    fmt::format("Cannot open metrics stream {}: {}", options.json_file->string(),
+                                std::strerror(errno))));
+            }
+        }
+    }
+    if (options.prometheus_file) {
+        const auto dir = options.prometheus_file->parent_path();
+        std::error_code ec;
+        if (!dir.empty() && !std::filesystem::is_directory(dir, ec)) {
+            if (json && json != stdout) std::fclose(json);
+            return std::unexpected(make_error(ErrorCode::InvalidPath,
+                fmt::format("Metrics directory does not exist: {}", dir.string())));
+        }
+    }
+    return std::unique_ptr<MetricsExporter>(new MetricsExporter(options, std::move(collector), json));
+}
+
+MetricsExporter::MetricsExporter(const Options& options, Collector collector, std::FILE* json)
+    : options_(options)
+    , collector_(std::move(collector))
+    , json_(json)
+{
+    worker_ = std::jthread([this](std::stop_token stop) {
+        std::mutex sleep_mutex;
+        std::condition_variable_any wakeup;
+        while (!stop.stop_requested()) {
+            {
+                std::unique_lock lock(sleep_mutex);
+                if (wakeup.wait_for(lock, stop, options_.interval, [] { return false; })) break;
+            }
+            if (stop.stop_requested()) break;
+            flush();
+        }
+    });
+}
+
+MetricsExporter::~MetricsExporter() {
+    if (worker_.joinable()) {
+        worker_.request_stop();
+        worker_.join();
+    }
+    flush();  // итоговые значения
+    if (json_ && json_ != stdout) std::fclose(json_);
+}
+
+void MetricsExporter::flush() {
+    std::lock_guard lock(mutex_);
+    const auto snapshot = collector_();
+
+    if (options_.prometheus_file) {
+        // node_exporter может прочитать файл в любой момент: пишем рядом и переименовываем
+        auto temporary = *options_.prometheus_file;
+#ifndef _WIN32
+        temporary += fmt::format(".{}.tmp", ::getpid());
+#else
+        temporary += ".tmp";
+#endif
+        bool written = false;
+        {
+            std::ofstream out(temporary, std::ios::trunc);
+            out << to_prometheus(snapshot);
+            out.flush();
+            written = static_cast<bool>(out);
+        }
+        std::error_code ec;
+        if (!written) {
+            // Недописанный файл не должен заменить последний целый снимок
+            spdlog::warn("Cannot write metrics to {}", temporary.string());
+            std::filesystem::remove(temporary, ec);
+        } else {
+            std::filesystem::rename(temporary, *options_.prometheus_file, ec);
+            if (ec) {
+                spdlog::warn("Cannot publish metrics file {}: {}", options_.prometheus_file->string(), ec.message());
+                std::filesystem::remove(temporary, ec);
+            }
+        }
+    }
+
+    if (json_) {
+        const auto line = to_json_line(snapshot, std::chrono::system_clock::now());
+        std::fwrite(line.data(), 1, line.size(), json_);
+        std::fflush(json_);
+    }
+}
+
+} // namespace cclone::infra
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <expected>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "../error_handler/error.hpp"
+
+namespace cclone::infra {
+
+// Гистограмма задержек с фиксированными границами в духе Prometheus.
+// Как и ShardedCounters: поток пишет в свой шард, снимок суммирует
+class LatencyHistogram {
+public:
+    // Верхние границы корзин, секунды; последняя корзина — +Inf
+    static constexpr std::array<double, 18> BOUNDS{
+        0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05,
+        0.1, 0.25, 0.5, 1, 2.5, 5, 10, 30, 60
+    };
+    static constexpr std::size_t BUCKETS = BOUNDS.size() + 1;
+
+    struct Snapshot {
+        std::array<std::uint64_t, BUCKETS> counts{};  // по корзинам, не накопительно
+        std::uint64_t count = 0;
+        double sum = 0;                               // секунды
+    };
+
+    LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(std::chrono::nanoseconds latency);
+    [[nodiscard]] auto snapshot() const -> Snapshot;
+
+private:
+    static constexpr std::size_t SHARDS = 16;
+
+    struct alignas(64) Shard {
+        std::array<std::atomic<std::uint64_t>, BUCKETS> counts{};
+        std::atomic<std::uint64_t> sum_ns{0};
+    };
+
+    std::array<Shard, SHARDS> shards_{};
+};
+
+// Снимок метрик для экспорта. Имена и подписи — по правилам Prometheus
+// (snake_case, счётчики с суффиксом _total); значения собирает владелец
+// счётчиков, экспортёр только форматирует
+class MetricsSnapshot {
+public:
+    enum class Type { Counter, Gauge, Histogram };
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+
+    struct Sample {
+        Labels labels;
+        double value = 0;
+        LatencyHistogram::Snapshot histogram;  // для Type::Histogram
+    };
+
+    struct Family {
+        std::string name;
+        std::string help;
+        Type type;
+        std::vector<Sample> samples;
+    };
+
+    void counter(std::string_view name, std::string_view help, double value, Labels labels = {});
+    void gauge(std::string_view name, std::string_view help, double value, Labels labels = {});
+    void histogram(std::string_view name, std::string_view help, const LatencyHistogram::Snapshot& histogram,
+                   Labels labels = {});
+
+    [[nodiscard]] auto families() const -> const std::vector<Family>& { return families_; }
+
+private:
+    auto family_(std::string_view name, std::string_view help, Type type) -> Family&;
+
+    std::vector<Family> families_;
+};
+
+// Текстовый формат Prometheus (textfile collector node_exporter)
+[[nodiscard]] auto to_prometheus(const MetricsSnapshot& snapshot) -> std::string;
+
+// Одна строка NDJSON: {"timestamp":..., "metrics":[{"name":..., "labels":{...}, "value":...}, ...]}
+[[nodiscard]] auto to_json_line(const MetricsSnapshot& snapshot, std::chrono::system_clock::time_point when)
+    -> std::string;
+
+// Периодический экспорт (--metrics-prom / --metrics-json): фоновый поток
+// раз в interval берёт снимок у collector и записывает его. Файл Prometheus
+// заменяется атомарно через rename, поток JSON дописывается построчно.
+// Деструктор останавливает поток и записывает последний снимок.
+class MetricsExporter {
+public:
+    struct Options {
+        std::optional<std::filesystem::path> prometheus_file;
+        std::optional<std::filesystem::path> json_file;   // "-" — stdout
+        std::chrono::milliseconds interval{10000};
+    };
+
+    using Collector = std::function<MetricsSnapshot()>;
+
+    [[nodiscard]] static auto create(const Options& options, Collector collector)
+        -> std::expected<std::unique_ptr<MetricsExporter>, Error>;
+
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    // Снять и записать снимок немедленно
+    void flush();
+
+private:
+    MetricsExporter(const Options& options, Collector collector, std::FILE* json);
+
+    Options options_;
+    Collector collector_;
+    std::mutex mutex_;       // flush() из фонового потока и снаружи
+    std::FILE* json_;
+    std::jthread worker_;
+};
+
+} // namespace cclone::infra
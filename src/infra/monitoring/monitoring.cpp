@@ -34,16 +34,17 @@ void ProgressMonitor::set_total(std::uint64_t files, std::uint64_t bytes) {
 }
 
 void ProgressMonitor::update(std::uint64_t files, std::uint64_t bytes) {
-    processed_files_ += files;
-    processed_bytes_ += bytes;
+    if (files) processed_.add(Counter::Files, files);
+    if (bytes) processed_.add(Counter::Bytes, bytes);
 }
 
 auto ProgressMonitor::get_stats() const -> Stats {
+    const auto processed = processed_.load_all();
     return Stats{
         .total_files = total_files_,
-        .processed_files = processed_files_.load(),
+        .processed_files = processed[static_cast<std::size_t>(Counter::Files)],
         .total_bytes = total_bytes_,
-        .processed_bytes = processed_bytes_.load(),
+        .processed_bytes = processed[static_cast<std::size_t>(Counter::Bytes)],
         .start_time = start_time_
     };
 }
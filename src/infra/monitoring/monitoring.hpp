@@ -7,6 +7,7 @@
 #include <string_view>
 #include <memory>
 #include <thread>
+#include "../concurrent/sharded_counters.hpp"
 
 namespace cclone::infra {
 
@@ -34,9 +35,10 @@ private:
     void start_rendering_thread_();
     void stop_rendering_thread_();
 
-    // Атомики для thread-safe обновления
-    std::atomic<std::uint64_t> processed_files_{0};
-    std::atomic<std::uint64_t> processed_bytes_{0};
+    // Шардированные счётчики: update() из рабочих не делят кеш-линию,
+    // get_stats() и отрисовка суммируют шарды
+    enum class Counter : std::size_t { Files, Bytes, Count };
+    ShardedCounters<Counter> processed_;
     std::uint64_t total_files_ = 0;
     std::uint64_t total_bytes_ = 0;
 
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "hdr_histogram.hpp"
+
+namespace cclone::infra {
+
+// Классы операций, задержки которых считаются по отдельности
+enum class IoOp : std::uint8_t {
+    Open,
+    Read,
+    Write,
+    Fsync,
+    Stat,
+    Metadata,
+    File,       // копирование файла целиком
+    Count
+};
+
+// Размер файла; границы совпадают с выбором стратегии копирования
+enum class SizeClass : std::uint8_t {
+    Under64K,
+    Under1M,
+    Under100M,
+    Huge,
+    Count
+};
+
+[[nodiscard]] auto io_op_name(IoOp op) -> std::string_view;
+[[nodiscard]] auto size_class_name(SizeClass size) -> std::string_view;
+[[nodiscard]] auto size_class(std::uint64_t bytes) -> SizeClass;
+
+// path — номер способа копирования у владельца (CopyPath движка)
+struct LatencyKey {
+    std::size_t path;
+    SizeClass size;
+};
+
+// Задержки операций ввода-вывода по способу копирования и размеру файла.
+// У каждого потока свои гистограммы (HdrHistogram), запись идёт без
+// блокировок и атомиков; merge() сливает их, когда рабочие закончили.
+// Гистограмма заводится при первой записи ключа в потоке. Рабочий общего
+// пула демона чередует задания, поэтому гистограммы потока ищутся по
+// регистратору: их не больше, чем потоков, сколько бы раз поток ни
+// переключался между регистраторами.
+//
+// Там же, в счётчике потока, копятся байты, записанные в назначение под
+// контекстом регистратора: они растут с каждой записью, а не по
+// завершении файла, и не включают чужие записи процесса (журнал,
+// метрики, другие задания демона) — по ним --adaptive меряет скорость
+class OpLatency {
+public:
+    static constexpr std::size_t PATHS = 8;
+    static constexpr std::size_t NO_PATH = PATHS - 1;   // вне копирования файла: сканирование
+
+    struct Row {
+        IoOp op;
+        LatencyKey key;
+        HdrHistogram histogram;
+    };
+
+    OpLatency();
+    ~OpLatency();
+
+    OpLatency(const OpLatency&) = delete;
+    OpLatency& operator=(const OpLatency&) = delete;
+
+    void record(IoOp op, LatencyKey key, std::chrono::nanoseconds latency);
+
+    // Непустые гистограммы, слитые по потокам
+    [[nodiscard]] auto merge() const -> std::vector<Row>;
+
+    // Потоков, писавших в регистратор
+    [[nodiscard]] auto threads() const -> std::size_t;
+
+    void add_written(std::uint64_t bytes);
+    [[nodiscard]] auto written() const -> std::uint64_t;
+
+    // Куда пишет OpTimer в текущем потоке
+    struct Binding {
+        OpLatency* recorder = nullptr;
+        LatencyKey key{NO_PATH, SizeClass::Under64K};
+    };
+
+    // Чтобы продолжить контекст в задаче другого потока
+    [[nodiscard]] static auto bound() noexcept -> Binding;
+
+    // Файл, который копирует текущий поток: OpTimer пишет под его ключом.
+    // Вложенный контекст восстанавливает внешний при выходе
+    class Context {
+    public:
+        Context(OpLatency& recorder, LatencyKey key) noexcept;
+        explicit Context(const Binding& binding) noexcept;
+        ~Context();
+
+        Context(const Context&) = delete;
+        Context& operator=(const Context&) = delete;
+
+    private:
+        Binding previous_;
+    };
+
+private:
+    struct ThreadSlots;
+    auto slots_() -> ThreadSlots&;
+
+    const std::uint64_t id_;
+    mutable std::mutex mutex_;   // только регистрация потоков и merge()
+    std::vector<std::unique_ptr<ThreadSlots>> threads_;
+};
+
+namespace detail {
+inline thread_local OpLatency::Binding latency_binding{};
+} // namespace detail
+
+inline auto OpLatency::bound() noexcept -> Binding {
+    return detail::latency_binding;
+}
+
+// Байты, записанные в контексте текущего потока; без контекста — ничего
+inline void note_written(std::uint64_t bytes) {
+    if (auto* recorder = detail::latency_binding.recorder) recorder->add_written(bytes);
+}
+
+// Задержка одной операции в контексте текущего потока. Без контекста
+// (копирование вне движка, тесты адаптеров) часы не читаются
+class OpTimer {
+public:
+    explicit OpTimer(IoOp op) noexcept
+        : op_(op)
+        , binding_(detail::latency_binding)
+    {
+        if (binding_.recorder) begin_ = std::chrono::steady_clock::now();
+    }
+
+    ~OpTimer() {
+        if (binding_.recorder) binding_.recorder->record(op_, binding_.key, std::chrono::steady_clock::now() - begin_);
+    }
+
+    OpTimer(const OpTimer&) = delete;
+    OpTimer& operator=(const OpTimer&) = delete;
+
+private:
+    IoOp op_;
+    OpLatency::Binding binding_;
+    std::chrono::steady_clock::time_point begin_{};
+};
+
+// Квантили одной строки отчёта
+struct LatencySummary {
+    IoOp op;
+    std::string label;             // пусто — итог по операции; иначе «способ размер»
+    std::uint64_t count = 0;
+    std::chrono::nanoseconds p50{0};
+    std::chrono::nanoseconds p90{0};
+    std::chrono::nanoseconds p99{0};
+    std::chrono::nanoseconds p999{0};
+    std::chrono::nanoseconds max{0};
+};
+
+// Итог по каждой операции и разбивка по способу и размеру;
+// path_names — имена способов копирования по номерам
+[[nodiscard]] auto summarize(const std::vector<OpLatency::Row>& rows, std::span<const std::string_view> path_names)
+    -> std::vector<LatencySummary>;
+
+// Таблица для журнала: заголовок и строка на каждую запись
+[[nodiscard]] auto format_latency_table(const std::vector<LatencySummary>& summary) -> std::vector<std::string>;
+
+} // namespace cclone::infra
@@ -0,0 +1,178 @@
+#include "numa.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <fmt/core.h>
+
+#ifdef __linux__
+    #include <sched.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <sys/sysmacros.h>
+    #include <unistd.h>
+    #include <cerrno>
+    #include <cstring>
+#endif
+
+namespace cclone::infra {
+
+namespace {
+
+#ifdef __linux__
+constexpr int MPOL_PREFERRED_MODE = 1;  // <numaif.h>, без зависимости от libnuma
+#endif
+
+auto read_line(const std::filesystem::path& path) -> std::optional<std::string> {
+    std::ifstream in(path);
+    std::string line;
+    if (!in || !std::getline(in, line)) return std::nullopt;
+    return line;
+}
+
+auto parse_int(std::string_view text) -> std::optional<int> {
+    while (!text.empty() && (text.back() == '\n' || text.back() == ' ')) text.remove_suffix(1);
+    int value = 0;
+    const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc{} || end != text.data() + text.size()) return std::nullopt;
+    return value;
+}
+
+auto all_cpus() -> std::vector<int> {
+    std::vector<int> cpus;
+#ifdef __linux__
+    const long count = ::sysconf(_SC_NPROCESSORS_ONLN);
+    for (long cpu = 0; cpu < std::max(count, 1L); ++cpu) cpus.push_back(static_cast<int>(cpu));
+#else
+    cpus.push_back(0);
+#endif
+    return cpus;
+}
+
+} // namespace
+
+auto parse_cpu_list(std::string_view list) -> std::optional<std::vector<int>> {
+    std::vector<int> cpus;
+    while (!list.empty() && (list.back() == '\n' || list.back() == ' ')) list.remove_suffix(1);
+    while (!list.empty()) {
+        const auto comma = list.find(',');
+        const auto item = list.substr(0, comma);
+        list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+
+        const auto dash = item.find('-');
+        const auto first = parse_int(item.substr(0, dash));
+        const auto last = dash == std::string_view::npos ? first : parse_int(item.substr(dash + 1));
+        if (!first || !last || *last < *first) return std::nullopt;
+        for (int cpu = *first; cpu <= *last; ++cpu) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+auto NumaTopology::discover(const std::filesystem::path& sysfs_root) -> NumaTopology {
+    NumaTopology topology;
+    topology.sysfs_root_ = sysfs_root;
+
+    const auto node_dir = sysfs_root / "devices/system/node";
+    const auto online = read_line(node_dir / "online");
+    const auto ids = online ? parse_cpu_list(*online) : std::nullopt;
+    if (ids) {
+        for (const int id : *ids) {
+            const auto cpulist = read_line(node_dir / fmt::format("node{}", id) / "cpulist");
+            auto cpus = cpulist ? parse_cpu_list(*cpulist) : std::nullopt;
+            // Узел только с памятью (CXL, HBM) рабочим не подходит
+            if (cpus && !cpus->empty()) {
+                topology.nodes_.push_back(Node{.id = id, .cpus = std::move(*cpus)});
+            }
+        }
+    }
+    if (topology.nodes_.empty()) {
+        topology.nodes_.push_back(Node{.id = 0, .cpus = all_cpus()});
+    }
+    return topology;
+}
+
+auto NumaTopology::find(int node) const -> const Node* {
+    const auto it = std::find_if(nodes_.begin(), nodes_.end(), [&](const Node& n) { return n.id == node; });
+    return it == nodes_.end() ? nullptr : &*it;
+}
+
+auto NumaTopology::device_node(std::uint64_t device) const -> std::optional<int> {
+#ifdef __linux__
+    // /sys/dev/block/M:m → .../pci0000:00/0000:00:05.0/.../block/vda[/vda1];
+    // numa_node есть у PCI-функции контроллера
+    std::error_code ec;
+    const auto link = sysfs_root_ / "dev/block" / fmt::format("{}:{}", major(device), minor(device));
+    auto dir = std::filesystem::canonical(link, ec);
+    if (ec) return std::nullopt;
+
+    const auto root = std::filesystem::canonical(sysfs_root_, ec);
+    for (; !ec && dir != root && dir.has_parent_path() && dir != dir.parent_path(); dir = dir.parent_path()) {
+        if (const auto value = read_line(dir / "numa_node")) {
+            const auto node = parse_int(*value);
+            if (node && *node >= 0 && find(*node)) return node;
+            if (node) return std::nullopt;  // -1: платформа узел не знает
+        }
+    }
+#else
+    (void)device;
+#endif
+    return std::nullopt;
+}
+
+auto pin_current_thread(const std::vector<int>& cpus) -> std::expected<void, Error> {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    if (::sched_setaffinity(0, sizeof(set), &set) != 0) {
+        return std::unexpected(make_error(ErrorCode::Unknown,
+                               fmt::format("sched_setaffinity failed: {}", std::strerror(errno))));
+    }
+    return {};
+#else
+    (void)cpus;
+    return std::unexpected(make_error(ErrorCode::UnsupportedFeature, "Thread pinning requires Linux"));
+#endif
+}
+
+auto current_numa_node() -> int {
+#ifdef __linux__
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (::syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) return static_cast<int>(node);
+#endif
+    return -1;
+}
+
+auto allocate_numa_memory(std::size_t size, int node) -> void* {
+#ifdef __linux__
+    void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) return nullptr;
+    if (node >= 0 && node < static_cast<int>(sizeof(unsigned long) * 8)) {
+        // Страниц ещё нет: политика действует на первое касание.
+        // Ошибка не фатальна — память просто останется на узле первого касания
+        const unsigned long mask = 1UL << node;
+        (void)::syscall(SYS_mbind, ptr, size, MPOL_PREFERRED_MODE, &mask, sizeof(mask) * 8, 0);
+    }
+    return ptr;
+#else
+    (void)node;
+    constexpr std::size_t PAGE = 4096;
+    return std::aligned_alloc(PAGE, (size + PAGE - 1) & ~(PAGE - 1));
+#endif
+}
+
+void free_numa_memory(void* ptr, std::size_t size) noexcept {
+    if (!ptr) return;
+#ifdef __linux__
+    ::munmap(ptr, size);
+#else
+    (void)size;
+    std::free(ptr);
+#endif
+}
+
+} // namespace cclone::infra
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <vector>
+#include "../error_handler/error.hpp"
+
+namespace cclone::infra {
+
+// Узлы NUMA по /sys/devices/system/node (без libnuma).
+// На системе без этого каталога — один узел со всеми процессорами.
+class NumaTopology {
+public:
+    struct Node {
+        int id;
+        std::vector<int> cpus;
+    };
+
+    // sysfs_root подменяется в тестах
+    static auto discover(const std::filesystem::path& sysfs_root = "/sys") -> NumaTopology;
+
+    [[nodiscard]] auto nodes() const -> const std::vector<Node>& { return nodes_; }
+    [[nodiscard]] auto node_count() const -> std::size_t { return nodes_.size(); }
+    [[nodiscard]] auto find(int node) const -> const Node*;
+
+    // Узел контроллера блочного устройства (st_dev): ближайший вверх по
+    // дереву устройств numa_node >= 0. nullopt — sysfs его не сообщает
+    [[nodiscard]] auto device_node(std::uint64_t device) const -> std::optional<int>;
+
+private:
+    std::filesystem::path sysfs_root_;
+    std::vector<Node> nodes_;
+};
+
+// Разбор списков вида "0-3,8-11" из cpulist/online
+[[nodiscard]] auto parse_cpu_list(std::string_view list) -> std::optional<std::vector<int>>;
+
+// Привязывает вызывающий поток к набору процессоров
+[[nodiscard]] auto pin_current_thread(const std::vector<int>& cpus) -> std::expected<void, Error>;
+
+// Узел, на котором сейчас выполняется поток; -1, если неизвестно
+[[nodiscard]] auto current_numa_node() -> int;
+
+// Анонимная память, страницы которой ядро выделяет на узле node
+// (mbind MPOL_PREFERRED; node < 0 — без политики). Выровнена по странице.
+// Освобождать free_numa_memory с тем же size
+[[nodiscard]] auto allocate_numa_memory(std::size_t size, int node) -> void*;
+void free_numa_memory(void* ptr, std::size_t size) noexcept;
+
+} // namespace cclone::infra
@@ -2,6 +2,7 @@
 
 #include "error_handler/error.hpp"
 #include <chrono>
+#include <cmath>
 #include <thread>
 #include <functional>
 #include <optional>
@@ -19,6 +20,7 @@ struct RetryPolicy {
     int max_attempts = 3;
     std::chrono::milliseconds initial_delay = std::chrono::milliseconds(100);
     double backoff_factor = 2.0; // exponential backoff
+    std::function<void(int attempt, const Error&)> on_retry; // перед каждой повторной попыткой (метрики)
 };
 
 template<typename F>
@@ -38,6 +40,10 @@ template<typename F>
             return result; // фатальная ошибка или последняя попытка
         }
 
+        if (policy.on_retry) {
+            policy.on_retry(attempt + 1, err);
+        }
+
         // Экспоненциальная задержка
         auto delay = policy.initial_delay * static_cast<long>(std::pow(policy.backoff_factor, attempt));
         std::this_thread::sleep_for(delay);
@@ -0,0 +1,93 @@
+#include "syscalls.hpp"
+#include <algorithm>
+#include <numeric>
+#include <fmt/core.h>
+
+namespace cclone::infra::sys {
+
+auto syscall_name(Syscall call) -> std::string_view {
+    switch (call) {
+        case Syscall::Open:          return "open";
+        case Syscall::Close:         return "close";
+        case Syscall::Read:          return "read";
+        case Syscall::Write:         return "write";
+        case Syscall::Pread:         return "pread";
+        case Syscall::Pwrite:        return "pwrite";
+        case Syscall::Stat:          return "stat";
+        case Syscall::Fstat:         return "fstat";
+        case Syscall::Mmap:          return "mmap";
+        case Syscall::Munmap:        return "munmap";
+        case Syscall::Truncate:      return "truncate";
+        case Syscall::Fsync:         return "fsync";
+        case Syscall::Fdatasync:     return "fdatasync";
+        case Syscall::SyncFileRange: return "sync_file_range";
+        case Syscall::Syncfs:        return "syncfs";
+        case Syscall::Fchmod:        return "fchmod";
+        case Syscall::Fchown:        return "fchown";
+        case Syscall::Utimens:       return "utimens";
+        case Syscall::Getxattr:      return "getxattr";
+        case Syscall::Setxattr:      return "setxattr";
+        case Syscall::Listxattr:     return "listxattr";
+        case Syscall::Link:          return "link";
+        case Syscall::Unlink:        return "unlink";
+        case Syscall::Rename:        return "rename";
+        case Syscall::Mkdir:         return "mkdir";
+        case Syscall::Ioctl:         return "ioctl";
+        case Syscall::Fadvise:       return "fadvise";
+        case Syscall::Fcntl:         return "fcntl";
+        case Syscall::UringEnter:    return "io_uring_enter";
+        case Syscall::Count:         break;
+    }
+    return "unknown";
+}
+
+auto Counts::total_calls() const -> std::uint64_t {
+    return std::accumulate(calls.begin(), calls.end(), std::uint64_t{0});
+}
+
+auto Counts::total_errors() const -> std::uint64_t {
+    return std::accumulate(errors.begin(), errors.end(), std::uint64_t{0});
+}
+
+auto snapshot() -> Counts {
+    return Counts{.calls = detail::calls.load_all(), .errors = detail::errors.load_all()};
+}
+
+auto operator-(const Counts& after, const Counts& before) -> Counts {
+    Counts delta;
+    for (std::size_t i = 0; i < SYSCALL_COUNT; ++i) {
+        delta.calls[i] = after.calls[i] - before.calls[i];
+        delta.errors[i] = after.errors[i] - before.errors[i];
+    }
+    return delta;
+}
+
+auto format_syscall_report(const Counts& counts, std::uint64_t files, std::uint64_t bytes)
+    -> std::vector<std::string>
+{
+    std::vector<std::string> lines;
+    const auto total = counts.total_calls();
+    if (total == 0) return lines;
+
+    const auto per_file = files ? static_cast<double>(total) / static_cast<double>(files) : 0.0;
+    const auto gigabytes = static_cast<double>(bytes) / 1024.0 / 1024.0 / 1024.0;
+    lines.push_back(fmt::format("Syscalls: {} ({:.1f} per file{}), errors: {}", total, per_file,
+                                bytes ? fmt::format(", {:.0f} per GB", static_cast<double>(total) / gigabytes) : "",
+                                counts.total_errors()));
+
+    std::vector<std::size_t> order;
+    for (std::size_t i = 0; i < SYSCALL_COUNT; ++i) {
+        if (counts.calls[i] != 0) order.push_back(i);
+    }
+    std::ranges::stable_sort(order, [&](auto a, auto b) { return counts.calls[a] > counts.calls[b]; });
+    lines.push_back(fmt::format("{:<20} {:>10} {:>9} {:>8}", "Syscall", "calls", "per file", "errors"));
+    for (const auto i : order) {
+        lines.push_back(fmt::format("  {:<18} {:>10} {:>9.2f} {:>8}", syscall_name(static_cast<Syscall>(i)),
+                                    counts.calls[i],
+                                    files ? static_cast<double>(counts.calls[i]) / static_cast<double>(files) : 0.0,
+                                    counts.errors[i]));
+    }
+    return lines;
+}
+
+} // namespace cclone::infra::sys
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include "infra/concurrent/sharded_counters.hpp"
+
+#ifndef _WIN32
+    #include <sys/ioctl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#ifdef __linux__
+    #include <sys/xattr.h>
+#endif
+
+// Системные вызовы файловой системы через тонкие обёртки со счётчиками.
+// Обёртка вызывает функцию libc и прибавляет к шардированному счётчику
+// вызовов (и ошибок) своего потока: fetch_add в уже лежащую в кеше
+// линию, без часов и блокировок. Адаптеры, расширения и движок зовут
+// sys::open вместо ::open — так видно, сколько вызовов стоит файл.
+// Обёртки над std::filesystem считают одну операцию по главному вызову:
+// create_directories — один mkdir, как бы глубоко ни был путь
+namespace cclone::infra::sys {
+
+enum class Syscall : std::size_t {
+    Open,
+    Close,
+    Read,
+    Write,
+    Pread,
+    Pwrite,
+    Stat,           // stat, lstat, statx и проверки std::filesystem
+    Fstat,
+    Mmap,
+    Munmap,
+    Truncate,       // ftruncate, resize_file
+    Fsync,
+    Fdatasync,
+    SyncFileRange,
+    Syncfs,
+    Fchmod,
+    Fchown,
+    Utimens,        // futimens, last_write_time
+    Getxattr,
+    Setxattr,
+    Listxattr,
+    Link,
+    Unlink,
+    Rename,
+    Mkdir,
+    Ioctl,
+    Fadvise,
+    Fcntl,
+    UringEnter,     // отправка и ожидание io_uring
+    Count
+};
+
+inline constexpr std::size_t SYSCALL_COUNT = static_cast<std::size_t>(Syscall::Count);
+
+[[nodiscard]] auto syscall_name(Syscall call) -> std::string_view;
+
+namespace detail {
+inline ShardedCounters<Syscall> calls;
+inline ShardedCounters<Syscall> errors;
+} // namespace detail
+
+// Учесть вызов, сделанный в обход обёрток (io_uring_submit и т. п.)
+inline void note(Syscall call, bool failed = false) {
+    detail::calls.add(call);
+    if (failed) [[unlikely]] detail::errors.add(call);
+}
+
+// Итог -1 (или другой отрицательный) — ошибка, errno не трогаем
+template <typename Result>
+inline auto counted(Syscall call, Result result) -> Result {
+    note(call, result < 0);
+    return result;
+}
+
+// Счётчики процесса; разность двух снимков — вызовы за прогон
+struct Counts {
+    std::array<std::uint64_t, SYSCALL_COUNT> calls{};
+    std::array<std::uint64_t, SYSCALL_COUNT> errors{};
+
+    [[nodiscard]] auto total_calls() const -> std::uint64_t;
+    [[nodiscard]] auto total_errors() const -> std::uint64_t;
+};
+
+[[nodiscard]] auto snapshot() -> Counts;
+[[nodiscard]] auto operator-(const Counts& after, const Counts& before) -> Counts;
+
+// Отчёт для журнала: итог на файл и на GB, затем типы по убыванию
+[[nodiscard]] auto format_syscall_report(const Counts& counts, std::uint64_t files, std::uint64_t bytes)
+    -> std::vector<std::string>;
+
+#ifndef _WIN32
+inline auto open(const char* path, int flags, mode_t mode = 0) -> int {
+    return counted(Syscall::Open, ::open(path, flags, mode));
+}
+inline auto close(int fd) -> int { return counted(Syscall::Close, ::close(fd)); }
+inline auto read(int fd, void* buffer, std::size_t size) -> ssize_t {
+    return counted(Syscall::Read, ::read(fd, buffer, size));
+}
+inline auto write(int fd, const void* data, std::size_t size) -> ssize_t {
+    return counted(Syscall::Write, ::write(fd, data, size));
+}
+inline auto pread(int fd, void* buffer, std::size_t size, off_t offset) -> ssize_t {
+    return counted(Syscall::Pread, ::pread(fd, buffer, size, offset));
+}
+inline auto pwrite(int fd, const void* data, std::size_t size, off_t offset) -> ssize_t {
+    return counted(Syscall::Pwrite, ::pwrite(fd, data, size, offset));
+}
+inline auto stat(const char* path, struct stat* sb) -> int { return counted(Syscall::Stat, ::stat(path, sb)); }
+inline auto lstat(const char* path, struct stat* sb) -> int { return counted(Syscall::Stat, ::lstat(path, sb)); }
+inline auto fstat(int fd, struct stat* sb) -> int { return counted(Syscall::Fstat, ::fstat(fd, sb)); }
+inline auto mmap(void* addr, std::size_t length, int prot, int flags, int fd, off_t offset) -> void* {
+    void* map = ::mmap(addr, length, prot, flags, fd, offset);
+    note(Syscall::Mmap, map == MAP_FAILED);
+    return map;
+}
+inline auto munmap(void* addr, std::size_t length) -> int { return counted(Syscall::Munmap, ::munmap(addr, length)); }
+inline auto ftruncate(int fd, off_t length) -> int { return counted(Syscall::Truncate, ::ftruncate(fd, length)); }
+inline auto fsync(int fd) -> int { return counted(Syscall::Fsync, ::fsync(fd)); }
+inline auto fdatasync(int fd) -> int { return counted(Syscall::Fdatasync, ::fdatasync(fd)); }
+inline auto fchmod(int fd, mode_t mode) -> int { return counted(Syscall::Fchmod, ::fchmod(fd, mode)); }
+inline auto fchown(int fd, uid_t uid, gid_t gid) -> int { return counted(Syscall::Fchown, ::fchown(fd, uid, gid)); }
+inline auto futimens(int fd, const struct timespec times[2]) -> int {
+    return counted(Syscall::Utimens, ::futimens(fd, times));
+}
+inline auto linkat(int from_dir, const char* from, int to_dir, const char* to, int flags) -> int {
+    return counted(Syscall::Link, ::linkat(from_dir, from, to_dir, to, flags));
+}
+inline auto unlink(const char* path) -> int { return counted(Syscall::Unlink, ::unlink(path)); }
+inline auto rename(const char* from, const char* to) -> int { return counted(Syscall::Rename, ::rename(from, to)); }
+inline auto ioctl(int fd, unsigned long request, int arg) -> int {
+    return counted(Syscall::Ioctl, ::ioctl(fd, request, arg));
+}
+inline auto fcntl(int fd, int command, int arg) -> int { return counted(Syscall::Fcntl, ::fcntl(fd, command, arg)); }
+
+// posix_fadvise возвращает номер ошибки, а не -1
+inline auto fadvise(int fd, off_t offset, off_t length, int advice) -> int {
+    const int rc = ::posix_fadvise(fd, offset, length, advice);
+    note(Syscall::Fadvise, rc != 0);
+    return rc;
+}
+#endif
+
+#ifdef __linux__
+inline auto syncfs(int fd) -> int { return counted(Syscall::Syncfs, ::syncfs(fd)); }
+inline auto sync_file_range(int fd, off_t offset, off_t length, unsigned flags) -> int {
+    return counted(Syscall::SyncFileRange, ::sync_file_range(fd, offset, length, flags));
+}
+#ifdef STATX_BASIC_STATS
+inline auto statx(int dir, const char* path, int flags, unsigned mask, struct statx* sx) -> int {
+    return counted(Syscall::Stat, ::statx(dir, path, flags, mask, sx));
+}
+#endif
+inline auto fgetxattr(int fd, const char* name, void* value, std::size_t size) -> ssize_t {
+    return counted(Syscall::Getxattr, ::fgetxattr(fd, name, value, size));
+}
+inline auto fsetxattr(int fd, const char* name, const void* value, std::size_t size, int flags) -> int {
+    return counted(Syscall::Setxattr, ::fsetxattr(fd, name, value, size, flags));
+}
+inline auto flistxattr(int fd, char* names, std::size_t size) -> ssize_t {
+    return counted(Syscall::Listxattr, ::flistxattr(fd, names, size));
+}
+#endif
+
+// std::filesystem. Бросающие версии учитывают ошибку и пробрасывают исключение
+namespace detail {
+template <typename Op>
+inline auto counted_throwing(Syscall call, Op&& op) -> decltype(op()) {
+    try {
+        note(call);
+        return op();
+    } catch (...) {
+        detail::errors.add(call);
+        throw;
+    }
+}
+} // namespace detail
+
+inline auto exists(const std::filesystem::path& path) -> bool {
+    return detail::counted_throwing(Syscall::Stat, [&] { return std::filesystem::exists(path); });
+}
+inline auto exists(const std::filesystem::path& path, std::error_code& ec) -> bool {
+    const bool found = std::filesystem::exists(path, ec);
+    note(Syscall::Stat, static_cast<bool>(ec));
+    return found;
+}
+inline auto is_regular_file(const std::filesystem::path& path) -> bool {
+    return detail::counted_throwing(Syscall::Stat, [&] { return std::filesystem::is_regular_file(path); });
+}
+inline auto is_directory(const std::filesystem::path& path) -> bool {
+    return detail::counted_throwing(Syscall::Stat, [&] { return std::filesystem::is_directory(path); });
+}
+inline auto file_size(const std::filesystem::path& path) -> std::uintmax_t {
+    return detail::counted_throwing(Syscall::Stat, [&] { return std::filesystem::file_size(path); });
+}
+inline auto file_size(const std::filesystem::path& path, std::error_code& ec) -> std::uintmax_t {
+    const auto size = std::filesystem::file_size(path, ec);
+    note(Syscall::Stat, static_cast<bool>(ec));
+    return size;
+}
+inline auto last_write_time(const std::filesystem::path& path, std::error_code& ec) -> std::filesystem::file_time_type {
+    const auto time = std::filesystem::last_write_time(path, ec);
+    note(Syscall::Stat, static_cast<bool>(ec));
+    return time;
+}
+inline void last_write_time(const std::filesystem::path& path, std::filesystem::file_time_type time,
+                            std::error_code& ec) {
+    std::filesystem::last_write_time(path, time, ec);
+    note(Syscall::Utimens, static_cast<bool>(ec));
+}
+inline auto remove(const std::filesystem::path& path, std::error_code& ec) -> bool {
+    const bool removed = std::filesystem::remove(path, ec);
+    note(Syscall::Unlink, static_cast<bool>(ec));
+    return removed;
+}
+inline void rename(const std::filesystem::path& from, const std::filesystem::path& to, std::error_code& ec) {
+    std::filesystem::rename(from, to, ec);
+    note(Syscall::Rename, static_cast<bool>(ec));
+}
+inline void create_hard_link(const std::filesystem::path& from, const std::filesystem::path& to,
+                             std::error_code& ec) {
+    std::filesystem::create_hard_link(from, to, ec);
+    note(Syscall::Link, static_cast<bool>(ec));
+}
+inline auto create_directories(const std::filesystem::path& path, std::error_code& ec) -> bool {
+    const bool created = std::filesystem::create_directories(path, ec);
+    note(Syscall::Mkdir, static_cast<bool>(ec));
+    return created;
+}
+inline void resize_file(const std::filesystem::path& path, std::uintmax_t size, std::error_code& ec) {
+    std::filesystem::resize_file(path, size, ec);
+    note(Syscall::Truncate, static_cast<bool>(ec));
+}
+
+} // namespace cclone::infra::sys
@@ -0,0 +1,88 @@
+#include "fair_pool.hpp"
+#include <algorithm>
+
+namespace cclone::infra {
+
+FairPool::FairPool(std::size_t nthreads, WorkerInit init) {
+    if (nthreads == 0) nthreads = 1;
+    threads_.reserve(nthreads);
+    for (std::size_t i = 0; i < nthreads; ++i) {
+        threads_.emplace_back([this, i, init] { run_worker_(i, init); });
+    }
+}
+
+FairPool::~FairPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    threads_.clear();
+}
+
+auto FairPool::open_lane(std::size_t limit, std::size_t queue_depth) -> std::unique_ptr<Lane> {
+    const auto effective = limit == 0 ? size() : std::min(limit, size());
+    return std::unique_ptr<Lane>(new Lane(*this, effective, effective * queue_depth));
+}
+
+FairPool::Lane::~Lane() {
+    wait();
+}
+
+void FairPool::Lane::wait() {
+    std::unique_lock lock(pool_.mutex_);
+    pool_.idle_cv_.wait(lock, [&] { return tasks_.empty() && active_ == 0; });
+}
+
+void FairPool::submit_(Lane& lane, Task task) {
+    std::unique_lock lock(mutex_);
+    if (lane.capacity_ != 0) {
+        space_cv_.wait(lock, [&] { return lane.tasks_.size() < lane.capacity_; });
+    }
+    lane.tasks_.push_back(std::move(task));
+    schedule_(lane);
+}
+
+void FairPool::schedule_(Lane& lane) {
+    if (lane.ready_ || lane.tasks_.empty() || lane.active_ >= lane.limit_) return;
+    lane.ready_ = true;
+    ready_.push_back(&lane);
+    work_cv_.notify_one();
+}
+
+void FairPool::run_worker_(std::size_t index, const WorkerInit& init) {
+    if (init) init(index);
+
+    std::unique_lock lock(mutex_);
+    for (;;) {
+        work_cv_.wait(lock, [&] { return stop_ || !ready_.empty(); });
+        if (ready_.empty()) return;  // stop_: круг пуст, задач не осталось
+
+        Lane& lane = *ready_.front();
+        ready_.pop_front();
+        lane.ready_ = false;
+        Task task = std::move(lane.tasks_.front());
+        lane.tasks_.pop_front();
+        ++lane.active_;
+        if (lane.capacity_ != 0) {
+            space_cv_.notify_all();  // один cv на все очереди: будим всех
+        }
+        schedule_(lane);  // в конец круга: следующую задачу возьмёт другое задание
+        lock.unlock();
+
+        try {
+            task();
+        } catch (...) {
+        }
+        task = nullptr;  // захваченное задачей освобождается вне мьютекса
+
+        lock.lock();
+        --lane.active_;
+        schedule_(lane);
+        if (lane.tasks_.empty() && lane.active_ == 0) {
+            idle_cv_.notify_all();
+        }
+    }
+}
+
+} // namespace cclone::infra
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace cclone::infra {
+
+// Пул, который делят несколько заданий (режим демона). У каждого задания
+// своя очередь — Lane; свободный рабочий берёт одну задачу у первой
+// очереди из круга готовых и ставит очередь в конец круга. Так задания
+// получают рабочих по очереди, задача за задачей, и задание на миллион
+// файлов не задерживает задание на десять, поставленное после него.
+//
+// У очереди может быть предел одновременно выполняемых задач (--threads
+// задания): очередь на пределе выходит из круга, пока одна из её задач
+// не завершится. Очередь может быть и ограничена по длине: enqueue ждёт
+// места, как BoundedQueue::push, и задание не выкладывает в память всё
+// дерево вперёд рабочих. Задачи крупные (по файлу), поэтому круг защищён
+// одним мьютексом. Исключение из задачи теряется, как и в WorkStealingPool.
+class FairPool {
+public:
+    // Вызывается в каждом рабочем потоке до первой задачи
+    using WorkerInit = std::function<void(std::size_t worker)>;
+    using Task = std::move_only_function<void()>;
+
+    class Lane {
+    public:
+        // Ждёт своих задач: очередь не переживает поставленное в неё
+        ~Lane();
+
+        Lane(const Lane&) = delete;
+        Lane& operator=(const Lane&) = delete;
+
+        // На пределе длины очереди ждёт, пока рабочий не возьмёт задачу
+        template<typename F>
+        void enqueue(F&& f) { pool_.submit_(*this, Task(std::forward<F>(f))); }
+
+        // Ждёт, пока в очереди не останется ни поставленных, ни выполняющихся
+        // задач. Из задачи этой же очереди не вызывать
+        void wait();
+
+        // Сколько задач очереди выполняется одновременно, не больше
+        [[nodiscard]] auto size() const -> std::size_t { return limit_; }
+
+    private:
+        friend class FairPool;
+        Lane(FairPool& pool, std::size_t limit, std::size_t capacity)
+            : pool_(pool), limit_(limit), capacity_(capacity) {}
+
+        FairPool& pool_;
+        const std::size_t limit_;
+        const std::size_t capacity_;    // ждущих задач не больше; 0 — без предела
+        // Под мьютексом пула
+        std::deque<Task> tasks_;
+        std::size_t active_ = 0;
+        bool ready_ = false;        // стоит в круге готовых
+    };
+
+    explicit FairPool(std::size_t nthreads = std::jthread::hardware_concurrency(), WorkerInit init = {});
+    ~FairPool();
+
+    FairPool(const FairPool&) = delete;
+    FairPool& operator=(const FairPool&) = delete;
+
+    // Очередь задания; limit 0 — до size() задач одновременно. queue_depth —
+    // ждущих задач на каждую выполняемую (длина очереди limit * queue_depth),
+    // 0 — без предела
+    [[nodiscard]] auto open_lane(std::size_t limit = 0, std::size_t queue_depth = 0) -> std::unique_ptr<Lane>;
+
+    [[nodiscard]] auto size() const -> std::size_t { return threads_.size(); }
+
+private:
+    void submit_(Lane& lane, Task task);
+    void run_worker_(std::size_t index, const WorkerInit& init);
+    // Возвращает очередь в круг, если у неё есть задачи и свободные места
+    void schedule_(Lane& lane);
+
+    std::mutex mutex_;
+    std::condition_variable work_cv_;   // рабочие ждут готовых очередей
+    std::condition_variable idle_cv_;   // Lane::wait ждёт опустевшей очереди
+    std::condition_variable space_cv_;  // enqueue ждёт места в ограниченной очереди
+    std::deque<Lane*> ready_;
+    bool stop_ = false;
+    std::vector<std::jthread> threads_;
+};
+
+} // namespace cclone::infra
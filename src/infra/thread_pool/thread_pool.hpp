@@ -16,7 +16,11 @@ namespace cclone::infra {
 
 class ThreadPool {
 public:
-    explicit ThreadPool(std::size_t nthreads = std::jthread::hardware_concurrency());
+    // Вызывается в каждом рабочем потоке до первой задачи (закрепление за узлом NUMA)
+    using WorkerInit = std::function<void(std::size_t worker)>;
+
+    explicit ThreadPool(std::size_t nthreads = std::jthread::hardware_concurrency(),
+                        WorkerInit init = {});
     ~ThreadPool();
 
     // Удалить копирование и присваивание
@@ -86,14 +90,15 @@ auto ThreadPool::enqueue_with_future(F&& f, Args&&... args)
 
 namespace cclone::infra {
 
-inline ThreadPool::ThreadPool(std::size_t nthreads)
+inline ThreadPool::ThreadPool(std::size_t nthreads, WorkerInit init)
     : stop_(false)
 {
     if (nthreads == 0) nthreads = 1;
     workers_.reserve(nthreads);
 
     for (std::size_t i = 0; i < nthreads; ++i) {
-        workers_.emplace_back([this](std::stop_token st) {
+        workers_.emplace_back([this, i, init](std::stop_token st) {
+            if (init) init(i);
             while (!st.stop_requested()) {
                 Task task;
                 {
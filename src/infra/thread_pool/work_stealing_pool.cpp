@@ -0,0 +1,214 @@
+#include "work_stealing_pool.hpp"
+#include <algorithm>
+
+namespace cclone::infra {
+
+namespace {
+
+// Раз в столько задач рабочий сначала смотрит в очередь инъекций:
+// иначе задачи извне голодают, пока свой дек не пуст
+constexpr std::uint64_t INJECT_INTERVAL = 61;
+// Сколько задач извне рабочий переносит к себе за раз
+constexpr std::size_t INJECT_BATCH = 32;
+constexpr int STEAL_ROUNDS = 2;
+
+thread_local const WorkStealingPool* current_pool = nullptr;
+thread_local std::size_t current_index = 0;
+
+auto next_random(std::uint64_t& state) -> std::uint64_t {
+    // xorshift64: жертве кражи криптостойкость не нужна
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(std::size_t nthreads, WorkerInit init) {
+    if (nthreads == 0) nthreads = 1;
+    workers_.reserve(nthreads);
+    for (std::size_t i = 0; i < nthreads; ++i) {
+        auto worker = std::make_unique<Worker>();
+        worker->rng = 0x9E3779B97F4A7C15ULL * (i + 1);
+        workers_.push_back(std::move(worker));
+    }
+    idle_.reserve(nthreads);
+
+    threads_.reserve(nthreads);
+    for (std::size_t i = 0; i < nthreads; ++i) {
+        threads_.emplace_back([this, i, init] { run_worker_(i, init); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    // Как и ThreadPool, оставшиеся задачи выполняются до конца
+    wait();
+    stop_.store(true, std::memory_order_seq_cst);
+    {
+        std::lock_guard lock(idle_mutex_);
+        for (const auto index : idle_) {
+            workers_[index]->wake.store(1, std::memory_order_release);
+            workers_[index]->wake.notify_one();
+        }
+        idle_.clear();
+        idle_count_.store(0, std::memory_order_relaxed);
+    }
+    threads_.clear();
+}
+
+auto WorkStealingPool::current_worker() const -> int {
+    return current_pool == this ? static_cast<int>(current_index) : -1;
+}
+
+void WorkStealingPool::wait() {
+    auto pending = pending_.load(std::memory_order_acquire);
+    while (pending != 0) {
+        pending_.wait(pending, std::memory_order_acquire);
+        pending = pending_.load(std::memory_order_acquire);
+    }
+}
+
+void WorkStealingPool::submit_(TaskBase* task) {
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    if (current_pool == this) {
+        workers_[current_index]->deque.push(task);
+    } else {
+        std::lock_guard lock(inject_mutex_);
+        injected_.push_back(task);
+        injected_size_.store(injected_.size(), std::memory_order_relaxed);
+    }
+
+    // Пара к забору в park_(): либо засыпающий увидит задачу,
+    // либо мы увидим его в idle_count_
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (searching_.load(std::memory_order_relaxed) == 0
+        && idle_count_.load(std::memory_order_relaxed) > 0) {
+        unpark_one_();
+    }
+}
+
+void WorkStealingPool::run_worker_(std::size_t index, const WorkerInit& init) {
+    current_pool = this;
+    current_index = index;
+    if (init) init(index);
+
+    for (std::uint64_t tick = 0;; ++tick) {
+        TaskBase* task = find_task_(index, tick);
+        if (!task) {
+            searching_.fetch_add(1, std::memory_order_seq_cst);
+            task = steal_(index);
+            const bool last_searcher = searching_.fetch_sub(1, std::memory_order_seq_cst) == 1;
+            if (!task) {
+                if (stop_.load(std::memory_order_acquire)) break;
+                park_(index);
+                continue;
+            }
+            // Пока мы искали, постановщики никого не будили — передаём эстафету
+            if (last_searcher && has_visible_work_()) {
+                unpark_one_();
+            }
+        }
+        task->run();
+        delete task;
+        finished_one_();
+    }
+}
+
+auto WorkStealingPool::find_task_(std::size_t index, std::uint64_t tick) -> TaskBase* {
+    auto& self = *workers_[index];
+    if (tick % INJECT_INTERVAL == INJECT_INTERVAL - 1) {
+        if (auto* task = take_injected_(self)) return task;
+    }
+    if (auto* task = self.deque.pop()) return task;
+    return take_injected_(self);
+}
+
+auto WorkStealingPool::take_injected_(Worker& self) -> TaskBase* {
+    if (injected_size_.load(std::memory_order_relaxed) == 0) return nullptr;
+
+    std::lock_guard lock(inject_mutex_);
+    if (injected_.empty()) return nullptr;
+    TaskBase* task = injected_.front();
+    injected_.pop_front();
+
+    // Часть остатка — в свой дек: дальше без мьютекса, и другим есть что украсть
+    const auto batch = std::min(INJECT_BATCH, injected_.size() / workers_.size());
+    for (std::size_t i = 0; i < batch; ++i) {
+        self.deque.push(injected_.front());
+        injected_.pop_front();
+    }
+    injected_size_.store(injected_.size(), std::memory_order_relaxed);
+    return task;
+}
+
+auto WorkStealingPool::steal_(std::size_t index) -> TaskBase* {
+    auto& self = *workers_[index];
+    if (auto* task = take_injected_(self)) return task;
+
+    const auto count = workers_.size();
+    if (count == 1) return nullptr;
+    for (int round = 0; round < STEAL_ROUNDS; ++round) {
+        const auto start = next_random(self.rng) % count;
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto victim = (start + i) % count;
+            if (victim == index) continue;
+            if (auto* task = workers_[victim]->deque.steal()) return task;
+        }
+    }
+    return nullptr;
+}
+
+auto WorkStealingPool::has_visible_work_() const -> bool {
+    if (injected_size_.load(std::memory_order_relaxed) != 0) return true;
+    return std::any_of(workers_.begin(), workers_.end(),
+                       [](const auto& worker) { return !worker->deque.empty(); });
+}
+
+void WorkStealingPool::park_(std::size_t index) {
+    auto& self = *workers_[index];
+    {
+        std::lock_guard lock(idle_mutex_);
+        idle_.push_back(index);
+        idle_count_.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    // Задача могла появиться между поиском и регистрацией
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (has_visible_work_() || stop_.load(std::memory_order_acquire)) {
+        std::lock_guard lock(idle_mutex_);
+        const auto it = std::find(idle_.begin(), idle_.end(), index);
+        if (it != idle_.end()) {
+            idle_.erase(it);
+            idle_count_.fetch_sub(1, std::memory_order_relaxed);
+            return;
+        }
+        // Нас уже вынули из списка — жетон придёт или пришёл
+    }
+
+    while (self.wake.load(std::memory_order_acquire) == 0) {
+        self.wake.wait(0, std::memory_order_acquire);
+    }
+    self.wake.store(0, std::memory_order_relaxed);
+}
+
+void WorkStealingPool::unpark_one_() {
+    std::size_t index;
+    {
+        std::lock_guard lock(idle_mutex_);
+        if (idle_.empty()) return;
+        index = idle_.back();
+        idle_.pop_back();
+        idle_count_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    workers_[index]->wake.store(1, std::memory_order_release);
+    workers_[index]->wake.notify_one();
+}
+
+void WorkStealingPool::finished_one_() {
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        pending_.notify_all();
+    }
+}
+
+} // namespace cclone::infra
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "../concurrent/chase_lev_deque.hpp"
+
+namespace cclone::infra {
+
+// Пул с раздельными очередями — замена ThreadPool там, где задач много
+// и они короткие (по задаче на файл).
+//
+//   * у каждого рабочего свой дек Chase-Lev: задачи, поставленные из
+//     рабочего потока, кладутся в него без блокировок;
+//   * задачи извне идут в общую очередь инъекций, рабочий забирает их
+//     пачкой в свой дек;
+//   * свободный рабочий крадёт у случайной жертвы;
+//   * простаивающий рабочий засыпает на собственном атомике, а постановка
+//     задачи будит ровно одного — и только если никто уже не ищет работу.
+//     Завершение задачи никого не будит, кроме ждущих в wait().
+//
+// Задача — один объект в куче с вызываемым внутри: без shared_ptr,
+// packaged_task и std::bind. Исключение из задачи без future теряется,
+// как и в ThreadPool.
+class WorkStealingPool {
+public:
+    // Вызывается в каждом рабочем потоке до первой задачи (закрепление за узлом NUMA)
+    using WorkerInit = std::function<void(std::size_t worker)>;
+
+    explicit WorkStealingPool(std::size_t nthreads = std::jthread::hardware_concurrency(),
+                              WorkerInit init = {});
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    template<typename F, typename... Args>
+    void enqueue(F&& f, Args&&... args);
+
+    template<typename F, typename... Args>
+    auto enqueue_with_future(F&& f, Args&&... args)
+        -> std::future<std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>>;
+
+    // Ждёт, пока не останется ни поставленных, ни выполняющихся задач.
+    // Из задачи этого же пула не вызывать
+    void wait();
+
+    [[nodiscard]] auto size() const -> std::size_t { return workers_.size(); }
+
+    // Номер рабочего этого пула, на котором выполняется вызывающий код, или -1
+    [[nodiscard]] auto current_worker() const -> int;
+
+private:
+    struct TaskBase {
+        virtual ~TaskBase() = default;
+        virtual void run() noexcept = 0;
+    };
+
+    template<typename Fn>
+    struct TaskImpl final : TaskBase {
+        explicit TaskImpl(Fn&& fn) : fn(std::move(fn)) {}
+        void run() noexcept override {
+            try {
+                fn();
+            } catch (...) {
+            }
+        }
+        Fn fn;
+    };
+
+    struct alignas(64) Worker {
+        ChaseLevDeque<TaskBase> deque;
+        std::atomic<std::uint32_t> wake{0};  // жетон пробуждения; ждём на нём
+        std::uint64_t rng = 0;
+    };
+
+    void submit_(TaskBase* task);
+    void run_worker_(std::size_t index, const WorkerInit& init);
+    [[nodiscard]] auto find_task_(std::size_t index, std::uint64_t tick) -> TaskBase*;
+    [[nodiscard]] auto take_injected_(Worker& self) -> TaskBase*;
+    [[nodiscard]] auto steal_(std::size_t index) -> TaskBase*;
+    [[nodiscard]] auto has_visible_work_() const -> bool;
+    void park_(std::size_t index);
+    void unpark_one_();
+    void finished_one_();
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::jthread> threads_;
+
+    std::mutex inject_mutex_;
+    std::deque<TaskBase*> injected_;
+    alignas(64) std::atomic<std::size_t> injected_size_{0};
+
+    // Спящие рабочие. Мьютекс берётся только при засыпании и пробуждении
+    std::mutex idle_mutex_;
+    std::vector<std::size_t> idle_;
+    alignas(64) std::atomic<std::size_t> idle_count_{0};
+    alignas(64) std::atomic<std::size_t> searching_{0};
+
+    alignas(64) std::atomic<std::uint64_t> pending_{0};  // поставлено и не завершено
+    std::atomic<bool> stop_{false};
+};
+
+// =============== Реализация шаблонов ===============
+
+template<typename F, typename... Args>
+void WorkStealingPool::enqueue(F&& f, Args&&... args) {
+    auto call = [fn = std::forward<F>(f), ...bound = std::forward<Args>(args)]() mutable {
+        std::invoke(std::move(fn), std::move(bound)...);
+    };
+    submit_(new TaskImpl<decltype(call)>(std::move(call)));
+}
+
+template<typename F, typename... Args>
+auto WorkStealingPool::enqueue_with_future(F&& f, Args&&... args)
+    -> std::future<std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>>
+{
+    using ReturnType = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+
+    std::promise<ReturnType> promise;
+    auto future = promise.get_future();
+    auto call = [promise = std::move(promise), fn = std::forward<F>(f),
+                 ...bound = std::forward<Args>(args)]() mutable {
+        try {
+            if constexpr (std::is_void_v<ReturnType>) {
+                std::invoke(std::move(fn), std::move(bound)...);
+                promise.set_value();
+            } else {
+                promise.set_value(std::invoke(std::move(fn), std::move(bound)...));
+            }
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+    };
+    submit_(new TaskImpl<decltype(call)>(std::move(call)));
+    return future;
+}
+
+} // namespace cclone::infra
@@ -0,0 +1,230 @@
+#include "io_limiter.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+#include "../interrupt.hpp"
+
+namespace cclone::infra {
+
+namespace {
+
+// Как часто сторож смотрит на mtime файла управления и флаг SIGUSR1
+constexpr auto WATCH_INTERVAL = std::chrono::milliseconds(250);
+
+auto trim(std::string_view s) -> std::string_view {
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front()))) s.remove_prefix(1);
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) s.remove_suffix(1);
+    return s;
+}
+
+// «64M», «1.5G», «500k», «100» — множители двоичные, как у --max-memory
+auto parse_size(std::string_view text) -> std::optional<std::uint64_t> {
+    double value = 0;
+    const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc{} || value < 0) return std::nullopt;
+
+    auto suffix = trim(std::string_view(end, static_cast<std::size_t>(text.data() + text.size() - end)));
+    if (!suffix.empty() && (suffix.back() == 'b' || suffix.back() == 'B')) suffix.remove_suffix(1);
+    double scale = 1;
+    if (!suffix.empty()) {
+        if (suffix.size() != 1) return std::nullopt;
+        switch (std::tolower(static_cast<unsigned char>(suffix.front()))) {
+        case 'k': scale = 1024.0; break;
+        case 'm': scale = 1024.0 * 1024; break;
+        case 'g': scale = 1024.0 * 1024 * 1024; break;
+        case 't': scale = 1024.0 * 1024 * 1024 * 1024; break;
+        default: return std::nullopt;
+        }
+    }
+    return static_cast<std::uint64_t>(value * scale);
+}
+
+} // namespace
+
+auto parse_io_limits(std::string_view text, IoLimits base) -> std::expected<IoLimits, Error> {
+    std::size_t line_no = 0;
+    while (!text.empty()) {
+        const auto eol = text.find('\n');
+        auto line = text.substr(0, eol);
+        text = eol == std::string_view::npos ? std::string_view{} : text.substr(eol + 1);
+        ++line_no;
+
+        if (const auto hash = line.find('#'); hash != std::string_view::npos) line = line.substr(0, hash);
+        line = trim(line);
+        if (line.empty()) continue;
+
+        const auto eq = line.find('=');
+        if (eq == std::string_view::npos) {
+            return std::unexpected(make_error(ErrorCode::InvalidPath,
+                                   fmt::format("Throttle file line {}: expected 'key = value'", line_no)));
+        }
+        const auto key = trim(line.substr(0, eq));
+        const auto value = parse_size(trim(line.substr(eq + 1)));
+        if (!value) {
+            return std::unexpected(make_error(ErrorCode::InvalidPath,
+                                   fmt::format("Throttle file line {}: bad value for {}", line_no, key)));
+        }
+
+        if (key == "bwlimit") base.bwlimit = *value;
+        else if (key == "iops_limit") base.iops_limit = *value;
+        else if (key == "device_bwlimit") base.device_bwlimit = *value;
+        else if (key == "device_iops_limit") base.device_iops_limit = *value;
+        else {
+            return std::unexpected(make_error(ErrorCode::InvalidPath,
+                                   fmt::format("Throttle file line {}: unknown key {}", line_no, key)));
+        }
+    }
+    return base;
+}
+
+// =============== IoPacer ===============
+
+auto IoPacer::reserve_(const Side& side, std::uint64_t bytes, bool count_bytes) const
+    -> TokenBucket::Clock::duration
+{
+    // Вёдра резервируются все сразу, ждать — самое долгое из них
+    auto& limiter = *limiter_;
+    auto delay = limiter.ops_.reserve(1);
+    if (count_bytes) delay = std::max(delay, limiter.bytes_.reserve(bytes));
+    if (side.device_ops) delay = std::max(delay, side.device_ops->reserve(1));
+    if (side.device_bytes) delay = std::max(delay, side.device_bytes->reserve(bytes));
+    return delay;
+}
+
+// Общий --bwlimit считает переданные байты один раз — при чтении;
+// устройства — каждое свои: источник чтение, назначение запись
+auto IoPacer::reserve_read(std::uint64_t bytes) const -> TokenBucket::Clock::duration {
+    return limiter_ ? reserve_(source_, bytes, true) : TokenBucket::Clock::duration::zero();
+}
+
+auto IoPacer::reserve_write(std::uint64_t bytes) const -> TokenBucket::Clock::duration {
+    return limiter_ ? reserve_(destination_, bytes, false) : TokenBucket::Clock::duration::zero();
+}
+
+auto IoPacer::epoch() const -> std::uint64_t {
+    return limiter_ ? limiter_->generation_() : 0;
+}
+
+void IoPacer::read(std::uint64_t bytes) const {
+    if (limiter_) wait_(reserve_read(bytes));
+}
+
+void IoPacer::write(std::uint64_t bytes) const {
+    if (limiter_) wait_(reserve_write(bytes));
+}
+
+void IoPacer::wait_(TokenBucket::Clock::duration delay) const {
+    if (delay <= TokenBucket::Clock::duration::zero()) return;
+
+    // Сон кусками: после Ctrl+C и смены пределов пауза по старой
+    // скорости не досыпается
+    const auto started = epoch();
+    const auto until = TokenBucket::Clock::now() + delay;
+    for (auto now = TokenBucket::Clock::now(); now < until; now = TokenBucket::Clock::now()) {
+        if (is_interrupted() || epoch() != started) return;
+        std::this_thread::sleep_for(std::min<TokenBucket::Clock::duration>(until - now, TokenBucket::BURST));
+    }
+}
+
+// =============== IoLimiter ===============
+
+IoLimiter::IoLimiter(const IoLimits& limits)
+    : bytes_(limits.bwlimit), ops_(limits.iops_limit), limits_(limits) {}
+
+IoLimiter::~IoLimiter() {
+    if (watcher_.joinable()) {
+        watcher_.request_stop();
+        watcher_.join();
+    }
+}
+
+auto IoLimiter::limits() const -> IoLimits {
+    std::lock_guard lock(limits_mutex_);
+    return limits_;
+}
+
+void IoLimiter::set_limits(const IoLimits& limits) {
+    {
+        std::lock_guard lock(limits_mutex_);
+        limits_ = limits;
+        bytes_.set_rate(limits.bwlimit);
+        ops_.set_rate(limits.iops_limit);
+        devices_.for_each([&](std::uint64_t, const std::shared_ptr<DeviceBuckets>& device) {
+            device->bytes.set_rate(limits.device_bwlimit);
+            device->ops.set_rate(limits.device_iops_limit);
+        });
+    }
+    generation_value_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+auto IoLimiter::device_(std::uint64_t device) -> DeviceBuckets& {
+    // Ведро нового устройства создаётся с пределами, действующими сейчас;
+    // set_limits под той же блокировкой обновит и его
+    if (auto found = devices_.find(device)) return **found;
+    std::lock_guard lock(limits_mutex_);
+    return *devices_.get_or_create(device, [&] {
+        return std::make_shared<DeviceBuckets>(limits_.device_bwlimit, limits_.device_iops_limit);
+    }).first;
+}
+
+auto IoLimiter::pacer(std::uint64_t src_device, std::uint64_t dst_device) -> IoPacer {
+    IoPacer pacer;
+    pacer.limiter_ = this;
+    auto& source = device_(src_device);
+    auto& destination = device_(dst_device);
+    pacer.source_ = {.device_bytes = &source.bytes, .device_ops = &source.ops};
+    pacer.destination_ = {.device_bytes = &destination.bytes, .device_ops = &destination.ops};
+    return pacer;
+}
+
+auto IoLimiter::reload() -> std::expected<void, Error> {
+    std::ifstream in(control_file_);
+    if (!in) {
+        return std::unexpected(make_error(ErrorCode::FileNotFound,
+                               fmt::format("Cannot read throttle file {}", control_file_.string())));
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+
+    auto parsed = parse_io_limits(text.str(), limits());
+    if (!parsed) {
+        return std::unexpected(std::move(parsed.error()));
+    }
+    const auto& next = *parsed;
+    set_limits(next);
+    spdlog::info("Throttle: bwlimit {} B/s, iops {}, per device {} B/s, {} iops",
+                 next.bwlimit, next.iops_limit, next.device_bwlimit, next.device_iops_limit);
+    return {};
+}
+
+void IoLimiter::watch(std::filesystem::path control_file) {
+    control_file_ = std::move(control_file);
+    install_reload_handler();
+
+    std::error_code ec;
+    auto seen = std::filesystem::last_write_time(control_file_, ec);
+    if (!ec) {
+        if (auto loaded = reload(); !loaded) spdlog::warn("{}", loaded.error().message);
+    }
+
+    watcher_ = std::jthread([this, seen](std::stop_token stop) mutable {
+        while (!stop.stop_requested()) {
+            std::this_thread::sleep_for(WATCH_INTERVAL);
+            std::error_code ec;
+            const auto mtime = std::filesystem::last_write_time(control_file_, ec);
+            const bool changed = !ec && mtime != seen;
+            if (!changed && !take_reload_request()) continue;
+            if (!ec) seen = mtime;
+            if (auto loaded = reload(); !loaded) {
+                spdlog::warn("Throttle limits unchanged: {}", loaded.error().message);
+            }
+        }
+    });
+}
+
+} // namespace cclone::infra
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include "token_bucket.hpp"
+#include "../concurrent/sharded_map.hpp"
+#include "../error_handler/error.hpp"
+
+namespace cclone::infra {
+
+// Пределы --bwlimit/--iops-limit; 0 — без ограничения.
+// device_* действуют на каждое устройство источника и назначения отдельно
+struct IoLimits {
+    std::uint64_t bwlimit = 0;            // байт/с на всё задание
+    std::uint64_t iops_limit = 0;         // операций чтения и записи в секунду на задание
+    std::uint64_t device_bwlimit = 0;     // байт/с на устройство
+    std::uint64_t device_iops_limit = 0;  // операций в секунду на устройство
+
+    [[nodiscard]] auto any() const -> bool {
+        return bwlimit || iops_limit || device_bwlimit || device_iops_limit;
+    }
+};
+
+// Разбор файла управления (--throttle-file): строки «ключ = значение»,
+// ключи как у IoLimits, размеры с суффиксами K/M/G/T, # — комментарий.
+// Отсутствующие ключи остаются как в base
+[[nodiscard]] auto parse_io_limits(std::string_view text, IoLimits base)
+    -> std::expected<IoLimits, Error>;
+
+class IoLimiter;
+
+// Вёдра, которые касаются одного файла: общие и устройств его источника
+// и назначения. Разрешаются один раз на файл (IoLimiter::pacer);
+// пустой IoPacer ничего не ограничивает. Копируется свободно, живёт
+// не дольше IoLimiter.
+class IoPacer {
+public:
+    IoPacer() = default;
+
+    [[nodiscard]] explicit operator bool() const { return limiter_ != nullptr; }
+
+    // Перед чтением/записью bytes байт: ждёт, пока её разрешат вёдра
+    void read(std::uint64_t bytes) const;
+    void write(std::uint64_t bytes) const;
+
+    // То же без сна — сколько ждать; для реактора (--engine=async)
+    [[nodiscard]] auto reserve_read(std::uint64_t bytes) const -> TokenBucket::Clock::duration;
+    [[nodiscard]] auto reserve_write(std::uint64_t bytes) const -> TokenBucket::Clock::duration;
+
+    // Меняется при каждой смене пределов: паузу по старым досыпать не нужно
+    [[nodiscard]] auto epoch() const -> std::uint64_t;
+
+private:
+    friend class IoLimiter;
+
+    struct Side {
+        TokenBucket* device_bytes = nullptr;
+        TokenBucket* device_ops = nullptr;
+    };
+
+    [[nodiscard]] auto reserve_(const Side& side, std::uint64_t bytes, bool count_bytes) const
+        -> TokenBucket::Clock::duration;
+    void wait_(TokenBucket::Clock::duration delay) const;
+
+    IoLimiter* limiter_ = nullptr;
+    Side source_;
+    Side destination_;
+};
+
+// Ограничитель ввода-вывода задания: общие вёдра байтов и операций и по
+// паре вёдер на каждое встреченное устройство. Пределы меняются на лету
+// (set_limits) — из файла управления, который перечитывается при
+// изменении и по SIGUSR1.
+class IoLimiter {
+public:
+    explicit IoLimiter(const IoLimits& limits);
+    ~IoLimiter();
+
+    IoLimiter(const IoLimiter&) = delete;
+    IoLimiter& operator=(const IoLimiter&) = delete;
+
+    [[nodiscard]] auto limits() const -> IoLimits;
+    void set_limits(const IoLimits& limits);
+
+    // Вёдра для файла с устройства src_device на устройство dst_device
+    [[nodiscard]] auto pacer(std::uint64_t src_device, std::uint64_t dst_device) -> IoPacer;
+
+    // Следит за файлом управления: перечитывает его при смене mtime и по
+    // SIGUSR1. Ошибки разбора не меняют действующих пределов
+    void watch(std::filesystem::path control_file);
+
+    // Перечитать файл управления сейчас
+    auto reload() -> std::expected<void, Error>;
+
+private:
+    friend class IoPacer;
+
+    struct DeviceBuckets {
+        TokenBucket bytes;
+        TokenBucket ops;
+        DeviceBuckets(std::uint64_t bw, std::uint64_t iops) : bytes(bw), ops(iops) {}
+    };
+
+    [[nodiscard]] auto device_(std::uint64_t device) -> DeviceBuckets&;
+    [[nodiscard]] auto generation_() const -> std::uint64_t {
+        return generation_value_.load(std::memory_order_acquire);
+    }
+
+    TokenBucket bytes_;
+    TokenBucket ops_;
+    ShardedMap<std::uint64_t, std::shared_ptr<DeviceBuckets>, std::hash<std::uint64_t>, 16> devices_;
+
+    mutable std::mutex limits_mutex_;   // IoLimits целиком и перечитывание файла
+    IoLimits limits_;
+    // Растёт при каждой смене пределов: ждущие потоки пересчитывают паузу
+    std::atomic<std::uint64_t> generation_value_{0};
+
+    std::filesystem::path control_file_;
+    std::jthread watcher_;
+};
+
+} // namespace cclone::infra
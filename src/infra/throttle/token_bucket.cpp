@@ -0,0 +1,92 @@
+#include "token_bucket.hpp"
+#include "../concurrent/sharded_counters.hpp"
+#include <algorithm>
+#include <thread>
+#include "../interrupt.hpp"
+
+namespace cclone::infra {
+
+namespace {
+
+constexpr std::int64_t NS_PER_SECOND = 1'000'000'000;
+
+// Стоимость amount токенов в наносекундах; 128 бит — без переполнения
+// на гигабайтных запросах
+auto cost_ns(std::uint64_t amount, std::uint64_t rate) -> std::int64_t {
+    const auto ns = static_cast<unsigned __int128>(amount) * NS_PER_SECOND / rate;
+    return static_cast<std::int64_t>(std::min<unsigned __int128>(ns, INT64_MAX / 4));
+}
+
+} // namespace
+
+auto TokenBucket::now_ns_() -> std::int64_t {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+auto TokenBucket::shard_index_() -> std::size_t {
+    return this_thread_slot() % SHARDS;
+}
+
+void TokenBucket::set_rate(std::uint64_t rate) {
+    const auto old = rate_.exchange(rate, std::memory_order_relaxed);
+    if (old == rate || old == 0 || rate == 0) return;
+
+    const auto now = now_ns_();
+    auto paid = paid_until_ns_.load(std::memory_order_relaxed);
+    for (;;) {
+        if (paid <= now) return;
+        const auto ahead = static_cast<__int128>(paid - now) * static_cast<__int128>(old) / rate;
+        const auto rescaled = now + static_cast<std::int64_t>(std::min<__int128>(ahead, INT64_MAX / 4));
+        if (paid_until_ns_.compare_exchange_weak(paid, rescaled, std::memory_order_relaxed)) return;
+    }
+}
+
+auto TokenBucket::reserve_global_(std::uint64_t amount, std::uint64_t rate) -> Clock::duration {
+    const auto now = now_ns_();
+    const auto burst = std::chrono::duration_cast<std::chrono::nanoseconds>(BURST).count();
+    const auto cost = cost_ns(amount, rate);
+
+    auto paid = paid_until_ns_.load(std::memory_order_relaxed);
+    std::int64_t next = 0;
+    do {
+        // Простой дольше BURST не копится: после паузы — не больше всплеска
+        next = std::max(paid, now - burst) + cost;
+    } while (!paid_until_ns_.compare_exchange_weak(paid, next, std::memory_order_relaxed));
+
+    return next > now ? std::chrono::nanoseconds(next - now) : Clock::duration::zero();
+}
+
+auto TokenBucket::reserve(std::uint64_t amount) -> Clock::duration {
+    const auto rate = rate_.load(std::memory_order_relaxed);
+    if (rate == 0 || amount == 0) return Clock::duration::zero();
+
+    auto& credit = shards_[shard_index_()].credit;
+    auto have = credit.load(std::memory_order_relaxed);
+    while (have >= amount) {
+        if (credit.compare_exchange_weak(have, have - amount, std::memory_order_relaxed)) {
+            return Clock::duration::zero();
+        }
+    }
+
+    // Запаса не хватило: забираем остаток и докупаем недостающее с порцией впрок
+    have = credit.exchange(0, std::memory_order_relaxed);
+    const auto quantum = std::max<std::uint64_t>(rate / QUANTA_PER_SECOND, 1);
+    const auto need = have >= amount ? 0 : amount - have;
+    const auto delay = reserve_global_(need + quantum, rate);
+    credit.fetch_add(have >= amount ? have - amount + quantum : quantum, std::memory_order_relaxed);
+    return delay;
+}
+
+void TokenBucket::acquire(std::uint64_t amount) {
+    const auto delay = reserve(amount);
+    if (delay <= Clock::duration::zero()) return;
+
+    // Сон кусками: Ctrl+C и снятие лимита не ждут конца большой паузы
+    const auto until = Clock::now() + delay;
+    for (auto now = Clock::now(); now < until; now = Clock::now()) {
+        if (is_interrupted() || rate() == 0) return;
+        std::this_thread::sleep_for(std::min<Clock::duration>(until - now, BURST));
+    }
+}
+
+} // namespace cclone::infra
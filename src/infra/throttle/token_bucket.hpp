@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace cclone::infra {
+
+// Ведро токенов для --bwlimit/--iops-limit, общее для всех рабочих потоков.
+//
+// Глобальное состояние — одно число: момент, до которого ведро уже
+// оплачено (GCRA, «виртуальное время»). Резервирование сдвигает его CAS'ом
+// на стоимость запроса и говорит, сколько ждать; ведро допускает всплеск
+// в BURST. Чтобы потоки не сходились на этом атомике на каждом чтении,
+// у каждого шарда (по потоку) есть запас уже оплаченных токенов: поток
+// берёт из него, а в глобальное время ходит за порцией раз в миллисекунду
+// трафика.
+//
+// Скорость меняется на лету (set_rate); 0 — без ограничения.
+class TokenBucket {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr auto BURST = std::chrono::milliseconds(100);
+
+    explicit TokenBucket(std::uint64_t rate = 0) : rate_(rate) {}
+
+    TokenBucket(const TokenBucket&) = delete;
+    TokenBucket& operator=(const TokenBucket&) = delete;
+
+    [[nodiscard]] auto rate() const -> std::uint64_t { return rate_.load(std::memory_order_relaxed); }
+
+    // Уже зарезервированное вперёд пересчитывается под новую скорость:
+    // понижение не оставляет очередь на старой, повышение не ждёт её
+    void set_rate(std::uint64_t rate);
+
+    // Резервирует amount токенов и возвращает, сколько ждать до их
+    // использования (ноль — сразу). Не блокирует: годится для реактора
+    [[nodiscard]] auto reserve(std::uint64_t amount) -> Clock::duration;
+
+    // reserve() и сон; прерывается по Ctrl+C
+    void acquire(std::uint64_t amount);
+
+private:
+    static constexpr std::size_t SHARDS = 16;
+    // Порция, которую шард берёт из глобального времени: 1 мс трафика
+    static constexpr std::uint64_t QUANTA_PER_SECOND = 1000;
+
+    struct alignas(64) Shard {
+        std::atomic<std::uint64_t> credit{0};  // оплаченные, но не взятые токены
+    };
+
+    [[nodiscard]] auto reserve_global_(std::uint64_t amount, std::uint64_t rate) -> Clock::duration;
+    [[nodiscard]] static auto shard_index_() -> std::size_t;
+    [[nodiscard]] static auto now_ns_() -> std::int64_t;
+
+    std::atomic<std::uint64_t> rate_;
+    alignas(64) std::atomic<std::int64_t> paid_until_ns_{0};
+    std::array<Shard, SHARDS> shards_{};
+};
+
+} // namespace cclone::infra
@@ -0,0 +1,275 @@
+#include "trace.hpp"
+#include "../json.hpp"
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+
+#ifndef _WIN32
+    #include <unistd.h>
+#endif
+
+namespace cclone::infra::trace {
+
+std::atomic<bool> g_enabled{false};
+
+namespace {
+
+constexpr std::size_t PHASES = static_cast<std::size_t>(Phase::Count);
+
+struct Event {
+    std::int64_t begin_ns;      // от начала сессии
+    std::int64_t end_ns;
+    const std::filesystem::path* subject;
+    std::uint32_t async_id;     // 0 — обычный срез потока
+    Phase phase;
+};
+
+// Кольцо и итоги одного потока. Пишет только владелец; читает finish(),
+// когда рабочие уже простаивают
+struct ThreadBuffer {
+    std::uint32_t tid = 0;
+    std::uint64_t generation = 0;
+    std::vector<Event> ring;            // растёт до ring_events, дальше по кругу
+    std::uint64_t written = 0;
+    std::array<std::uint64_t, PHASES> phase_ns{};
+    std::array<std::uint64_t, PHASES> phase_count{};
+    std::vector<SlowFile> slowest;      // куча с самым быстрым наверху
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;  // потоки текущей сессии
+    std::uint32_t next_tid = 1;
+    std::atomic<std::uint64_t> generation{0};
+    std::atomic<std::uint32_t> next_async{1};
+    // Параметры сессии: пишутся до увеличения generation
+    Clock::time_point origin{};
+    std::size_t top_files = 0;
+    std::size_t ring_events = 0;
+};
+
+auto registry() -> Registry& {
+    static Registry instance;
+    return instance;
+}
+
+auto faster(const SlowFile& a, const SlowFile& b) -> bool {
+    return a.duration > b.duration;
+}
+
+// Буфер потока; в новой сессии поток очищает его сам и заново регистрируется
+auto this_buffer() -> ThreadBuffer& {
+    thread_local const auto buffer = std::make_shared<ThreadBuffer>();
+    auto& reg = registry();
+    const auto generation = reg.generation.load(std::memory_order_acquire);
+    if (buffer->generation != generation) {
+        buffer->generation = generation;
+        buffer->ring.clear();
+        buffer->written = 0;
+        buffer->phase_ns.fill(0);
+        buffer->phase_count.fill(0);
+        buffer->slowest.clear();
+        std::lock_guard lock(reg.mutex);
+        buffer->tid = reg.next_tid++;
+        reg.buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+auto format_seconds(std::chrono::nanoseconds duration) -> std::string {
+    return fmt::format("{:.3f} s", std::chrono::duration<double>(duration).count());
+}
+
+} // namespace
+
+auto phase_name(Phase phase) -> std::string_view {
+    switch (phase) {
+        case Phase::File:     return "file";
+        case Phase::Scan:     return "scan";
+        case Phase::Queue:    return "queue";
+        case Phase::Open:     return "open";
+        case Phase::Read:     return "read";
+        case Phase::Write:    return "write";
+        case Phase::Publish:  return "publish";
+        case Phase::Metadata: return "metadata";
+        case Phase::Fsync:    return "fsync";
+        case Phase::Verify:   return "verify";
+        case Phase::Hash:     return "hash";
+        case Phase::Delta:    return "delta";
+        case Phase::Count:    break;
+    }
+    return "unknown";
+}
+
+void record(Phase phase, Clock::time_point begin, Clock::time_point end,
+            const std::filesystem::path* subject, bool async)
+{
+    if (!enabled()) return;  // интервал начался до finish()
+    auto& buffer = this_buffer();
+    auto& reg = registry();
+
+    const Event event{
+        .begin_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(begin - reg.origin).count(),
+        .end_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - reg.origin).count(),
+        .subject = subject,
+        .async_id = async ? reg.next_async.fetch_add(1, std::memory_order_relaxed) : 0,
+        .phase = phase
+    };
+    if (buffer.ring.size() < reg.ring_events) {
+        buffer.ring.push_back(event);
+    } else if (reg.ring_events != 0) {
+        buffer.ring[buffer.written % reg.ring_events] = event;
+    }
+    ++buffer.written;
+
+    const auto duration = std::chrono::nanoseconds(std::max<std::int64_t>(0, event.end_ns - event.begin_ns));
+    const auto index = static_cast<std::size_t>(phase);
+    buffer.phase_ns[index] += static_cast<std::uint64_t>(duration.count());
+    ++buffer.phase_count[index];
+
+    // Путь копируется, только если файл попадает в число самых медленных
+    if (phase == Phase::File && subject && reg.top_files != 0) {
+        auto& slowest = buffer.slowest;
+        if (slowest.size() < reg.top_files) {
+            slowest.push_back(SlowFile{.path = subject->string(), .duration = duration});
+            std::push_heap(slowest.begin(), slowest.end(), faster);
+        } else if (duration > slowest.front().duration) {
+            std::pop_heap(slowest.begin(), slowest.end(), faster);
+            slowest.back() = SlowFile{.path = subject->string(), .duration = duration};
+            std::push_heap(slowest.begin(), slowest.end(), faster);
+        }
+    }
+}
+
+Session::Session(const Options& options)
+    : options_(options)
+{
+    auto& reg = registry();
+    {
+        std::lock_guard lock(reg.mutex);
+        reg.buffers.clear();
+        reg.next_tid = 1;
+        reg.origin = Clock::now();
+        reg.top_files = options_.top_files;
+        reg.ring_events = options_.ring_events;
+    }
+    reg.generation.fetch_add(1, std::memory_order_release);
+    g_enabled.store(true, std::memory_order_release);
+}
+
+Session::~Session() {
+    if (!finished_) {
+        if (auto summary = finish(); !summary) {
+            spdlog::warn("{}", summary.error().message);
+        }
+    }
+}
+
+auto Session::finish() -> std::expected<Summary, Error> {
+    finished_ = true;
+    g_enabled.store(false, std::memory_order_release);
+
+    auto& reg = registry();
+    std::lock_guard lock(reg.mutex);
+
+    Summary summary;
+    std::array<PhaseTotal, PHASES> totals{};
+    for (std::size_t i = 0; i < PHASES; ++i) totals[i].phase = static_cast<Phase>(i);
+
+    std::ofstream out(options_.output, std::ios::trunc);
+    if (!out) {
+        return std::unexpected(make_error(ErrorCode::InvalidPath,
+            fmt::format("Cannot write trace to {}", options_.output.string())));
+    }
+#ifndef _WIN32
+    const auto pid = static_cast<long>(::getpid());
+#else
+    const long pid = 1;
+#endif
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto emit = [&](const std::string& line) {
+        if (!first) out << ",\n";
+        first = false;
+        out << line;
+    };
+
+    for (const auto& buffer : reg.buffers) {
+        emit(fmt::format(R"({{"name":"thread_name","ph":"M","pid":{},"tid":{},"args":{{"name":"cclone {}"}}}})",
+                         pid, buffer->tid, buffer->tid));
+
+        const auto capacity = buffer->ring.size();
+        const auto start = capacity != 0 && buffer->written > capacity ? buffer->written % capacity : 0;
+        for (std::size_t n = 0; n < capacity; ++n) {
+            const auto& event = buffer->ring[(start + n) % capacity];
+            const auto name = phase_name(event.phase);
+            const double ts = static_cast<double>(event.begin_ns) / 1000.0;
+            const double dur = static_cast<double>(std::max<std::int64_t>(0, event.end_ns - event.begin_ns)) / 1000.0;
+            const auto args = event.subject
+                ? fmt::format(R"(,"args":{{"file":"{}"}})", json_escape(event.subject->string()))
+                : std::string{};
+            if (event.async_id == 0) {
+                emit(fmt::format(R"({{"name":"{}","cat":"cclone","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":{},"tid":{}{}}})",
+                                 name, ts, dur, pid, buffer->tid, args));
+            } else {
+                // Файлы реактора перекрываются на одном потоке — асинхронные пары b/e
+                emit(fmt::format(R"({{"name":"{}","cat":"cclone","ph":"b","id":{},"ts":{:.3f},"pid":{},"tid":{}{}}})",
+                                 name, event.async_id, ts, pid, buffer->tid, args));
+                emit(fmt::format(R"({{"name":"{}","cat":"cclone","ph":"e","id":{},"ts":{:.3f},"pid":{},"tid":{}}})",
+                                 name, event.async_id, ts + dur, pid, buffer->tid));
+            }
+        }
+        summary.events += capacity;
+        summary.dropped += buffer->written - capacity;
+
+        for (std::size_t i = 0; i < PHASES; ++i) {
+            totals[i].count += buffer->phase_count[i];
+            totals[i].total += std::chrono::nanoseconds(buffer->phase_ns[i]);
+        }
+        summary.slowest.insert(summary.slowest.end(), buffer->slowest.begin(), buffer->slowest.end());
+    }
+    out << "\n]}\n";
+    reg.buffers.clear();
+    if (!out) {
+        return std::unexpected(make_error(ErrorCode::DiskFull,
+            fmt::format("Cannot write trace to {}", options_.output.string())));
+    }
+
+    for (const auto& total : totals) {
+        if (total.count != 0) summary.phases.push_back(total);
+    }
+    std::sort(summary.phases.begin(), summary.phases.end(),
+              [](const PhaseTotal& a, const PhaseTotal& b) { return a.total > b.total; });
+    std::sort(summary.slowest.begin(), summary.slowest.end(), faster);
+    if (summary.slowest.size() > options_.top_files) summary.slowest.resize(options_.top_files);
+    return summary;
+}
+
+void log_summary(const Summary& summary) {
+    if (summary.dropped != 0) {
+        spdlog::info("Trace: {} spans written, {} oldest dropped from full per-thread buffers",
+                     summary.events, summary.dropped);
+    } else {
+        spdlog::info("Trace: {} spans written", summary.events);
+    }
+    spdlog::info("Time by phase (summed over threads, nested phases included):");
+    for (const auto& phase : summary.phases) {
+        const double mean_ms = std::chrono::duration<double, std::milli>(phase.total).count()
+                             / static_cast<double>(phase.count);
+        spdlog::info("  {:<9} {:>10} spans {:>12}  avg {:.3f} ms", phase_name(phase.phase), phase.count,
+                     format_seconds(phase.total), mean_ms);
+    }
+    if (!summary.slowest.empty()) {
+        spdlog::info("Slowest files:");
+        for (const auto& file : summary.slowest) {
+            spdlog::info("  {:>12}  {}", format_seconds(file.duration), file.path);
+        }
+    }
+}
+
+} // namespace cclone::infra::trace
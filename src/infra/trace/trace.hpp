@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../error_handler/error.hpp"
+
+namespace cclone::infra::trace {
+
+// Фазы копирования. File — файл целиком, остальные вложены в него
+enum class Phase : std::uint8_t {
+    File,
+    Scan,
+    Queue,      // ожидание в очереди сканирование → копирование
+    Open,
+    Read,
+    Write,
+    Publish,    // --atomic: имя появляется у готового файла
+    Metadata,
+    Fsync,
+    Verify,
+    Hash,
+    Delta,
+    Count
+};
+
+[[nodiscard]] auto phase_name(Phase phase) -> std::string_view;
+
+using Clock = std::chrono::steady_clock;
+
+extern std::atomic<bool> g_enabled;
+
+// Идёт ли сессия (--trace). Выключенная трассировка стоит одной
+// relaxed-загрузки на интервал
+[[nodiscard]] inline auto enabled() -> bool {
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+// Записать интервал в кольцо текущего потока. subject — путь файла
+// (только у Phase::File) и должен жить до Session::finish(); async — файл
+// копирует реактор вперемешку с другими, интервал пишется асинхронным
+// событием, а не вложенным срезом потока
+void record(Phase phase, Clock::time_point begin, Clock::time_point end,
+            const std::filesystem::path* subject = nullptr, bool async = false);
+
+// Интервал от конструктора до деструктора
+class Span {
+public:
+    explicit Span(Phase phase, const std::filesystem::path* subject = nullptr) noexcept
+        : phase_(phase)
+        , subject_(subject)
+        , active_(enabled())
+    {
+        if (active_) begin_ = Clock::now();
+    }
+
+    ~Span() {
+        if (active_) record(phase_, begin_, Clock::now(), subject_);
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+private:
+    Phase phase_;
+    const std::filesystem::path* subject_;
+    bool active_;
+    Clock::time_point begin_{};
+};
+
+struct PhaseTotal {
+    Phase phase;
+    std::uint64_t count = 0;
+    std::chrono::nanoseconds total{0};  // включая вложенные фазы
+};
+
+struct SlowFile {
+    std::string path;
+    std::chrono::nanoseconds duration{0};
+};
+
+struct Summary {
+    std::vector<PhaseTotal> phases;     // по убыванию времени
+    std::vector<SlowFile> slowest;      // по убыванию времени
+    std::uint64_t events = 0;           // записано в файл
+    std::uint64_t dropped = 0;          // вытеснены из колец
+};
+
+// Сессия трассировки (--trace). Каждый поток пишет интервалы в своё
+// кольцо без блокировок; итоги по фазам и самые медленные файлы
+// считаются по ходу и не зависят от переполнения колец. finish()
+// выключает трассировку и выгружает кольца в Chrome trace-event JSON
+// (chrome://tracing, ui.perfetto.dev). Одна сессия за раз; finish() —
+// когда рабочие потоки уже простаивают
+class Session {
+public:
+    struct Options {
+        std::filesystem::path output;
+        std::size_t top_files = 10;
+        std::size_t ring_events = 131072;  // на поток (32 байта на событие); старые вытесняются
+    };
+
+    explicit Session(const Options& options);
+    ~Session();
+
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+
+    [[nodiscard]] auto finish() -> std::expected<Summary, Error>;
+
+private:
+    Options options_;
+    bool finished_ = false;
+};
+
+// Итоги в журнал: разбивка по фазам и самые медленные файлы
+void log_summary(const Summary& summary);
+
+} // namespace cclone::infra::trace
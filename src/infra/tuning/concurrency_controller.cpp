@@ -0,0 +1,201 @@
+#include "concurrency_controller.hpp"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+
+namespace cclone::infra {
+
+namespace {
+
+// Во сколько раз больше plateau должна измениться пропускная способность
+// на удерживаемом уровне, чтобы регулятор снова начал поиск
+constexpr double RESEARCH_FACTOR = 4.0;
+
+auto describe(const OperatingPoint& point, const std::string& unit) -> std::string {
+    auto text = fmt::format("{} {} ({:.1f} MB/s", point.level, unit, point.throughput / 1e6);
+    if (point.latency_ms) text += fmt::format(", device latency {:.2f} ms", *point.latency_ms);
+    return text + ")";
+}
+
+} // namespace
+
+ConcurrencyController::ConcurrencyController(const Options& options)
+    : options_(options)
+{
+    options_.min_level = std::max<std::size_t>(1, options_.min_level);
+    options_.max_level = std::max(options_.min_level, options_.max_level);
+    level_ = std::clamp(options_.initial_level, options_.min_level, options_.max_level);
+    cap_ = options_.max_level;
+}
+
+ConcurrencyController::~ConcurrencyController() {
+    stop();
+}
+
+auto ConcurrencyController::level() const -> std::size_t {
+    std::lock_guard lock(mutex_);
+    return level_;
+}
+
+auto ConcurrencyController::settled() const -> bool {
+    std::lock_guard lock(mutex_);
+    return settled_;
+}
+
+auto ConcurrencyController::best() const -> OperatingPoint {
+    std::lock_guard lock(mutex_);
+    return best_;
+}
+
+void ConcurrencyController::move_(int direction) {
+    const auto step = std::max<std::size_t>(1, level_ / 4);
+    const auto next = direction > 0 ? std::min(cap_, level_ + step)
+                                    : std::max(options_.min_level, level_ > step ? level_ - step : 0);
+    if (next == level_) {
+        settle_();  // упёрлись в границу: дальше идти некуда
+        return;
+    }
+    level_ = next;
+}
+
+void ConcurrencyController::settle_() {
+    // Из почти равных по пропускной способности — наименьший уровень:
+    // лишние рабочие только добавляют очередь устройству
+    const double good_enough = best_.throughput * (1.0 - options_.plateau);
+    std::size_t target = level_;
+    for (const auto& [level, throughput] : history_) {
+        if (level <= cap_ && throughput >= good_enough) {
+            target = level;
+            break;
+        }
+    }
+    level_ = target;
+    settled_ = true;
+    reversals_ = 0;
+    const auto seen = history_.find(level_);
+    previous_ = seen != history_.end() ? std::optional(seen->second) : std::nullopt;
+}
+
+auto ConcurrencyController::observe(double throughput, std::optional<double> latency_ms) -> std::size_t {
+    std::lock_guard lock(mutex_);
+    current_ = OperatingPoint{.level = level_, .throughput = throughput, .latency_ms = latency_ms};
+
+    if (options_.latency_ceiling_ms && latency_ms && *latency_ms > *options_.latency_ceiling_ms) {
+        // Устройство перегружено: уменьшаем на четверть и выше не поднимаемся
+        cap_ = std::max(options_.min_level, level_ > 1 ? level_ - 1 : 1);
+        level_ = std::max(options_.min_level, level_ - std::max<std::size_t>(1, level_ / 4));
+        history_.erase(history_.upper_bound(cap_), history_.end());
+        direction_ = -1;
+        reversals_ = 0;
+        settled_ = false;
+        previous_.reset();
+        return level_;
+    }
+
+    history_[level_] = throughput;
+    if (throughput > best_.throughput) best_ = current_;
+
+    if (settled_) {
+        // Нагрузка сменилась (пошли крупные файлы, соседи по диску) — ищем заново
+        if (previous_ && std::abs(throughput - *previous_) > *previous_ * options_.plateau * RESEARCH_FACTOR) {
+            settled_ = false;
+            history_.clear();
+            history_[level_] = throughput;
+            best_ = current_;
+            direction_ = +1;
+            previous_ = throughput;
+            move_(direction_);
+        }
+        return level_;
+    }
+
+    if (!previous_) {
+        previous_ = throughput;
+        move_(direction_);
+        return level_;
+    }
+
+    const double change = (throughput - *previous_) / std::max(*previous_, 1.0);
+    previous_ = throughput;
+    if (change > options_.plateau) {
+        move_(direction_);
+    } else if (change < -options_.plateau) {
+        direction_ = -direction_;
+        if (++reversals_ >= 2) {
+            settle_();  // вершина между двумя разворотами
+        } else {
+            move_(direction_);
+        }
+    } else {
+        settle_();      // плато: больше параллелизма ничего не даёт
+    }
+    return level_;
+}
+
+void ConcurrencyController::start(Sampler sample, Apply apply, std::chrono::milliseconds interval,
+                                  std::string unit, Clock clock)
+{
+    unit_ = std::move(unit);
+    if (!clock) clock = [] { return std::chrono::steady_clock::now(); };
+    apply(level());
+    worker_ = std::jthread([this, sample = std::move(sample), apply = std::move(apply), interval,
+                            clock = std::move(clock)](std::stop_token stop) {
+        std::mutex sleep_mutex;
+        std::condition_variable_any wakeup;
+
+        auto last = sample();
+        auto last_time = clock();
+        while (!stop.stop_requested()) {
+            {
+                std::unique_lock lock(sleep_mutex);
+                if (wakeup.wait_for(lock, stop, interval, [] { return false; })) break;
+            }
+            if (stop.stop_requested()) break;
+
+            const auto now_sample = sample();
+            const auto now = clock();
+            const double seconds = std::chrono::duration<double>(now - last_time).count();
+            const auto bytes = now_sample.bytes - std::min(now_sample.bytes, last.bytes);
+            std::optional<double> latency;
+            if (now_sample.ios && last.ios && *now_sample.ios > *last.ios) {
+                latency = static_cast<double>(now_sample.io_ticks_ms - last.io_ticks_ms)
+                        / static_cast<double>(*now_sample.ios - *last.ios);
+            }
+            last = now_sample;
+            last_time = now;
+            // Интервал без единого записанного байта ничего не говорит об уровне
+            if (bytes == 0 || seconds <= 0) continue;
+
+            const bool was_settled = settled();
+            const auto before = level();
+            const auto after = observe(static_cast<double>(bytes) / seconds, latency);
+            if (after != before) {
+                apply(after);
+                spdlog::debug("Adaptive concurrency: {} -> {} {} ({:.1f} MB/s)",
+                              before, after, unit_, static_cast<double>(bytes) / seconds / 1e6);
+            }
+            if (settled() && !was_settled) {
+                std::lock_guard lock(mutex_);
+                auto point = current_;
+                point.level = level_;
+                if (const auto seen = history_.find(level_); seen != history_.end()) point.throughput = seen->second;
+                spdlog::info("Adaptive concurrency: settled at {}", describe(point, unit_));
+            }
+        }
+    });
+}
+
+void ConcurrencyController::stop() {
+    if (!worker_.joinable()) return;
+    worker_.request_stop();
+    worker_.join();
+    const auto point = best();
+    if (point.level != 0) {
+        spdlog::info("Adaptive concurrency: best operating point {}, finished at {} {}",
+                     describe(point, unit_), level(), unit_);
+    }
+}
+
+} // namespace cclone::infra
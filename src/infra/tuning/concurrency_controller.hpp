@@ -0,0 +1,94 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace cclone::infra {
+
+// Рабочая точка: уровень параллелизма и что он дал
+struct OperatingPoint {
+    std::size_t level = 0;
+    double throughput = 0;                 // байт/с
+    std::optional<double> latency_ms;      // средняя задержка операции устройства
+};
+
+// Регулятор параллелизма (--adaptive): раз в несколько сотен миллисекунд
+// смотрит на пропускную способность и задержку операций и двигает
+// уровень — число активных рабочих или файлов в полёте.
+//
+// Подъём в гору: пока пропускная способность растёт больше чем на
+// plateau, уровень меняется в ту же сторону шагами по четверти; упала —
+// разворот. Два разворота подряд — вершина найдена: регулятор встаёт на
+// лучший из виденных уровней и держит его, пока нагрузка заметно не
+// изменится. Задержка выше потолка — мультипликативное уменьшение, и
+// выше этого уровня регулятор больше не поднимается.
+class ConcurrencyController {
+public:
+    struct Options {
+        std::size_t min_level = 1;
+        std::size_t max_level = 1;
+        std::size_t initial_level = 1;
+        std::optional<double> latency_ceiling_ms;
+        double plateau = 0.05;             // изменение меньше этой доли — «не изменилось»
+    };
+
+    // Накопительные счётчики; регулятор берёт разности между снимками
+    struct Sample {
+        std::uint64_t bytes = 0;
+        std::optional<std::uint64_t> ios;       // nullopt — задержка неизвестна
+        std::uint64_t io_ticks_ms = 0;
+    };
+
+    using Sampler = std::function<Sample()>;
+    using Apply = std::function<void(std::size_t level)>;
+    using Clock = std::function<std::chrono::steady_clock::time_point()>;
+
+    explicit ConcurrencyController(const Options& options);
+    ~ConcurrencyController();
+
+    ConcurrencyController(const ConcurrencyController&) = delete;
+    ConcurrencyController& operator=(const ConcurrencyController&) = delete;
+
+    // Один шаг по наблюдению за прошедший интервал; возвращает новый уровень
+    auto observe(double throughput, std::optional<double> latency_ms) -> std::size_t;
+
+    [[nodiscard]] auto level() const -> std::size_t;
+    [[nodiscard]] auto settled() const -> bool;
+    [[nodiscard]] auto best() const -> OperatingPoint;
+
+    // Фоновый цикл: sample() каждые interval, apply() при смене уровня.
+    // unit — как назвать уровень в журнале («workers», «files in flight»).
+    // clock — чем мерить длину интервала (пусто — steady_clock; тесты
+    // подставляют свои часы, чтобы скорость не зависела от планировщика)
+    void start(Sampler sample, Apply apply, std::chrono::milliseconds interval, std::string unit,
+               Clock clock = {});
+    void stop();
+
+private:
+    void move_(int direction);
+    void settle_();
+
+    Options options_;
+    mutable std::mutex mutex_;
+    std::size_t level_;
+    std::size_t cap_;                      // потолок после превышения задержки
+    int direction_ = +1;
+    int reversals_ = 0;
+    bool settled_ = false;
+    std::optional<double> previous_;       // пропускная способность прошлого интервала
+    std::map<std::size_t, double> history_; // последняя пропускная способность на каждом уровне
+    OperatingPoint best_;
+    OperatingPoint current_;
+
+    std::string unit_;
+    std::jthread worker_;
+};
+
+} // namespace cclone::infra
@@ -0,0 +1,28 @@
+#include "io_probe.hpp"
+#include <fstream>
+#include <fmt/core.h>
+
+#ifdef __linux__
+    #include <sys/sysmacros.h>
+#endif
+
+namespace cclone::infra {
+
+auto read_device_counters(std::uint64_t device, const std::filesystem::path& sysfs_root)
+    -> std::optional<DeviceCounters>
+{
+#ifdef __linux__
+    // Поля: чтения, слияния, секторы, мс чтения, записи, слияния, секторы, мс записи, ...
+    std::ifstream in(sysfs_root / "dev/block" / fmt::format("{}:{}", major(device), minor(device)) / "stat");
+    std::uint64_t fields[8] = {};
+    for (auto& field : fields) {
+        if (!(in >> field)) return std::nullopt;
+    }
+    return DeviceCounters{.ios = fields[0] + fields[4], .ticks_ms = fields[3] + fields[7]};
+#else
+    (void)device; (void)sysfs_root;
+    return std::nullopt;
+#endif
+}
+
+} // namespace cclone::infra
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+namespace cclone::infra {
+
+// Счётчики блочного устройства из /sys/dev/block/M:m/stat: завершённые
+// чтения и записи и время, которое они провели в устройстве. Разность
+// двух снимков даёт среднюю задержку операции (как await у iostat)
+struct DeviceCounters {
+    std::uint64_t ios = 0;
+    std::uint64_t ticks_ms = 0;
+};
+
+// device — st_dev (FileStat::device); nullopt — не блочное устройство
+// (tmpfs, overlay, сеть) или sysfs недоступен. sysfs_root подменяется в тестах
+[[nodiscard]] auto read_device_counters(std::uint64_t device, const std::filesystem::path& sysfs_root = "/sys")
+    -> std::optional<DeviceCounters>;
+
+} // namespace cclone::infra
@@ -1,4 +1,6 @@
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 
@@ -6,11 +8,18 @@
 #include "infra/error_handler/error.hpp"
 #include "infra/interrupt.hpp"
 #include "infra/monitoring/monitoring.hpp"
+#include "infra/monitoring/op_latency.hpp"
+#include "infra/syscall/syscalls.hpp"
 #include "cli/args_parser/args_parser.hpp"
 #include "core/copy_engine/copy_engine.hpp"
+#include "extensions/manifest.hpp"
+#include "cli/daemon/client.hpp"
+#include "cli/daemon/daemon.hpp"
+#include "core/daemon/job_manager.hpp"
 #include <git_info.hpp>
 #include <spdlog/spdlog.h>
 #include <chrono>
+#include <thread>
 
 using GIT = cclone::build_info::GitInfo;
 using ARGS = cclone::args_parser::CLIArgs;
@@ -18,7 +27,7 @@ using GIT_VERSE = cclone::build_info::GitInfo;
 
 constexpr auto load_from_cli = cclone::infra::config_from_cli;
 constexpr auto load_config_file = cclone::infra::load_config_from_file;
-constexpr auto args_parser = cclone::args_parser::parse_args;
+constexpr std::optional<ARGS> (*args_parser)(int, char const* const*) = cclone::args_parser::parse_args;
 constexpr auto git =  cclone::build_info::get_git_info();
 [[nodiscard]] 
 static auto 
@@ -81,7 +90,96 @@ int main(int argc, char** argv)
         
         spdlog::debug("Merging CLI config with file config...");
         config.merge_with(cli_config); // CLI имеет приоритет
+
+        // Демон: параметры этого запуска — умолчания для всех заданий
+        const auto socket = args.socket.empty() ? cclone::daemon::default_socket_path()
+                                                : std::filesystem::path(args.socket);
+        if (args.daemon) {
+            cclone::core::JobManager jobs({
+                .threads = config.threads.value_or(0),
+                .max_running = args.daemon_jobs.value_or(4)
+            });
+            auto server = cclone::daemon::Server::bind(socket, config, jobs);
+            if (!server) {
+                spdlog::error("Daemon error: {}", server.error().message);
+                return 1;
+            }
+            (*server)->serve(std::stop_token{});
+            spdlog::info("Daemon stopped");
+            return 0;
+        }
+
+        if (args.list_jobs || args.cancel) {
+            auto client = cclone::daemon::Client::connect(socket);
+            if (!client) {
+                spdlog::error("No daemon: {}", client.error().message);
+                return 1;
+            }
+            if (args.cancel) {
+                if (auto cancelled = client->cancel(*args.cancel); !cancelled) {
+                    spdlog::error("{}", cancelled.error().message);
+                    return 1;
+                }
+                spdlog::info("Job {} cancelled", *args.cancel);
+                return 0;
+            }
+            auto jobs = client->list();
+            if (!jobs) {
+                spdlog::error("{}", jobs.error().message);
+                return 1;
+            }
+            for (const auto& line : cclone::daemon::format_jobs(*jobs)) {
+                fmt::print("{}\n", line);
+            }
+            return 0;
+        }
+
+        // Режимы работы с манифестом не копируют данные
+        if (!args.dump_manifest.empty()) {
+            auto entries = cclone::extensions::load_manifest(args.dump_manifest);
+            if (!entries) {
+                spdlog::error("Manifest error: {}", entries.error().message);
+                return 1;
+            }
+            cclone::extensions::export_manifest_text(*entries, std::cout);
+            return 0;
+        }
+
+        if (!args.check_manifest.empty()) {
+            auto check = cclone::extensions::check_manifest(
+                args.check_manifest, args.destination,
+                config.threads.value_or(std::jthread::hardware_concurrency()));
+            if (!check) {
+                spdlog::error("Manifest check failed: {}", check.error().message);
+                return 1;
+            }
+            spdlog::info("Manifest check: {} ok, {} missing, {} mismatched, {} errors",
+                         check->files_ok, check->files_missing, check->files_mismatched, check->errors);
+            if (check->files_missing > 0 || check->files_mismatched > 0 || check->errors > 0) {
+                return cclone::infra::make_error(cclone::infra::ErrorCode::ChecksumMismatch,
+                                                 "Manifest check failed").to_exit_code();
+            }
+            return 0;
+        }
         
+        // Запущен демон — копирует он, этот процесс только ставит задание и ждёт
+        if (!args.no_daemon) {
+            auto client = cclone::daemon::Client::connect(socket);
+            if (!client && client.error().code != cclone::infra::ErrorCode::FileNotFound) {
+                spdlog::warn("Not using the daemon: {}", client.error().message);
+            }
+            if (client) {
+                // Свой конфигурационный файл клиент отдаёт демону вместе с параметрами
+                std::string client_config;
+                if (const auto file = cclone::infra::find_config_file()) {
+                    std::ifstream in(*file);
+                    client_config.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+                }
+                return cclone::daemon::run_remote(*client, std::vector<std::string>(argv + 1, argv + argc),
+                                                  client_config, config.progress, args.quiet);
+            }
+        }
+
         // Выводим информацию о версии
         if (!args.quiet) {
             __out_git_verse(git);
@@ -134,6 +232,23 @@ int main(int argc, char** argv)
             spdlog::info("Bytes copied: {} ({:.2f} MB)", 
                         stats.bytes_copied, 
                         stats.bytes_copied / 1024.0 / 1024.0);
+            if (stats.bytes_written != stats.bytes_copied) {
+                const double saved = stats.bytes_copied > 0
+                    ? 100.0 * (1.0 - static_cast<double>(stats.bytes_written) / stats.bytes_copied)
+                    : 0.0;
+                spdlog::info("Bytes written: {} ({:.2f} MB, {:.1f}% of logical size saved)",
+                            stats.bytes_written,
+                            stats.bytes_written / 1024.0 / 1024.0,
+                            saved);
+            }
+            if (stats.hardlinks > 0) {
+                spdlog::info("Hard links recreated: {}", stats.hardlinks);
+            }
+            if (stats.bytes_deduped > 0) {
+                spdlog::info("Bytes deduplicated: {} ({:.2f} MB)",
+                            stats.bytes_deduped,
+                            stats.bytes_deduped / 1024.0 / 1024.0);
+            }
             spdlog::info("Files skipped: {}", stats.files_skipped);
             spdlog::info("Errors: {}", stats.errors);
             spdlog::info("Time elapsed: {:.2f} seconds", duration.count() / 1000.0);
@@ -142,6 +257,14 @@ int main(int argc, char** argv)
                 double speed_mbps = (stats.bytes_copied / 1024.0 / 1024.0) / (duration.count() / 1000.0);
                 spdlog::info("Average speed: {:.2f} MB/s", speed_mbps);
             }
+            for (const auto& line : cclone::infra::format_latency_table(stats.latency)) {
+                spdlog::info("{}", line);
+            }
+            const auto files_handled = stats.files_copied + stats.files_skipped + stats.errors;
+            for (const auto& line : cclone::infra::sys::format_syscall_report(stats.syscalls, files_handled,
+                                                                              stats.bytes_copied)) {
+                spdlog::info("{}", line);
+            }
         }
         
         return stats.errors > 0 ? 1 : 0;
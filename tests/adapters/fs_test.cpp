@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+
+#include "adapters/fs.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace {
+
+namespace fs = std::filesystem;
+using namespace cclone::adapters::fs;
+
+auto read_all(const fs::path& path) -> std::string {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+// Размер не кратен блоку: O_DIRECT дописывает хвост до 4096, результат обрезается
+TEST(FsAdapterTest, EveryStrategyKeepsExactContent)
+{
+    const auto dir = fs::temp_directory_path() / "cclone_fs_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    std::string data(5 * 1024 * 1024 + 123, '\0');
+    for (std::size_t i = 0; i < data.size(); ++i) data[i] = static_cast<char>(i * 31 % 251);
+    std::ofstream(dir / "src", std::ios::binary) << data;
+
+    for (auto strategy : {CopyStrategy::Buffered, CopyStrategy::MMap, CopyStrategy::DirectIO, CopyStrategy::Async}) {
+        const auto dst = dir / "dst";
+        ASSERT_TRUE(copy_file(dir / "src", dst, strategy).has_value());
+        EXPECT_EQ(read_all(dst), data);
+        fs::remove(dst);
+    }
+
+    auto async = copy_file_async(dir / "src", dir / "async", CopyStrategy::DirectIO).get();
+    ASSERT_TRUE(async.has_value());
+    EXPECT_EQ(read_all(dir / "async"), data);
+
+    fs::remove_all(dir);
+}
+
+} // namespace
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include "adapters/io_reactor.hpp"
+#include "infra/async/task.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <fmt/core.h>
+
+#ifdef __linux__
+    #include <fcntl.h>
+#endif
+
+namespace {
+
+namespace fs = std::filesystem;
+using cclone::adapters::fs::IoReactor;
+using cclone::infra::Detached;
+using cclone::infra::Task;
+using cclone::infra::WorkStealingPool;
+
+auto read_all(const fs::path& path) -> std::string {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+#ifdef __linux__
+// Вложенная сопрограмма: копия одного файла кусками по 7 байт
+auto copy_small(IoReactor& io, const fs::path& src, const fs::path& dst) -> Task<int> {
+    const int in = co_await io.open(src.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0) co_return in;
+    const int out = co_await io.open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (out < 0) co_return out;
+
+    char buffer[7];
+    std::uint64_t offset = 0;
+    for (;;) {
+        const int got = co_await io.read(in, buffer, sizeof(buffer), offset);
+        if (got <= 0) break;
+        (void)co_await io.write(out, buffer, static_cast<std::size_t>(got), offset);
+        offset += static_cast<std::uint64_t>(got);
+    }
+    (void)co_await io.close(in);
+    (void)co_await io.close(out);
+    co_return static_cast<int>(offset);
+}
+
+auto run_copy(IoReactor& io, fs::path src, fs::path dst, int& result, std::size_t& active) -> Detached {
+    result = co_await copy_small(io, src, dst);
+    --active;
+}
+
+class IoReactorTest : public ::testing::TestWithParam<bool> {
+protected:
+    void SetUp() override {
+        dir_ = fs::temp_directory_path() / "cclone_io_reactor_test";
+        fs::remove_all(dir_);
+        fs::create_directories(dir_);
+        auto reactor = IoReactor::create(64, pool_, GetParam());
+        ASSERT_TRUE(reactor.has_value()) << reactor.error().message;
+        io_ = std::move(*reactor);
+    }
+    void TearDown() override { fs::remove_all(dir_); }
+
+    void drain(const std::size_t& active) {
+        while (active != 0) io_->wait();
+        EXPECT_EQ(io_->pending(), 0u);
+    }
+
+    WorkStealingPool pool_{2};
+    std::unique_ptr<IoReactor> io_;
+    fs::path dir_;
+};
+
+// Тысяча файлов в полёте на одном потоке; операций больше, чем мест в кольце
+TEST_P(IoReactorTest, ManyFilesInFlightOnOneThread)
+{
+    constexpr int FILES = 1000;
+    std::vector<int> results(FILES, -1);
+    std::size_t active = 0;
+    for (int i = 0; i < FILES; ++i) {
+        std::ofstream(dir_ / fmt::format("src{}", i)) << "file number " << i;
+    }
+    for (int i = 0; i < FILES; ++i) {
+        ++active;
+        run_copy(*io_, dir_ / fmt::format("src{}", i), dir_ / fmt::format("dst{}", i), results[i], active);
+    }
+    EXPECT_EQ(io_->pending(), static_cast<std::size_t>(FILES));
+    drain(active);
+
+    for (int i = 0; i < FILES; ++i) {
+        const auto expected = fmt::format("file number {}", i);
+        EXPECT_EQ(results[i], static_cast<int>(expected.size()));
+        EXPECT_EQ(read_all(dir_ / fmt::format("dst{}", i)), expected);
+    }
+}
+
+TEST_P(IoReactorTest, ErrorsAreNegativeErrno)
+{
+    int result = 0;
+    std::size_t active = 1;
+    run_copy(*io_, dir_ / "missing", dir_ / "dst", result, active);
+    drain(active);
+    EXPECT_EQ(result, -ENOENT);
+    EXPECT_FALSE(fs::exists(dir_ / "dst"));
+}
+
+auto offload_twice(IoReactor& io, std::vector<int>& seen, std::size_t& active) -> Detached {
+    seen.push_back(co_await io.offload([] { return 1; }));
+    try {
+        seen.push_back(co_await io.offload([]() -> int { throw std::runtime_error("boom"); }));
+    } catch (const std::runtime_error&) {
+        seen.push_back(-1);
+    }
+    --active;
+}
+
+// offload выполняется в пуле, а продолжается сопрограмма в потоке реактора
+TEST_P(IoReactorTest, OffloadResumesOnReactorThread)
+{
+    std::vector<int> seen;
+    std::size_t active = 1;
+    offload_twice(*io_, seen, active);
+    drain(active);
+    EXPECT_EQ(seen, (std::vector<int>{1, -1}));
+}
+
+auto nap(IoReactor& io, std::chrono::milliseconds duration, std::vector<int>& order, int id, std::size_t& active)
+    -> Detached
+{
+    EXPECT_EQ(co_await io.sleep(duration), 0);
+    order.push_back(id);
+    --active;
+}
+
+// Пауза не держит реактор: короткая завершается раньше длинной
+TEST_P(IoReactorTest, SleepsCompleteInDeadlineOrder)
+{
+    using namespace std::chrono_literals;
+    std::vector<int> order;
+    std::size_t active = 2;
+    const auto start = std::chrono::steady_clock::now();
+    nap(*io_, 60ms, order, 1, active);
+    nap(*io_, 10ms, order, 2, active);
+    drain(active);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 60ms);
+    EXPECT_EQ(order, (std::vector<int>{2, 1}));
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, IoReactorTest, ::testing::Values(true, false),
+                         [](const auto& info) { return info.param ? "Uring" : "Threads"; });
+#endif
+
+} // namespace
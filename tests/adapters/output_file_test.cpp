@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include "adapters/fs.hpp"
+#include "adapters/output_file.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#ifndef _WIN32
+    #include <unistd.h>
+#endif
+
+namespace {
+
+namespace fs = std::filesystem;
+using namespace cclone::adapters::fs;
+
+auto read_all(const fs::path& path) -> std::string {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+auto entries(const fs::path& dir) -> std::size_t {
+    return static_cast<std::size_t>(std::distance(fs::directory_iterator(dir), fs::directory_iterator{}));
+}
+
+class OutputFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = fs::temp_directory_path() / "cclone_output_file_test";
+        fs::remove_all(dir_);
+        fs::create_directories(dir_);
+    }
+    void TearDown() override { fs::remove_all(dir_); }
+
+    fs::path dir_;
+};
+
+#ifndef _WIN32
+TEST_F(OutputFileTest, AtomicNameAppearsOnlyOnPublish)
+{
+    const auto dst = dir_ / "new";
+    auto out = OutputFile::open(dst, Publish::Atomic);
+    ASSERT_TRUE(out.has_value());
+    ASSERT_EQ(::write(out->fd(), "data", 4), 4);
+    EXPECT_FALSE(fs::exists(dst));
+
+    ASSERT_TRUE(out->publish().has_value());
+    EXPECT_EQ(read_all(dst), "data");
+    EXPECT_EQ(entries(dir_), 1u);
+}
+
+TEST_F(OutputFileTest, AtomicReplacesExistingFile)
+{
+    const auto dst = dir_ / "existing";
+    std::ofstream(dst) << "old contents";
+
+    auto out = OutputFile::open(dst, Publish::Atomic);
+    ASSERT_TRUE(out.has_value());
+    ASSERT_EQ(::write(out->fd(), "new", 3), 3);
+    EXPECT_EQ(read_all(dst), "old contents");
+
+    ASSERT_TRUE(out->publish().has_value());
+    EXPECT_EQ(read_all(dst), "new");
+    EXPECT_EQ(entries(dir_), 1u);
+}
+
+TEST_F(OutputFileTest, UnpublishedFileLeavesNothingBehind)
+{
+    const auto dst = dir_ / "existing";
+    std::ofstream(dst) << "old contents";
+    {
+        auto out = OutputFile::open(dst, Publish::Atomic);
+        ASSERT_TRUE(out.has_value());
+        ASSERT_EQ(::write(out->fd(), "partial", 7), 7);
+    }
+    EXPECT_EQ(read_all(dst), "old contents");
+    EXPECT_EQ(entries(dir_), 1u);
+}
+
+TEST_F(OutputFileTest, CopyFileAtomicOverwrites)
+{
+    std::ofstream(dir_ / "src", std::ios::binary) << std::string(100000, 'x');
+    std::ofstream(dir_ / "dst") << "stale";
+
+    for (auto strategy : {CopyStrategy::Buffered, CopyStrategy::MMap, CopyStrategy::DirectIO}) {
+        ASSERT_TRUE(copy_file(dir_ / "src", dir_ / "dst", strategy, {}, Publish::Atomic).has_value());
+        EXPECT_EQ(read_all(dir_ / "dst"), std::string(100000, 'x'));
+    }
+    EXPECT_EQ(entries(dir_), 2u);
+}
+#endif
+
+} // namespace
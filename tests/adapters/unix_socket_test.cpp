@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include "adapters/unix_socket.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <cstring>
+#include <fstream>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+namespace fs = std::filesystem;
+using namespace cclone::adapters::ipc;
+using namespace std::chrono_literals;
+
+TEST(UnixSocketTest, LinesRoundTrip)
+{
+    const auto path = fs::temp_directory_path() / "cclone_socket_test.sock";
+    fs::remove(path);
+    auto listener = UnixListener::bind(path);
+    ASSERT_TRUE(listener.has_value());
+
+    auto client = UnixStream::connect(path);
+    ASSERT_TRUE(client.has_value());
+    auto accepted = listener->accept(1000ms);
+    ASSERT_TRUE(accepted.has_value() && accepted->has_value());
+    auto& server = **accepted;
+
+    // Две строки одним сообщением разбираются по одной
+    ASSERT_TRUE(client->write_line("first").has_value());
+    ASSERT_TRUE(client->write_line("second").has_value());
+    EXPECT_EQ(*server.read_line(), "first");
+    EXPECT_EQ(*server.read_line(), "second");
+
+    ASSERT_TRUE(server.write_line(R"({"ok":true})").has_value());
+    EXPECT_EQ(*client->read_line(), R"({"ok":true})");
+
+    client->shutdown();
+    auto eof = server.read_line();
+    ASSERT_TRUE(eof.has_value());
+    EXPECT_FALSE(eof->has_value());
+}
+
+TEST(UnixSocketTest, AcceptTimesOutWithoutClients)
+{
+    const auto path = fs::temp_directory_path() / "cclone_socket_idle.sock";
+    auto listener = UnixListener::bind(path);
+    ASSERT_TRUE(listener.has_value());
+    auto accepted = listener->accept(10ms);
+    ASSERT_TRUE(accepted.has_value());
+    EXPECT_FALSE(accepted->has_value());
+}
+
+TEST(UnixSocketTest, StaleSocketIsReplacedLiveOneIsNot)
+{
+    const auto path = fs::temp_directory_path() / "cclone_socket_stale.sock";
+    fs::remove(path);
+    {
+        // Сокет завершившегося демона: файл есть, никто не слушает
+        const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        ASSERT_GE(fd, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        ASSERT_EQ(::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+        ::close(fd);
+    }
+    ASSERT_TRUE(fs::is_socket(path));
+
+    {
+        auto listener = UnixListener::bind(path);
+        ASSERT_TRUE(listener.has_value());
+        auto second = UnixListener::bind(path);
+        ASSERT_FALSE(second.has_value());
+        EXPECT_EQ(second.error().code, cclone::infra::ErrorCode::FileLocked);
+    }
+    EXPECT_FALSE(fs::exists(path));
+
+    auto missing = UnixStream::connect(path);
+    ASSERT_FALSE(missing.has_value());
+    EXPECT_EQ(missing.error().code, cclone::infra::ErrorCode::FileNotFound);
+}
+
+TEST(UnixSocketTest, BindDoesNotRemoveOtherFiles)
+{
+    const auto path = fs::temp_directory_path() / "cclone_socket_not_a_socket";
+    std::ofstream(path) << "not a socket";
+    auto listener = UnixListener::bind(path);
+    ASSERT_FALSE(listener.has_value());
+    EXPECT_EQ(listener.error().code, cclone::infra::ErrorCode::FileLocked);
+    EXPECT_TRUE(fs::is_regular_file(path));
+    fs::remove(path);
+}
+
+TEST(UnixSocketTest, PeerUidIsTheListeningProcess)
+{
+    const auto path = fs::temp_directory_path() / "cclone_socket_peer.sock";
+    fs::remove(path);
+    auto listener = UnixListener::bind(path);
+    ASSERT_TRUE(listener.has_value());
+    auto client = UnixStream::connect(path);
+    ASSERT_TRUE(client.has_value());
+    const auto uid = client->peer_uid();
+    ASSERT_TRUE(uid.has_value());
+    EXPECT_EQ(*uid, ::getuid());
+}
+
+} // namespace
@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+
+#include "core/copy_engine/copy_engine.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <fmt/core.h>
+
+namespace {
+
+namespace fs = std::filesystem;
+using cclone::core::CopyEngine;
+
+void write_file(const fs::path& path, const std::string& data)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+auto read_file(const fs::path& path) -> std::string
+{
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+// Относительный путь -> содержимое всех файлов дерева
+auto tree_contents(const fs::path& root) -> std::map<std::string, std::string>
+{
+    std::map<std::string, std::string> files;
+    for (const auto& entry : fs::recursive_directory_iterator(root)) {
+        if (entry.is_regular_file()) {
+            files[entry.path().lexically_relative(root).string()] = read_file(entry.path());
+        }
+    }
+    return files;
+}
+
+// Небольшое дерево: вложенные каталоги, пустой файл, файл больше буфера
+// и пара жёстких ссылок (под -H её копирование уходит из реактора в пул)
+void make_tree(const fs::path& src, char fill)
+{
+    fs::create_directories(src / "a" / "b");
+    for (int i = 0; i < 20; ++i) {
+        write_file(src / (i % 2 ? "a" : "a/b") / fmt::format("file{}.txt", i),
+                   std::string(static_cast<std::size_t>(i) * 1000 + 1, static_cast<char>(fill + i % 7)));
+    }
+    write_file(src / "empty.bin", {});
+    write_file(src / "large.bin", std::string(3 * 1024 * 1024 + 17, fill));
+    if (!fs::exists(src / "linked.bin")) {
+        write_file(src / "linked.bin", std::string(5000, fill));
+        fs::create_hard_link(src / "linked.bin", src / "a" / "linked_too.bin");
+    } else {
+        write_file(src / "linked.bin", std::string(5000, fill));
+    }
+}
+
+auto copy_config(cclone::infra::EngineBackend backend) -> cclone::infra::Config
+{
+    cclone::infra::Config config;
+    config.recursive = true;
+    config.progress = false;
+    config.quiet = true;
+    config.hard_links = true;
+    config.threads = 4;
+    config.engine = backend;
+    return config;
+}
+
+auto run_copy(const cclone::infra::Config& config, const fs::path& src, const fs::path& dst)
+    -> std::expected<cclone::core::CopyStatsSnapshot, cclone::infra::Error>
+{
+    cclone::infra::ProgressMonitor monitor(false, true);
+    CopyEngine engine(config, monitor);
+    return engine.run({src}, dst);
+}
+
+// Владелец крупного файла под --resume берёт бюджет на каждую задачу чанков,
+// урезанный здесь до всего --max-memory. Задание встаёт, если бюджет держат
+// ссылки, ждущие этого владельца, или уже завершённые задачи чанков
+TEST(CopyEngineTest, HardLinksWaitForOriginWithoutMemoryBudget)
+{
+    const auto dir = fs::temp_directory_path() / "cclone_copy_engine_budget_test";
+    fs::remove_all(dir);
+    const auto src = dir / "src";
+    fs::create_directories(src);
+
+    // Больше CHUNKED_THRESHOLD (100MB): с журналом копируется чанками
+    const auto big = src / "big.bin";
+    std::ofstream(big, std::ios::binary) << "head";
+    fs::resize_file(big, 101'000'000);
+    for (int i = 0; i < 3; ++i) {
+        fs::create_hard_link(big, src / fmt::format("big_link{}.bin", i));
+    }
+    for (int i = 0; i < 8; ++i) {
+        const auto small = src / fmt::format("small{}.bin", i);
+        std::ofstream(small, std::ios::binary) << std::string(64 * 1024, static_cast<char>('a' + i));
+        for (int j = 0; j < 3; ++j) {
+            fs::create_hard_link(small, src / fmt::format("small{}_link{}.bin", i, j));
+        }
+    }
+
+    cclone::infra::Config config;
+    config.recursive = true;
+    config.progress = false;
+    config.quiet = true;
+    config.resume = true;
+    config.hard_links = true;
+    config.threads = 4;
+    config.buffer_size = 1024 * 1024;
+    config.max_memory = 1024 * 1024;
+
+    cclone::infra::ProgressMonitor monitor(false, true);
+    CopyEngine engine(config, monitor);
+    const auto stats = engine.run({src}, dir / "dst");
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->errors, 0u);
+    EXPECT_EQ(stats->hardlinks, 3u + 8u * 3u);
+    EXPECT_EQ(fs::file_size(dir / "dst" / "big.bin"), 101'000'000u);
+    EXPECT_EQ(fs::hard_link_count(dir / "dst" / "big.bin"), 4u);
+
+    fs::remove_all(dir);
+}
+
+TEST(CopyEngineTest, IncrementalRerunSkipsUnchangedFiles)
+{
+    const auto dir = fs::temp_directory_path() / "cclone_copy_engine_incremental_test";
+    fs::remove_all(dir);
+    const auto src = dir / "src";
+    const auto dst = dir / "dst";
+    make_tree(src, 'a');
+    const auto files = tree_contents(src).size();
+
+    auto config = copy_config(cclone::infra::EngineBackend::Threads);
+    config.incremental = true;
+    const auto first = run_copy(config, src, dst);
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->errors, 0u);
+    EXPECT_EQ(first->files_skipped, 0u);
+
+    // Файлы назначения после первого прогона: второй не должен их переписать
+    std::map<std::string, fs::file_time_type> mtimes;
+    for (const auto& [relative, content] : tree_contents(src)) {
+        mtimes[relative] = fs::last_write_time(dst / relative);
+    }
+
+    const auto second = run_copy(config, src, dst);
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(second->errors, 0u);
+    EXPECT_EQ(second->files_copied, 0u);
+    EXPECT_EQ(second->files_skipped, files);
+    EXPECT_EQ(second->bytes_written, 0u);
+
+    // Назначение не трогается: ни stat, ни open по его файлам. Остаются
+    // stat сканирования источника (файлы, каталоги, корень) и индекс
+    const auto calls = [&](cclone::infra::sys::Syscall call) {
+        return second->syscalls.calls[static_cast<std::size_t>(call)];
+    };
+    const auto source_entries = static_cast<std::uint64_t>(
+        std::distance(fs::recursive_directory_iterator(src), fs::recursive_directory_iterator{})) + 1;
+    EXPECT_LE(calls(cclone::infra::sys::Syscall::Stat), source_entries);
+    EXPECT_LE(calls(cclone::infra::sys::Syscall::Open), 2u);
+    EXPECT_EQ(calls(cclone::infra::sys::Syscall::Write) + calls(cclone::infra::sys::Syscall::Pwrite), 0u);
+    for (const auto& [relative, mtime] : mtimes) {
+        EXPECT_EQ(fs::last_write_time(dst / relative), mtime) << relative;
+    }
+
+    fs::remove_all(dir);
+}
+
+// Движок на сопрограммах копирует то же, что и на потоках: файлы реактора,
+// файлы, отданные в блокирующий пул, замену существующих и --atomic
+TEST(CopyEngineTest, AsyncEngineMatchesThreads)
+{
+    const auto dir = fs::temp_directory_path() / "cclone_copy_engine_async_test";
+    fs::remove_all(dir);
+    const auto src = dir / "src";
+    make_tree(src, 'a');
+
+    const auto threaded = run_copy(copy_config(cclone::infra::EngineBackend::Threads), src, dir / "threads");
+    ASSERT_TRUE(threaded.has_value());
+    EXPECT_EQ(threaded->errors, 0u);
+
+    const auto async_config = copy_config(cclone::infra::EngineBackend::Async);
+    const auto async = run_copy(async_config, src, dir / "async");
+    ASSERT_TRUE(async.has_value());
+    EXPECT_EQ(async->errors, 0u);
+    EXPECT_EQ(async->files_copied, threaded->files_copied);
+    EXPECT_EQ(async->bytes_copied, threaded->bytes_copied);
+    EXPECT_EQ(async->hardlinks, 1u);
+    EXPECT_EQ(tree_contents(dir / "async"), tree_contents(dir / "threads"));
+    EXPECT_EQ(fs::hard_link_count(dir / "async" / "linked.bin"), 2u);
+    // Файлы действительно шли через реактор, а не через запасной путь на потоке
+    EXPECT_TRUE(std::ranges::any_of(async->latency, [](const auto& row) { return row.label.starts_with("async"); }));
+
+    // Назначение уже есть: O_EXCL не проходит, файлы удаляются и пишутся заново
+    make_tree(src, 'k');
+    const auto replaced = run_copy(async_config, src, dir / "async");
+    ASSERT_TRUE(replaced.has_value());
+    EXPECT_EQ(replaced->errors, 0u);
+    EXPECT_EQ(tree_contents(dir / "async"), tree_contents(src));
+
+    // --atomic: старый inode не меняется, новый файл заменяет его целиком
+    fs::create_hard_link(dir / "async" / "large.bin", dir / "old_large.bin");
+    const auto before = read_file(dir / "old_large.bin");
+    make_tree(src, 'u');
+    auto atomic_config = async_config;
+    atomic_config.atomic = true;
+    const auto atomic = run_copy(atomic_config, src, dir / "async");
+    ASSERT_TRUE(atomic.has_value());
+    EXPECT_EQ(atomic->errors, 0u);
+    EXPECT_EQ(tree_contents(dir / "async"), tree_contents(src));
+    EXPECT_EQ(read_file(dir / "old_large.bin"), before);
+
+    fs::remove_all(dir);
+}
+
+} // namespace
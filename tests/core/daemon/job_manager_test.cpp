@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include "core/daemon/job_manager.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <fmt/core.h>
+
+namespace {
+
+namespace fs = std::filesystem;
+using cclone::core::JobManager;
+using cclone::core::JobSpec;
+using cclone::core::JobState;
+
+auto make_tree(const fs::path& root, int files) -> void {
+    fs::create_directories(root / "sub");
+    for (int i = 0; i < files; ++i) {
+        std::ofstream(root / (i % 2 ? "sub" : "") / fmt::format("f{}.bin", i), std::ios::binary)
+            << std::string(1000 + i, static_cast<char>('a' + i % 26));
+    }
+}
+
+auto count_files(const fs::path& root) -> int {
+    int count = 0;
+    for (const auto& entry : fs::recursive_directory_iterator(root)) count += entry.is_regular_file();
+    return count;
+}
+
+auto spec_for(const fs::path& source, const fs::path& destination) -> JobSpec {
+    JobSpec spec{.sources = {source}, .destination = destination};
+    spec.config.recursive = true;
+    spec.config.progress = false;
+    return spec;
+}
+
+TEST(JobManagerTest, ConcurrentJobsCopyTheirTrees)
+{
+    const auto dir = fs::temp_directory_path() / "cclone_job_manager_test";
+    fs::remove_all(dir);
+    make_tree(dir / "a", 20);
+    make_tree(dir / "b", 30);
+
+    JobManager jobs({.threads = 2, .max_running = 2});
+    auto first = jobs.submit(spec_for(dir / "a", dir / "out_a"));
+    auto second = jobs.submit(spec_for(dir / "b", dir / "out_b"));
+    ASSERT_TRUE(first.has_value());
+    ASSERT_TRUE(second.has_value());
+    EXPECT_NE(*first, *second);
+
+    const auto a = jobs.wait(*first);
+    const auto b = jobs.wait(*second);
+    ASSERT_TRUE(a && b);
+    EXPECT_EQ(a->state, JobState::Done);
+    EXPECT_EQ(b->state, JobState::Done);
+    EXPECT_EQ(a->stats.files_copied, 20u);
+    EXPECT_EQ(b->stats.files_copied, 30u);
+    EXPECT_EQ(b->files_total, 30u);
+    EXPECT_EQ(b->files_done, 30u);
+    EXPECT_EQ(count_files(dir / "out_a"), 20);
+    EXPECT_EQ(count_files(dir / "out_b"), 30);
+    EXPECT_EQ(jobs.list().size(), 2u);
+
+    fs::remove_all(dir);
+}
+
+TEST(JobManagerTest, MissingSourceIsRejected)
+{
+    JobManager jobs({.threads = 1, .max_running = 1});
+    const auto missing = fs::temp_directory_path() / "cclone_job_manager_missing";
+    auto id = jobs.submit(spec_for(missing, missing.string() + "_out"));
+    ASSERT_FALSE(id.has_value());
+    EXPECT_EQ(id.error().code, cclone::infra::ErrorCode::FileNotFound);
+    EXPECT_TRUE(jobs.list().empty());
+}
+
+// Единственное место занято первым заданием: второе ждёт и снимается, не начавшись
+TEST(JobManagerTest, QueuedJobIsCancelledBeforeItRuns)
+{
+    const auto dir = fs::temp_directory_path() / "cclone_job_manager_cancel";
+    fs::remove_all(dir);
+    make_tree(dir / "src", 200);
+
+    JobManager jobs({.threads = 1, .max_running = 1});
+    auto running = jobs.submit(spec_for(dir / "src", dir / "out_1"));
+    auto queued = jobs.submit(spec_for(dir / "src", dir / "out_2"));
+    ASSERT_TRUE(running && queued);
+
+    EXPECT_TRUE(jobs.cancel(*queued));
+    const auto cancelled = jobs.wait(*queued);
+    ASSERT_TRUE(cancelled.has_value());
+    EXPECT_EQ(cancelled->state, JobState::Cancelled);
+    EXPECT_FALSE(jobs.cancel(*queued));
+    EXPECT_FALSE(fs::exists(dir / "out_2"));
+
+    EXPECT_EQ(jobs.wait(*running)->state, JobState::Done);
+    EXPECT_FALSE(jobs.status(12345).has_value());
+
+    fs::remove_all(dir);
+}
+
+} // namespace
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include "extensions/dedup.hpp"
+#include "extensions/origin_registry.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+namespace fs = std::filesystem;
+using namespace cclone::extensions;
+
+void write_file(const fs::path& path, const std::string& data)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+TEST(DedupTest, PrefilterAndContentKey)
+{
+    const auto dir = fs::temp_directory_path() / "cclone_dedup_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    std::string data(64 * 1024, 'a');
+    write_file(dir / "a", data);
+    write_file(dir / "b", data);
+    data[32 * 1024] = 'b'; // середина: предфильтр не видит, полный ключ видит
+    write_file(dir / "c", data);
+
+    const auto size = data.size();
+    EXPECT_EQ(*head_tail_digest(dir / "a", size), *head_tail_digest(dir / "c", size));
+    EXPECT_EQ(*content_key(dir / "a", size), *content_key(dir / "b", size));
+    EXPECT_NE(*content_key(dir / "a", size), *content_key(dir / "c", size));
+
+    ASSERT_TRUE(link_file(dir / "a", dir / "link", cclone::infra::DedupPolicy::Hardlink).has_value());
+    EXPECT_TRUE(fs::equivalent(dir / "a", dir / "link"));
+
+    fs::remove_all(dir);
+}
+
+TEST(DedupTest, RegistryElectsSingleOwner)
+{
+    OriginRegistry<ContentKey, ContentKeyHash> registry;
+    const ContentKey key{.size = 10, .low = 1, .high = 2};
+
+    std::atomic<int> owners{0};
+    std::atomic<int> linked{0};
+    std::vector<std::jthread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&] {
+            auto claim = registry.claim(key);
+            if (claim.owner) {
+                owners.fetch_add(1);
+                registry.publish(key, fs::path("origin"));
+            } else if (claim.origin.get() == fs::path("origin")) {
+                linked.fetch_add(1);
+            }
+        });
+    }
+    threads.clear();
+
+    EXPECT_EQ(owners.load(), 1);
+    EXPECT_EQ(linked.load(), 7);
+    EXPECT_EQ(registry.size(), 1u);
+}
+
+} // namespace
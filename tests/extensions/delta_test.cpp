@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+
+#include "extensions/delta.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+
+namespace {
+
+namespace fs = std::filesystem;
+using cclone::extensions::DeltaCopier;
+
+void write_file(const fs::path& path, const std::string& data)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+auto read_file(const fs::path& path) -> std::string
+{
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+auto make_data(std::size_t size) -> std::string
+{
+    std::string data(size, '\0');
+    for (std::size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<char>((i * 131) ^ (i >> 7));
+    }
+    return data;
+}
+
+// Без периодичности make_data: блоки не повторяют друг друга
+auto make_random(std::size_t size) -> std::string
+{
+    std::mt19937_64 rng(42);
+    std::string data(size, '\0');
+    for (auto& c : data) c = static_cast<char>(rng());
+    return data;
+}
+
+TEST(DeltaCopierTest, WritesOnlyChangedBlocks)
+{
+    const auto dir = fs::temp_directory_path() / "cclone_delta_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const auto src = dir / "src.bin";
+    const auto dst = dir / "dst.bin";
+
+    constexpr std::uint64_t block = 4096;
+    auto data = make_data(block * 16 + 100);
+    write_file(dst, data);
+    data[block * 3 + 5] ^= 0x5a;
+    data[block * 10] ^= 0x5a;
+    write_file(src, data);
+
+    cclone::infra::ThreadPool pool{2};
+    DeltaCopier delta(pool, dir, block, /*use_cache=*/true);
+
+    auto result = delta.copy(src, dst);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->blocks_total, 17u);
+    EXPECT_EQ(result->blocks_changed, 2u);
+    EXPECT_EQ(result->bytes_written, 2 * block);
+    EXPECT_FALSE(result->cache_hit);
+    EXPECT_EQ(read_file(dst), data);
+
+    // Второй проход с кэшем: назначение не читается и ничего не пишется
+    ASSERT_TRUE(delta.store_cache(dst, result->block_signatures).has_value());
+    auto again = delta.copy(src, dst);
+    ASSERT_TRUE(again.has_value());
+    EXPECT_TRUE(again->cache_hit);
+    EXPECT_EQ(again->bytes_written, 0u);
+
+    fs::remove_all(dir);
+}
+
+TEST(DeltaCopierTest, MatchesShiftedBlocks)
+{
+    const auto dir = fs::temp_directory_path() / "cclone_delta_shift_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const auto src = dir / "src.bin";
+    const auto dst = dir / "dst.bin";
+
+    constexpr std::uint64_t block = 4096;
+    const auto old = make_random(block * 16 + 100);
+    write_file(dst, old);
+    // Вставка в третий блок сдвигает всё после неё на 10 байт
+    auto data = old;
+    data.insert(block * 2 + 17, "0123456789");
+    write_file(src, data);
+
+    cclone::infra::ThreadPool pool{2};
+    DeltaCopier delta(pool, dir, block, /*use_cache=*/true);
+
+    auto result = delta.copy(src, dst);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(read_file(dst), data);
+    EXPECT_TRUE(result->replaced);
+    EXPECT_EQ(result->blocks_changed, 15u);
+    // Блоки 3..15 назначения найдены со сдвигом; из источника — только
+    // блок со вставкой и хвост (плюс блоки 0..1, если ФС не умеет клонировать)
+    EXPECT_EQ(result->bytes_moved, 13 * block);
+    EXPECT_LT(result->bytes_written - result->bytes_moved, 4 * block);
+
+    // Подписи итогового файла годятся для кэша, как и при записи на месте
+    ASSERT_TRUE(delta.store_cache(dst, result->block_signatures).has_value());
+    auto again = delta.copy(src, dst);
+    ASSERT_TRUE(again.has_value());
+    EXPECT_TRUE(again->cache_hit);
+    EXPECT_FALSE(again->replaced);
+    EXPECT_EQ(again->bytes_written, 0u);
+
+    fs::remove_all(dir);
+}
+
+TEST(DeltaCopierTest, AtomicPublishLeavesOldFileIntact)
+{
+    const auto dir = fs::temp_directory_path() / "cclone_delta_atomic_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const auto src = dir / "src.bin";
+    const auto dst = dir / "dst.bin";
+    const auto old_name = dir / "old.bin";
+
+    constexpr std::uint64_t block = 4096;
+    const auto old = make_random(block * 8);
+    write_file(dst, old);
+    // Вторая ссылка на старый inode: правка на месте была бы видна и через неё
+    fs::create_hard_link(dst, old_name);
+    auto data = old;
+    data[block * 5] ^= 0x5a;
+    write_file(src, data);
+
+    cclone::infra::ThreadPool pool{2};
+    DeltaCopier delta(pool, dir, block);
+
+    auto result = delta.copy(src, dst, cclone::adapters::fs::Publish::Atomic);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_TRUE(result->replaced);
+    EXPECT_EQ(result->blocks_changed, 1u);
+    EXPECT_EQ(read_file(dst), data);
+    EXPECT_EQ(read_file(old_name), old);
+    EXPECT_FALSE(fs::equivalent(dst, old_name));
+
+    // Без изменений заменять нечего
+    auto again = delta.copy(src, dst, cclone::adapters::fs::Publish::Atomic);
+    ASSERT_TRUE(again.has_value());
+    EXPECT_FALSE(again->replaced);
+    EXPECT_EQ(again->bytes_written, 0u);
+
+    fs::remove_all(dir);
+}
+
+TEST(DeltaCopierTest, RejectsCacheWithWrongBlockCount)
+{
+    const auto dir = fs::temp_directory_path() / "cclone_delta_cache_count_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const auto src = dir / "src.bin";
+    const auto dst = dir / "dst.bin";
+
+    constexpr std::uint64_t block = 4096;
+    auto data = make_data(block * 4);
+    write_file(dst, data);
+    data[block * 2] ^= 0x5a;
+    write_file(src, data);
+
+    cclone::infra::ThreadPool pool{2};
+    DeltaCopier delta(pool, dir, block, /*use_cache=*/true);
+    const auto first = delta.copy(src, dst);
+    ASSERT_TRUE(first.has_value());
+    ASSERT_TRUE(delta.store_cache(dst, first->block_signatures).has_value());
+
+    // Счётчик хешей в заголовке (последнее поле) испорчен: кэш отвергается
+    // и назначение читается заново
+    const auto cache = *fs::directory_iterator(dir / DeltaCopier::CACHE_DIR);
+    {
+        std::fstream io(cache.path(), std::ios::binary | std::ios::in | std::ios::out);
+        io.seekp(40);
+        const std::uint64_t huge = 1ull << 60;
+        io.write(reinterpret_cast<const char*>(&huge), sizeof(huge));
+    }
+    const auto again = delta.copy(src, dst);
+    ASSERT_TRUE(again.has_value());
+    EXPECT_FALSE(again->cache_hit);
+    EXPECT_EQ(again->bytes_written, 0u);
+
+    fs::remove_all(dir);
+}
+
+TEST(DeltaCopierTest, ResizesDestination)
+{
+    const auto dir = fs::temp_directory_path() / "cclone_delta_resize_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const auto src = dir / "src.bin";
+    const auto dst = dir / "dst.bin";
+
+    constexpr std::uint64_t block = 4096;
+    const auto data = make_data(block * 8);
+    write_file(dst, data + make_data(block * 3));
+    write_file(src, data);
+
+    cclone::infra::ThreadPool pool{2};
+    DeltaCopier delta(pool, dir, block);
+
+    auto shrunk = delta.copy(src, dst);
+    ASSERT_TRUE(shrunk.has_value());
+    EXPECT_EQ(shrunk->bytes_written, 0u);
+    EXPECT_EQ(read_file(dst), data);
+
+    const auto longer = data + std::string(1000, 'x');
+    write_file(src, longer);
+    auto grown = delta.copy(src, dst);
+    ASSERT_TRUE(grown.has_value());
+    EXPECT_EQ(grown->bytes_written, 1000u);
+    EXPECT_EQ(read_file(dst), longer);
+
+    fs::remove_all(dir);
+}
+
+} // namespace
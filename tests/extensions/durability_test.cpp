@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include "adapters/fs.hpp"
+#include "extensions/durability.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+
+namespace fs = std::filesystem;
+using namespace cclone;
+
+#ifndef _WIN32
+class DurabilityTest : public ::testing::TestWithParam<infra::Durability> {};
+
+TEST_P(DurabilityTest, SyncsEveryWrittenFile)
+{
+    const auto dir = fs::temp_directory_path() / "cclone_durability_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "src");
+    fs::create_directories(dir / "dst" / "sub");
+
+    auto tracker = extensions::DurabilityTracker::create(GetParam(), dir / "dst");
+    ASSERT_TRUE(tracker.has_value());
+    (*tracker)->directory_created(dir / "dst" / "sub");
+
+    // Больше одного окна, чтобы batch прошёл и по порогу, и по остановке
+    const std::size_t files = extensions::DurabilityTracker::BATCH_FILES + 7;
+    for (std::size_t i = 0; i < files; ++i) {
+        const auto src = dir / "src" / std::to_string(i);
+        const auto dst = dir / "dst" / "sub" / std::to_string(i);
+        std::ofstream(src, std::ios::binary) << std::string(1000 + i, 'd');
+        auto copied = adapters::fs::copy_file_buffered(src, dst, [&](int, int dst_fd) {
+            return (*tracker)->file_written(dst_fd, dst);
+        });
+        ASSERT_TRUE(copied.has_value());
+    }
+    ASSERT_TRUE((*tracker)->file_written(dir / "dst" / "sub" / "0").has_value());
+    ASSERT_TRUE((*tracker)->finish().has_value());
+
+    const auto stats = (*tracker)->stats();
+    switch (GetParam()) {
+    case infra::Durability::File:
+    case infra::Durability::Batch:
+        EXPECT_EQ(stats.files, files + 1);
+        EXPECT_GE(stats.directories, 1u);
+        EXPECT_EQ(stats.filesystems, 0u);
+        break;
+    case infra::Durability::End:
+        EXPECT_EQ(stats.files, 0u);
+        EXPECT_EQ(stats.filesystems, 1u); // sub на той же ФС, что и корень
+        break;
+    case infra::Durability::None:
+        break;
+    }
+    if (GetParam() == infra::Durability::Batch) {
+        EXPECT_GE(stats.batches, 1u);
+    }
+
+    fs::remove_all(dir);
+}
+
+INSTANTIATE_TEST_SUITE_P(Modes, DurabilityTest,
+                         ::testing::Values(infra::Durability::File,
+                                           infra::Durability::Batch,
+                                           infra::Durability::End));
+#endif
+
+} // namespace
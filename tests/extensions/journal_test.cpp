@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include "extensions/journal.hpp"
+#include "infra/syscall/syscalls.hpp"
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+namespace fs = std::filesystem;
+using cclone::extensions::JobJournal;
+namespace sys = cclone::infra::sys;
+
+void write_file(const fs::path& path, const std::string& content) {
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+}
+
+// Запись, лежащая в файле журнала сразу за заголовком (16 байт)
+auto first_record_type(const fs::path& journal) -> std::uint32_t {
+    std::ifstream in(journal, std::ios::binary);
+    in.seekg(16);
+    std::uint32_t type = 0;
+    in.read(reinterpret_cast<char*>(&type), sizeof(type));
+    return type;
+}
+
+TEST(JobJournalTest, ReplaysFilesAndChunks)
+{
+    const auto dir = fs::temp_directory_path() / "cclone_journal_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const auto path = dir / JobJournal::FILE_NAME;
+    const auto data = dir / "data.bin";
+    write_file(data, "payload");
+
+    {
+        auto journal = JobJournal::open(path);
+        ASSERT_TRUE(journal.has_value());
+
+        std::vector<std::jthread> threads;
+        for (std::uint64_t t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t] {
+                for (std::uint64_t i = 0; i < 10'000; ++i) {
+                    (*journal)->file_done(t * 100'000 + i, i, 1000, data);
+                }
+            });
+        }
+        threads.clear();
+
+        (*journal)->file_begin(7, 10'000, 42, 4096, data);
+        (*journal)->chunk_done(7, 10'000, 42, 0, data);
+        (*journal)->chunk_done(7, 10'000, 42, 2, data);
+        ASSERT_TRUE((*journal)->commit().has_value());
+    }
+
+    auto journal = JobJournal::open(path);
+    ASSERT_TRUE(journal.has_value());
+    EXPECT_TRUE((*journal)->is_complete(300'000 + 9'999, 9'999, 1000));
+    EXPECT_FALSE((*journal)->is_complete(5, 5, 1001)); // источник изменился
+
+    const auto chunks = (*journal)->completed_chunks(7, 10'000, 42, 4096);
+    ASSERT_EQ(chunks.size(), 3u);
+    EXPECT_TRUE(chunks[0]);
+    EXPECT_FALSE(chunks[1]);
+    EXPECT_TRUE(chunks[2]);
+    EXPECT_TRUE((*journal)->completed_chunks(7, 10'000, 42, 8192).empty());
+
+    ASSERT_TRUE((*journal)->discard().has_value());
+    EXPECT_FALSE(fs::exists(path));
+    fs::remove_all(dir);
+}
+
+TEST(JobJournalTest, DropsTornTail)
+{
+    const auto dir = fs::temp_directory_path() / "cclone_journal_torn_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const auto path = dir / JobJournal::FILE_NAME;
+    const auto data = dir / "data.bin";
+    write_file(data, "payload");
+
+    {
+        auto journal = JobJournal::open(path);
+        ASSERT_TRUE(journal.has_value());
+        (*journal)->file_done(1, 10, 10, data);
+        (*journal)->file_done(2, 20, 20, data);
+    }
+
+    // Портим вторую запись (header 16 байт + запись 40 байт)
+    {
+        std::fstream f(path, std::ios::binary | std::ios::in | std::ios::out);
+        f.seekp(16 + 40 + 20);
+        f.put('\x7f');
+    }
+
+    auto journal = JobJournal::open(path);
+    ASSERT_TRUE(journal.has_value());
+    EXPECT_TRUE((*journal)->is_complete(1, 10, 10));
+    EXPECT_FALSE((*journal)->is_complete(2, 20, 20));
+
+    fs::remove_all(dir);
+}
+
+TEST(JobJournalTest, RecordsReachDiskOnlyAfterTheirData)
+{
+    const auto dir = fs::temp_directory_path() / "cclone_journal_order_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const auto path = dir / JobJournal::FILE_NAME;
+    const auto data = dir / "data.bin";
+    write_file(data, "payload");
+
+    {
+        // Фоновая фиксация не успеет сработать: фиксируем руками
+        auto journal = JobJournal::open(path, std::chrono::hours(1));
+        ASSERT_TRUE(journal.has_value());
+
+        (*journal)->file_done(1, 7, 100, data);
+        (*journal)->file_done(2, 7, 100, dir / "missing.bin");
+        // До сброса данных запись не должна попасть даже в page cache журнала
+        EXPECT_EQ(first_record_type(path), 0u);
+
+        const auto before = sys::snapshot();
+        ASSERT_TRUE((*journal)->commit().has_value());
+        const auto calls = sys::snapshot() - before;
+
+        // fdatasync данных, fsync их каталога, затем fdatasync журнала
+        EXPECT_EQ(calls.calls[static_cast<std::size_t>(sys::Syscall::Fdatasync)], 2u);
+        EXPECT_EQ(calls.calls[static_cast<std::size_t>(sys::Syscall::Fsync)], 1u);
+        EXPECT_NE(first_record_type(path), 0u);
+    }
+
+    // Запись о файле, данные которого не удалось сбросить, отброшена
+    auto journal = JobJournal::open(path);
+    ASSERT_TRUE(journal.has_value());
+    EXPECT_TRUE((*journal)->is_complete(1, 7, 100));
+    EXPECT_FALSE((*journal)->is_complete(2, 7, 100));
+
+    fs::remove_all(dir);
+}
+
+TEST(JobJournalTest, ManyFilesShareOneSyncfs)
+{
+    const auto dir = fs::temp_directory_path() / "cclone_journal_syncfs_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const auto path = dir / JobJournal::FILE_NAME;
+
+    auto journal = JobJournal::open(path, std::chrono::hours(1));
+    ASSERT_TRUE(journal.has_value());
+    for (std::uint64_t i = 0; i < JobJournal::SYNCFS_FILES; ++i) {
+        const auto data = dir / ("data" + std::to_string(i));
+        write_file(data, "payload");
+        (*journal)->file_done(i, 7, 100, data);
+    }
+
+    const auto before = sys::snapshot();
+    ASSERT_TRUE((*journal)->commit().has_value());
+    const auto calls = sys::snapshot() - before;
+
+#ifdef __linux__
+    EXPECT_EQ(calls.calls[static_cast<std::size_t>(sys::Syscall::Syncfs)], 1u);
+    EXPECT_EQ(calls.calls[static_cast<std::size_t>(sys::Syscall::Fdatasync)], 1u); // только журнал
+#endif
+
+    fs::remove_all(dir);
+}
+
+} // namespace
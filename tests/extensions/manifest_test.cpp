@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include "extensions/manifest.hpp"
+#include "infra/hash/xxhash_verifier.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+TEST(ManifestTest, ConcurrentAppendRoundTrip)
+{
+    const auto dir = fs::temp_directory_path() / "cclone_manifest_test";
+    fs::create_directories(dir);
+    const auto manifest_path = dir / "manifest.bin";
+
+    {
+        auto writer = cclone::extensions::ManifestWriter::create(manifest_path);
+        ASSERT_TRUE(writer.has_value());
+
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < 250; ++i) {
+                    (*writer)->append({.path = fmt::format("dir{}/file{}.bin", t, i),
+                                       .size = static_cast<std::uint64_t>(i),
+                                       .mtime_ns = 1000 + i,
+                                       .hash = static_cast<std::uint64_t>(t * 1000 + i),
+                                       .segment_size = 0});
+                }
+            });
+        }
+        threads.clear();
+        ASSERT_TRUE((*writer)->close().has_value());
+        EXPECT_EQ((*writer)->entry_count(), 1000u);
+    }
+
+    auto entries = cclone::extensions::load_manifest(manifest_path);
+    ASSERT_TRUE(entries.has_value());
+    ASSERT_EQ(entries->size(), 1000u);
+
+    std::ostringstream text;
+    cclone::extensions::export_manifest_text(*entries, text);
+    EXPECT_NE(text.str().find("dir3/file249.bin"), std::string::npos);
+
+    fs::remove_all(dir);
+}
+
+TEST(ManifestTest, CheckDetectsMissingAndModifiedFiles)
+{
+    const auto dir = fs::temp_directory_path() / "cclone_manifest_check_test";
+    const auto root = dir / "dst";
+    fs::create_directories(root);
+    const auto manifest_path = dir / "manifest.bin";
+
+    auto write = [&](const std::string& name, const std::string& data) {
+        std::ofstream(root / name, std::ios::binary) << data;
+    };
+    write("a.txt", "alpha");
+    write("b.txt", "bravo");
+
+    {
+        auto writer = cclone::extensions::ManifestWriter::create(manifest_path);
+        ASSERT_TRUE(writer.has_value());
+        for (const auto* name : {"a.txt", "b.txt"}) {
+            auto hash = cclone::infra::XXHashVerifier::hash_file(root / name);
+            ASSERT_TRUE(hash.has_value());
+            auto entry = cclone::extensions::make_manifest_entry(name, root / name, *hash, 0);
+            ASSERT_TRUE(entry.has_value());
+            (*writer)->append(std::move(*entry));
+        }
+        ASSERT_TRUE((*writer)->close().has_value());
+    }
+
+    auto clean = cclone::extensions::check_manifest(manifest_path, root, 2);
+    ASSERT_TRUE(clean.has_value());
+    EXPECT_EQ(clean->files_ok, 2u);
+
+    write("a.txt", "alphx");
+    fs::remove(root / "b.txt");
+    auto dirty = cclone::extensions::check_manifest(manifest_path, root, 2);
+    ASSERT_TRUE(dirty.has_value());
+    EXPECT_EQ(dirty->files_ok, 0u);
+    EXPECT_EQ(dirty->files_mismatched, 1u);
+    EXPECT_EQ(dirty->files_missing, 1u);
+
+    fs::remove_all(dir);
+}
+
+} // namespace
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include "adapters/file_stat.hpp"
+#include "adapters/fs.hpp"
+#include "extensions/metadata.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#ifdef __linux__
+    #include <sys/xattr.h>
+#endif
+
+namespace {
+
+namespace fs = std::filesystem;
+using namespace cclone;
+
+#ifndef _WIN32
+TEST(MetadataTest, AppliedThroughDescriptorHook)
+{
+    const auto dir = fs::temp_directory_path() / "cclone_metadata_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const auto src = dir / "src";
+    const auto dst = dir / "dst";
+
+    std::ofstream(src, std::ios::binary) << std::string(10000, 'x');
+    fs::permissions(src, fs::perms::owner_read | fs::perms::owner_write | fs::perms::group_read);
+    fs::last_write_time(src, fs::file_time_type::clock::now() - std::chrono::hours(48));
+#ifdef __linux__
+    const bool has_xattr = ::setxattr(src.c_str(), "user.cclone", "v1", 2, 0) == 0;
+#endif
+
+    auto stat = adapters::fs::stat_file(src);
+    ASSERT_TRUE(stat.has_value());
+
+    bool called = false;
+    auto copied = adapters::fs::copy_file(src, dst, adapters::fs::CopyStrategy::Buffered,
+        [&](int src_fd, int dst_fd) {
+            called = true;
+            return extensions::apply_metadata(src_fd, dst_fd, *stat);
+        });
+    ASSERT_TRUE(copied.has_value());
+    EXPECT_TRUE(called);
+
+    auto copied_stat = adapters::fs::stat_file(dst);
+    ASSERT_TRUE(copied_stat.has_value());
+    EXPECT_EQ(copied_stat->size, stat->size);
+    EXPECT_EQ(copied_stat->mtime_ns, stat->mtime_ns);
+    EXPECT_EQ(copied_stat->mode & 07777, stat->mode & 07777);
+
+#ifdef __linux__
+    if (has_xattr) {
+        char value[8] = {};
+        EXPECT_EQ(::getxattr(dst.c_str(), "user.cclone", value, sizeof(value)), 2);
+        EXPECT_EQ(std::string(value, 2), "v1");
+    }
+#endif
+
+    fs::remove_all(dir);
+}
+#endif
+
+} // namespace
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include "extensions/sync_index.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+namespace fs = std::filesystem;
+using cclone::extensions::SyncIndex;
+using cclone::extensions::SyncIndexBuilder;
+
+TEST(SyncIndexTest, MissingFileIsEmptyIndex)
+{
+    const auto path = fs::temp_directory_path() / "cclone_sync_index_missing" / ".cclone.index";
+    auto index = SyncIndex::load(path);
+    ASSERT_TRUE(index.has_value());
+    EXPECT_EQ(index->size(), 0u);
+    EXPECT_EQ(index->lookup(SyncIndex::path_hash("a.txt")), nullptr);
+}
+
+TEST(SyncIndexTest, SaveAndLookupRoundTrip)
+{
+    const auto dir = fs::temp_directory_path() / "cclone_sync_index_test";
+    fs::create_directories(dir);
+    const auto path = dir / SyncIndex::FILE_NAME;
+
+    SyncIndexBuilder builder;
+    for (int i = 0; i < 100; ++i) {
+        builder.record({.path_hash = SyncIndex::path_hash(fs::path("dir") / std::to_string(i)),
+                        .size = static_cast<std::uint64_t>(i),
+                        .mtime_ns = 1000 + i,
+                        .inode = static_cast<std::uint64_t>(i + 1),
+                        .content_hash = 0});
+    }
+    ASSERT_TRUE(builder.save(path).has_value());
+
+    auto index = SyncIndex::load(path);
+    ASSERT_TRUE(index.has_value());
+    ASSERT_EQ(index->size(), 100u);
+
+    const auto* entry = index->lookup(SyncIndex::path_hash(fs::path("dir") / "42"));
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->size, 42u);
+    EXPECT_EQ(entry->mtime_ns, 1042);
+    EXPECT_EQ(entry->inode, 43u);
+    EXPECT_EQ(index->lookup(SyncIndex::path_hash("dir/missing")), nullptr);
+
+    fs::remove_all(dir);
+}
+
+TEST(SyncIndexTest, HugeEntryCountIsRejected)
+{
+    const auto dir = fs::temp_directory_path() / "cclone_sync_index_corrupt";
+    fs::create_directories(dir);
+    const auto path = dir / SyncIndex::FILE_NAME;
+
+    {
+        // count * sizeof(entry) переполняется до 0: заголовок проходил наивную проверку
+        const std::uint64_t count = std::uint64_t{1} << 63;
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write("CCSIDX01", 8);
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    }
+
+    EXPECT_FALSE(SyncIndex::load(path).has_value());
+
+    fs::remove_all(dir);
+}
+
+} // namespace
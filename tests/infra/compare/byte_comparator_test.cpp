@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include "infra/compare/byte_comparator.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+using cclone::infra::ByteComparator;
+
+TEST(ByteComparatorTest, KernelFindsFirstMismatchAtEveryPosition)
+{
+    // Покрываем хвосты и границы 16/32/64-байтных блоков
+    constexpr std::size_t size = 200;
+    std::vector<unsigned char> a(size, 0x11);
+    for (std::size_t pos = 0; pos < size; ++pos) {
+        std::vector<unsigned char> b = a;
+        b[pos] = 0x22;
+        EXPECT_EQ(ByteComparator::first_mismatch(a.data(), b.data(), size), pos);
+    }
+    EXPECT_EQ(ByteComparator::first_mismatch(a.data(), a.data(), size), size);
+}
+
+TEST(ByteComparatorTest, ReportsOffsetOfFirstDifferingByte)
+{
+    namespace fs = std::filesystem;
+    const auto dir = fs::temp_directory_path() / "cclone_byte_comparator_test";
+    fs::create_directories(dir);
+
+    std::vector<char> data(5 * 1024 * 1024, 'x');
+    auto write = [&](const fs::path& path, const std::vector<char>& bytes) {
+        std::ofstream ofs(path, std::ios::binary);
+        ofs.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    };
+
+    write(dir / "a.bin", data);
+    write(dir / "b.bin", data);
+    auto same = ByteComparator::compare_files(dir / "a.bin", dir / "b.bin");
+    ASSERT_TRUE(same.has_value());
+    EXPECT_TRUE(same->equal);
+
+    data[4 * 1024 * 1024 + 3] = 'y';
+    write(dir / "b.bin", data);
+    auto changed = ByteComparator::compare_files(dir / "a.bin", dir / "b.bin");
+    ASSERT_TRUE(changed.has_value());
+    EXPECT_FALSE(changed->equal);
+    EXPECT_EQ(changed->first_mismatch, 4u * 1024 * 1024 + 3);
+
+    data.resize(1000);
+    write(dir / "b.bin", data);
+    auto shorter = ByteComparator::compare_files(dir / "a.bin", dir / "b.bin");
+    ASSERT_TRUE(shorter.has_value());
+    EXPECT_FALSE(shorter->equal);
+    EXPECT_EQ(shorter->first_mismatch, 1000u);
+
+    fs::remove_all(dir);
+}
+
+} // namespace
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include "infra/concurrent/bounded_queue.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using cclone::infra::BoundedQueue;
+
+TEST(BoundedQueueTest, TryPushFailsWhenFull)
+{
+    BoundedQueue<std::unique_ptr<int>> queue(3);  // округляется до 4
+    EXPECT_EQ(queue.capacity(), 4u);
+    for (int i = 0; i < 4; ++i) {
+        auto value = std::make_unique<int>(i);
+        ASSERT_TRUE(queue.try_push(value));
+        EXPECT_EQ(value, nullptr);
+    }
+    auto extra = std::make_unique<int>(99);
+    EXPECT_FALSE(queue.try_push(extra));
+    EXPECT_NE(extra, nullptr);
+
+    EXPECT_EQ(**queue.try_pop(), 0);
+    EXPECT_TRUE(queue.try_push(extra));
+}
+
+// Производители упираются в ёмкость, потребители получают каждый элемент ровно раз
+TEST(BoundedQueueTest, BlockingPipelineDeliversEverything)
+{
+    constexpr int PER_PRODUCER = 20000;
+    constexpr int PRODUCERS = 3;
+    BoundedQueue<int> queue(8);
+    std::vector<std::atomic<int>> seen(PER_PRODUCER * PRODUCERS);
+
+    std::vector<std::jthread> consumers;
+    for (int c = 0; c < 3; ++c) {
+        consumers.emplace_back([&] {
+            while (auto value = queue.pop()) seen[static_cast<std::size_t>(*value)].fetch_add(1);
+        });
+    }
+    {
+        std::vector<std::jthread> producers;
+        for (int p = 0; p < PRODUCERS; ++p) {
+            producers.emplace_back([&, p] {
+                for (int i = 0; i < PER_PRODUCER; ++i) EXPECT_TRUE(queue.push(p * PER_PRODUCER + i));
+            });
+        }
+    }
+    queue.close();
+    consumers.clear();
+
+    for (const auto& count : seen) EXPECT_EQ(count.load(), 1);
+    EXPECT_FALSE(queue.push(1));
+}
+
+TEST(BoundedQueueTest, CloseWakesBlockedConsumer)
+{
+    BoundedQueue<int> queue(2);
+    std::jthread consumer([&] { EXPECT_FALSE(queue.pop().has_value()); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.close();
+}
+
+} // namespace
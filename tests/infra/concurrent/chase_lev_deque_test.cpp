@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include "infra/concurrent/chase_lev_deque.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using cclone::infra::ChaseLevDeque;
+
+TEST(ChaseLevDequeTest, OwnerIsLifoThiefIsFifo)
+{
+    ChaseLevDeque<int> deque(2);
+    std::vector<int> items(10);
+    for (auto& item : items) deque.push(&item);  // с ростом массива
+
+    EXPECT_EQ(deque.pop(), &items[9]);
+    EXPECT_EQ(deque.steal(), &items[0]);
+    EXPECT_EQ(deque.size_approx(), 8u);
+    while (deque.pop() != nullptr) {}
+    EXPECT_TRUE(deque.empty());
+    EXPECT_EQ(deque.steal(), nullptr);
+}
+
+// Каждый элемент достаётся ровно одному: владельцу или одному из воров
+TEST(ChaseLevDequeTest, ConcurrentStealTakesEachItemOnce)
+{
+    constexpr int ITEMS = 200000;
+    ChaseLevDeque<int> deque(64);
+    std::vector<int> items(ITEMS);
+    std::vector<std::atomic<int>> taken(ITEMS);
+    std::atomic<bool> done{false};
+
+    auto take = [&](int* item) { taken[static_cast<std::size_t>(item - items.data())].fetch_add(1); };
+
+    std::vector<std::jthread> thieves;
+    for (int t = 0; t < 4; ++t) {
+        thieves.emplace_back([&] {
+            while (!done.load(std::memory_order_acquire) || !deque.empty()) {
+                if (auto* item = deque.steal()) take(item);
+            }
+        });
+    }
+
+    for (int i = 0; i < ITEMS; ++i) {
+        deque.push(&items[static_cast<std::size_t>(i)]);
+        if (i % 3 == 0) {
+            if (auto* item = deque.pop()) take(item);
+        }
+    }
+    while (auto* item = deque.pop()) take(item);
+    done.store(true, std::memory_order_release);
+    thieves.clear();
+
+    for (const auto& count : taken) EXPECT_EQ(count.load(), 1);
+}
+
+} // namespace
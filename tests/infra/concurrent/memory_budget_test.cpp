@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+
+#include "infra/concurrent/memory_budget.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using cclone::infra::MemoryBudget;
+
+TEST(MemoryBudgetTest, ReservationsStayWithinLimit)
+{
+    MemoryBudget budget(100);
+    std::atomic<std::uint64_t> held{0};
+    std::atomic<bool> exceeded{false};
+
+    std::vector<std::jthread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 2000; ++i) {
+                auto reservation = budget.acquire(static_cast<std::uint64_t>(10 + t * 5));
+                if (held.fetch_add(reservation.bytes()) + reservation.bytes() > 100) exceeded = true;
+                held.fetch_sub(reservation.bytes());
+            }
+        });
+    }
+    threads.clear();
+
+    EXPECT_FALSE(exceeded.load());
+    EXPECT_EQ(budget.in_use(), 0u);
+    EXPECT_LE(budget.peak(), 100u);
+}
+
+TEST(MemoryBudgetTest, OversizedRequestIsClampedAndExclusive)
+{
+    MemoryBudget budget(64);
+    auto big = budget.acquire(1000);
+    EXPECT_EQ(big.bytes(), 64u);
+    EXPECT_EQ(budget.try_acquire(1).bytes(), 0u);
+
+    std::jthread waiter([&] { EXPECT_EQ(budget.acquire(8).bytes(), 8u); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    big.release();
+    waiter.join();
+    EXPECT_EQ(budget.in_use(), 0u);
+    EXPECT_GE(budget.stalls(), 1u);
+}
+
+} // namespace
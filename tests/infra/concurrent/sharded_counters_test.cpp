@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include "infra/concurrent/sharded_counters.hpp"
+
+#include <thread>
+#include <vector>
+
+namespace {
+
+using cclone::infra::ShardedCounters;
+
+enum class Metric : std::size_t { Files, Bytes, Errors, Count };
+
+TEST(ShardedCountersTest, SumsAcrossThreads)
+{
+    constexpr int THREADS = 8;
+    constexpr int PER_THREAD = 10000;
+    ShardedCounters<Metric> counters;
+    {
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < PER_THREAD; ++i) {
+                    counters.add(Metric::Files);
+                    counters.add(Metric::Bytes, 4096);
+                }
+            });
+        }
+    }
+    EXPECT_EQ(counters.load(Metric::Files), THREADS * PER_THREAD);
+    EXPECT_EQ(counters.load(Metric::Bytes), 4096ull * THREADS * PER_THREAD);
+    EXPECT_EQ(counters.load(Metric::Errors), 0u);
+
+    const auto all = counters.load_all();
+    EXPECT_EQ(all[0], THREADS * PER_THREAD);
+    EXPECT_EQ(all[1], 4096ull * THREADS * PER_THREAD);
+}
+
+// Потоков больше, чем шардов: делящие шард потоки не теряют прибавлений
+TEST(ShardedCountersTest, MoreThreadsThanShards)
+{
+    ShardedCounters<Metric, 2> counters;
+    {
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < 6; ++t) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < 5000; ++i) counters.add(Metric::Errors);
+            });
+        }
+    }
+    EXPECT_EQ(counters.load(Metric::Errors), 30000u);
+}
+
+TEST(ShardedCountersTest, ShardsDoNotShareCacheLines)
+{
+    EXPECT_GE(sizeof(ShardedCounters<Metric, 4>), 4u * 64u);
+}
+
+} // namespace
@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+
+#include "infra/concurrent/sharded_map.hpp"
+#include "extensions/origin_registry.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using cclone::extensions::InodeKey;
+using cclone::extensions::InodeKeyHash;
+
+TEST(ShardedMapTest, ConcurrentGetOrCreateCreatesOnce)
+{
+    cclone::infra::ShardedMap<InodeKey, int, InodeKeyHash> map;
+    std::atomic<int> created{0};
+
+    std::vector<std::jthread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&] {
+            for (std::uint64_t inode = 0; inode < 1000; ++inode) {
+                auto [value, inserted] = map.get_or_create(InodeKey{.device = 1, .inode = inode},
+                                                           [&] { return static_cast<int>(inode); });
+                if (inserted) created.fetch_add(1);
+                EXPECT_EQ(value, static_cast<int>(inode));
+            }
+        });
+    }
+    threads.clear();
+
+    EXPECT_EQ(created.load(), 1000);
+    EXPECT_EQ(map.size(), 1000u);
+    EXPECT_EQ(map.find(InodeKey{.device = 1, .inode = 42}), 42);
+    EXPECT_FALSE(map.find(InodeKey{.device = 2, .inode = 42}).has_value());
+    EXPECT_TRUE(map.erase(InodeKey{.device = 1, .inode = 42}));
+    EXPECT_EQ(map.size(), 999u);
+}
+
+} // namespace
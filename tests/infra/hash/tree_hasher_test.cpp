@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include "infra/hash/tree_hasher.hpp"
+#include "infra/thread_pool/thread_pool.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <vector>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+class TreeHasherTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = fs::temp_directory_path() / fmt::format("cclone_tree_hasher_{}", ::testing::UnitTest::GetInstance()->random_seed());
+        fs::create_directories(dir_);
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove_all(dir_, ec);
+    }
+
+    auto write_file(const std::string& name, const std::vector<char>& data) -> fs::path {
+        auto path = dir_ / name;
+        std::ofstream ofs(path, std::ios::binary);
+        ofs.write(data.data(), static_cast<std::streamsize>(data.size()));
+        return path;
+    }
+
+    static auto random_bytes(std::size_t size) -> std::vector<char> {
+        std::mt19937 gen(42);
+        std::vector<char> data(size);
+        for (auto& byte : data) byte = static_cast<char>(gen());
+        return data;
+    }
+
+    fs::path dir_;
+    cclone::infra::ThreadPool pool_{4};
+};
+
+TEST_F(TreeHasherTest, IdenticalFilesHaveSameRoot)
+{
+    const auto data = random_bytes(10'000);
+    const auto a = write_file("a.bin", data);
+    const auto b = write_file("b.bin", data);
+
+    cclone::infra::TreeHasher hasher(pool_, 1024);
+    auto digest_a = hasher.hash_file(a);
+    auto digest_b = hasher.hash_file(b);
+    ASSERT_TRUE(digest_a.has_value());
+    ASSERT_TRUE(digest_b.has_value());
+
+    EXPECT_EQ(digest_a->segment_count(), 10u);
+    EXPECT_EQ(digest_a->root, digest_b->root);
+    EXPECT_TRUE(digest_a->diff(*digest_b).empty());
+    EXPECT_TRUE(hasher.verify_files(a, b).value());
+}
+
+TEST_F(TreeHasherTest, DiffPointsToChangedSegment)
+{
+    auto data = random_bytes(10'000);
+    const auto a = write_file("a.bin", data);
+    data[5 * 1024 + 7] ^= 0x5a;
+    const auto b = write_file("b.bin", data);
+
+    cclone::infra::TreeHasher hasher(pool_, 1024);
+    auto digest_a = hasher.hash_file(a);
+    auto digest_b = hasher.hash_file(b);
+    ASSERT_TRUE(digest_a.has_value());
+    ASSERT_TRUE(digest_b.has_value());
+
+    EXPECT_NE(digest_a->root, digest_b->root);
+    EXPECT_EQ(digest_a->diff(*digest_b), std::vector<std::size_t>{5});
+    EXPECT_FALSE(hasher.verify_files(a, b).value());
+}
+
+TEST_F(TreeHasherTest, PartialRehashMatchesFullDigest)
+{
+    const auto a = write_file("a.bin", random_bytes(10'000));
+
+    cclone::infra::TreeHasher hasher(pool_, 1024);
+    auto digest = hasher.hash_file(a);
+    ASSERT_TRUE(digest.has_value());
+
+    const std::vector<std::size_t> indices{9, 2};
+    auto partial = hasher.hash_segments(a, indices);
+    ASSERT_TRUE(partial.has_value());
+    EXPECT_EQ((*partial)[0], digest->segments[9]);
+    EXPECT_EQ((*partial)[1], digest->segments[2]);
+
+    const std::vector<std::size_t> out_of_range{10};
+    EXPECT_FALSE(hasher.hash_segments(a, out_of_range).has_value());
+}
+
+TEST_F(TreeHasherTest, EmptyFileHasSingleSegment)
+{
+    const auto a = write_file("empty.bin", {});
+
+    cclone::infra::TreeHasher hasher(pool_, 1024);
+    auto digest = hasher.hash_file(a);
+    ASSERT_TRUE(digest.has_value());
+    EXPECT_EQ(digest->segment_count(), 1u);
+    EXPECT_EQ(digest->file_size, 0u);
+}
+
+} // namespace
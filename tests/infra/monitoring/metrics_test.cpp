@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include "infra/monitoring/metrics.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using cclone::infra::LatencyHistogram;
+using cclone::infra::MetricsExporter;
+using cclone::infra::MetricsSnapshot;
+using namespace std::chrono_literals;
+
+auto read_file(const std::filesystem::path& path) -> std::string {
+    std::ifstream in(path);
+    std::stringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+TEST(LatencyHistogramTest, BucketsAndSumAcrossThreads)
+{
+    LatencyHistogram histogram;
+    {
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < 1000; ++i) histogram.record(2ms);
+            });
+        }
+    }
+    histogram.record(90s);
+
+    const auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, 4001u);
+    EXPECT_EQ(snapshot.counts[4], 4000u);               // le=0.0025
+    EXPECT_EQ(snapshot.counts[LatencyHistogram::BUCKETS - 1], 1u);  // +Inf
+    EXPECT_NEAR(snapshot.sum, 4000 * 0.002 + 90, 1e-6);
+}
+
+TEST(MetricsSnapshotTest, PrometheusTextFormat)
+{
+    MetricsSnapshot snapshot;
+    snapshot.counter("cclone_files_copied_total", "Files copied", 42);
+    snapshot.counter("cclone_strategy_bytes_total", "Bytes by strategy", 10, {{"strategy", "mmap"}});
+    snapshot.counter("cclone_strategy_bytes_total", "Bytes by strategy", 20, {{"strategy", "buf\"fered"}});
+    snapshot.gauge("cclone_copy_queue_depth", "Queue", 3);
+    LatencyHistogram histogram;
+    histogram.record(300us);
+    histogram.record(2s);
+    snapshot.histogram("cclone_file_copy_duration_seconds", "Per file", histogram.snapshot());
+
+    const auto text = cclone::infra::to_prometheus(snapshot);
+    EXPECT_NE(text.find("# TYPE cclone_files_copied_total counter\ncclone_files_copied_total 42\n"), std::string::npos);
+    // Семейство с несколькими подписями — один заголовок
+    EXPECT_EQ(text.find("# TYPE cclone_strategy_bytes_total"), text.rfind("# TYPE cclone_strategy_bytes_total"));
+    EXPECT_NE(text.find("cclone_strategy_bytes_total{strategy=\"mmap\"} 10\n"), std::string::npos);
+    EXPECT_NE(text.find("cclone_strategy_bytes_total{strategy=\"buf\\\"fered\"} 20\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE cclone_copy_queue_depth gauge\n"), std::string::npos);
+    // Корзины накопительные
+    EXPECT_NE(text.find("cclone_file_copy_duration_seconds_bucket{le=\"0.00025\"} 0\n"), std::string::npos);
+    EXPECT_NE(text.find("cclone_file_copy_duration_seconds_bucket{le=\"0.0005\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("cclone_file_copy_duration_seconds_bucket{le=\"2.5\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("cclone_file_copy_duration_seconds_bucket{le=\"+Inf\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("cclone_file_copy_duration_seconds_count 2\n"), std::string::npos);
+}
+
+TEST(MetricsSnapshotTest, JsonLine)
+{
+    MetricsSnapshot snapshot;
+    snapshot.counter("cclone_errors_total", "Errors", 1, {{"strategy", "direct"}});
+    const auto line = cclone::infra::to_json_line(snapshot, std::chrono::system_clock::time_point(1500ms));
+
+    EXPECT_EQ(line, "{\"timestamp\":1.500,\"metrics\":[{\"name\":\"cclone_errors_total\",\"type\":\"counter\","
+                    "\"labels\":{\"strategy\":\"direct\"},\"value\":1}]}\n");
+}
+
+// Фоновый поток выгружает снимки, деструктор — последний
+TEST(MetricsExporterTest, WritesPeriodicallyAndOnShutdown)
+{
+    const auto dir = std::filesystem::temp_directory_path() / "cclone_metrics_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    std::atomic<int> copied{0};
+    {
+        auto exporter = MetricsExporter::create(
+            MetricsExporter::Options{.prometheus_file = dir / "cclone.prom", .json_file = dir / "cclone.json",
+                                     .interval = 20ms},
+            [&] {
+                MetricsSnapshot snapshot;
+                snapshot.counter("cclone_files_copied_total", "Files copied", copied.load());
+                return snapshot;
+            });
+        ASSERT_TRUE(exporter.has_value());
+        for (int i = 0; i < 5; ++i) {
+            ++copied;
+            std::this_thread::sleep_for(25ms);
+        }
+        copied = 100;
+    }
+
+    EXPECT_NE(read_file(dir / "cclone.prom").find("cclone_files_copied_total 100\n"), std::string::npos);
+    std::ifstream json(dir / "cclone.json");
+    std::string line;
+    int lines = 0;
+    std::string last;
+    while (std::getline(json, line)) {
+        ++lines;
+        last = line;
+    }
+    EXPECT_GE(lines, 2);
+    EXPECT_NE(last.find("\"value\":100}"), std::string::npos);
+    // Временный файл переименован, рядом ничего не осталось
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator(dir), std::filesystem::directory_iterator{}), 2);
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST(MetricsExporterTest, RejectsMissingDirectory)
+{
+    auto exporter = MetricsExporter::create(
+        MetricsExporter::Options{.prometheus_file = "/nonexistent/cclone/metrics.prom"},
+        [] { return MetricsSnapshot{}; });
+    EXPECT_FALSE(exporter.has_value());
+}
+
+} // namespace
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include "infra/monitoring/hdr_histogram.hpp"
+#include "infra/monitoring/op_latency.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using cclone::infra::HdrHistogram;
+using cclone::infra::IoOp;
+using cclone::infra::LatencyKey;
+using cclone::infra::OpLatency;
+using cclone::infra::OpTimer;
+using cclone::infra::SizeClass;
+using namespace std::chrono_literals;
+
+TEST(HdrHistogramTest, BucketsCoverRangeWithBoundedError)
+{
+    EXPECT_EQ(HdrHistogram::bucket_of(0), 0u);
+    EXPECT_EQ(HdrHistogram::bucket_of(63), 63u);
+    EXPECT_EQ(HdrHistogram::bucket_of(HdrHistogram::MAX_VALUE), HdrHistogram::BUCKETS - 1);
+    EXPECT_EQ(HdrHistogram::bucket_of(HdrHistogram::MAX_VALUE * 4), HdrHistogram::BUCKETS - 1);
+
+    std::size_t previous = 0;
+    for (std::uint64_t value = 1; value < HdrHistogram::MAX_VALUE; value = value * 3 / 2 + 1) {
+        const auto bucket = HdrHistogram::bucket_of(value);
+        EXPECT_GE(bucket, previous);
+        previous = bucket;
+        const auto high = HdrHistogram::bucket_high(bucket);
+        EXPECT_GE(high, value);
+        EXPECT_LE(static_cast<double>(high - value), static_cast<double>(value) / HdrHistogram::SUB_COUNT);
+        EXPECT_EQ(HdrHistogram::bucket_of(high), bucket);
+        EXPECT_EQ(HdrHistogram::bucket_of(high + 1), bucket + 1);
+    }
+}
+
+TEST(HdrHistogramTest, PercentilesOfUniformValues)
+{
+    HdrHistogram histogram;
+    for (std::uint64_t us = 1; us <= 1000; ++us) histogram.record(us * 1000);
+
+    EXPECT_EQ(histogram.count(), 1000u);
+    EXPECT_EQ(histogram.max(), 1'000'000u);
+    EXPECT_NEAR(static_cast<double>(histogram.percentile(0.5)), 500'000.0, 500'000.0 / 32);
+    EXPECT_NEAR(static_cast<double>(histogram.percentile(0.99)), 990'000.0, 990'000.0 / 32);
+    EXPECT_EQ(histogram.percentile(1.0), 1'000'000u);   // не выше наибольшего
+
+    HdrHistogram other;
+    other.record(5'000'000);
+    histogram.merge(other);
+    EXPECT_EQ(histogram.count(), 1001u);
+    EXPECT_EQ(histogram.percentile(1.0), 5'000'000u);
+}
+
+TEST(OpLatencyTest, ThreadsMergeByKey)
+{
+    OpLatency latency;
+    const LatencyKey small{.path = 0, .size = SizeClass::Under64K};
+    const LatencyKey large{.path = 2, .size = SizeClass::Huge};
+    {
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < 100; ++i) latency.record(IoOp::Read, small, 10us);
+                latency.record(IoOp::Read, large, 2ms);
+            });
+        }
+    }
+
+    const auto rows = latency.merge();
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(rows[0].key.path, 0u);
+    EXPECT_EQ(rows[0].histogram.count(), 400u);
+    EXPECT_EQ(rows[1].key.size, SizeClass::Huge);
+    EXPECT_EQ(rows[1].histogram.count(), 4u);
+
+    constexpr std::array<std::string_view, 3> names{"buffered", "mmap", "direct"};
+    const auto summary = cclone::infra::summarize(rows, names);
+    ASSERT_EQ(summary.size(), 3u);   // итог по чтению и две строки разбивки
+    EXPECT_TRUE(summary[0].label.empty());
+    EXPECT_EQ(summary[0].count, 404u);
+    EXPECT_EQ(summary[0].max, 2ms);
+    EXPECT_EQ(summary[2].label, "direct >=100M");
+    EXPECT_EQ(cclone::infra::format_latency_table(summary).size(), 4u);
+}
+
+TEST(OpLatencyTest, TimerFollowsThreadContext)
+{
+    OpLatency latency;
+    {
+        OpTimer outside(IoOp::Write);   // без контекста не пишется
+    }
+    {
+        const OpLatency::Context file(latency, LatencyKey{.path = 1, .size = SizeClass::Under1M});
+        OpTimer timer(IoOp::Write);
+        std::thread([binding = OpLatency::bound(), &latency] {
+            const OpLatency::Context inherited(binding);
+            OpTimer fsync(IoOp::Fsync);
+            EXPECT_EQ(OpLatency::bound().recorder, &latency);
+        }).join();
+    }
+    EXPECT_EQ(OpLatency::bound().recorder, nullptr);
+
+    const auto rows = latency.merge();
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(rows[0].op, IoOp::Write);
+    EXPECT_EQ(rows[1].op, IoOp::Fsync);
+    EXPECT_EQ(rows[1].key.path, 1u);
+    EXPECT_EQ(rows[1].key.size, SizeClass::Under1M);
+}
+
+// Записанные байты идут регистратору контекста, из любого потока
+TEST(OpLatencyTest, WrittenBytesFollowThreadContext)
+{
+    OpLatency latency;
+    cclone::infra::note_written(100);   // без контекста не учитываются
+    {
+        const OpLatency::Context file(latency, LatencyKey{.path = 0, .size = SizeClass::Under64K});
+        cclone::infra::note_written(4096);
+        std::thread([binding = OpLatency::bound()] {
+            const OpLatency::Context inherited(binding);
+            cclone::infra::note_written(512);
+        }).join();
+    }
+    latency.add_written(8);
+    EXPECT_EQ(latency.written(), 4096u + 512u + 8u);
+}
+
+} // namespace
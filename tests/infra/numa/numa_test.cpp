@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include "infra/numa/numa.hpp"
+#include "adapters/io_buffer.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#ifdef __linux__
+    #include <sys/sysmacros.h>
+#endif
+
+namespace {
+
+namespace fs = std::filesystem;
+using namespace cclone::infra;
+
+TEST(NumaTest, ParsesCpuLists)
+{
+    EXPECT_EQ(parse_cpu_list("0-3,8,10-11\n"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(parse_cpu_list(""), std::vector<int>{});
+    EXPECT_FALSE(parse_cpu_list("3-1").has_value());
+    EXPECT_FALSE(parse_cpu_list("a-b").has_value());
+}
+
+#ifdef __linux__
+// Двухсокетная машина в миниатюре: узел 2 только с памятью, диск на узле 1
+TEST(NumaTest, DiscoversNodesAndDeviceAffinity)
+{
+    const auto root = fs::temp_directory_path() / "cclone_numa_test";
+    fs::remove_all(root);
+    const auto nodes = root / "devices/system/node";
+    fs::create_directories(nodes / "node0");
+    fs::create_directories(nodes / "node1");
+    fs::create_directories(nodes / "node2");
+    std::ofstream(nodes / "online") << "0-2\n";
+    std::ofstream(nodes / "node0/cpulist") << "0-3\n";
+    std::ofstream(nodes / "node1/cpulist") << "4-7\n";
+    std::ofstream(nodes / "node2/cpulist") << "\n";
+
+    const auto pci = root / "devices/pci0000:40/0000:40:01.0";
+    fs::create_directories(pci / "nvme/nvme0/nvme0n1/nvme0n1p1");
+    std::ofstream(pci / "numa_node") << "1\n";
+    fs::create_directories(root / "dev/block");
+    fs::create_directory_symlink(pci / "nvme/nvme0/nvme0n1", root / "dev/block/259:0");
+    fs::create_directory_symlink(pci / "nvme/nvme0/nvme0n1/nvme0n1p1", root / "dev/block/259:1");
+
+    const auto topology = NumaTopology::discover(root);
+    ASSERT_EQ(topology.node_count(), 2u);
+    EXPECT_EQ(topology.nodes()[1].id, 1);
+    EXPECT_EQ(topology.nodes()[1].cpus, (std::vector<int>{4, 5, 6, 7}));
+    EXPECT_EQ(topology.find(2), nullptr);
+
+    EXPECT_EQ(topology.device_node(makedev(259, 0)), 1);
+    EXPECT_EQ(topology.device_node(makedev(259, 1)), 1);
+    EXPECT_FALSE(topology.device_node(makedev(8, 0)).has_value());
+
+    fs::remove_all(root);
+}
+
+TEST(NumaTest, MissingSysfsMeansOneNode)
+{
+    const auto topology = NumaTopology::discover("/nonexistent-sysfs");
+    ASSERT_EQ(topology.node_count(), 1u);
+    EXPECT_FALSE(topology.nodes()[0].cpus.empty());
+}
+
+TEST(NumaTest, PinnedThreadGetsPageAlignedLocalBuffer)
+{
+    const auto topology = NumaTopology::discover();
+    std::jthread worker([&] {
+        EXPECT_TRUE(pin_current_thread(topology.nodes()[0].cpus).has_value());
+
+        char* buffer = cclone::adapters::fs::thread_io_buffer(1 << 20);
+        ASSERT_NE(buffer, nullptr);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buffer) % 4096, 0u);
+        std::memset(buffer, 0xab, 1 << 20);
+        // Тот же поток — тот же буфер
+        EXPECT_EQ(cclone::adapters::fs::thread_io_buffer(4096), buffer);
+    });
+}
+#endif
+
+} // namespace
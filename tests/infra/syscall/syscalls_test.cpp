@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include "infra/syscall/syscalls.hpp"
+
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+namespace sys = cclone::infra::sys;
+
+auto calls(const sys::Counts& counts, sys::Syscall call) -> std::uint64_t {
+    return counts.calls[static_cast<std::size_t>(call)];
+}
+
+auto errors(const sys::Counts& counts, sys::Syscall call) -> std::uint64_t {
+    return counts.errors[static_cast<std::size_t>(call)];
+}
+
+class SyscallsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = std::filesystem::temp_directory_path() / "cclone_syscalls_test";
+        std::filesystem::remove_all(dir_);
+        std::filesystem::create_directories(dir_);
+    }
+    void TearDown() override {
+        std::filesystem::remove_all(dir_);
+    }
+
+    std::filesystem::path dir_;
+};
+
+TEST_F(SyscallsTest, WrappersCountCallsAndErrors)
+{
+    const auto file = dir_ / "data.bin";
+    const auto before = sys::snapshot();
+
+    const int fd = sys::open(file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    ASSERT_NE(fd, -1);
+    const std::string payload = "syscall accounting";
+    EXPECT_EQ(sys::write(fd, payload.data(), payload.size()), static_cast<ssize_t>(payload.size()));
+    EXPECT_EQ(sys::fsync(fd), 0);
+    EXPECT_EQ(sys::close(fd), 0);
+
+    EXPECT_EQ(sys::open((dir_ / "missing").c_str(), O_RDONLY | O_CLOEXEC), -1);
+    EXPECT_EQ(errno, ENOENT);  // обёртка не портит errno
+
+    const auto delta = sys::snapshot() - before;
+    EXPECT_EQ(calls(delta, sys::Syscall::Open), 2u);
+    EXPECT_EQ(errors(delta, sys::Syscall::Open), 1u);
+    EXPECT_EQ(calls(delta, sys::Syscall::Write), 1u);
+    EXPECT_EQ(calls(delta, sys::Syscall::Fsync), 1u);
+    EXPECT_EQ(calls(delta, sys::Syscall::Close), 1u);
+    EXPECT_EQ(delta.total_calls(), 5u);
+    EXPECT_EQ(delta.total_errors(), 1u);
+}
+
+TEST_F(SyscallsTest, FilesystemWrappersCountTheirMainCall)
+{
+    const auto before = sys::snapshot();
+    std::error_code ec;
+    EXPECT_TRUE(sys::create_directories(dir_ / "a" / "b", ec));
+    EXPECT_FALSE(sys::exists(dir_ / "nothing"));
+    sys::remove(dir_ / "a" / "b", ec);
+    EXPECT_THROW((void)sys::file_size(dir_ / "nothing"), std::filesystem::filesystem_error);
+
+    const auto delta = sys::snapshot() - before;
+    EXPECT_EQ(calls(delta, sys::Syscall::Mkdir), 1u);
+    EXPECT_EQ(calls(delta, sys::Syscall::Stat), 2u);
+    EXPECT_EQ(errors(delta, sys::Syscall::Stat), 1u);   // только file_size
+    EXPECT_EQ(calls(delta, sys::Syscall::Unlink), 1u);
+}
+
+TEST_F(SyscallsTest, CountsFromAllThreadsAreSummed)
+{
+    const auto before = sys::snapshot();
+    {
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([] {
+                for (int i = 0; i < 1000; ++i) sys::note(sys::Syscall::Pread);
+            });
+        }
+    }
+    const auto delta = sys::snapshot() - before;
+    EXPECT_EQ(calls(delta, sys::Syscall::Pread), 4000u);
+}
+
+TEST_F(SyscallsTest, ReportRanksSyscallsPerFileAndPerGigabyte)
+{
+    sys::Counts counts;
+    counts.calls[static_cast<std::size_t>(sys::Syscall::Read)] = 30;
+    counts.calls[static_cast<std::size_t>(sys::Syscall::Open)] = 20;
+    counts.errors[static_cast<std::size_t>(sys::Syscall::Open)] = 2;
+
+    const auto lines = sys::format_syscall_report(counts, 10, 1024ull * 1024 * 1024);
+    ASSERT_EQ(lines.size(), 4u);
+    EXPECT_EQ(lines[0], "Syscalls: 50 (5.0 per file, 50 per GB), errors: 2");
+    EXPECT_NE(lines[2].find("read"), std::string::npos);
+    EXPECT_NE(lines[3].find("open"), std::string::npos);
+    EXPECT_NE(lines[3].find("2.00"), std::string::npos);
+
+    EXPECT_TRUE(sys::format_syscall_report(sys::Counts{}, 10, 0).empty());
+}
+
+} // namespace
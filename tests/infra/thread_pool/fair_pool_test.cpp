@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+
+#include "infra/monitoring/op_latency.hpp"
+#include "infra/thread_pool/fair_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using cclone::infra::FairPool;
+using cclone::infra::IoOp;
+using cclone::infra::LatencyKey;
+using cclone::infra::OpLatency;
+using cclone::infra::OpTimer;
+using cclone::infra::SizeClass;
+
+TEST(FairPoolTest, WaitSeesEveryTaskOfTheLane)
+{
+    FairPool pool{4};
+    auto lane = pool.open_lane();
+    std::atomic<int> counter{0};
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 5000; ++i) {
+            lane->enqueue([&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+        }
+        lane->wait();
+        EXPECT_EQ(counter.load(), (round + 1) * 5000);
+    }
+    EXPECT_EQ(lane->size(), 4u);
+}
+
+// Задание, поставленное позже, не ждёт конца длинного: рабочий чередует очереди
+TEST(FairPoolTest, LanesTakeTurns)
+{
+    FairPool pool{1};
+    auto big = pool.open_lane();
+    auto small = pool.open_lane();
+
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::mutex mutex;
+    std::vector<char> order;
+    auto record = [&](char who) {
+        std::lock_guard lock(mutex);
+        order.push_back(who);
+    };
+
+    big->enqueue([released] { released.wait(); });
+    for (int i = 0; i < 100; ++i) big->enqueue([&] { record('b'); });
+    for (int i = 0; i < 10; ++i) small->enqueue([&] { record('s'); });
+    release.set_value();
+    small->wait();
+    big->wait();
+
+    ASSERT_EQ(order.size(), 110u);
+    const auto last_small = std::find(order.rbegin(), order.rend(), 's');
+    const auto position = order.size() - 1 - static_cast<std::size_t>(last_small - order.rbegin());
+    EXPECT_LT(position, 25u);
+}
+
+TEST(FairPoolTest, LaneLimitCapsConcurrency)
+{
+    FairPool pool{4};
+    auto limited = pool.open_lane(1);
+    auto free = pool.open_lane();
+    std::atomic<int> active{0};
+    std::atomic<int> peak{0};
+    std::atomic<int> others{0};
+
+    for (int i = 0; i < 200; ++i) {
+        limited->enqueue([&] {
+            const int now = active.fetch_add(1) + 1;
+            int seen = peak.load();
+            while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+            std::this_thread::yield();
+            active.fetch_sub(1);
+        });
+        free->enqueue([&] { others.fetch_add(1); });
+    }
+    limited->wait();
+    free->wait();
+
+    EXPECT_EQ(limited->size(), 1u);
+    EXPECT_EQ(peak.load(), 1);
+    EXPECT_EQ(others.load(), 200);
+}
+
+// Ограниченная очередь: поставщик ждёт, пока рабочий не освободит место
+TEST(FairPoolTest, LaneCapacityBlocksSubmitter)
+{
+    FairPool pool{1};
+    auto lane = pool.open_lane(1, 2);
+
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::promise<void> started;
+    lane->enqueue([released, &started] {
+        started.set_value();
+        released.wait();
+    });
+    started.get_future().wait();
+
+    std::atomic<int> done{0};
+    lane->enqueue([&] { done.fetch_add(1); });
+    lane->enqueue([&] { done.fetch_add(1); });
+
+    std::atomic<bool> submitted{false};
+    std::jthread submitter([&] {
+        lane->enqueue([&] { done.fetch_add(1); });
+        submitted = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(submitted.load());
+
+    release.set_value();
+    submitter.join();
+    lane->wait();
+    EXPECT_TRUE(submitted.load());
+    EXPECT_EQ(done.load(), 3);
+}
+
+// Два задания демона на одном пуле: рабочие переключаются между их
+// регистраторами задержек почти на каждом файле, но гистограммы
+// заводятся по потоку, а не по переключению
+TEST(FairPoolTest, AlternatingJobsKeepOneLatencySlotPerThread)
+{
+    FairPool pool{4};
+    OpLatency first;
+    OpLatency second;
+    auto first_lane = pool.open_lane();
+    auto second_lane = pool.open_lane();
+    const LatencyKey key{0, SizeClass::Under64K};
+
+    for (int i = 0; i < 2000; ++i) {
+        first_lane->enqueue([&] {
+            const OpLatency::Context context(first, key);
+            const OpTimer timer(IoOp::Write);
+        });
+        second_lane->enqueue([&] {
+            const OpLatency::Context context(second, key);
+            const OpTimer timer(IoOp::Write);
+        });
+    }
+    first_lane->wait();
+    second_lane->wait();
+
+    EXPECT_LE(first.threads(), pool.size());
+    EXPECT_LE(second.threads(), pool.size());
+    ASSERT_EQ(first.merge().size(), 1u);
+    EXPECT_EQ(first.merge().front().histogram.count(), 2000u);
+}
+
+TEST(FairPoolTest, ExceptionDoesNotStopTheWorker)
+{
+    FairPool pool{1};
+    auto lane = pool.open_lane();
+    std::atomic<int> counter{0};
+    lane->enqueue([] { throw std::runtime_error("boom"); });
+    lane->enqueue([&] { counter.fetch_add(1); });
+    lane->wait();
+    EXPECT_EQ(counter.load(), 1);
+}
+
+} // namespace
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include "infra/thread_pool/work_stealing_pool.hpp"
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+
+using cclone::infra::WorkStealingPool;
+
+TEST(WorkStealingPoolTest, WaitSeesEveryTask)
+{
+    WorkStealingPool pool{4};
+    std::atomic<int> counter{0};
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 10000; ++i) {
+            pool.enqueue([&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+        }
+        pool.wait();
+        EXPECT_EQ(counter.load(), (round + 1) * 10000);
+    }
+}
+
+TEST(WorkStealingPoolTest, FuturesCarryValuesAndExceptions)
+{
+    WorkStealingPool pool{2};
+    auto sum = pool.enqueue_with_future([](int a, int b) { return a + b; }, 2, 3);
+    auto moved = pool.enqueue_with_future([](std::unique_ptr<int> p) { return *p; }, std::make_unique<int>(7));
+    auto failed = pool.enqueue_with_future([]() -> int { throw std::runtime_error("boom"); });
+
+    EXPECT_EQ(sum.get(), 5);
+    EXPECT_EQ(moved.get(), 7);
+    EXPECT_THROW(failed.get(), std::runtime_error);
+}
+
+// Задачи, поставленные из рабочего, идут в его дек и разбираются кражей
+TEST(WorkStealingPoolTest, NestedTasksAreStolen)
+{
+    WorkStealingPool pool{4};
+    std::atomic<int> leaves{0};
+
+    for (int root = 0; root < 8; ++root) {
+        pool.enqueue([&] {
+            EXPECT_GE(pool.current_worker(), 0);
+            for (int i = 0; i < 1000; ++i) {
+                pool.enqueue([&] {
+                    EXPECT_GE(pool.current_worker(), 0);
+                    leaves.fetch_add(1, std::memory_order_relaxed);
+                });
+            }
+        });
+    }
+    pool.wait();
+
+    EXPECT_EQ(leaves.load(), 8000);
+    EXPECT_EQ(pool.current_worker(), -1);
+}
+
+TEST(WorkStealingPoolTest, DestructorDrainsQueue)
+{
+    std::atomic<int> counter{0};
+    {
+        WorkStealingPool pool{3};
+        for (int i = 0; i < 1000; ++i) {
+            pool.enqueue([&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+        }
+    }
+    EXPECT_EQ(counter.load(), 1000);
+}
+
+} // namespace
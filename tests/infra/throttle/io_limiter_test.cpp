@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include "infra/throttle/io_limiter.hpp"
+#include "infra/throttle/token_bucket.hpp"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using cclone::infra::IoLimiter;
+using cclone::infra::IoLimits;
+using cclone::infra::TokenBucket;
+using namespace std::chrono_literals;
+
+TEST(TokenBucketTest, UnlimitedNeverWaits)
+{
+    TokenBucket bucket;
+    EXPECT_EQ(bucket.reserve(1ull << 40), TokenBucket::Clock::duration::zero());
+}
+
+// Несколько потоков вместе не превышают скорость: сверх всплеска
+// 4 МБ при 10 МБ/с — около 0.4 с
+TEST(TokenBucketTest, ThreadsShareTheRate)
+{
+    constexpr std::uint64_t RATE = 10'000'000;
+    constexpr std::uint64_t CHUNK = 16 * 1024;
+    TokenBucket bucket(RATE);
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&] {
+                for (std::uint64_t sent = 0; sent < 5'000'000 / 4; sent += CHUNK) bucket.acquire(CHUNK);
+            });
+        }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_GE(elapsed, 300ms);
+    EXPECT_LE(elapsed, 1500ms);
+}
+
+// Очередь, набранная на низкой скорости, пересчитывается под новую
+TEST(TokenBucketTest, SetRateRescalesBacklog)
+{
+    TokenBucket bucket(1000);
+    const auto backlog = bucket.reserve(2000);
+    EXPECT_GE(backlog, 1500ms);
+
+    bucket.set_rate(10'000);
+    const auto after = bucket.reserve(1000);
+    EXPECT_GE(after, 150ms);
+    EXPECT_LE(after, 600ms);
+}
+
+TEST(IoLimitsTest, ParsesControlFile)
+{
+    const IoLimits base{.bwlimit = 1, .iops_limit = 2, .device_bwlimit = 3, .device_iops_limit = 4};
+    auto parsed = cclone::infra::parse_io_limits("# night limits\n"
+                                                 "bwlimit = 20M\n"
+                                                 "  device_iops_limit=1.5k  # per disk\n"
+                                                 "\n"
+                                                 "iops_limit = 0\n", base);
+    ASSERT_TRUE(parsed.has_value()) << parsed.error().message;
+    EXPECT_EQ(parsed->bwlimit, 20u * 1024 * 1024);
+    EXPECT_EQ(parsed->iops_limit, 0u);
+    EXPECT_EQ(parsed->device_bwlimit, 3u);
+    EXPECT_EQ(parsed->device_iops_limit, 1536u);
+
+    EXPECT_FALSE(cclone::infra::parse_io_limits("bandwidth = 5M\n", base).has_value());
+    EXPECT_FALSE(cclone::infra::parse_io_limits("bwlimit = fast\n", base).has_value());
+    EXPECT_FALSE(cclone::infra::parse_io_limits("bwlimit\n", base).has_value());
+}
+
+// Общий предел считает байты при чтении, устройства — каждое своё;
+// новые пределы действуют на уже выданные IoPacer
+TEST(IoLimiterTest, DeviceLimitsApplyAtRuntime)
+{
+    IoLimiter limiter(IoLimits{.bwlimit = 1000});
+    const auto pacer = limiter.pacer(1, 2);
+    EXPECT_GE(pacer.reserve_read(1000), 800ms);
+    EXPECT_EQ(pacer.reserve_write(1'000'000), TokenBucket::Clock::duration::zero());
+
+    const auto epoch = pacer.epoch();
+    limiter.set_limits(IoLimits{.device_bwlimit = 1000});
+    EXPECT_NE(pacer.epoch(), epoch);
+    EXPECT_GE(pacer.reserve_read(1'000'000), 900s);  // устройство 1
+    EXPECT_GE(pacer.reserve_write(2000), 1500ms);    // устройство 2
+    EXPECT_EQ(limiter.pacer(3, 3).reserve_read(50), TokenBucket::Clock::duration::zero());
+}
+
+} // namespace
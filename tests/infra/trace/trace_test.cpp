@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include "infra/trace/trace.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+namespace trace = cclone::infra::trace;
+using namespace std::chrono_literals;
+
+auto read_file(const std::filesystem::path& path) -> std::string {
+    std::ifstream in(path);
+    std::stringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+auto count(std::string_view text, std::string_view needle) -> std::size_t {
+    std::size_t found = 0;
+    for (auto pos = text.find(needle); pos != std::string_view::npos; pos = text.find(needle, pos + 1)) {
+        ++found;
+    }
+    return found;
+}
+
+class TraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = std::filesystem::temp_directory_path() / "cclone_trace_test";
+        std::filesystem::remove_all(dir_);
+        std::filesystem::create_directories(dir_);
+    }
+    void TearDown() override {
+        std::filesystem::remove_all(dir_);
+    }
+
+    std::filesystem::path dir_;
+};
+
+TEST_F(TraceTest, DisabledSpansRecordNothing)
+{
+    {
+        trace::Span span(trace::Phase::Read);
+    }
+    EXPECT_FALSE(trace::enabled());
+
+    trace::Session session({.output = dir_ / "trace.json"});
+    auto summary = session.finish();
+    ASSERT_TRUE(summary) << summary.error().message;
+    EXPECT_EQ(summary->events, 0u);
+    EXPECT_TRUE(summary->phases.empty());
+}
+
+TEST_F(TraceTest, SpansFromThreadsBecomeChromeEvents)
+{
+    const std::vector<std::filesystem::path> files{"/src/a \"quoted\"", "/src/b", "/src/c", "/src/d"};
+    trace::Session session({.output = dir_ / "trace.json"});
+    {
+        std::vector<std::jthread> threads;
+        for (const auto& file : files) {
+            threads.emplace_back([&file] {
+                trace::Span span(trace::Phase::File, &file);
+                trace::Span read(trace::Phase::Read);
+            });
+        }
+    }
+    const auto now = trace::Clock::now();
+    trace::record(trace::Phase::File, now - 5ms, now, &files[0], true);
+
+    auto summary = session.finish();
+    ASSERT_TRUE(summary) << summary.error().message;
+    EXPECT_FALSE(trace::enabled());
+    EXPECT_EQ(summary->events, 9u);
+    EXPECT_EQ(summary->dropped, 0u);
+    ASSERT_EQ(summary->phases.size(), 2u);
+    EXPECT_EQ(summary->phases.front().phase, trace::Phase::File);  // включает вложенное чтение
+    EXPECT_EQ(summary->phases.front().count, 5u);
+
+    const auto json = read_file(dir_ / "trace.json");
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("]}"), std::string::npos);
+    EXPECT_EQ(count(json, "\"ph\":\"X\""), 8u);
+    EXPECT_EQ(count(json, "\"ph\":\"b\""), 1u);
+    EXPECT_EQ(count(json, "\"ph\":\"e\""), 1u);
+    EXPECT_EQ(count(json, "\"ph\":\"M\""), 5u);  // потоки и главный
+    EXPECT_NE(json.find(R"("file":"/src/a \"quoted\"")"), std::string::npos);
+}
+
+TEST_F(TraceTest, SlowestFilesAreRankedAcrossThreads)
+{
+    std::vector<std::filesystem::path> files;
+    for (int i = 0; i < 20; ++i) files.emplace_back("/src/file" + std::to_string(i));
+
+    trace::Session session({.output = dir_ / "trace.json", .top_files = 3});
+    const auto base = trace::Clock::now();
+    {
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < 2; ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = t; i < 20; i += 2) {
+                    trace::record(trace::Phase::File, base, base + std::chrono::milliseconds(i), &files[i]);
+                }
+            });
+        }
+    }
+    auto summary = session.finish();
+    ASSERT_TRUE(summary) << summary.error().message;
+    ASSERT_EQ(summary->slowest.size(), 3u);
+    EXPECT_EQ(summary->slowest[0].path, "/src/file19");
+    EXPECT_EQ(summary->slowest[1].path, "/src/file18");
+    EXPECT_EQ(summary->slowest[2].path, "/src/file17");
+    EXPECT_EQ(summary->slowest[0].duration, 19ms);
+}
+
+TEST_F(TraceTest, FullRingDropsOldestButKeepsTotals)
+{
+    trace::Session session({.output = dir_ / "trace.json", .ring_events = 8});
+    const auto base = trace::Clock::now();
+    for (int i = 0; i < 100; ++i) {
+        trace::record(trace::Phase::Write, base + std::chrono::microseconds(i), base + std::chrono::microseconds(i + 1));
+    }
+    auto summary = session.finish();
+    ASSERT_TRUE(summary) << summary.error().message;
+    EXPECT_EQ(summary->events, 8u);
+    EXPECT_EQ(summary->dropped, 92u);
+    ASSERT_EQ(summary->phases.size(), 1u);
+    EXPECT_EQ(summary->phases[0].count, 100u);
+    EXPECT_EQ(summary->phases[0].total, 100us);
+
+    // В файле остались последние события, от старых к новым
+    const auto json = read_file(dir_ / "trace.json");
+    std::vector<double> starts;
+    for (auto pos = json.find("\"ts\":"); pos != std::string::npos; pos = json.find("\"ts\":", pos + 1)) {
+        starts.push_back(std::stod(json.substr(pos + 5)));
+    }
+    ASSERT_EQ(starts.size(), 8u);
+    for (std::size_t i = 1; i < starts.size(); ++i) {
+        EXPECT_NEAR(starts[i] - starts[i - 1], 1.0, 0.01);
+    }
+    const auto origin_to_base = starts.front() - 92.0;  // base относительно начала сессии
+    EXPECT_GE(origin_to_base, 0.0);
+}
+
+TEST_F(TraceTest, UnwritableOutputIsAnError)
+{
+    trace::Session session({.output = dir_ / "missing" / "trace.json"});
+    EXPECT_FALSE(session.finish());
+}
+
+} // namespace
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include "infra/tuning/concurrency_controller.hpp"
+#include "infra/tuning/io_probe.hpp"
+#include "infra/concurrent/concurrency_gate.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include <sys/sysmacros.h>
+
+namespace {
+
+using cclone::infra::ConcurrencyController;
+using cclone::infra::ConcurrencyGate;
+
+// Синтетическое устройство: пропускная способность растёт до колена
+// и дальше не меняется
+auto knee_curve(std::size_t knee) {
+    return [knee](std::size_t level) { return 100e6 * static_cast<double>(std::min(level, knee)); };
+}
+
+auto run(ConcurrencyController& controller, auto curve, int intervals = 40) {
+    for (int i = 0; i < intervals && !controller.settled(); ++i) {
+        controller.observe(curve(controller.level()), std::nullopt);
+    }
+    return controller.level();
+}
+
+TEST(ConcurrencyControllerTest, SettlesNearTheKnee)
+{
+    ConcurrencyController controller({.min_level = 1, .max_level = 64, .initial_level = 2});
+    const auto level = run(controller, knee_curve(12));
+
+    EXPECT_TRUE(controller.settled());
+    // Выше колена — лишняя очередь; заметно ниже — потерянная скорость
+    EXPECT_GE(level, 10u);
+    EXPECT_LE(level, 16u);
+    EXPECT_GE(controller.best().throughput, 100e6 * 10);
+}
+
+TEST(ConcurrencyControllerTest, StopsAtMaxLevel)
+{
+    ConcurrencyController controller({.min_level = 1, .max_level = 8, .initial_level = 1});
+    EXPECT_EQ(run(controller, knee_curve(1000)), 8u);
+    EXPECT_TRUE(controller.settled());
+}
+
+// После колена скорость падает — регулятор возвращается к вершине
+TEST(ConcurrencyControllerTest, BacksOffWhenThroughputDrops)
+{
+    auto peak = [](std::size_t level) {
+        const double l = static_cast<double>(level);
+        return l <= 8 ? 100e6 * l : 100e6 * std::max(1.0, 16 - l);
+    };
+    ConcurrencyController controller({.min_level = 1, .max_level = 64, .initial_level = 4});
+    const auto level = run(controller, peak);
+
+    EXPECT_TRUE(controller.settled());
+    EXPECT_GE(level, 6u);
+    EXPECT_LE(level, 10u);
+}
+
+// Задержка выше потолка: уровень уменьшается и больше не поднимается выше
+TEST(ConcurrencyControllerTest, LatencyCeilingCapsTheLevel)
+{
+    ConcurrencyController controller({.min_level = 1, .max_level = 64, .initial_level = 32,
+                                      .latency_ceiling_ms = 5.0});
+    const auto curve = knee_curve(1000);
+    for (int i = 0; i < 60; ++i) {
+        const auto level = controller.level();
+        // Задержка растёт с очередью: 0.5 мс на каждый уровень
+        controller.observe(curve(level), 0.5 * static_cast<double>(level));
+    }
+    EXPECT_LE(controller.level(), 10u);
+    EXPECT_GE(controller.level(), 6u);
+}
+
+// Фоновый цикл сам снимает счётчики и применяет уровень. Часы и байты
+// двигает сам снимок: каждый интервал длится 5 мс и приносит столько,
+// сколько даёт текущий уровень, как бы ни спал поток регулятора
+TEST(ConcurrencyControllerTest, BackgroundLoopAppliesLevels)
+{
+    std::uint64_t bytes = 0;
+    auto now = std::chrono::steady_clock::time_point{};
+    std::atomic<std::size_t> applied{0};
+    ConcurrencyController controller({.min_level = 1, .max_level = 16, .initial_level = 2});
+    controller.start([&] {
+                         now += std::chrono::milliseconds(5);
+                         bytes += 1'000'000 * std::min<std::size_t>(applied.load(), 6);
+                         return ConcurrencyController::Sample{.bytes = bytes};
+                     },
+                     [&](std::size_t level) { applied = level; },
+                     std::chrono::milliseconds(1), "workers", [&] { return now; });
+    EXPECT_EQ(applied.load(), 2u);
+    for (int i = 0; i < 2000 && !controller.settled(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    controller.stop();
+    EXPECT_TRUE(controller.settled());
+    EXPECT_EQ(applied.load(), controller.level());
+    EXPECT_EQ(controller.level(), 6u);
+}
+
+TEST(ConcurrencyGateTest, LimitsActiveHolders)
+{
+    ConcurrencyGate gate(2);
+    std::atomic<int> active{0};
+    std::atomic<int> peak{0};
+    {
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < 8; ++t) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < 50; ++i) {
+                    auto slot = gate.enter();
+                    const int now = ++active;
+                    peak = std::max(peak.load(), now);
+                    std::this_thread::yield();
+                    --active;
+                }
+            });
+        }
+        gate.set_limit(3);
+    }
+    EXPECT_LE(peak.load(), 3);
+    EXPECT_EQ(active.load(), 0);
+}
+
+TEST(IoProbeTest, ReadsDeviceCountersFromSysfs)
+{
+    const auto root = std::filesystem::temp_directory_path() / "cclone_io_probe_test";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "dev/block/8:16");
+    std::ofstream(root / "dev/block/8:16/stat")
+        << "    1200  0  9600  300   800  0  6400  500  0  700  800  0 0 0 0\n";
+
+    const auto counters = cclone::infra::read_device_counters(makedev(8, 16), root);
+    ASSERT_TRUE(counters.has_value());
+    EXPECT_EQ(counters->ios, 2000u);
+    EXPECT_EQ(counters->ticks_ms, 800u);
+    EXPECT_FALSE(cclone::infra::read_device_counters(makedev(9, 1), root).has_value());
+
+    std::filesystem::remove_all(root);
+}
+
+} // namespace
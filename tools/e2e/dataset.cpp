@@ -0,0 +1,253 @@
+#include "dataset.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace cclone::e2e {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr std::uint64_t KiB = 1024;
+constexpr std::uint64_t MiB = 1024 * KiB;
+constexpr std::uint64_t GiB = 1024 * MiB;
+
+auto scaled(double base, double scale, std::uint64_t floor = 1) -> std::uint64_t {
+    return std::max<std::uint64_t>(floor, static_cast<std::uint64_t>(std::llround(base * scale)));
+}
+
+auto io_error(std::string_view what, const fs::path& path, int err = errno) -> infra::Error {
+    return infra::make_error(err == ENOSPC ? infra::ErrorCode::DiskFull : infra::ErrorCode::Unknown,
+                             fmt::format("{} {}: {}", what, path.string(), std::strerror(err)));
+}
+
+// Пишет файлы из одного псевдослучайного блока. Каждый файл начинается
+// со своего номера и читает блок со своего сдвига, так что одинаковых
+// файлов нет и --dedup или сжатие ФС не искажают замер
+class Writer {
+public:
+    explicit Writer(std::uint64_t seed)
+        : block_(BLOCK_SIZE)
+    {
+        std::uint64_t state = seed * 0x9E3779B97F4A7C15ull + 1;
+        for (auto& byte : block_) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            byte = static_cast<char>(state >> 56);
+        }
+    }
+
+    auto file(const fs::path& path, std::uint64_t size) -> std::expected<void, infra::Error> {
+        const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd == -1) return std::unexpected(io_error("Cannot create", path));
+        auto written = fill(fd, 0, size, path);
+        ::close(fd);
+        return written;
+    }
+
+    // Разреженный файл: extent данных в начале каждого шага, остальное — дыры
+    auto sparse(const fs::path& path, std::uint64_t size, std::uint64_t step, std::uint64_t extent)
+        -> std::expected<void, infra::Error>
+    {
+        const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd == -1) return std::unexpected(io_error("Cannot create", path));
+        std::expected<void, infra::Error> result{};
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            result = std::unexpected(io_error("Cannot size", path));
+        }
+        for (std::uint64_t offset = 0; result && offset < size; offset += step) {
+            result = fill(fd, offset, std::min(extent, size - offset), path);
+        }
+        ::close(fd);
+        return result;
+    }
+
+private:
+    static constexpr std::size_t BLOCK_SIZE = 1 << 20;
+
+    auto fill(int fd, std::uint64_t offset, std::uint64_t size, const fs::path& path)
+        -> std::expected<void, infra::Error>
+    {
+        const auto tag = next_++;
+        std::uint64_t done = 0;
+        while (done < size) {
+            const auto start = (tag * 4099 + done) % BLOCK_SIZE;
+            auto length = std::min<std::uint64_t>(size - done, BLOCK_SIZE - start);
+            const char* data = block_.data() + start;
+            std::string head;
+            if (done == 0 && size >= sizeof(tag)) {
+                head.assign(data, static_cast<std::size_t>(length));
+                std::memcpy(head.data(), &tag, sizeof(tag));
+                data = head.data();
+            }
+            const ssize_t n = ::pwrite(fd, data, static_cast<std::size_t>(length), static_cast<off_t>(offset + done));
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return std::unexpected(io_error("Cannot write", path));
+            }
+            done += static_cast<std::uint64_t>(n);
+        }
+        return {};
+    }
+
+    std::vector<char> block_;
+    std::uint64_t next_ = 0;
+};
+
+auto make_dir(const fs::path& dir) -> std::expected<void, infra::Error> {
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::PermissionDenied,
+                               fmt::format("Cannot create {}: {}", dir.string(), ec.message())));
+    }
+    return {};
+}
+
+// count файлов по size байт, по per_dir в подкаталоге
+auto flat_files(Writer& writer, const fs::path& root, std::uint64_t count, std::uint64_t size,
+                std::uint64_t per_dir, DatasetStats& stats) -> std::expected<void, infra::Error>
+{
+    for (std::uint64_t i = 0; i < count; ++i) {
+        const auto dir = per_dir >= count ? root : root / fmt::format("d{:05}", i / per_dir);
+        if (i % per_dir == 0) {
+            if (auto made = make_dir(dir); !made) return made;
+        }
+        if (auto written = writer.file(dir / fmt::format("f{:07}.bin", i), size); !written) return written;
+        ++stats.files;
+        stats.bytes += size;
+        if ((i + 1) % 100'000 == 0) spdlog::info("  {} of {} files", i + 1, count);
+    }
+    return {};
+}
+
+auto build(std::string_view shape, const fs::path& root, double scale, Writer& writer)
+    -> std::expected<DatasetStats, infra::Error>
+{
+    DatasetStats stats;
+    std::expected<void, infra::Error> done{};
+
+    if (shape == "small-files") {
+        done = flat_files(writer, root, scaled(1'000'000, scale), 1 * KiB, 1000, stats);
+    } else if (shape == "medium-files") {
+        done = flat_files(writer, root, scaled(10'000, scale), 10 * MiB, 100, stats);
+    } else if (shape == "huge-files") {
+        done = flat_files(writer, root, 3, scaled(50.0 * GiB, scale, MiB), 3, stats);
+    } else if (shape == "wide-dir") {
+        done = flat_files(writer, root, scaled(200'000, scale), 4 * KiB, UINT64_MAX, stats);
+    } else if (shape == "deep-tree") {
+        // Глубина постоянна — её и проверяет форма; scale меняет файлы на уровне
+        constexpr int DEPTH = 256;
+        const auto per_level = scaled(4, scale);
+        auto dir = root;
+        for (int level = 0; done && level < DEPTH; ++level) {
+            dir /= fmt::format("l{:03}", level);
+            done = make_dir(dir);
+            for (std::uint64_t i = 0; done && i < per_level; ++i) {
+                done = writer.file(dir / fmt::format("f{}.bin", i), 4 * KiB);
+                ++stats.files;
+                stats.bytes += 4 * KiB;
+            }
+        }
+    } else if (shape == "sparse") {
+        const auto size = scaled(8.0 * GiB, scale, 64 * MiB);
+        done = make_dir(root);
+        for (int i = 0; done && i < 8; ++i) {
+            done = writer.sparse(root / fmt::format("sparse{}.img", i), size, 64 * MiB, 1 * MiB);
+            ++stats.files;
+            stats.bytes += size;
+        }
+    } else if (shape == "hardlinks") {
+        // Каждый inode под пятью именами в пяти каталогах
+        constexpr int NAMES = 5;
+        const auto inodes = scaled(20'000, scale);
+        for (int name = 0; done && name < NAMES; ++name) {
+            done = make_dir(root / fmt::format("n{}", name));
+        }
+        for (std::uint64_t i = 0; done && i < inodes; ++i) {
+            const auto first = root / "n0" / fmt::format("f{:07}.bin", i);
+            done = writer.file(first, 8 * KiB);
+            for (int name = 1; done && name < NAMES; ++name) {
+                const auto link = root / fmt::format("n{}", name) / first.filename();
+                if (::link(first.c_str(), link.c_str()) != 0) done = std::unexpected(io_error("Cannot link", link));
+            }
+            stats.files += NAMES;
+            stats.bytes += 8 * KiB;
+        }
+    } else {
+        return std::unexpected(infra::make_error(infra::ErrorCode::InvalidPath,
+                               fmt::format("Unknown dataset shape: {}", shape)));
+    }
+    if (!done) return std::unexpected(std::move(done.error()));
+    return stats;
+}
+
+auto marker_line(std::string_view shape, const GenerateOptions& options) -> std::string {
+    return fmt::format("{} scale={} seed={}", shape, options.scale, options.seed);
+}
+
+} // namespace
+
+auto shapes() -> const std::vector<Shape>& {
+    static const std::vector<Shape> all{
+        {"small-files", "1,000,000 files of 1 KB in directories of 1000"},
+        {"medium-files", "10,000 files of 10 MB in directories of 100"},
+        {"huge-files", "3 files of 50 GB"},
+        {"deep-tree", "256 nested directories, 4 files of 4 KB on each level"},
+        {"wide-dir", "200,000 files of 4 KB in one directory"},
+        {"sparse", "8 sparse files of 8 GB, 1 MB of data every 64 MB"},
+        {"hardlinks", "20,000 files of 8 KB, each under 5 names"},
+    };
+    return all;
+}
+
+auto find_shape(std::string_view name) -> const Shape* {
+    const auto& all = shapes();
+    const auto it = std::ranges::find(all, name, &Shape::name);
+    return it == all.end() ? nullptr : &*it;
+}
+
+auto generate(const Shape& shape, const fs::path& root, const GenerateOptions& options)
+    -> std::expected<DatasetStats, infra::Error>
+{
+    auto marker = root;
+    marker += MARKER;
+    const auto expected_line = marker_line(shape.name, options);
+    if (!options.force) {
+        std::ifstream in(marker);
+        std::string line;
+        DatasetStats stats;
+        if (std::getline(in, line) && line == expected_line && in >> stats.files >> stats.bytes) {
+            spdlog::info("Dataset {} already in {}", shape.name, root.string());
+            return stats;
+        }
+    }
+
+    // Метка уходит первой: недостроенный набор не должен сойти за готовый
+    std::error_code ec;
+    fs::remove(marker, ec);
+    fs::remove_all(root, ec);
+    if (auto made = make_dir(root); !made) return std::unexpected(std::move(made.error()));
+
+    spdlog::info("Generating {} ({}) in {}, scale {}", shape.name, shape.description, root.string(), options.scale);
+    Writer writer(options.seed);
+    auto stats = build(shape.name, root, options.scale, writer);
+    if (!stats) return stats;
+
+    std::ofstream out(marker, std::ios::trunc);
+    out << expected_line << '\n' << stats->files << ' ' << stats->bytes << '\n';
+    if (!out) return std::unexpected(io_error("Cannot write", marker));
+    return stats;
+}
+
+} // namespace cclone::e2e
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "infra/error_handler/error.hpp"
+
+namespace cclone::e2e {
+
+// Форма нагрузки для сквозных замеров. scale умножает число файлов, а у
+// форм из нескольких больших файлов — их размер: 0.01 даёт ту же форму
+// в сотую долю объёма (CI), 1 — полный набор
+struct Shape {
+    std::string_view name;
+    std::string_view description;
+};
+
+[[nodiscard]] auto shapes() -> const std::vector<Shape>&;
+[[nodiscard]] auto find_shape(std::string_view name) -> const Shape*;
+
+// Что лежит в наборе: files — имена, включая жёсткие ссылки; bytes —
+// данные, каждый inode один раз: столько пишет копия, сохраняющая ссылки
+struct DatasetStats {
+    std::uint64_t files = 0;
+    std::uint64_t bytes = 0;
+};
+
+struct GenerateOptions {
+    double scale = 1.0;
+    std::uint64_t seed = 1;
+    bool force = false;     // пересоздать, даже если набор уже есть
+};
+
+// Создаёт набор формы shape в root. Набор детерминирован (seed) и
+// помечается файлом <root>MARKER рядом с корнем, а не в нём, чтобы метка
+// не копировалась и не замерялась вместе с данными. Повторный вызов с
+// теми же параметрами ничего не пишет и возвращает сохранённую статистику
+[[nodiscard]] auto generate(const Shape& shape, const std::filesystem::path& root, const GenerateOptions& options)
+    -> std::expected<DatasetStats, infra::Error>;
+
+inline constexpr std::string_view MARKER = ".cclone-dataset";
+
+} // namespace cclone::e2e
@@ -0,0 +1,195 @@
+// cclone_e2e — fcopyrover против cp -a и rsync на синтетических наборах:
+// время, CPU, пиковый RSS и пропускная способность, отчёт JSON и
+// проверка ухудшений против прежнего отчёта
+#include "dataset.hpp"
+#include "harness.hpp"
+#include <CLI/CLI.hpp>
+#include <spdlog/spdlog.h>
+#include <functional>
+#include <iostream>
+#include <set>
+
+namespace {
+
+namespace fs = std::filesystem;
+using namespace cclone::e2e;
+
+// Копирование дерева src в новый каталог dst
+struct Tool {
+    std::string name;
+    std::function<std::vector<std::string>(const fs::path& src, const fs::path& dst)> argv;
+};
+
+auto default_fcopyrover() -> std::string {
+    std::error_code ec;
+    const auto sibling = fs::read_symlink("/proc/self/exe", ec).parent_path() / "fcopyrover";
+    return !ec && fs::exists(sibling) ? sibling.string() : "fcopyrover";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    CLI::App app{"End-to-end benchmark of fcopyrover against cp -a and rsync"};
+
+    fs::path work;
+    std::vector<std::string> shape_names;
+    std::string fcopyrover = default_fcopyrover();
+    std::vector<std::string> fcopyrover_args;
+    std::vector<std::string> baselines;
+    std::string cache = "both";
+    GenerateOptions generate_options;
+    ReportInfo info;
+    fs::path report;
+    fs::path compare;
+    double threshold_pct = 10.0;
+
+    app.add_option("-w, --work", work, "Working directory: datasets, copies, logs and the report")->required();
+    app.add_option("--shape", shape_names, "Shapes to run (default: all, see cclone_datagen --list)");
+    app.add_option("--scale", generate_options.scale, "Dataset scale; 1 is the full set")->check(CLI::PositiveNumber);
+    app.add_option("--fcopyrover", fcopyrover, "fcopyrover binary");
+    app.add_option("--fcopyrover-arg", fcopyrover_args, "Extra argument for fcopyrover (repeatable)")
+        ->expected(1);
+    app.add_option("--baseline", baselines, "Baseline tools: cp, rsync or none (default: cp and rsync)")
+        ->check(CLI::IsMember({"cp", "rsync", "none"}));
+    app.add_option("--cache", cache, "Page cache before each run: cold (drop_caches), warm or both")
+        ->check(CLI::IsMember({"cold", "warm", "both"}));
+    app.add_option("--runs", info.runs, "Timed runs per tool; the report keeps medians")->check(CLI::PositiveNumber);
+    app.add_option("--label", info.label, "Label stored in the report (release, commit)");
+    app.add_option("--report", report, "JSON report (default: <work>/e2e-report.json)");
+    app.add_option("--compare", compare, "Previous report to check for regressions");
+    app.add_option("--threshold", threshold_pct, "Allowed slowdown or RSS growth against --compare, %");
+    try {
+        app.parse(argc, argv);
+    } catch (const CLI::CallForHelp&) {
+        std::cout << app.help() << "\n";
+        return 0;
+    } catch (const CLI::ParseError& e) {
+        std::cerr << "Error: " << e.what() << "\n\n" << app.help() << "\n";
+        return 1;
+    }
+
+    if (shape_names.empty()) {
+        for (const auto& shape : shapes()) shape_names.emplace_back(shape.name);
+    }
+    if (baselines.empty()) baselines = {"cp", "rsync"};
+    if (report.empty()) report = work / "e2e-report.json";
+    info.fcopyrover = fcopyrover;
+    info.scale = generate_options.scale;
+
+    // Та же работа, что у cp -a и rsync -aH: метаданные fcopyrover сохраняет
+    // по умолчанию, -H воссоздаёт жёсткие ссылки вместо копий. --no-daemon:
+    // иначе при запущенном демоне замерялся бы тонкий клиент
+    std::vector<Tool> tools{{"fcopyrover", [&](const fs::path& src, const fs::path& dst) {
+        std::vector<std::string> args{fcopyrover, "-s", src.string(), "-d", dst.string(), "-r", "-H",
+                                      "--no-progress", "--no-daemon"};
+        args.insert(args.end(), fcopyrover_args.begin(), fcopyrover_args.end());
+        return args;
+    }}};
+    for (const auto& baseline : baselines) {
+        if (baseline == "none") continue;
+        if (baseline == "cp") {
+            tools.push_back({"cp", [](const fs::path& src, const fs::path& dst) {
+                return std::vector<std::string>{"cp", "-a", (src / ".").string(), dst.string()};
+            }});
+        } else {
+            // -H: жёсткие ссылки, как у cp -a
+            tools.push_back({"rsync", [](const fs::path& src, const fs::path& dst) {
+                return std::vector<std::string>{"rsync", "-aH", src.string() + "/", dst.string() + "/"};
+            }});
+        }
+    }
+
+    std::vector<std::string> caches;
+    if (cache != "warm") {
+        info.cold_cache = drop_caches();
+        if (info.cold_cache) {
+            caches.emplace_back("cold");
+        } else {
+            spdlog::warn("Cannot write /proc/sys/vm/drop_caches (needs root): cold-cache runs skipped");
+        }
+    }
+    if (cache != "cold") caches.emplace_back("warm");
+
+    std::error_code ec;
+    fs::create_directories(work / "logs", ec);
+    std::vector<Result> results;
+    std::set<std::string> missing;
+
+    for (const auto& name : shape_names) {
+        const auto* shape = find_shape(name);
+        if (!shape) {
+            spdlog::error("Unknown shape '{}'", name);
+            return 1;
+        }
+        const auto src = work / "datasets" / shape->name;
+        auto dataset = generate(*shape, src, generate_options);
+        if (!dataset) {
+            spdlog::error("{}", dataset.error().message);
+            return 1;
+        }
+
+        for (const auto& mode : caches) {
+            std::vector<Result> group;
+            for (const auto& tool : tools) {
+                if (missing.contains(tool.name)) continue;
+                const auto dst = work / "copy" / tool.name;
+                const auto log = work / "logs" / fmt::format("{}-{}-{}.log", shape->name, tool.name, mode);
+                Result result{.shape = std::string(shape->name), .tool = tool.name, .cache = mode, .dataset = *dataset};
+
+                // Тёплый кеш: неучтённый прогон читает источник в page cache
+                const int warmups = mode == "warm" ? 1 : 0;
+                for (int run = -warmups; run < info.runs; ++run) {
+                    fs::remove_all(dst, ec);
+                    if (mode == "cold") (void)drop_caches();
+                    auto measured = run_measured(tool.argv(src, dst), log);
+                    if (!measured) {
+                        spdlog::warn("{}, skipping {}", measured.error().message, tool.name);
+                        missing.insert(tool.name);
+                        break;
+                    }
+                    if (run >= 0) result.runs.push_back(*measured);
+                }
+                fs::remove_all(dst, ec);
+                if (result.runs.empty()) continue;
+
+                result.median = median_of(result.runs);
+                spdlog::info("{:<13} {:<10} {:<4}  wall {:8.2f}s  cpu {:8.2f}s  rss {:7.1f} MB  {:9.1f} MB/s{}",
+                             shape->name, tool.name, mode, result.median.wall_s, result.median.cpu_s,
+                             result.median.peak_rss_kb / 1024.0, result.throughput_mbps(),
+                             result.median.exit_code ? fmt::format("  exit {} (see {})", result.median.exit_code,
+                                                                   log.string())
+                                                     : "");
+                group.push_back(std::move(result));
+            }
+
+            // Во сколько раз fcopyrover быстрее каждого базового инструмента
+            if (!group.empty() && group.front().tool == "fcopyrover" && group.front().median.wall_s > 0) {
+                for (std::size_t i = 1; i < group.size(); ++i) {
+                    group.front().speedup[group[i].tool] = group[i].median.wall_s / group.front().median.wall_s;
+                }
+            }
+            results.insert(results.end(), group.begin(), group.end());
+        }
+    }
+
+    if (auto written = write_report(report, info, results); !written) {
+        spdlog::error("{}", written.error().message);
+        return 1;
+    }
+    spdlog::info("Report written to {}", report.string());
+
+    if (compare.empty()) return 0;
+    auto previous = load_report(compare);
+    if (!previous) {
+        spdlog::error("{}", previous.error().message);
+        return 1;
+    }
+    const auto regressions = find_regressions(results, *previous, threshold_pct / 100.0);
+    for (const auto& regression : regressions) {
+        spdlog::error("Regression {} {}: {:.3f} -> {:.3f}", regression.key, regression.metric,
+                      regression.baseline, regression.current);
+    }
+    if (!regressions.empty()) return 2;
+    spdlog::info("No regressions beyond {:.1f}% against {}", threshold_pct, compare.string());
+    return 0;
+}
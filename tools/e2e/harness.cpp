@@ -0,0 +1,207 @@
+#include "harness.hpp"
+#include "infra/json.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <thread>
+#include <fmt/core.h>
+#include <yaml-cpp/yaml.h>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/utsname.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace cclone::e2e {
+
+namespace {
+
+auto seconds(const timeval& tv) -> double {
+    return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) / 1e6;
+}
+
+template <typename T>
+auto median_by(std::vector<Measurement> runs, T Measurement::*field) -> T {
+    std::ranges::sort(runs, {}, field);
+    return runs[runs.size() / 2].*field;
+}
+
+auto measurement_json(const Measurement& m) -> std::string {
+    return fmt::format(R"("wall_s":{:.4f},"cpu_s":{:.4f},"peak_rss_kb":{},"exit_code":{})",
+                       m.wall_s, m.cpu_s, m.peak_rss_kb, m.exit_code);
+}
+
+auto host_json() -> std::string {
+    utsname name{};
+    ::uname(&name);
+    return fmt::format(R"("host":"{}","kernel":"{} {}","cpus":{})", infra::json_escape(name.nodename),
+                       infra::json_escape(name.sysname), infra::json_escape(name.release),
+                       std::thread::hardware_concurrency());
+}
+
+} // namespace
+
+auto run_measured(const std::vector<std::string>& argv, const std::filesystem::path& log)
+    -> std::expected<Measurement, infra::Error>
+{
+    std::vector<char*> args;
+    for (const auto& arg : argv) args.push_back(const_cast<char*>(arg.c_str()));
+    args.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+
+    const auto started = std::chrono::steady_clock::now();
+    pid_t pid = 0;
+    const int spawned = ::posix_spawnp(&pid, args[0], &actions, nullptr, args.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (spawned != 0) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::FileNotFound,
+                               fmt::format("Cannot run {}: {}", argv[0], std::strerror(spawned))));
+    }
+
+    int status = 0;
+    rusage usage{};
+    while (::wait4(pid, &status, 0, &usage) == -1) {
+        if (errno != EINTR) {
+            return std::unexpected(infra::make_error(infra::ErrorCode::Unknown,
+                                   fmt::format("wait4 failed for {}: {}", argv[0], std::strerror(errno))));
+        }
+    }
+    const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - started;
+
+    return Measurement{
+        .wall_s = wall.count(),
+        .cpu_s = seconds(usage.ru_utime) + seconds(usage.ru_stime),
+        .peak_rss_kb = static_cast<std::uint64_t>(usage.ru_maxrss),
+        .exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status)
+    };
+}
+
+auto drop_caches() -> bool {
+    ::sync();
+    std::ofstream control("/proc/sys/vm/drop_caches");
+    control << "3\n";
+    control.flush();
+    return static_cast<bool>(control);
+}
+
+auto Result::throughput_mbps() const -> double {
+    return median.wall_s > 0 ? static_cast<double>(dataset.bytes) / 1024.0 / 1024.0 / median.wall_s : 0.0;
+}
+
+auto median_of(const std::vector<Measurement>& runs) -> Measurement {
+    if (runs.empty()) return {};
+    return Measurement{
+        .wall_s = median_by(runs, &Measurement::wall_s),
+        .cpu_s = median_by(runs, &Measurement::cpu_s),
+        .peak_rss_kb = median_by(runs, &Measurement::peak_rss_kb),
+        // Один неудачный прогон портит весь результат
+        .exit_code = std::ranges::max(runs, {}, &Measurement::exit_code).exit_code
+    };
+}
+
+auto write_report(const std::filesystem::path& path, const ReportInfo& info, const std::vector<Result>& results)
+    -> std::expected<void, infra::Error>
+{
+    std::string json = fmt::format(
+        R"({{"label":"{}","timestamp":{},{},"fcopyrover":"{}","scale":{},"runs":{},"cold_cache":{},"results":[)",
+        infra::json_escape(info.label), std::time(nullptr), host_json(), infra::json_escape(info.fcopyrover),
+        info.scale, info.runs, info.cold_cache);
+
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        json += fmt::format(R"({}{{"shape":"{}","tool":"{}","cache":"{}","files":{},"bytes":{},{},"throughput_mbps":{:.2f})",
+                            i ? "," : "", result.shape, result.tool, result.cache, result.dataset.files,
+                            result.dataset.bytes, measurement_json(result.median), result.throughput_mbps());
+        if (!result.speedup.empty()) {
+            json += R"(,"speedup":{)";
+            bool first = true;
+            for (const auto& [tool, ratio] : result.speedup) {
+                json += fmt::format(R"({}"{}":{:.3f})", first ? "" : ",", tool, ratio);
+                first = false;
+            }
+            json += "}";
+        }
+        json += R"(,"runs":[)";
+        for (std::size_t run = 0; run < result.runs.size(); ++run) {
+            json += fmt::format("{}{{{}}}", run ? "," : "", measurement_json(result.runs[run]));
+        }
+        json += "]}";
+    }
+    json += "]}\n";
+
+    std::ofstream out(path, std::ios::trunc);
+    out << json;
+    if (!out) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::PermissionDenied,
+                               fmt::format("Cannot write report {}", path.string())));
+    }
+    return {};
+}
+
+auto load_report(const std::filesystem::path& path) -> std::expected<std::vector<Result>, infra::Error> {
+    // JSON — подмножество YAML: отчёт читает тот же yaml-cpp, что и конфиг
+    try {
+        const auto root = YAML::LoadFile(path.string());
+        std::vector<Result> results;
+        for (const auto& node : root["results"]) {
+            Result result{
+                .shape = node["shape"].as<std::string>(),
+                .tool = node["tool"].as<std::string>(),
+                .cache = node["cache"].as<std::string>(),
+                .dataset = {.files = node["files"].as<std::uint64_t>(), .bytes = node["bytes"].as<std::uint64_t>()},
+            };
+            result.median = Measurement{
+                .wall_s = node["wall_s"].as<double>(),
+                .cpu_s = node["cpu_s"].as<double>(),
+                .peak_rss_kb = node["peak_rss_kb"].as<std::uint64_t>(),
+                .exit_code = node["exit_code"].as<int>()
+            };
+            results.push_back(std::move(result));
+        }
+        return results;
+    } catch (const YAML::Exception& e) {
+        return std::unexpected(infra::make_error(infra::ErrorCode::InvalidPath,
+                               fmt::format("Cannot read report {}: {}", path.string(), e.what())));
+    }
+}
+
+auto find_regressions(const std::vector<Result>& current, const std::vector<Result>& baseline, double threshold)
+    -> std::vector<Regression>
+{
+    std::vector<Regression> regressions;
+    for (const auto& result : current) {
+        if (result.tool != "fcopyrover") continue;
+        if (result.median.exit_code != 0) {
+            regressions.push_back({result.key(), "exit_code", 0, static_cast<double>(result.median.exit_code)});
+            continue;
+        }
+        const auto base = std::ranges::find(baseline, result.key(), &Result::key);
+        // Другой масштаб — другой набор: сравнивать нечего
+        if (base == baseline.end() || base->dataset.bytes != result.dataset.bytes
+            || base->dataset.files != result.dataset.files) {
+            continue;
+        }
+        const auto check = [&](std::string_view metric, double before, double now) {
+            if (before > 0 && now > before * (1.0 + threshold)) {
+                regressions.push_back({result.key(), std::string(metric), before, now});
+            }
+        };
+        check("wall_s", base->median.wall_s, result.median.wall_s);
+        check("peak_rss_kb", static_cast<double>(base->median.peak_rss_kb),
+              static_cast<double>(result.median.peak_rss_kb));
+    }
+    return regressions;
+}
+
+} // namespace cclone::e2e
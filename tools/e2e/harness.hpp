@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+#include "dataset.hpp"
+#include "infra/error_handler/error.hpp"
+
+namespace cclone::e2e {
+
+// Один запуск копировщика: время по часам, процессорное время
+// (user + sys из wait4) и пиковый RSS дочернего процесса
+struct Measurement {
+    double wall_s = 0;
+    double cpu_s = 0;
+    std::uint64_t peak_rss_kb = 0;
+    int exit_code = 0;
+};
+
+// Запускает argv, вывод пишет в log; ошибка — только если запуск не удался
+[[nodiscard]] auto run_measured(const std::vector<std::string>& argv, const std::filesystem::path& log)
+    -> std::expected<Measurement, infra::Error>;
+
+// sync и сброс page cache через /proc/sys/vm/drop_caches; false — нет прав
+[[nodiscard]] auto drop_caches() -> bool;
+
+// Инструмент на форме при одном состоянии кеша: все прогоны и медианы
+struct Result {
+    std::string shape;
+    std::string tool;
+    std::string cache;              // cold или warm
+    DatasetStats dataset;
+    std::vector<Measurement> runs;
+    Measurement median;             // медиана каждой величины по прогонам
+    std::map<std::string, double> speedup;  // время базового инструмента / время этого
+
+    [[nodiscard]] auto key() const -> std::string { return shape + "/" + tool + "/" + cache; }
+    [[nodiscard]] auto throughput_mbps() const -> double;
+};
+
+[[nodiscard]] auto median_of(const std::vector<Measurement>& runs) -> Measurement;
+
+struct ReportInfo {
+    std::string label;
+    std::string fcopyrover;
+    double scale = 1.0;
+    int runs = 1;
+    bool cold_cache = false;        // удалось ли сбрасывать кеш
+};
+
+[[nodiscard]] auto write_report(const std::filesystem::path& path, const ReportInfo& info,
+                                const std::vector<Result>& results) -> std::expected<void, infra::Error>;
+
+// Результаты из прежнего отчёта (только медианы)
+[[nodiscard]] auto load_report(const std::filesystem::path& path) -> std::expected<std::vector<Result>, infra::Error>;
+
+struct Regression {
+    std::string key;
+    std::string metric;             // wall_s, peak_rss_kb или exit_code
+    double baseline = 0;
+    double current = 0;
+};
+
+// Ухудшения fcopyrover больше чем на threshold (доля: 0.1 — 10%) против
+// прежнего отчёта; прогон с ненулевым кодом выхода — всегда ухудшение
+[[nodiscard]] auto find_regressions(const std::vector<Result>& current, const std::vector<Result>& baseline,
+                                    double threshold) -> std::vector<Regression>;
+
+} // namespace cclone::e2e